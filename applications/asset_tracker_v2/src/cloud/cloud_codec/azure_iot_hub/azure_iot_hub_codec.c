@@ -145,93 +145,18 @@ exit:
 int cloud_codec_decode_config(char *input, size_t input_len,
 			      struct cloud_data_cfg *cfg)
 {
-	int err = 0;
-	cJSON *root_obj = NULL;
-	cJSON *group_obj = NULL;
-	cJSON *subgroup_obj = NULL;
-
 	if (input == NULL) {
 		return -EINVAL;
 	}
 
-	root_obj = cJSON_ParseWithLength(input, input_len);
-	if (root_obj == NULL) {
-		return -ENOENT;
-	}
-
-	/* Verify that the incoming JSON string is an object. */
-	if (!cJSON_IsObject(root_obj)) {
-		return -ENOENT;
-	}
-
-	if (IS_ENABLED(CONFIG_CLOUD_CODEC_LOG_LEVEL_DBG)) {
-		json_print_obj("Decoded message:\n", root_obj);
-	}
-
-	group_obj = json_object_decode(root_obj, OBJECT_CONFIG);
-	if (group_obj != NULL) {
-		subgroup_obj = group_obj;
-		goto get_data;
-	}
-
-	group_obj = json_object_decode(root_obj, OBJECT_DESIRED);
-	if (group_obj == NULL) {
-		err = -ENODATA;
-		goto exit;
-	}
-
-	subgroup_obj = json_object_decode(group_obj, OBJECT_CONFIG);
-	if (subgroup_obj == NULL) {
-		err = -ENODATA;
-		goto exit;
-	}
-
-get_data:
-
-	json_common_config_get(subgroup_obj, cfg);
-
-exit:
-	cJSON_Delete(root_obj);
-	return err;
+	/* The configuration is pulled from the input without building a cJSON tree. */
+	return json_common_config_decode(input, input_len, OBJECT_DESIRED, cfg);
 }
 
 int cloud_codec_encode_config(struct cloud_codec_data *output,
 			      struct cloud_data_cfg *data)
 {
-	int err;
-	char *buffer;
-
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	err = json_common_config_add(root_obj, data, DATA_CONFIG);
-
-	if (err) {
-		goto exit;
-	}
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (buffer == NULL) {
-		LOG_ERR("Failed to allocate memory for JSON string");
-
-		err = -ENOMEM;
-		goto exit;
-	}
-
-	if (IS_ENABLED(CONFIG_CLOUD_CODEC_LOG_LEVEL_DBG)) {
-		json_print_obj("Encoded message:\n", root_obj);
-	}
-
-	output->buf = buffer;
-	output->len = strlen(buffer);
-
-exit:
-	cJSON_Delete(root_obj);
-	return err;
+	return json_common_config_encode(output, data, NULL, 0);
 }
 
 int cloud_codec_encode_data(struct cloud_codec_data *output,
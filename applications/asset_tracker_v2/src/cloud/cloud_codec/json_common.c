@@ -5,6 +5,7 @@
  */
 
 #include <zephyr.h>
+#include <math.h>
 #include <cJSON.h>
 #include <date_time.h>
 
@@ -16,6 +17,9 @@
 #include <logging/log.h>
 LOG_MODULE_REGISTER(json_common, CONFIG_CLOUD_CODEC_LOG_LEVEL);
 
+/* 2020-01-01 00:00:00 UTC. Uptime does not reach this value in practice, about 50 years. */
+#define UNIX_TIME_MS_MIN 1577836800000LL
+
 static int op_code_handle(cJSON *parent, enum json_common_op_code op,
 			  const char *object_label, cJSON *child, cJSON **parent_ref)
 {
@@ -54,6 +58,15 @@ static int op_code_handle(cJSON *parent, enum json_common_op_code op,
 	return 0;
 }
 
+int json_common_timestamp_convert(int64_t *ts)
+{
+	if (*ts >= UNIX_TIME_MS_MIN) {
+		return 0;
+	}
+
+	return date_time_uptime_to_unix_time_ms(ts);
+}
+
 int json_common_modem_static_data_add(cJSON *parent,
 				      struct cloud_data_modem_static *data,
 				      enum json_common_op_code op,
@@ -66,7 +79,7 @@ int json_common_modem_static_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = json_common_timestamp_convert(&data->ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -150,7 +163,7 @@ int json_common_modem_dynamic_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = json_common_timestamp_convert(&data->ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -283,7 +296,7 @@ int json_common_sensor_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->env_ts);
+	err = json_common_timestamp_convert(&data->env_ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -361,7 +374,7 @@ int json_common_gnss_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->gnss_ts);
+	err = json_common_timestamp_convert(&data->gnss_ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -466,7 +479,7 @@ int json_common_accel_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = json_common_timestamp_convert(&data->ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -535,7 +548,7 @@ int json_common_ui_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->btn_ts);
+	err = json_common_timestamp_convert(&data->btn_ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -584,7 +597,7 @@ int json_common_neighbor_cells_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = json_common_timestamp_convert(&data->ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -904,7 +917,7 @@ int json_common_battery_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->bat_ts);
+	err = json_common_timestamp_convert(&data->bat_ts);
 	if (err) {
 		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 		return err;
@@ -1099,11 +1112,269 @@ void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data)
 	}
 }
 
+int json_common_config_write(struct json_writer *writer, const struct cloud_data_cfg *data,
+			     const char *object_label)
+{
+	if (object_label == NULL) {
+		LOG_WRN("Missing object label");
+		return -EINVAL;
+	}
+
+	/* Errors are sticky and returned when the object is ended. */
+	json_writer_obj_start(writer, object_label);
+	json_writer_add_bool(writer, CONFIG_DEVICE_MODE, data->active_mode);
+	json_writer_add_number(writer, CONFIG_GNSS_TIMEOUT, data->gnss_timeout);
+	json_writer_add_number(writer, CONFIG_ACTIVE_TIMEOUT, data->active_wait_timeout);
+	json_writer_add_number(writer, CONFIG_MOVE_RES, data->movement_resolution);
+	json_writer_add_number(writer, CONFIG_MOVE_TIMEOUT, data->movement_timeout);
+	json_writer_add_number(writer, CONFIG_ACC_THRESHOLD, data->accelerometer_threshold);
+	json_writer_array_start(writer, CONFIG_NO_DATA_LIST);
+
+	if (data->no_data.gnss) {
+		json_writer_add_str(writer, NULL, CONFIG_NO_DATA_LIST_GNSS);
+	}
+
+	if (data->no_data.neighbor_cell) {
+		json_writer_add_str(writer, NULL, CONFIG_NO_DATA_LIST_NEIGHBOR_CELL);
+	}
+
+	json_writer_array_end(writer);
+
+	return json_writer_obj_end(writer);
+}
+
+int json_common_config_encode(struct cloud_codec_data *output,
+			      const struct cloud_data_cfg *data,
+			      const char *const *parents, size_t parent_count)
+{
+	int err;
+	size_t len;
+	struct json_writer writer;
+	/* Released with cJSON_FreeString() in cloud_codec_release_data(). */
+	char *buffer = cJSON_malloc(JSON_COMMON_CONFIG_BUF_SIZE);
+
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for JSON string");
+		return -ENOMEM;
+	}
+
+	/* The configuration is written directly to the output, without building a cJSON tree. */
+	json_writer_init(&writer, buffer, JSON_COMMON_CONFIG_BUF_SIZE);
+	json_writer_obj_start(&writer, NULL);
+
+	for (size_t i = 0; i < parent_count; i++) {
+		json_writer_obj_start(&writer, parents[i]);
+	}
+
+	err = json_common_config_write(&writer, data, DATA_CONFIG);
+	if (err) {
+		goto exit;
+	}
+
+	for (size_t i = 0; i < parent_count; i++) {
+		json_writer_obj_end(&writer);
+	}
+
+	json_writer_obj_end(&writer);
+
+	err = json_writer_finish(&writer, &len);
+	if (err) {
+		LOG_ERR("Failed to encode configuration, error: %d", err);
+		goto exit;
+	}
+
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_LOG_LEVEL_DBG)) {
+		printk("Encoded message:\n%s\n", buffer);
+	}
+
+	output->buf = buffer;
+	output->len = len;
+	return 0;
+
+exit:
+	cJSON_free(buffer);
+	return err;
+}
+
+static int no_data_list_decode(struct json_reader *reader, struct cloud_data_no_data *no_data)
+{
+	struct json_token token;
+	bool gnss_found = false;
+	bool ncell_found = false;
+	int err;
+
+	while ((err = json_reader_next(reader, &token)) == 0) {
+		if (token.type == JSON_TOKEN_ARRAY_END) {
+			no_data->gnss = gnss_found;
+			no_data->neighbor_cell = ncell_found;
+			return 0;
+		}
+
+		if (json_token_str_eq(&token, CONFIG_NO_DATA_LIST_GNSS)) {
+			gnss_found = true;
+		}
+
+		if (json_token_str_eq(&token, CONFIG_NO_DATA_LIST_NEIGHBOR_CELL)) {
+			ncell_found = true;
+		}
+
+		err = json_reader_skip(reader, &token);
+		if (err) {
+			return err;
+		}
+	}
+
+	return err;
+}
+
+static int config_obj_decode(struct json_reader *reader, struct cloud_data_cfg *data)
+{
+	struct json_token key;
+	struct json_token value;
+	int err;
+
+	err = json_reader_next(reader, &value);
+	if (err || (value.type != JSON_TOKEN_OBJ_START)) {
+		return err ? err : json_reader_skip(reader, &value);
+	}
+
+	while (((err = json_reader_next(reader, &key)) == 0) && (key.type == JSON_TOKEN_KEY)) {
+		int num;
+
+		err = json_reader_next(reader, &value);
+		if (err) {
+			return err;
+		}
+
+		/* Values of unexpected type are ignored */
+		if (json_token_str_eq(&key, CONFIG_GNSS_TIMEOUT)) {
+			(void)json_token_int_get(&value, &data->gnss_timeout);
+		} else if (json_token_str_eq(&key, CONFIG_DEVICE_MODE)) {
+			if (json_token_int_get(&value, &num) == 0) {
+				data->active_mode = num;
+			}
+		} else if (json_token_str_eq(&key, CONFIG_ACTIVE_TIMEOUT)) {
+			(void)json_token_int_get(&value, &data->active_wait_timeout);
+		} else if (json_token_str_eq(&key, CONFIG_MOVE_RES)) {
+			(void)json_token_int_get(&value, &data->movement_resolution);
+		} else if (json_token_str_eq(&key, CONFIG_MOVE_TIMEOUT)) {
+			(void)json_token_int_get(&value, &data->movement_timeout);
+		} else if (json_token_str_eq(&key, CONFIG_ACC_THRESHOLD)) {
+			(void)json_token_number_get(&value, &data->accelerometer_threshold);
+		} else if (json_token_str_eq(&key, CONFIG_NO_DATA_LIST) &&
+			   (value.type == JSON_TOKEN_ARRAY_START)) {
+			err = no_data_list_decode(reader, &data->no_data);
+			if (err) {
+				return err;
+			}
+			continue;
+		}
+
+		err = json_reader_skip(reader, &value);
+		if (err) {
+			return err;
+		}
+	}
+
+	return err;
+}
+
+static int group_obj_decode(struct json_reader *reader, struct cloud_data_cfg *data, bool *found)
+{
+	struct json_token token;
+	int err;
+
+	err = json_reader_next(reader, &token);
+	if (err || (token.type != JSON_TOKEN_OBJ_START)) {
+		return err ? err : json_reader_skip(reader, &token);
+	}
+
+	while (((err = json_reader_next(reader, &token)) == 0) && (token.type == JSON_TOKEN_KEY)) {
+		if (json_token_str_eq(&token, OBJECT_CONFIG)) {
+			*found = true;
+			return config_obj_decode(reader, data);
+		}
+
+		err = json_reader_skip(reader, &token);
+		if (err) {
+			return err;
+		}
+	}
+
+	return err;
+}
+
+int json_common_config_decode(const char *input, size_t input_len, const char *group,
+			      struct cloud_data_cfg *data)
+{
+	struct cloud_data_cfg cfg = *data;
+	struct json_reader reader;
+	struct json_token token;
+	bool found = false;
+	int err;
+
+	if (input == NULL) {
+		return -EINVAL;
+	}
+
+	/* The input can include the null terminator */
+	json_reader_init(&reader, input, strnlen(input, input_len));
+
+	err = json_reader_next(&reader, &token);
+	if (err || (token.type != JSON_TOKEN_OBJ_START)) {
+		return -ENOENT;
+	}
+
+	while (!found) {
+		err = json_reader_next(&reader, &token);
+		if (err || (token.type != JSON_TOKEN_KEY)) {
+			break;
+		}
+
+		if (json_token_str_eq(&token, OBJECT_CONFIG)) {
+			found = true;
+			err = config_obj_decode(&reader, &cfg);
+		} else if ((group != NULL) && json_token_str_eq(&token, group)) {
+			err = group_obj_decode(&reader, &cfg, &found);
+		} else {
+			err = json_reader_skip(&reader, &token);
+		}
+
+		if (err) {
+			break;
+		}
+	}
+
+	/* The configuration is only applied if the whole document is valid. */
+	while (err == 0) {
+		err = json_reader_next(&reader, &token);
+	}
+
+	if (err != -ENODATA) {
+		return -ENOENT;
+	}
+
+	if (!found) {
+		return -ENODATA;
+	}
+
+	*data = cfg;
+
+	return 0;
+}
+
 int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
 			       size_t buf_count, const char *object_label)
 {
 	int err = 0;
-	cJSON *array_obj = cJSON_CreateArray();
+	cJSON *array_obj;
+
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_BATCH_COLUMNAR) &&
+	    (type != JSON_COMMON_MODEM_STATIC) && (type != JSON_COMMON_MODEM_DYNAMIC)) {
+		return json_common_batch_columnar_add(parent, type, buf, buf_count, object_label);
+	}
+
+	array_obj = cJSON_CreateArray();
 
 	if (parent == NULL || array_obj == NULL) {
 		cJSON_Delete(array_obj);
@@ -1212,3 +1483,321 @@ int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type,
 	json_add_obj(parent, object_label, array_obj);
 	return 0;
 }
+
+/* Column of the columnar batch format. Values are multiplied by the scale and rounded to integers
+ * before they are delta encoded.
+ */
+struct column {
+	const char *label;
+	double scale;
+};
+
+static const struct column gnss_pvt_columns[] = {
+	{ DATA_TIMESTAMP, 1 },
+	{ DATA_GNSS_LONGITUDE, 1000000 },
+	{ DATA_GNSS_LATITUDE, 1000000 },
+	{ DATA_GNSS_ACCURACY, 10 },
+	{ DATA_GNSS_ALTITUDE, 10 },
+	{ DATA_GNSS_SPEED, 10 },
+	{ DATA_GNSS_HEADING, 10 },
+};
+
+/* NMEA strings are added as a separate column of strings. */
+static const struct column gnss_nmea_columns[] = {
+	{ DATA_TIMESTAMP, 1 },
+};
+
+static const struct column sensor_columns[] = {
+	{ DATA_TIMESTAMP, 1 },
+	{ DATA_TEMPERATURE, 100 },
+	{ DATA_HUMIDITY, 100 },
+	{ DATA_PRESSURE, 100 },
+	{ DATA_BSEC_IAQ, 1 },
+};
+
+static const struct column accel_columns[] = {
+	{ DATA_TIMESTAMP, 1 },
+	{ DATA_MOVEMENT_X, 100 },
+	{ DATA_MOVEMENT_Y, 100 },
+	{ DATA_MOVEMENT_Z, 100 },
+};
+
+static const struct column value_columns[] = {
+	{ DATA_TIMESTAMP, 1 },
+	{ DATA_VALUE, 1 },
+};
+
+/* Returns the entry if it is queued and, for GNSS data, has the passed in format. */
+static void *columnar_entry_get(enum json_common_buffer_type type, void *buf, size_t index,
+				enum cloud_data_gnss_format gnss_format)
+{
+	switch (type) {
+	case JSON_COMMON_GNSS: {
+		struct cloud_data_gnss *data = (struct cloud_data_gnss *)buf + index;
+
+		return (data->queued && (data->format == gnss_format)) ? data : NULL;
+	}
+	case JSON_COMMON_SENSOR: {
+		struct cloud_data_sensors *data = (struct cloud_data_sensors *)buf + index;
+
+		return data->queued ? data : NULL;
+	}
+	case JSON_COMMON_ACCELEROMETER: {
+		struct cloud_data_accelerometer *data =
+				(struct cloud_data_accelerometer *)buf + index;
+
+		return data->queued ? data : NULL;
+	}
+	case JSON_COMMON_UI: {
+		struct cloud_data_ui *data = (struct cloud_data_ui *)buf + index;
+
+		return data->queued ? data : NULL;
+	}
+	case JSON_COMMON_BATTERY: {
+		struct cloud_data_battery *data = (struct cloud_data_battery *)buf + index;
+
+		return data->queued ? data : NULL;
+	}
+	default:
+		return NULL;
+	}
+}
+
+static void columnar_entry_unqueue(enum json_common_buffer_type type, void *entry)
+{
+	switch (type) {
+	case JSON_COMMON_GNSS:
+		((struct cloud_data_gnss *)entry)->queued = false;
+		break;
+	case JSON_COMMON_SENSOR:
+		((struct cloud_data_sensors *)entry)->queued = false;
+		break;
+	case JSON_COMMON_ACCELEROMETER:
+		((struct cloud_data_accelerometer *)entry)->queued = false;
+		break;
+	case JSON_COMMON_UI:
+		((struct cloud_data_ui *)entry)->queued = false;
+		break;
+	case JSON_COMMON_BATTERY:
+		((struct cloud_data_battery *)entry)->queued = false;
+		break;
+	default:
+		break;
+	}
+}
+
+static int64_t *columnar_entry_ts_get(enum json_common_buffer_type type, void *entry)
+{
+	switch (type) {
+	case JSON_COMMON_GNSS:
+		return &((struct cloud_data_gnss *)entry)->gnss_ts;
+	case JSON_COMMON_SENSOR:
+		return &((struct cloud_data_sensors *)entry)->env_ts;
+	case JSON_COMMON_ACCELEROMETER:
+		return &((struct cloud_data_accelerometer *)entry)->ts;
+	case JSON_COMMON_UI:
+		return &((struct cloud_data_ui *)entry)->btn_ts;
+	case JSON_COMMON_BATTERY:
+		return &((struct cloud_data_battery *)entry)->bat_ts;
+	default:
+		return NULL;
+	}
+}
+
+/* Returns the value of a column, the columns are in the order of the column tables. */
+static double columnar_value_get(enum json_common_buffer_type type, void *entry, size_t column)
+{
+	if (column == 0) {
+		return *columnar_entry_ts_get(type, entry);
+	}
+
+	switch (type) {
+	case JSON_COMMON_GNSS: {
+		struct cloud_data_gnss_pvt *pvt = &((struct cloud_data_gnss *)entry)->pvt;
+		const double values[] = { pvt->longi, pvt->lat, pvt->acc, pvt->alt, pvt->spd,
+					  pvt->hdg };
+
+		return values[column - 1];
+	}
+	case JSON_COMMON_SENSOR: {
+		struct cloud_data_sensors *data = entry;
+		const double values[] = { data->temperature, data->humidity, data->pressure,
+					  data->bsec_air_quality };
+
+		return values[column - 1];
+	}
+	case JSON_COMMON_ACCELEROMETER:
+		return ((struct cloud_data_accelerometer *)entry)->values[column - 1];
+	case JSON_COMMON_UI:
+		return ((struct cloud_data_ui *)entry)->btn;
+	case JSON_COMMON_BATTERY:
+		return ((struct cloud_data_battery *)entry)->bat;
+	default:
+		return 0;
+	}
+}
+
+int json_common_batch_columnar_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
+				   size_t buf_count, const char *object_label)
+{
+	int err;
+	const struct column *columns;
+	size_t column_count;
+	size_t entry_count = 0;
+	enum cloud_data_gnss_format gnss_format = CLOUD_CODEC_GNSS_FORMAT_INVALID;
+	cJSON *columns_obj;
+
+	if (parent == NULL || buf == NULL || object_label == NULL) {
+		return -EINVAL;
+	}
+
+	switch (type) {
+	case JSON_COMMON_GNSS: {
+		struct cloud_data_gnss *data = buf;
+
+		/* Only entries with the format of the first queued entry are encoded. Entries with
+		 * other formats are left queued.
+		 */
+		for (size_t i = 0; i < buf_count; i++) {
+			if (data[i].queued &&
+			    ((data[i].format == CLOUD_CODEC_GNSS_FORMAT_PVT) ||
+			     (data[i].format == CLOUD_CODEC_GNSS_FORMAT_NMEA))) {
+				gnss_format = data[i].format;
+				break;
+			}
+		}
+
+		if (gnss_format == CLOUD_CODEC_GNSS_FORMAT_NMEA) {
+			columns = gnss_nmea_columns;
+			column_count = ARRAY_SIZE(gnss_nmea_columns);
+		} else {
+			columns = gnss_pvt_columns;
+			column_count = ARRAY_SIZE(gnss_pvt_columns);
+		}
+		break;
+	}
+	case JSON_COMMON_SENSOR:
+		columns = sensor_columns;
+		column_count = ARRAY_SIZE(sensor_columns);
+		break;
+	case JSON_COMMON_ACCELEROMETER:
+		columns = accel_columns;
+		column_count = ARRAY_SIZE(accel_columns);
+		break;
+	case JSON_COMMON_UI:
+		/* Fall through */
+	case JSON_COMMON_BATTERY:
+		columns = value_columns;
+		column_count = ARRAY_SIZE(value_columns);
+		break;
+	default:
+		LOG_WRN("Buffer type %d not supported in columnar format", type);
+		return -ENOTSUP;
+	}
+
+	if ((type == JSON_COMMON_GNSS) && (gnss_format == CLOUD_CODEC_GNSS_FORMAT_INVALID)) {
+		return -ENODATA;
+	}
+
+	for (size_t i = 0; i < buf_count; i++) {
+		void *entry = columnar_entry_get(type, buf, i, gnss_format);
+
+		if (entry == NULL) {
+			continue;
+		}
+
+		err = json_common_timestamp_convert(columnar_entry_ts_get(type, entry));
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
+
+		entry_count++;
+	}
+
+	if (entry_count == 0) {
+		return -ENODATA;
+	}
+
+	columns_obj = cJSON_CreateObject();
+	if (columns_obj == NULL) {
+		return -ENOMEM;
+	}
+
+	for (size_t c = 0; c < column_count; c++) {
+		cJSON *array_obj = cJSON_CreateArray();
+		int64_t prev = 0;
+
+		if (array_obj == NULL) {
+			err = -ENOMEM;
+			goto exit;
+		}
+
+		json_add_obj(columns_obj, columns[c].label, array_obj);
+
+		for (size_t i = 0; i < buf_count; i++) {
+			void *entry = columnar_entry_get(type, buf, i, gnss_format);
+			double value;
+			int64_t scaled;
+
+			if (entry == NULL) {
+				continue;
+			}
+
+			value = columnar_value_get(type, entry, c) * columns[c].scale;
+			scaled = isfinite(value) ? llround(value) : 0;
+
+			err = json_add_number_to_array(array_obj, scaled - prev);
+			if (err) {
+				LOG_ERR("Encoding error: %d returned at %s:%d", err, __FILE__, __LINE__);
+				goto exit;
+			}
+
+			prev = scaled;
+		}
+	}
+
+	if (gnss_format == CLOUD_CODEC_GNSS_FORMAT_NMEA) {
+		cJSON *array_obj = cJSON_CreateArray();
+
+		if (array_obj == NULL) {
+			err = -ENOMEM;
+			goto exit;
+		}
+
+		json_add_obj(columns_obj, DATA_GNSS_NMEA, array_obj);
+
+		for (size_t i = 0; i < buf_count; i++) {
+			struct cloud_data_gnss *entry = columnar_entry_get(type, buf, i, gnss_format);
+			cJSON *nmea_obj;
+
+			if (entry == NULL) {
+				continue;
+			}
+
+			nmea_obj = cJSON_CreateString(entry->nmea);
+			if (nmea_obj == NULL) {
+				err = -ENOMEM;
+				goto exit;
+			}
+
+			json_add_obj_array(array_obj, nmea_obj);
+		}
+	}
+
+	json_add_obj(parent, object_label, columns_obj);
+
+	for (size_t i = 0; i < buf_count; i++) {
+		void *entry = columnar_entry_get(type, buf, i, gnss_format);
+
+		if (entry != NULL) {
+			columnar_entry_unqueue(type, entry);
+		}
+	}
+
+	return 0;
+
+exit:
+	cJSON_Delete(columns_obj);
+	return err;
+}
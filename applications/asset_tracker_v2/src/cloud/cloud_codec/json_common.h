@@ -27,6 +27,8 @@ extern "C" {
 
 #include "cloud_codec.h"
 #include "json_protocol_names.h"
+#include "json_reader.h"
+#include "json_writer.h"
 
 /** @brief Type of data to be handled by the respective API. Used to signify what data structure
  *         that is passed in to the function.
@@ -56,6 +58,18 @@ enum json_common_op_code {
 	JSON_COMMON_GET_POINTER_TO_OBJECT
 };
 
+/**
+ * @brief Convert a timestamp from uptime to UNIX time.
+ *
+ * Timestamps that are already in UNIX time, such as the timestamps of entries read from the
+ * data log, are not converted.
+ *
+ * @param[inout] ts Pointer to timestamp in milliseconds.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_common_timestamp_convert(int64_t *ts);
+
 /**
  * @brief Encode and add static modem data to the parent object.
  *
@@ -267,10 +281,67 @@ int json_common_config_add(cJSON *parent, struct cloud_data_cfg *data, const cha
  */
 void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data);
 
+/** @brief Size of a buffer that fits the encoded configuration and its enclosing objects. */
+#define JSON_COMMON_CONFIG_BUF_SIZE 256
+
+/**
+ * @brief Encode configuration data directly into a JSON writer, without building a cJSON tree.
+ *
+ * The output is identical to the output of json_common_config_add.
+ *
+ * @param[inout] writer Pointer to writer positioned in the object that the data is added to.
+ * @param[in] data Pointer to data that is to be encoded.
+ * @param[in] object_label Name of the encoded object.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_common_config_write(struct json_writer *writer, const struct cloud_data_cfg *data,
+			     const char *object_label);
+
+/**
+ * @brief Encode a configuration message, without building a cJSON tree.
+ *
+ * The configuration is encoded as a DATA_CONFIG object, nested in the given parent objects.
+ * The buffer is allocated with cJSON_malloc and is released in cloud_codec_release_data.
+ *
+ * @param[out] output Pointer to structure that is populated with the encoded message.
+ * @param[in] data Pointer to data that is to be encoded.
+ * @param[in] parents Names of the objects enclosing the configuration, outermost first.
+ *		      Can be NULL if parent_count is 0.
+ * @param[in] parent_count Number of entries in parents.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_common_config_encode(struct cloud_codec_data *output,
+			      const struct cloud_data_cfg *data,
+			      const char *const *parents, size_t parent_count);
+
+/**
+ * @brief Extract configuration values from a JSON document, without building a cJSON tree.
+ *
+ * The configuration object is looked up at the top level of the document, and in the passed in
+ * group object. Members that are not present in the configuration object are not changed.
+ *
+ * @param[in] input Pointer to JSON document, does not need to be null-terminated.
+ * @param[in] input_len Length of the JSON document.
+ * @param[in] group Name of the top level object that contains the configuration object.
+ *                  Can be NULL.
+ * @param[out] data Pointer to data structure that will be populated with the extracted
+ *                  configuration values.
+ *
+ * @return 0 on success. -ENOENT if the input is not a JSON object. -ENODATA if there is no
+ *         configuration object. Otherwise a negative error code is returned.
+ */
+int json_common_config_decode(const char *input, size_t input_len, const char *group,
+			      struct cloud_data_cfg *data);
+
 /**
  * @brief Encode all queued entries in the passed in buffer and add it to the parent object
  *        as an array.
  *
+ * If CONFIG_CLOUD_CODEC_BATCH_COLUMNAR is enabled, all data types except static and dynamic modem
+ * data are encoded with json_common_batch_columnar_add() instead.
+ *
  * @param[out] parent Pointer to object that the encoded data is added to.
  * @param[in] type Type of data passed in to the function.
  * @param[in] buf Pointer to data buffer that is to be encoded.
@@ -283,6 +354,31 @@ void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data);
 int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
 			       size_t buf_count, const char *object_label);
 
+/**
+ * @brief Encode all queued entries in the passed in buffer in columnar format and add them to
+ *        the parent object.
+ *
+ * The entries are added as an object with one array per field, where element n of each array
+ * belongs to the same entry. Numeric fields are scaled to integers and delta encoded: the first
+ * element holds the value and each following element the difference to the previous value.
+ * Timestamps are in milliseconds, GNSS longitude and latitude in 10^-6 degrees, GNSS accuracy,
+ * altitude, speed and heading in tenths, temperature, humidity, pressure and acceleration in
+ * hundredths. Other fields are not scaled. For GNSS data, only entries with the same format as
+ * the first queued entry are encoded. NMEA strings are added as an array of strings.
+ *
+ * @param[out] parent Pointer to object that the encoded data is added to.
+ * @param[in] type Type of data passed in to the function. Static and dynamic modem data are not
+ *                 supported.
+ * @param[in] buf Pointer to data buffer that is to be encoded.
+ * @param[in] buf_count Number of entries in passed in data buffer.
+ * @param[in] object_label Name of the object that is added to the parent object.
+ *
+ * @return 0 on success. -ENODATA if there are no queued entries. -ENOTSUP if the data type is
+ *         not supported. Otherwise a negative error code is returned.
+ */
+int json_common_batch_columnar_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
+				   size_t buf_count, const char *object_label);
+
 #ifdef __cplusplus
 }
 #endif
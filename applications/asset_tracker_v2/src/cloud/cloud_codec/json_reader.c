@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_reader.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(json_reader, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* Longest number that is accepted, in characters */
+#define NUMBER_MAX_LEN 32
+
+enum expect {
+	EXPECT_VALUE,
+	/* First member of an object, or its end */
+	EXPECT_KEY_OR_END,
+	/* Member of an object after a comma */
+	EXPECT_KEY,
+	/* First element of an array, or its end */
+	EXPECT_VALUE_OR_END,
+	EXPECT_COMMA_OR_END,
+	EXPECT_DONE,
+	/* Invalid input was found */
+	EXPECT_NOTHING,
+};
+
+static void skip_whitespace(struct json_reader *reader)
+{
+	while (reader->pos < reader->len) {
+		char c = reader->buf[reader->pos];
+
+		if ((c != ' ') && (c != '\t') && (c != '\n') && (c != '\r')) {
+			break;
+		}
+		reader->pos++;
+	}
+}
+
+static bool in_array(const struct json_reader *reader)
+{
+	return (reader->is_array & BIT(reader->depth)) != 0;
+}
+
+/* Set the expected token after a complete value. */
+static void value_end(struct json_reader *reader)
+{
+	reader->expect = (reader->depth == 0) ? EXPECT_DONE : EXPECT_COMMA_OR_END;
+}
+
+static int string_read(struct json_reader *reader, struct json_token *token)
+{
+	/* Skip the opening quote */
+	size_t pos = reader->pos + 1;
+
+	token->str = reader->buf + pos;
+
+	while (pos < reader->len) {
+		char c = reader->buf[pos];
+
+		if (c == '"') {
+			token->len = reader->buf + pos - token->str;
+			reader->pos = pos + 1;
+			return 0;
+		}
+
+		if ((unsigned char)c < 0x20) {
+			return -EBADMSG;
+		}
+
+		/* The escaped character is validated when the string is decoded */
+		pos += (c == '\\') ? 2 : 1;
+	}
+
+	return -EBADMSG;
+}
+
+static int literal_read(struct json_reader *reader, struct json_token *token,
+			const char *literal, enum json_token_type type)
+{
+	size_t len = strlen(literal);
+
+	if ((reader->len - reader->pos < len) ||
+	    strncmp(reader->buf + reader->pos, literal, len)) {
+		return -EBADMSG;
+	}
+
+	token->type = type;
+	token->str = reader->buf + reader->pos;
+	token->len = len;
+	reader->pos += len;
+
+	return 0;
+}
+
+static int number_read(struct json_reader *reader, struct json_token *token)
+{
+	size_t pos = reader->pos;
+	double value;
+
+	while ((pos < reader->len) && strchr("+-.eE0123456789", reader->buf[pos]) &&
+	       (reader->buf[pos] != '\0')) {
+		pos++;
+	}
+
+	token->type = JSON_TOKEN_NUMBER;
+	token->str = reader->buf + reader->pos;
+	token->len = pos - reader->pos;
+	reader->pos = pos;
+
+	return json_token_number_get(token, &value) ? -EBADMSG : 0;
+}
+
+static int container_start(struct json_reader *reader, struct json_token *token, bool array)
+{
+	if (reader->depth == JSON_READER_MAX_DEPTH) {
+		LOG_WRN("Maximum depth exceeded");
+		return -EBADMSG;
+	}
+
+	reader->depth++;
+	WRITE_BIT(reader->is_array, reader->depth, array);
+	reader->expect = array ? EXPECT_VALUE_OR_END : EXPECT_KEY_OR_END;
+
+	token->type = array ? JSON_TOKEN_ARRAY_START : JSON_TOKEN_OBJ_START;
+	token->str = reader->buf + reader->pos;
+	token->len = 1;
+	reader->pos++;
+
+	return 0;
+}
+
+static int container_end(struct json_reader *reader, struct json_token *token)
+{
+	char c = reader->buf[reader->pos];
+
+	if (c != (in_array(reader) ? ']' : '}')) {
+		return -EBADMSG;
+	}
+
+	token->type = in_array(reader) ? JSON_TOKEN_ARRAY_END : JSON_TOKEN_OBJ_END;
+	token->str = reader->buf + reader->pos;
+	token->len = 1;
+	reader->pos++;
+	reader->depth--;
+	value_end(reader);
+
+	return 0;
+}
+
+static int key_read(struct json_reader *reader, struct json_token *token)
+{
+	int err;
+
+	if (reader->buf[reader->pos] != '"') {
+		return -EBADMSG;
+	}
+
+	err = string_read(reader, token);
+	if (err) {
+		return err;
+	}
+
+	skip_whitespace(reader);
+
+	if ((reader->pos == reader->len) || (reader->buf[reader->pos] != ':')) {
+		return -EBADMSG;
+	}
+
+	reader->pos++;
+	token->type = JSON_TOKEN_KEY;
+	reader->expect = EXPECT_VALUE;
+
+	return 0;
+}
+
+static int value_read(struct json_reader *reader, struct json_token *token)
+{
+	int err;
+
+	switch (reader->buf[reader->pos]) {
+	case '{':
+		return container_start(reader, token, false);
+	case '[':
+		return container_start(reader, token, true);
+	case '"':
+		token->type = JSON_TOKEN_STRING;
+		err = string_read(reader, token);
+		break;
+	case 't':
+		err = literal_read(reader, token, "true", JSON_TOKEN_TRUE);
+		break;
+	case 'f':
+		err = literal_read(reader, token, "false", JSON_TOKEN_FALSE);
+		break;
+	case 'n':
+		err = literal_read(reader, token, "null", JSON_TOKEN_NULL);
+		break;
+	default:
+		err = number_read(reader, token);
+		break;
+	}
+
+	if (err == 0) {
+		value_end(reader);
+	}
+
+	return err;
+}
+
+static int token_read(struct json_reader *reader, struct json_token *token)
+{
+	if (reader->expect == EXPECT_NOTHING) {
+		return -EBADMSG;
+	}
+
+	skip_whitespace(reader);
+
+	if (reader->expect == EXPECT_DONE) {
+		return (reader->pos == reader->len) ? -ENODATA : -EBADMSG;
+	}
+
+	if (reader->pos == reader->len) {
+		return -EBADMSG;
+	}
+
+	if (reader->expect == EXPECT_COMMA_OR_END) {
+		if (reader->buf[reader->pos] != ',') {
+			return container_end(reader, token);
+		}
+
+		reader->pos++;
+		reader->expect = in_array(reader) ? EXPECT_VALUE : EXPECT_KEY;
+		skip_whitespace(reader);
+
+		if (reader->pos == reader->len) {
+			return -EBADMSG;
+		}
+	}
+
+	switch (reader->expect) {
+	case EXPECT_KEY_OR_END:
+		if (reader->buf[reader->pos] == '}') {
+			return container_end(reader, token);
+		}
+		return key_read(reader, token);
+	case EXPECT_KEY:
+		return key_read(reader, token);
+	case EXPECT_VALUE_OR_END:
+		if (reader->buf[reader->pos] == ']') {
+			return container_end(reader, token);
+		}
+		return value_read(reader, token);
+	case EXPECT_VALUE:
+		return value_read(reader, token);
+	default:
+		return -EBADMSG;
+	}
+}
+
+void json_reader_init(struct json_reader *reader, const char *buf, size_t len)
+{
+	__ASSERT_NO_MSG(reader != NULL);
+
+	*reader = (struct json_reader){
+		.buf = buf,
+		.len = (buf == NULL) ? 0 : len,
+		.expect = EXPECT_VALUE,
+	};
+}
+
+int json_reader_next(struct json_reader *reader, struct json_token *token)
+{
+	int err = token_read(reader, token);
+
+	if (err) {
+		token->type = JSON_TOKEN_INVALID;
+		token->str = NULL;
+		token->len = 0;
+
+		if (err == -EBADMSG) {
+			LOG_WRN("Invalid JSON at offset %d", (int)reader->pos);
+			/* Stop at the first error */
+			reader->expect = EXPECT_NOTHING;
+		}
+	}
+
+	return err;
+}
+
+int json_reader_skip(struct json_reader *reader, const struct json_token *token)
+{
+	struct json_token next;
+	uint8_t depth = reader->depth;
+	int err;
+
+	switch (token->type) {
+	case JSON_TOKEN_KEY:
+		err = json_reader_next(reader, &next);
+		if (err) {
+			return err;
+		}
+		return json_reader_skip(reader, &next);
+	case JSON_TOKEN_OBJ_START:
+	case JSON_TOKEN_ARRAY_START:
+		/* Read until the container is ended */
+		while (reader->depth >= depth) {
+			err = json_reader_next(reader, &next);
+			if (err) {
+				return err;
+			}
+		}
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+bool json_token_str_eq(const struct json_token *token, const char *str)
+{
+	if ((token->type != JSON_TOKEN_KEY) && (token->type != JSON_TOKEN_STRING)) {
+		return false;
+	}
+
+	return (strlen(str) == token->len) && !memcmp(token->str, str, token->len);
+}
+
+static int utf8_put(uint32_t code, char *buf, size_t size, size_t *len)
+{
+	size_t n = (code < 0x80) ? 1 : (code < 0x800) ? 2 : 3;
+
+	if (n >= size - *len) {
+		return -ENOMEM;
+	}
+
+	switch (n) {
+	case 1:
+		buf[(*len)++] = code;
+		break;
+	case 2:
+		buf[(*len)++] = 0xC0 | (code >> 6);
+		buf[(*len)++] = 0x80 | (code & 0x3F);
+		break;
+	default:
+		buf[(*len)++] = 0xE0 | (code >> 12);
+		buf[(*len)++] = 0x80 | ((code >> 6) & 0x3F);
+		buf[(*len)++] = 0x80 | (code & 0x3F);
+		break;
+	}
+
+	return 0;
+}
+
+int json_token_str_get(const struct json_token *token, char *buf, size_t size)
+{
+	size_t len = 0;
+
+	if ((token->type != JSON_TOKEN_KEY) && (token->type != JSON_TOKEN_STRING)) {
+		return -EINVAL;
+	}
+
+	if (size == 0) {
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < token->len; i++) {
+		uint32_t code;
+		char hex[5] = { 0 };
+		char *end;
+		int err;
+
+		if (token->str[i] != '\\') {
+			/* Copied as is, including UTF-8 sequences */
+			if (len + 1 >= size) {
+				return -ENOMEM;
+			}
+
+			buf[len++] = token->str[i];
+			continue;
+		}
+
+		i++;
+
+
+		switch (token->str[i]) {
+		case '"':
+		case '\\':
+		case '/':
+			code = token->str[i];
+			break;
+		case 'b':
+			code = '\b';
+			break;
+		case 'f':
+			code = '\f';
+			break;
+		case 'n':
+			code = '\n';
+			break;
+		case 'r':
+			code = '\r';
+			break;
+		case 't':
+			code = '\t';
+			break;
+		case 'u':
+			if (token->len - i <= 4) {
+				return -EINVAL;
+			}
+
+			memcpy(hex, &token->str[i + 1], 4);
+			code = strtoul(hex, &end, 16);
+
+			/* Surrogate pairs are not supported */
+			if ((end != &hex[4]) || (code == 0) ||
+			    ((code >= 0xD800) && (code <= 0xDFFF))) {
+				return -EINVAL;
+			}
+
+			i += 4;
+			break;
+		default:
+			return -EINVAL;
+		}
+
+		err = utf8_put(code, buf, size, &len);
+		if (err) {
+			return err;
+		}
+	}
+
+	buf[len] = '\0';
+
+	return 0;
+}
+
+int json_token_number_get(const struct json_token *token, double *value)
+{
+	char num[NUMBER_MAX_LEN + 1];
+	char *end;
+
+	if ((token->type != JSON_TOKEN_NUMBER) || (token->len == 0) ||
+	    (token->len > NUMBER_MAX_LEN)) {
+		return -EINVAL;
+	}
+
+	/* The token is not null-terminated */
+	memcpy(num, token->str, token->len);
+	num[token->len] = '\0';
+
+	*value = strtod(num, &end);
+
+	return (end == &num[token->len]) ? 0 : -EINVAL;
+}
+
+int json_token_int_get(const struct json_token *token, int *value)
+{
+	double number;
+	int err;
+
+	switch (token->type) {
+	case JSON_TOKEN_TRUE:
+		*value = 1;
+		return 0;
+	case JSON_TOKEN_FALSE:
+		*value = 0;
+		return 0;
+	default:
+		break;
+	}
+
+	err = json_token_number_get(token, &number);
+	if (err) {
+		return err;
+	}
+
+	if (number >= INT_MAX) {
+		*value = INT_MAX;
+	} else if (number <= (double)INT_MIN) {
+		*value = INT_MIN;
+	} else {
+		*value = (int)number;
+	}
+
+	return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief JSON reader header.
+ */
+
+#ifndef JSON_READER_H__
+#define JSON_READER_H__
+
+/**@file
+ *
+ * @defgroup JSON reader json_reader
+ * @brief    Pull-style JSON tokenizer.
+ *
+ * The reader returns the tokens of a JSON document one at a time, without building an object
+ * tree and without allocating memory. Tokens refer to the input, which must not be modified or
+ * released while the reader is used.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+/** @brief Maximum nesting depth of objects and arrays. */
+#define JSON_READER_MAX_DEPTH 31
+
+/** @brief Token types. */
+enum json_token_type {
+	JSON_TOKEN_INVALID,
+	JSON_TOKEN_OBJ_START,
+	JSON_TOKEN_OBJ_END,
+	JSON_TOKEN_ARRAY_START,
+	JSON_TOKEN_ARRAY_END,
+	/** Key of an object member. The value is the next token. */
+	JSON_TOKEN_KEY,
+	JSON_TOKEN_STRING,
+	JSON_TOKEN_NUMBER,
+	JSON_TOKEN_TRUE,
+	JSON_TOKEN_FALSE,
+	JSON_TOKEN_NULL,
+};
+
+/** @brief Token. */
+struct json_token {
+	/** Token type. */
+	enum json_token_type type;
+	/** Start of the token in the input. For keys and strings, the content without quotes. */
+	const char *str;
+	/** Length of the token. For keys and strings, the length of the escaped content. */
+	size_t len;
+};
+
+/** @brief JSON reader state. */
+struct json_reader {
+	/** Input. */
+	const char *buf;
+	/** Length of the input. */
+	size_t len;
+	/** Position of the next token. */
+	size_t pos;
+	/** Bit n is set if the container at depth n is an array. */
+	uint32_t is_array;
+	/** Current nesting depth. */
+	uint8_t depth;
+	/** Expected next token, internal. */
+	uint8_t expect;
+};
+
+/**
+ * @brief Initialize a reader.
+ *
+ * @param[out] reader Pointer to reader.
+ * @param[in] buf Input, does not need to be null-terminated.
+ * @param[in] len Length of the input.
+ */
+void json_reader_init(struct json_reader *reader, const char *buf, size_t len);
+
+/**
+ * @brief Read the next token.
+ *
+ * @param[inout] reader Pointer to reader.
+ * @param[out] token Pointer to token.
+ *
+ * @return 0 on success. -ENODATA at the end of the document. -EBADMSG if the input is not valid
+ *         JSON.
+ */
+int json_reader_next(struct json_reader *reader, struct json_token *token);
+
+/**
+ * @brief Skip the value of a token.
+ *
+ * If the token starts an object or array, the reader skips to the end of it. If the token is
+ * a key, the reader skips the value of the key. Otherwise nothing is done.
+ *
+ * @param[inout] reader Pointer to reader.
+ * @param[in] token Last token returned by the reader.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_reader_skip(struct json_reader *reader, const struct json_token *token);
+
+/**
+ * @brief Compare a key or string token with a string.
+ *
+ * Escape sequences in the token are not decoded.
+ *
+ * @param[in] token Pointer to token.
+ * @param[in] str Null-terminated string.
+ *
+ * @return true if the token is a key or string equal to @p str.
+ */
+bool json_token_str_eq(const struct json_token *token, const char *str);
+
+/**
+ * @brief Decode a key or string token.
+ *
+ * @param[in] token Pointer to token.
+ * @param[out] buf Buffer for the null-terminated string.
+ * @param[in] size Size of the buffer.
+ *
+ * @return 0 on success. -ENOMEM if the buffer is too small. -EINVAL if the token is not a key or
+ *         string, or contains an unsupported escape sequence.
+ */
+int json_token_str_get(const struct json_token *token, char *buf, size_t size);
+
+/**
+ * @brief Get the value of a number token.
+ *
+ * @param[in] token Pointer to token.
+ * @param[out] value Value.
+ *
+ * @return 0 on success. -EINVAL if the token is not a number.
+ */
+int json_token_number_get(const struct json_token *token, double *value);
+
+/**
+ * @brief Get the value of a number token as an integer, saturated like cJSON does.
+ *
+ * Booleans are returned as 1 and 0.
+ *
+ * @param[in] token Pointer to token.
+ * @param[out] value Value.
+ *
+ * @return 0 on success. -EINVAL if the token is not a number or boolean.
+ */
+int json_token_int_get(const struct json_token *token, int *value);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* JSON_READER_H__ */
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json_writer.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(json_writer, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+static void put(struct json_writer *writer, const char *str, size_t len)
+{
+	if (writer->err) {
+		return;
+	}
+
+	/* Leave room for the null terminator */
+	if (len >= writer->size - writer->len) {
+		writer->err = -ENOMEM;
+		return;
+	}
+
+	memcpy(writer->buf + writer->len, str, len);
+	writer->len += len;
+}
+
+static void put_char(struct json_writer *writer, char c)
+{
+	put(writer, &c, 1);
+}
+
+static bool needs_escape(char c)
+{
+	return (c == '"') || (c == '\\') || ((unsigned char)c < 0x20);
+}
+
+/* Escape the string the same way as cJSON does. */
+static void put_str(struct json_writer *writer, const char *str)
+{
+	put_char(writer, '"');
+
+	while (*str) {
+		const char *run = str;
+		char esc[7];
+
+		/* Copy characters that do not need escaping in one go */
+		while (*str && !needs_escape(*str)) {
+			str++;
+		}
+
+		put(writer, run, str - run);
+
+		if (*str == '\0') {
+			break;
+		}
+
+		switch (*str) {
+		case '"':
+		case '\\':
+			esc[0] = '\\';
+			esc[1] = *str;
+			put(writer, esc, 2);
+			break;
+		case '\b':
+			put(writer, "\\b", 2);
+			break;
+		case '\f':
+			put(writer, "\\f", 2);
+			break;
+		case '\n':
+			put(writer, "\\n", 2);
+			break;
+		case '\r':
+			put(writer, "\\r", 2);
+			break;
+		case '\t':
+			put(writer, "\\t", 2);
+			break;
+		default:
+			snprintf(esc, sizeof(esc), "\\u%04x", (unsigned char)*str);
+			put(writer, esc, 6);
+			break;
+		}
+
+		str++;
+	}
+
+	put_char(writer, '"');
+}
+
+/* Format the number the same way as cJSON does. */
+static void put_number(struct json_writer *writer, double item)
+{
+	char num[26];
+	int len;
+
+	if (isnan(item) || isinf(item)) {
+		len = snprintf(num, sizeof(num), "null");
+	} else if ((item >= INT32_MIN) && (item <= INT32_MAX) && (item == (int32_t)item)) {
+		len = snprintf(num, sizeof(num), "%d", (int32_t)item);
+	} else {
+		/* Use 15 digits if they are enough to represent the number exactly */
+		len = snprintf(num, sizeof(num), "%1.15g", item);
+		if (strtod(num, NULL) != item) {
+			len = snprintf(num, sizeof(num), "%1.17g", item);
+		}
+	}
+
+	put(writer, num, len);
+}
+
+/* Add the separator and the key before a value. */
+static void member_start(struct json_writer *writer, const char *key)
+{
+	if (writer->err) {
+		return;
+	}
+
+	if (writer->depth == 0) {
+		/* Only one value at the top level, without a key */
+		if (key || writer->len) {
+			writer->err = -EINVAL;
+		}
+		return;
+	}
+
+	/* Members of objects need a key, members of arrays must not have one */
+	if ((key == NULL) != ((writer->is_array & BIT(writer->depth)) != 0)) {
+		LOG_WRN("Key does not match container type");
+		writer->err = -EINVAL;
+		return;
+	}
+
+	if (writer->has_member & BIT(writer->depth)) {
+		put_char(writer, ',');
+	}
+
+	writer->has_member |= BIT(writer->depth);
+
+	if (key) {
+		put_str(writer, key);
+		put_char(writer, ':');
+	}
+}
+
+static int container_start(struct json_writer *writer, const char *key, bool array)
+{
+	member_start(writer, key);
+
+	if (writer->err) {
+		return writer->err;
+	}
+
+	if (writer->depth == JSON_WRITER_MAX_DEPTH) {
+		writer->err = -EINVAL;
+		return writer->err;
+	}
+
+	put_char(writer, array ? '[' : '{');
+
+	writer->depth++;
+	writer->has_member &= ~BIT(writer->depth);
+	WRITE_BIT(writer->is_array, writer->depth, array);
+
+	return writer->err;
+}
+
+static int container_end(struct json_writer *writer, bool array)
+{
+	if (writer->err) {
+		return writer->err;
+	}
+
+	if ((writer->depth == 0) ||
+	    (((writer->is_array & BIT(writer->depth)) != 0) != array)) {
+		LOG_WRN("End does not match container type");
+		writer->err = -EINVAL;
+		return writer->err;
+	}
+
+	put_char(writer, array ? ']' : '}');
+	writer->depth--;
+
+	return writer->err;
+}
+
+void json_writer_init(struct json_writer *writer, char *buf, size_t size)
+{
+	__ASSERT_NO_MSG(writer != NULL);
+
+	*writer = (struct json_writer){
+		.buf = buf,
+		.size = size,
+		.err = ((buf == NULL) || (size == 0)) ? -EINVAL : 0,
+	};
+}
+
+int json_writer_obj_start(struct json_writer *writer, const char *key)
+{
+	return container_start(writer, key, false);
+}
+
+int json_writer_obj_end(struct json_writer *writer)
+{
+	return container_end(writer, false);
+}
+
+int json_writer_array_start(struct json_writer *writer, const char *key)
+{
+	return container_start(writer, key, true);
+}
+
+int json_writer_array_end(struct json_writer *writer)
+{
+	return container_end(writer, true);
+}
+
+int json_writer_add_number(struct json_writer *writer, const char *key, double item)
+{
+	member_start(writer, key);
+	put_number(writer, item);
+
+	return writer->err;
+}
+
+int json_writer_add_bool(struct json_writer *writer, const char *key, bool item)
+{
+	member_start(writer, key);
+
+	if (item) {
+		put(writer, "true", 4);
+	} else {
+		put(writer, "false", 5);
+	}
+
+	return writer->err;
+}
+
+int json_writer_add_str(struct json_writer *writer, const char *key, const char *item)
+{
+	if (item == NULL) {
+		if (writer->err == 0) {
+			writer->err = -EINVAL;
+		}
+		return writer->err;
+	}
+
+	member_start(writer, key);
+	put_str(writer, item);
+
+	return writer->err;
+}
+
+int json_writer_add_null(struct json_writer *writer, const char *key)
+{
+	member_start(writer, key);
+	put(writer, "null", 4);
+
+	return writer->err;
+}
+
+int json_writer_finish(struct json_writer *writer, size_t *len)
+{
+	if (writer->err) {
+		return writer->err;
+	}
+
+	if (writer->depth != 0) {
+		LOG_WRN("%d containers not ended", writer->depth);
+		writer->err = -EINVAL;
+		return writer->err;
+	}
+
+	writer->buf[writer->len] = '\0';
+
+	if (len) {
+		*len = writer->len;
+	}
+
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief JSON writer header.
+ */
+
+#ifndef JSON_WRITER_H__
+#define JSON_WRITER_H__
+
+/**@file
+ *
+ * @defgroup JSON writer json_writer
+ * @brief    Forward-only JSON writer.
+ *
+ * The writer emits JSON directly into a buffer provided by the caller, without building an
+ * object tree and without allocating memory. The output is identical to the unformatted output
+ * of cJSON for the same sequence of calls.
+ *
+ * Errors are sticky. After an error, all subsequent calls do nothing and return the error, so
+ * a sequence of calls can be checked once, when the writer is finished.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+/** @brief Maximum nesting depth of objects and arrays. */
+#define JSON_WRITER_MAX_DEPTH 31
+
+/** @brief JSON writer state. */
+struct json_writer {
+	/** Output buffer. */
+	char *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Length of the output. */
+	size_t len;
+	/** Bit n is set if the container at depth n is an array. */
+	uint32_t is_array;
+	/** Bit n is set if the container at depth n has at least one member. */
+	uint32_t has_member;
+	/** Current nesting depth. */
+	uint8_t depth;
+	/** First error encountered. */
+	int err;
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param[out] writer Pointer to writer.
+ * @param[out] buf Output buffer.
+ * @param[in] size Size of the output buffer, including the null terminator.
+ */
+void json_writer_init(struct json_writer *writer, char *buf, size_t size);
+
+/**
+ * @brief Start an object.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the object if it is added to an object, NULL otherwise.
+ *
+ * @return 0 on success. -ENOMEM if the buffer is too small. -EINVAL if the key does not match
+ *         the enclosing container or the maximum depth is exceeded.
+ */
+int json_writer_obj_start(struct json_writer *writer, const char *key);
+
+/**
+ * @brief End the current object.
+ *
+ * @param[inout] writer Pointer to writer.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_obj_end(struct json_writer *writer);
+
+/**
+ * @brief Start an array.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the array if it is added to an object, NULL otherwise.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_array_start(struct json_writer *writer, const char *key);
+
+/**
+ * @brief End the current array.
+ *
+ * @param[inout] writer Pointer to writer.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_array_end(struct json_writer *writer);
+
+/**
+ * @brief Add a number.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the number if it is added to an object, NULL otherwise.
+ * @param[in] item Value. NaN and infinity are encoded as null.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_add_number(struct json_writer *writer, const char *key, double item);
+
+/**
+ * @brief Add a boolean.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the boolean if it is added to an object, NULL otherwise.
+ * @param[in] item Value.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_add_bool(struct json_writer *writer, const char *key, bool item);
+
+/**
+ * @brief Add a string. The string is escaped.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the string if it is added to an object, NULL otherwise.
+ * @param[in] item Null-terminated string.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_add_str(struct json_writer *writer, const char *key, const char *item);
+
+/**
+ * @brief Add null.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[in] key Name of the null if it is added to an object, NULL otherwise.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int json_writer_add_null(struct json_writer *writer, const char *key);
+
+/**
+ * @brief Finish the output and null-terminate it.
+ *
+ * @param[inout] writer Pointer to writer.
+ * @param[out] len Length of the output, without the null terminator. Can be NULL.
+ *
+ * @return 0 on success. -EINVAL if an object or array is not ended. Otherwise the first error
+ *         encountered while writing is returned.
+ */
+int json_writer_finish(struct json_writer *writer, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* JSON_WRITER_H__ */
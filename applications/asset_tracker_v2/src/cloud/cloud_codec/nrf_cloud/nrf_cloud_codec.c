@@ -79,7 +79,7 @@ static int add_meta_data(cJSON *parent, const char *app_id, int64_t *timestamp,
 
 	if (timestamp != NULL) {
 		if (convert_time) {
-			err = date_time_uptime_to_unix_time_ms(timestamp);
+			err = json_common_timestamp_convert(timestamp);
 			if (err) {
 				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 				return err;
@@ -175,7 +175,7 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 				break;
 			}
 
-			err = date_time_uptime_to_unix_time_ms(&data[i].env_ts);
+			err = json_common_timestamp_convert(&data[i].env_ts);
 			if (err) {
 				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
 				return -EOVERFLOW;
@@ -509,47 +509,9 @@ exit:
 int cloud_codec_encode_config(struct cloud_codec_data *output,
 			      struct cloud_data_cfg *data)
 {
-	int err;
-	char *buffer;
-
-	cJSON *root_obj = cJSON_CreateObject();
-	cJSON *state_obj = cJSON_CreateObject();
-	cJSON *rep_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL || state_obj == NULL || rep_obj == NULL) {
-		cJSON_Delete(root_obj);
-		cJSON_Delete(state_obj);
-		cJSON_Delete(rep_obj);
-		return -ENOMEM;
-	}
-
-	err = json_common_config_add(rep_obj, data, DATA_CONFIG);
-
-	json_add_obj(state_obj, OBJECT_REPORTED, rep_obj);
-	json_add_obj(root_obj, OBJECT_STATE, state_obj);
-
-	if (err) {
-		goto exit;
-	}
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (buffer == NULL) {
-		LOG_ERR("Failed to allocate memory for JSON string");
-
-		err = -ENOMEM;
-		goto exit;
-	}
+	static const char *const parents[] = { OBJECT_STATE, OBJECT_REPORTED };
 
-	if (IS_ENABLED(CONFIG_CLOUD_CODEC_LOG_LEVEL_DBG)) {
-		json_print_obj("Encoded message:\n", root_obj);
-	}
-
-	output->buf = buffer;
-	output->len = strlen(buffer);
-
-exit:
-	cJSON_Delete(root_obj);
-	return err;
+	return json_common_config_encode(output, data, parents, ARRAY_SIZE(parents));
 }
 
 int cloud_codec_encode_data(struct cloud_codec_data *output,
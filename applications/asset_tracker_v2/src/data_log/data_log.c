@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <stddef.h>
+#include <string.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+#include <fs/fcb.h>
+
+#include "data_log.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(data_log, CONFIG_DATA_LOG_LOG_LEVEL);
+
+#if !FLASH_AREA_LABEL_EXISTS(data_log)
+#error "No data_log partition, build with overlay-data-log.conf"
+#endif
+
+#define DATA_LOG_SETTINGS_KEY		"data_log"
+#define DATA_LOG_SETTINGS_CURSOR_KEY	"cursor"
+
+#define DATA_LOG_FCB_MAGIC		0x64617461
+#define DATA_LOG_FCB_VERSION		1
+
+/* Maximum number of flash pages in the partition. */
+#define DATA_LOG_SECTOR_COUNT_MAX	64
+
+/* Read cursor as it is stored in settings. */
+struct cursor_stored {
+	/* Offset of the flash page in the partition. */
+	uint32_t sector_off;
+	/* Offset of the last entry read in the flash page. */
+	uint32_t elem_off;
+	/* Set if entries have been read since the log was created. */
+	bool valid;
+};
+
+/* Entry as it is written to flash. Only the data structure of the type is written. */
+struct entry {
+	uint32_t type;
+	union {
+		struct cloud_data_gnss gnss;
+		struct cloud_data_sensors sensors;
+		struct cloud_data_modem_dynamic modem_dyn;
+		struct cloud_data_ui ui;
+		struct cloud_data_accelerometer accel;
+		struct cloud_data_battery bat;
+	} data;
+};
+
+#define ENTRY_HDR_SIZE offsetof(struct entry, data)
+
+static struct flash_sector sectors[DATA_LOG_SECTOR_COUNT_MAX];
+static struct fcb fcb;
+
+/* Last entry read and committed. If fe_sector is NULL, no entry in the log has been read. */
+static struct fcb_entry cursor;
+static struct cursor_stored cursor_stored;
+
+/* Incremented when the log is full and entries are erased before they have been read. */
+static uint32_t overflow_count;
+
+static const size_t type_size[DATA_LOG_TYPE_COUNT] = {
+	[DATA_LOG_TYPE_GNSS] = sizeof(struct cloud_data_gnss),
+	[DATA_LOG_TYPE_SENSORS] = sizeof(struct cloud_data_sensors),
+	[DATA_LOG_TYPE_MODEM_DYNAMIC] = sizeof(struct cloud_data_modem_dynamic),
+	[DATA_LOG_TYPE_UI] = sizeof(struct cloud_data_ui),
+	[DATA_LOG_TYPE_ACCELEROMETER] = sizeof(struct cloud_data_accelerometer),
+	[DATA_LOG_TYPE_BATTERY] = sizeof(struct cloud_data_battery),
+};
+
+static int cursor_settings_handler(const char *key, size_t len,
+				   settings_read_cb read_cb, void *cb_arg)
+{
+	int err;
+
+	if (strcmp(key, DATA_LOG_SETTINGS_CURSOR_KEY) == 0) {
+		if (len != sizeof(cursor_stored)) {
+			LOG_WRN("Stored read cursor has unexpected size, ignored");
+			return 0;
+		}
+
+		err = read_cb(cb_arg, &cursor_stored, sizeof(cursor_stored));
+		if (err < 0) {
+			LOG_ERR("Failed to load read cursor, error: %d", err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(data_log, DATA_LOG_SETTINGS_KEY, NULL,
+			       cursor_settings_handler, NULL, NULL);
+
+static int cursor_save(void)
+{
+	int err;
+
+	cursor_stored = (struct cursor_stored){
+		.valid = (cursor.fe_sector != NULL),
+	};
+
+	if (cursor_stored.valid) {
+		cursor_stored.sector_off = cursor.fe_sector->fs_off;
+		cursor_stored.elem_off = cursor.fe_elem_off;
+	}
+
+	err = settings_save_one(DATA_LOG_SETTINGS_KEY "/" DATA_LOG_SETTINGS_CURSOR_KEY,
+				&cursor_stored, sizeof(cursor_stored));
+	if (err) {
+		LOG_WRN("settings_save_one, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Returns true if the flash page is between the oldest and the active page. */
+static bool sector_is_used(const struct flash_sector *sector)
+{
+	const struct flash_sector *oldest = fcb.f_oldest;
+	const struct flash_sector *active = fcb.f_active.fe_sector;
+
+	if (oldest <= active) {
+		return (sector >= oldest) && (sector <= active);
+	}
+
+	return (sector >= oldest) || (sector <= active);
+}
+
+/* Restore the read cursor from settings. If the stored entry is not found, all entries in the
+ * log are read again, so that entries are sent more than once rather than not at all.
+ */
+static void cursor_restore(void)
+{
+	struct fcb_entry loc = { 0 };
+
+	cursor = (struct fcb_entry){ 0 };
+
+	if (!cursor_stored.valid) {
+		return;
+	}
+
+	for (size_t i = 0; i < fcb.f_sector_cnt; i++) {
+		if (sectors[i].fs_off == cursor_stored.sector_off) {
+			loc.fe_sector = &sectors[i];
+			break;
+		}
+	}
+
+	if ((loc.fe_sector == NULL) || !sector_is_used(loc.fe_sector)) {
+		LOG_WRN("Stored read cursor not valid, reading log from the start");
+		return;
+	}
+
+	/* Serve entries from the start of the flash page until the stored entry is found */
+	while (fcb_getnext(&fcb, &loc) == 0) {
+		if ((loc.fe_sector->fs_off != cursor_stored.sector_off) ||
+		    (loc.fe_elem_off > cursor_stored.elem_off)) {
+			break;
+		}
+
+		if (loc.fe_elem_off == cursor_stored.elem_off) {
+			cursor = loc;
+			return;
+		}
+	}
+
+	LOG_WRN("Stored read cursor not found, reading log from the start");
+}
+
+/* Erase the oldest flash page to make room for new entries. */
+static int overflow_handle(void)
+{
+	int err;
+
+	LOG_WRN("Data log full, erasing oldest entries");
+
+	if (cursor.fe_sector == fcb.f_oldest) {
+		/* Entries that have not been read are erased, continue at the new oldest page */
+		cursor = (struct fcb_entry){ 0 };
+
+		err = cursor_save();
+		if (err) {
+			return err;
+		}
+	}
+
+	overflow_count++;
+
+	err = fcb_rotate(&fcb);
+	if (err) {
+		LOG_ERR("fcb_rotate, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+static void *chunk_entry_get(struct data_log_chunk *chunk, enum data_log_type type,
+			     size_t index)
+{
+	switch (type) {
+	case DATA_LOG_TYPE_GNSS:
+		return &chunk->gnss[index];
+	case DATA_LOG_TYPE_SENSORS:
+		return &chunk->sensors[index];
+	case DATA_LOG_TYPE_MODEM_DYNAMIC:
+		return &chunk->modem_dyn[index];
+	case DATA_LOG_TYPE_UI:
+		return &chunk->ui[index];
+	case DATA_LOG_TYPE_ACCELEROMETER:
+		return &chunk->accel[index];
+	case DATA_LOG_TYPE_BATTERY:
+		return &chunk->bat[index];
+	default:
+		return NULL;
+	}
+}
+
+int data_log_init(void)
+{
+	int err;
+	bool cleared = false;
+	uint32_t sector_cnt = ARRAY_SIZE(sectors);
+
+	err = flash_area_get_sectors(FLASH_AREA_ID(data_log), &sector_cnt, sectors);
+	if (err) {
+		LOG_ERR("flash_area_get_sectors, error: %d", err);
+		return err;
+	}
+
+	fcb.f_magic = DATA_LOG_FCB_MAGIC;
+	fcb.f_version = DATA_LOG_FCB_VERSION;
+	fcb.f_sectors = sectors;
+	fcb.f_sector_cnt = sector_cnt;
+	fcb.f_scratch_cnt = 0;
+
+	err = fcb_init(FLASH_AREA_ID(data_log), &fcb);
+	if (err) {
+		/* Written with an incompatible format, start over */
+		LOG_WRN("fcb_init, error: %d, clearing data log", err);
+
+		err = fcb_clear(&fcb);
+		if (err) {
+			LOG_ERR("fcb_clear, error: %d", err);
+			return err;
+		}
+
+		cleared = true;
+	}
+
+	cursor_stored = (struct cursor_stored){ 0 };
+	overflow_count = 0;
+
+	err = settings_load_subtree(DATA_LOG_SETTINGS_KEY);
+	if (err) {
+		LOG_ERR("settings_load_subtree, error: %d", err);
+		return err;
+	}
+
+	if (cleared) {
+		cursor_stored.valid = false;
+	}
+
+	cursor_restore();
+
+	return 0;
+}
+
+int data_log_append(enum data_log_type type, const void *data)
+{
+	int err;
+	struct fcb_entry loc;
+	static struct entry entry;
+	size_t len;
+
+	if ((type >= DATA_LOG_TYPE_COUNT) || (data == NULL)) {
+		return -EINVAL;
+	}
+
+	len = ENTRY_HDR_SIZE + type_size[type];
+
+	err = fcb_append(&fcb, len, &loc);
+	if (err == -ENOSPC) {
+		err = overflow_handle();
+		if (err) {
+			return err;
+		}
+
+		err = fcb_append(&fcb, len, &loc);
+	}
+
+	if (err) {
+		LOG_ERR("fcb_append, error: %d", err);
+		return err;
+	}
+
+	/* Flash writes must be a multiple of the write block size, the padding is zeroed */
+	memset(&entry, 0, sizeof(entry));
+	entry.type = type;
+	memcpy(&entry.data, data, type_size[type]);
+
+	err = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), &entry,
+			       MIN(ROUND_UP(len, fcb.f_align), sizeof(entry)));
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	/* The entry is only valid once the CRC has been written */
+	err = fcb_append_finish(&fcb, &loc);
+	if (err) {
+		LOG_ERR("fcb_append_finish, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+int data_log_chunk_read(struct data_log_chunk *chunk)
+{
+	int err;
+	size_t count[DATA_LOG_TYPE_COUNT] = { 0 };
+	struct fcb_entry loc = cursor;
+
+	memset(chunk, 0, sizeof(*chunk));
+	chunk->end = cursor;
+	chunk->overflow_count = overflow_count;
+
+	while (fcb_getnext(&fcb, &loc) == 0) {
+		uint32_t type;
+		void *entry;
+
+		err = flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), &type, sizeof(type));
+		if (err) {
+			LOG_ERR("flash_area_read, error: %d", err);
+			return err;
+		}
+
+		if ((type >= DATA_LOG_TYPE_COUNT) ||
+		    (loc.fe_data_len != ENTRY_HDR_SIZE + type_size[type])) {
+			/* Written by a firmware with a different data layout */
+			LOG_WRN("Unknown entry skipped");
+			chunk->end = loc;
+			continue;
+		}
+
+		if (count[type] == CONFIG_DATA_LOG_CHUNK_ENTRIES) {
+			break;
+		}
+
+		entry = chunk_entry_get(chunk, type, count[type]);
+
+		err = flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc) + ENTRY_HDR_SIZE, entry,
+				      type_size[type]);
+		if (err) {
+			LOG_ERR("flash_area_read, error: %d", err);
+			return err;
+		}
+
+		count[type]++;
+		chunk->count++;
+		chunk->end = loc;
+	}
+
+	if (chunk->count == 0) {
+		return -ENODATA;
+	}
+
+	LOG_DBG("%d entries read from data log", (int)chunk->count);
+
+	return 0;
+}
+
+int data_log_chunk_commit(const struct data_log_chunk *chunk)
+{
+	int err;
+
+	if (chunk->overflow_count != overflow_count) {
+		/* The flash page of the chunk might have been erased and reused, the entries after
+		 * the read cursor are read again.
+		 */
+		LOG_WRN("Data log overflowed while the chunk was sent");
+		return -ECANCELED;
+	}
+
+	cursor = chunk->end;
+
+	err = cursor_save();
+	if (err) {
+		return err;
+	}
+
+	/* Erase flash pages where all entries have been read */
+	while ((cursor.fe_sector != NULL) && (fcb.f_oldest != cursor.fe_sector)) {
+		err = fcb_rotate(&fcb);
+		if (err) {
+			LOG_ERR("fcb_rotate, error: %d", err);
+			return err;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief Data log header.
+ */
+
+#ifndef DATA_LOG_H__
+#define DATA_LOG_H__
+
+/**@file
+ *
+ * @defgroup data_log Data log
+ * @brief    Flash-backed store-and-forward log of sampled data.
+ *
+ * Entries are appended to a flash circular buffer (FCB) in the data_log partition. They are
+ * read back in chunks, starting at a read cursor. The cursor is only moved past a chunk when the
+ * chunk is committed, and it is stored in settings so that entries that have not been committed
+ * are read again after a reboot.
+ *
+ * The functions are not thread safe and must be called from the same thread.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+#include <fs/fcb.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+
+/** @brief Types of data stored in the log. */
+enum data_log_type {
+	DATA_LOG_TYPE_GNSS,
+	DATA_LOG_TYPE_SENSORS,
+	DATA_LOG_TYPE_MODEM_DYNAMIC,
+	DATA_LOG_TYPE_UI,
+	DATA_LOG_TYPE_ACCELEROMETER,
+	DATA_LOG_TYPE_BATTERY,
+	DATA_LOG_TYPE_COUNT
+};
+
+/** @brief Entries read from the log. Unused entries are zeroed and thus not queued. */
+struct data_log_chunk {
+	struct cloud_data_gnss gnss[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	struct cloud_data_sensors sensors[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	struct cloud_data_modem_dynamic modem_dyn[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	struct cloud_data_ui ui[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	struct cloud_data_accelerometer accel[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	struct cloud_data_battery bat[CONFIG_DATA_LOG_CHUNK_ENTRIES];
+	/** Number of entries read. */
+	size_t count;
+	/** Last entry read, internal. */
+	struct fcb_entry end;
+	/** Overflow count of the log when the chunk was read, internal. */
+	uint32_t overflow_count;
+};
+
+/**
+ * @brief Initialize the log and restore the read cursor.
+ *
+ * The settings subsystem must be initialized before this function is called.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int data_log_init(void);
+
+/**
+ * @brief Append an entry to the log.
+ *
+ * If the log is full, the flash page with the oldest entries is erased, including entries that
+ * have not been read.
+ *
+ * Timestamps of entries must be in UNIX time, since uptime is reset by a reboot.
+ *
+ * @param[in] type Type of the entry.
+ * @param[in] data Pointer to the entry, a cloud_data structure that matches @p type.
+ *
+ * @return 0 on success. Otherwise a negative error code is returned.
+ */
+int data_log_append(enum data_log_type type, const void *data);
+
+/**
+ * @brief Read the entries after the read cursor.
+ *
+ * Entries are read until the chunk holds CONFIG_DATA_LOG_CHUNK_ENTRIES entries of one type.
+ * The read cursor is not moved.
+ *
+ * @param[out] chunk Pointer to chunk.
+ *
+ * @return 0 on success. -ENODATA if there are no entries after the read cursor. Otherwise a
+ *         negative error code is returned.
+ */
+int data_log_chunk_read(struct data_log_chunk *chunk);
+
+/**
+ * @brief Move the read cursor past a chunk and store it.
+ *
+ * Flash pages that only hold entries before the read cursor are erased.
+ *
+ * @param[in] chunk Pointer to chunk returned by data_log_chunk_read().
+ *
+ * @return 0 on success. -ECANCELED if entries have been erased to make room for new entries
+ *         since the chunk was read. The read cursor is not moved and the entries after it are
+ *         read again. Otherwise a negative error code is returned.
+ */
+int data_log_chunk_commit(const struct data_log_chunk *chunk);
+
+#ifdef __cplusplus
+}
+#endif
+/**
+ * @}
+ */
+#endif /* DATA_LOG_H__ */
@@ -87,6 +87,10 @@ struct cloud_module_data_ack {
 	void *ptr;
 	/** Length of data that was attempted to be sent. */
 	size_t len;
+	/** The data was dropped without being sent, because the list of pending messages
+	 *  was full.
+	 */
+	bool dropped;
 };
 
 /** @brief Cloud module event. */
@@ -449,7 +449,7 @@ static void cloud_wrap_event_handler(const struct cloud_wrap_event *const evt)
 }
 
 /* Static module functions. */
-static void send_data_ack(void *ptr, size_t len)
+static void send_data_ack(void *ptr, size_t len, bool dropped)
 {
 	if (len < 0) {
 		LOG_WRN("Data to be ACKen has zero length");
@@ -462,6 +462,7 @@ static void send_data_ack(void *ptr, size_t len)
 	cloud_module_event->type = CLOUD_EVT_DATA_ACK;
 	cloud_module_event->data.ack.ptr = ptr;
 	cloud_module_event->data.ack.len = len;
+	cloud_module_event->data.ack.dropped = dropped;
 
 	APP_EVENT_SUBMIT(cloud_module_event);
 }
@@ -646,8 +647,16 @@ static void qos_event_handler(const struct qos_evt *evt)
 		LOG_DBG("QOS_EVT_MESSAGE_REMOVED_FROM_LIST");
 
 		if (evt->message.heap_allocated) {
+			/* Messages that require ACK have been notified at least once, unless
+			 * they could not be added to the list of pending messages.
+			 */
+			bool dropped = qos_message_has_flag(&evt->message,
+							    QOS_FLAG_RELIABILITY_ACK_REQUIRED) &&
+				       (evt->message.notified_count == 0);
+
 			send_data_ack(evt->message.data.buf,
-				      evt->message.data.len);
+				      evt->message.data.len,
+				      dropped);
 		}
 		break;
 	default:
@@ -19,6 +19,10 @@
 
 #include "cloud/cloud_codec/cloud_codec.h"
 
+#if defined(CONFIG_DATA_LOG)
+#include "data_log/data_log.h"
+#endif
+
 #define MODULE data_module
 
 #include "modules_common.h"
@@ -107,6 +111,14 @@ static struct cloud_data_cfg current_cfg = {
 
 static struct k_work_delayable data_send_work;
 
+#if defined(CONFIG_DATA_LOG)
+/* Chunk of entries read from the data log, and the encoded chunk that is being sent.
+ * Only one chunk is sent at a time.
+ */
+static struct data_log_chunk log_chunk;
+static void *log_chunk_buf;
+#endif
+
 /* List used to keep track of responses from other modules with data that is
  * requested to be sampled/published.
  */
@@ -336,6 +348,14 @@ static int setup(void)
 		return err;
 	}
 
+#if defined(CONFIG_DATA_LOG)
+	err = data_log_init();
+	if (err) {
+		LOG_ERR("data_log_init, error: %d", err);
+		return err;
+	}
+#endif
+
 	date_time_register_handler(date_time_event_handler);
 
 	return 0;
@@ -485,6 +505,238 @@ static void data_encode(void)
 	}
 }
 
+#if defined(CONFIG_DATA_LOG)
+/* Append a copy of a queued ringbuffer entry to the data log. The timestamp of the copy is
+ * converted to UNIX time first, since uptime is reset by a reboot.
+ */
+static int log_entry_store(enum data_log_type type, const void *entry, int64_t *ts)
+{
+	int err;
+
+	err = date_time_uptime_to_unix_time_ms(ts);
+	if (err) {
+		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		return err;
+	}
+
+	err = data_log_append(type, entry);
+	if (err) {
+		LOG_ERR("data_log_append, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Move queued entries from the ringbuffers to the data log. This frees the ringbuffers for
+ * new data while the device is disconnected, and keeps the data across reboots.
+ */
+static void log_store(void)
+{
+	int err;
+
+	if (!date_time_is_valid()) {
+		/* Entries are kept in the ringbuffers until they can be timestamped */
+		return;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(gnss_buf); i++) {
+		struct cloud_data_gnss entry = gnss_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_GNSS, &entry, &entry.gnss_ts);
+		if (err) {
+			return;
+		}
+
+		gnss_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(sensors_buf); i++) {
+		struct cloud_data_sensors entry = sensors_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_SENSORS, &entry, &entry.env_ts);
+		if (err) {
+			return;
+		}
+
+		sensors_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(modem_dyn_buf); i++) {
+		struct cloud_data_modem_dynamic entry = modem_dyn_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_MODEM_DYNAMIC, &entry, &entry.ts);
+		if (err) {
+			return;
+		}
+
+		modem_dyn_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ui_buf); i++) {
+		struct cloud_data_ui entry = ui_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_UI, &entry, &entry.btn_ts);
+		if (err) {
+			return;
+		}
+
+		ui_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(accel_buf); i++) {
+		struct cloud_data_accelerometer entry = accel_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_ACCELEROMETER, &entry, &entry.ts);
+		if (err) {
+			return;
+		}
+
+		accel_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(bat_buf); i++) {
+		struct cloud_data_battery entry = bat_buf[i];
+
+		if (!entry.queued) {
+			continue;
+		}
+
+		err = log_entry_store(DATA_LOG_TYPE_BATTERY, &entry, &entry.bat_ts);
+		if (err) {
+			return;
+		}
+
+		bat_buf[i].queued = false;
+	}
+}
+
+/* Read the next chunk of entries from the data log and send it as batch data. The read cursor
+ * of the log is moved past the chunk when the cloud module has released the message.
+ */
+static void log_send(void)
+{
+	int err;
+	struct cloud_codec_data codec = {0};
+	/* Static modem data is not stored in the log */
+	struct cloud_data_modem_static modem_stat_none = {0};
+
+	if (log_chunk_buf != NULL) {
+		/* Wait for the chunk being sent */
+		return;
+	}
+
+	while (true) {
+		err = data_log_chunk_read(&log_chunk);
+		if (err == -ENODATA) {
+			return;
+		} else if (err) {
+			LOG_ERR("data_log_chunk_read, error: %d", err);
+			SEND_ERROR(data, DATA_EVT_ERROR, err);
+			return;
+		}
+
+		err = cloud_codec_encode_batch_data(&codec,
+						    log_chunk.gnss,
+						    log_chunk.sensors,
+						    &modem_stat_none,
+						    log_chunk.modem_dyn,
+						    log_chunk.ui,
+						    log_chunk.accel,
+						    log_chunk.bat,
+						    ARRAY_SIZE(log_chunk.gnss),
+						    ARRAY_SIZE(log_chunk.sensors),
+						    MODEM_STATIC_ARRAY_SIZE,
+						    ARRAY_SIZE(log_chunk.modem_dyn),
+						    ARRAY_SIZE(log_chunk.ui),
+						    ARRAY_SIZE(log_chunk.accel),
+						    ARRAY_SIZE(log_chunk.bat));
+		if (err != -ENODATA) {
+			break;
+		}
+
+		/* None of the entries could be encoded, they are not read again */
+		err = data_log_chunk_commit(&log_chunk);
+		if (err) {
+			LOG_ERR("data_log_chunk_commit, error: %d", err);
+			return;
+		}
+	}
+
+	if (err) {
+		LOG_ERR("Error batch-enconding data log chunk: %d", err);
+		SEND_ERROR(data, DATA_EVT_ERROR, err);
+		return;
+	}
+
+	LOG_DBG("Data log chunk encoded successfully");
+
+	log_chunk_buf = codec.buf;
+	data_send(DATA_EVT_DATA_SEND_BATCH, &codec);
+}
+
+/* Forget the chunk that is being sent. The cloud module drops messages that it receives while
+ * it is disconnected, so the chunk might never be released. The read cursor of the log has not
+ * been moved, and the entries of the chunk are read again by the next call to log_send().
+ */
+static void log_chunk_discard(void)
+{
+	if (log_chunk_buf != NULL) {
+		LOG_DBG("Data log chunk not released, it is sent again");
+		log_chunk_buf = NULL;
+	}
+}
+
+/* The message is released by the cloud module when it has been acknowledged, or when it has
+ * been given up after the maximum number of retransmissions.
+ */
+static void log_ack_handle(const struct cloud_module_data_ack *ack)
+{
+	int err;
+
+	if ((log_chunk_buf != NULL) && (ack->ptr == log_chunk_buf)) {
+		log_chunk_buf = NULL;
+
+		if (ack->dropped) {
+			/* Not sent, the chunk is read again when another message is released and
+			 * there is room for it.
+			 */
+			LOG_WRN("Data log chunk dropped by the cloud module");
+			return;
+		}
+
+		err = data_log_chunk_commit(&log_chunk);
+		if (err) {
+			LOG_WRN("data_log_chunk_commit, error: %d", err);
+		}
+	}
+
+	if (state == STATE_CLOUD_CONNECTED) {
+		log_send();
+	}
+}
+#endif /* CONFIG_DATA_LOG */
+
 #if defined(CONFIG_NRF_CLOUD_AGPS) && !defined(CONFIG_NRF_CLOUD_MQTT)
 static int get_modem_info(struct modem_param_info *const modem_info)
 {
@@ -901,9 +1153,21 @@ static void on_cloud_state_disconnected(struct data_msg_data *msg)
 		}
 
 		state_set(STATE_CLOUD_CONNECTED);
+
+#if defined(CONFIG_DATA_LOG)
+		log_chunk_discard();
+		log_send();
+#endif
 		return;
 	}
 
+#if defined(CONFIG_DATA_LOG)
+	if (IS_EVENT(msg, data, DATA_EVT_DATA_READY)) {
+		log_store();
+		return;
+	}
+#endif
+
 	if (IS_EVENT(msg, cloud, CLOUD_EVT_CONFIG_EMPTY) &&
 	    IS_ENABLED(CONFIG_NRF_CLOUD_MQTT)) {
 		config_send();
@@ -930,6 +1194,9 @@ static void on_cloud_state_connected(struct data_msg_data *msg)
 
 	if (IS_EVENT(msg, cloud, CLOUD_EVT_DISCONNECTED)) {
 		state_set(STATE_CLOUD_DISCONNECTED);
+#if defined(CONFIG_DATA_LOG)
+		log_chunk_discard();
+#endif
 		return;
 	}
 
@@ -1218,6 +1485,9 @@ static void on_all_states(struct data_msg_data *msg)
 	}
 
 	if (IS_EVENT(msg, cloud, CLOUD_EVT_DATA_ACK)) {
+#if defined(CONFIG_DATA_LOG)
+		log_ack_handle(&msg->module.cloud.data.ack);
+#endif
 		k_free(msg->module.cloud.data.ack.ptr);
 	}
 }
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+
+#include "data_log.h"
+
+/* Timestamps of entries are in UNIX time. */
+#define TS_BASE 1600000000000LL
+
+/* More battery entries than fit in the data log partition. */
+#define WRAP_COUNT 1000
+
+static struct data_log_chunk chunk;
+
+static void battery_append(uint16_t value)
+{
+	int err;
+	struct cloud_data_battery bat = {
+		.bat = value,
+		.bat_ts = TS_BASE + value,
+		.queued = true,
+	};
+
+	err = data_log_append(DATA_LOG_TYPE_BATTERY, &bat);
+	zassert_equal(0, err, "data_log_append, error: %d", err);
+}
+
+/* Check that the chunk holds consecutive battery entries, starting at first. */
+static void battery_chunk_verify(uint16_t first, size_t count)
+{
+	zassert_equal(count, chunk.count, "Chunk holds %d entries, expected %d",
+		      (int)chunk.count, (int)count);
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal(first + i, chunk.bat[i].bat, "Unexpected entry %d", (int)i);
+		zassert_equal(TS_BASE + first + i, chunk.bat[i].bat_ts,
+			      "Unexpected timestamp of entry %d", (int)i);
+		zassert_true(chunk.bat[i].queued, "Entry %d is not queued", (int)i);
+	}
+
+	for (size_t i = count; i < CONFIG_DATA_LOG_CHUNK_ENTRIES; i++) {
+		zassert_false(chunk.bat[i].queued, "Unused entry %d is queued", (int)i);
+	}
+}
+
+/* Read and commit chunks until the log is empty. Returns the number of entries read. */
+static size_t log_drain(uint16_t *first, uint16_t *last)
+{
+	int err;
+	size_t total = 0;
+
+	while ((err = data_log_chunk_read(&chunk)) == 0) {
+		if (total == 0) {
+			*first = chunk.bat[0].bat;
+		} else {
+			zassert_equal(*last + 1, chunk.bat[0].bat, "Entries are not consecutive");
+		}
+
+		battery_chunk_verify(chunk.bat[0].bat, chunk.count);
+
+		*last = chunk.bat[chunk.count - 1].bat;
+		total += chunk.count;
+
+		err = data_log_chunk_commit(&chunk);
+		zassert_equal(0, err, "data_log_chunk_commit, error: %d", err);
+	}
+
+	zassert_equal(-ENODATA, err, "data_log_chunk_read, error: %d", err);
+
+	return total;
+}
+
+static void test_store(void)
+{
+	int err;
+	struct cloud_data_sensors sensors = {
+		.temperature = 21.5,
+		.humidity = 40.0,
+		.env_ts = TS_BASE,
+		.queued = true,
+	};
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(-ENODATA, err, "Empty log returned %d", err);
+
+	battery_append(0);
+	battery_append(1);
+	battery_append(2);
+
+	err = data_log_append(DATA_LOG_TYPE_SENSORS, &sensors);
+	zassert_equal(0, err, "data_log_append, error: %d", err);
+
+	err = data_log_append(DATA_LOG_TYPE_COUNT, &sensors);
+	zassert_equal(-EINVAL, err, "Unknown type returned %d", err);
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	zassert_equal(4, chunk.count, "Chunk holds %d entries", (int)chunk.count);
+
+	zassert_true(chunk.sensors[0].queued, "Sensor entry is not queued");
+	zassert_equal(TS_BASE, chunk.sensors[0].env_ts, "Unexpected sensor timestamp");
+	zassert_within(21.5, chunk.sensors[0].temperature, 0.01, "Unexpected temperature");
+	zassert_within(40.0, chunk.sensors[0].humidity, 0.01, "Unexpected humidity");
+	zassert_false(chunk.sensors[1].queued, "Unused sensor entry is queued");
+	zassert_false(chunk.gnss[0].queued, "Unused GNSS entry is queued");
+
+	for (size_t i = 0; i < 3; i++) {
+		zassert_equal(i, chunk.bat[i].bat, "Unexpected entry %d", (int)i);
+	}
+}
+
+static void test_drain(void)
+{
+	int err;
+	size_t total;
+	uint16_t first = 0;
+	uint16_t last = 0;
+
+	for (uint16_t i = 0; i < 12; i++) {
+		battery_append(i);
+	}
+
+	/* Chunks are limited to CONFIG_DATA_LOG_CHUNK_ENTRIES entries of a type */
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	total = log_drain(&first, &last);
+	zassert_equal(12, total, "%d entries read", (int)total);
+	zassert_equal(0, first, "First entry is %d", first);
+	zassert_equal(11, last, "Last entry is %d", last);
+
+	/* Entries appended after the log has been emptied are read */
+	battery_append(12);
+
+	total = log_drain(&first, &last);
+	zassert_equal(1, total, "%d entries read", (int)total);
+	zassert_equal(12, first, "First entry is %d", first);
+}
+
+static void test_ack(void)
+{
+	int err;
+
+	for (uint16_t i = 0; i < 7; i++) {
+		battery_append(i);
+	}
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	/* The chunk is acknowledged by cloud */
+	err = data_log_chunk_commit(&chunk);
+	zassert_equal(0, err, "data_log_chunk_commit, error: %d", err);
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(CONFIG_DATA_LOG_CHUNK_ENTRIES, 7 - CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	/* The read cursor is kept across a reboot */
+	err = data_log_init();
+	zassert_equal(0, err, "data_log_init, error: %d", err);
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(CONFIG_DATA_LOG_CHUNK_ENTRIES, 7 - CONFIG_DATA_LOG_CHUNK_ENTRIES);
+}
+
+static void test_lost_ack(void)
+{
+	int err;
+
+	for (uint16_t i = 0; i < 7; i++) {
+		battery_append(i);
+	}
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	/* The chunk is not acknowledged, for instance due to a disconnect. The same entries are
+	 * read again.
+	 */
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	/* Also after a reboot */
+	err = data_log_init();
+	zassert_equal(0, err, "data_log_init, error: %d", err);
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	err = data_log_chunk_commit(&chunk);
+	zassert_equal(0, err, "data_log_chunk_commit, error: %d", err);
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(CONFIG_DATA_LOG_CHUNK_ENTRIES, 7 - CONFIG_DATA_LOG_CHUNK_ENTRIES);
+}
+
+static void test_wraparound(void)
+{
+	int err;
+	size_t total;
+	uint16_t first = 0;
+	uint16_t last = 0;
+
+	for (uint16_t i = 0; i < WRAP_COUNT; i++) {
+		battery_append(i);
+	}
+
+	/* The oldest entries are erased and the newest are kept, in order */
+	total = log_drain(&first, &last);
+	zassert_true(total < WRAP_COUNT, "No entries erased");
+	zassert_true(first > 0, "Oldest entry not erased");
+	zassert_equal(WRAP_COUNT - 1, last, "Last entry is %d", last);
+	zassert_equal(WRAP_COUNT - first, total, "Entries are missing");
+
+	/* A chunk read before the log overflows is not committed */
+	for (uint16_t i = 0; i < CONFIG_DATA_LOG_CHUNK_ENTRIES; i++) {
+		battery_append(i);
+	}
+
+	err = data_log_chunk_read(&chunk);
+	zassert_equal(0, err, "data_log_chunk_read, error: %d", err);
+	battery_chunk_verify(0, CONFIG_DATA_LOG_CHUNK_ENTRIES);
+
+	for (uint16_t i = CONFIG_DATA_LOG_CHUNK_ENTRIES; i < WRAP_COUNT; i++) {
+		battery_append(i);
+	}
+
+	err = data_log_chunk_commit(&chunk);
+	zassert_equal(-ECANCELED, err, "Stale chunk committed, error: %d", err);
+
+	total = log_drain(&first, &last);
+	zassert_true(first > 0, "Oldest entry not erased");
+	zassert_equal(WRAP_COUNT - 1, last, "Last entry is %d", last);
+	zassert_equal(WRAP_COUNT - first, total, "Entries are missing");
+}
+
+/* Setup function. Used to start each test with an empty log and no stored read cursor. */
+
+static void test_setup(void)
+{
+	int err;
+	const struct flash_area *fa;
+
+	err = flash_area_open(FLASH_AREA_ID(data_log), &fa);
+	zassert_equal(0, err, "flash_area_open, error: %d", err);
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(0, err, "flash_area_erase, error: %d", err);
+
+	flash_area_close(fa);
+
+	err = settings_delete("data_log/cursor");
+	zassert_equal(0, err, "settings_delete, error: %d", err);
+
+	err = data_log_init();
+	zassert_equal(0, err, "data_log_init, error: %d", err);
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = settings_subsys_init();
+	zassert_equal(0, err, "settings_subsys_init, error: %d", err);
+
+	ztest_test_suite(data_log,
+		ztest_unit_test_setup_teardown(test_store, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_drain, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_ack, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_lost_ack, test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_wraparound, test_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(data_log);
+}
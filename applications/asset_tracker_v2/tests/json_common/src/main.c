@@ -8,6 +8,7 @@
 #include <zephyr.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <cJSON.h>
 #include <cJSON_os.h>
 
@@ -1220,6 +1221,652 @@ static void test_floating_point_encoding_configuration(void)
 	cJSON_Delete(decoded_root_obj);
 }
 
+/* Streaming writer and reader */
+
+static void test_encode_configuration_data_writer(void)
+{
+	int ret;
+	char buf[sizeof(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA)];
+	struct json_writer writer;
+	struct cloud_data_cfg data = {
+		.active_mode = false,
+		.active_wait_timeout = 120,
+		.movement_resolution = 120,
+		.movement_timeout = 3600,
+		.gnss_timeout = 60,
+		.accelerometer_threshold = 2,
+		.no_data.gnss = true,
+		.no_data.neighbor_cell = true
+	};
+
+	json_writer_init(&writer, buf, sizeof(buf));
+	json_writer_obj_start(&writer, NULL);
+	ret = json_common_config_write(&writer, &data, DATA_CONFIG);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	json_writer_obj_end(&writer);
+	ret = json_writer_finish(&writer, NULL);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(0, strcmp(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA, buf),
+		      "Encoded output is wrong");
+
+	/* Check for too small buffer. */
+
+	json_writer_init(&writer, buf, sizeof(buf) - 1);
+	json_writer_obj_start(&writer, NULL);
+	json_common_config_write(&writer, &data, DATA_CONFIG);
+	json_writer_obj_end(&writer);
+	ret = json_writer_finish(&writer, NULL);
+	zassert_equal(-ENOMEM, ret, "Return value %d is wrong", ret);
+
+	/* Check for invalid input. */
+
+	json_writer_init(&writer, buf, sizeof(buf));
+	json_writer_obj_start(&writer, NULL);
+	ret = json_common_config_write(&writer, &data, NULL);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong.", ret);
+}
+
+static void test_encode_configuration_message(void)
+{
+	int ret;
+	struct cloud_codec_data output = { 0 };
+	static const char *const parents[] = { "state", "reported" };
+	struct cloud_data_cfg data = {
+		.active_mode = false,
+		.active_wait_timeout = 120,
+		.movement_resolution = 120,
+		.movement_timeout = 3600,
+		.gnss_timeout = 60,
+		.accelerometer_threshold = 2,
+		.no_data.gnss = true,
+		.no_data.neighbor_cell = true
+	};
+
+	ret = json_common_config_encode(&output, &data, NULL, 0);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(strlen(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA), output.len,
+		      "Encoded length is wrong");
+	zassert_equal(0, strcmp(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA, output.buf),
+		      "Encoded output is wrong");
+	cJSON_free(output.buf);
+
+	ret = json_common_config_encode(&output, &data, parents, ARRAY_SIZE(parents));
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(0, strcmp("{\"state\":{\"reported\":"
+				TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA "}}", output.buf),
+		      "Encoded output is wrong");
+	cJSON_free(output.buf);
+}
+
+static void test_json_writer_matches_cjson(void)
+{
+	static const char *const strings[] = {
+		"plain", "\"quoted\"", "back\\slash", "line\nbreak\ttab", "ctrl\x01", "\xc3\xa6",
+	};
+	static const double numbers[] = {
+		0, -1, 2.22, 0.1, 1e300, -3.5e-7, 1634567890123, 2147483648.0, NAN,
+	};
+	char buf[512];
+	char *expected;
+	struct json_writer writer;
+	cJSON *root_obj = cJSON_CreateObject();
+	cJSON *array_obj = cJSON_CreateArray();
+	int ret;
+
+	zassert_not_null(root_obj, "Root object is NULL");
+	zassert_not_null(array_obj, "Array object is NULL");
+
+	json_writer_init(&writer, buf, sizeof(buf));
+	json_writer_obj_start(&writer, NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(strings); i++) {
+		json_add_str(root_obj, strings[i], strings[i]);
+		json_writer_add_str(&writer, strings[i], strings[i]);
+	}
+
+	json_writer_array_start(&writer, "numbers");
+
+	for (size_t i = 0; i < ARRAY_SIZE(numbers); i++) {
+		json_add_number_to_array(array_obj, numbers[i]);
+		json_writer_add_number(&writer, NULL, numbers[i]);
+	}
+
+	json_writer_array_end(&writer);
+	json_add_obj(root_obj, "numbers", array_obj);
+
+	json_add_bool(root_obj, "bool", true);
+	json_writer_add_bool(&writer, "bool", true);
+
+	json_writer_obj_end(&writer);
+	ret = json_writer_finish(&writer, NULL);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	expected = cJSON_PrintUnformatted(root_obj);
+	zassert_not_null(expected, "Printed JSON string is NULL");
+	zassert_equal(0, strcmp(expected, buf), "Output differs from cJSON: %s", buf);
+
+	/* Check for unbalanced containers and misplaced keys. */
+
+	json_writer_init(&writer, buf, sizeof(buf));
+	json_writer_obj_start(&writer, NULL);
+	ret = json_writer_add_number(&writer, NULL, 1);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong", ret);
+
+	json_writer_init(&writer, buf, sizeof(buf));
+	json_writer_array_start(&writer, NULL);
+	ret = json_writer_finish(&writer, NULL);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong", ret);
+
+	cJSON_FreeString(expected);
+	cJSON_Delete(root_obj);
+}
+
+static void test_json_reader_tokens(void)
+{
+	static const char input[] = " {\"a\" : [1, -2.5e3, \"s\\u00e6\\n\"], \"b\":{}, \"c\":null}";
+	static const enum json_token_type expected[] = {
+		JSON_TOKEN_OBJ_START, JSON_TOKEN_KEY, JSON_TOKEN_ARRAY_START, JSON_TOKEN_NUMBER,
+		JSON_TOKEN_NUMBER, JSON_TOKEN_STRING, JSON_TOKEN_ARRAY_END, JSON_TOKEN_KEY,
+		JSON_TOKEN_OBJ_START, JSON_TOKEN_OBJ_END, JSON_TOKEN_KEY, JSON_TOKEN_NULL,
+		JSON_TOKEN_OBJ_END,
+	};
+	static const char *const invalid[] = {
+		"{\"a\" 1}", "{\"a\":1,}", "[1 2]", "{\"a\":[}", "\"open", "{} {}", "[tru]",
+	};
+	struct json_reader reader;
+	struct json_token token;
+	char str[8];
+	double num;
+	int ret;
+
+	/* The input does not need to be null-terminated. */
+	json_reader_init(&reader, input, sizeof(input) - 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		ret = json_reader_next(&reader, &token);
+		zassert_equal(0, ret, "Return value %d is wrong at token %zu", ret, i);
+		zassert_equal(expected[i], token.type, "Token %zu type %d is wrong", i, token.type);
+
+		if (i == 4) {
+			zassert_equal(0, json_token_number_get(&token, &num), "Number not decoded");
+			zassert_within(-2500, num, 0.001, "Number %f is wrong", num);
+		} else if (i == 5) {
+			zassert_equal(0, json_token_str_get(&token, str, sizeof(str)),
+				      "String not decoded");
+			zassert_equal(0, strcmp("s\xc3\xa6\n", str), "String is wrong");
+			zassert_equal(-ENOMEM, json_token_str_get(&token, str, 4),
+				      "Decoding to too small buffer should fail");
+		}
+	}
+
+	ret = json_reader_next(&reader, &token);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	/* Skip the first value */
+	json_reader_init(&reader, input, sizeof(input) - 1);
+	json_reader_next(&reader, &token);
+	json_reader_next(&reader, &token);
+	ret = json_reader_skip(&reader, &token);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	json_reader_next(&reader, &token);
+	zassert_true(json_token_str_eq(&token, "b"), "Skipped to wrong token");
+
+	for (size_t i = 0; i < ARRAY_SIZE(invalid); i++) {
+		json_reader_init(&reader, invalid[i], strlen(invalid[i]));
+
+		do {
+			ret = json_reader_next(&reader, &token);
+		} while (ret == 0);
+
+		zassert_equal(-EBADMSG, ret, "Invalid input %zu not detected", i);
+	}
+}
+
+static void test_decode_configuration_data_reader(void)
+{
+	static const char nested[] =
+		"{\"version\":3,\"state\":{\"other\":[{}],\"cfg\":{\"gnsst\":30,"
+		"\"unknown\":{\"gnsst\":1},\"nod\":[]}}}";
+	struct cloud_data_cfg data = {0};
+	int ret;
+
+	ret = json_common_config_decode(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA,
+					strlen(TEST_VALIDATE_CONFIGURATION_JSON_SCHEMA), NULL, &data);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	zassert_equal(false, data.active_mode, "Configuration is wrong");
+	zassert_equal(true, data.no_data.gnss, "Configuration is wrong");
+	zassert_equal(true, data.no_data.neighbor_cell, "Configuration is wrong");
+	zassert_equal(60, data.gnss_timeout, "Configuration is wrong");
+	zassert_equal(120, data.active_wait_timeout, "Configuration is wrong");
+	zassert_equal(120, data.movement_resolution, "Configuration is wrong");
+	zassert_equal(3600, data.movement_timeout, "Configuration is wrong");
+	zassert_equal(2, data.accelerometer_threshold, "Configuration is wrong");
+
+	/* Configuration in a group object, only present members are changed. */
+
+	ret = json_common_config_decode(nested, sizeof(nested), "state", &data);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(30, data.gnss_timeout, "Configuration is wrong");
+	zassert_equal(3600, data.movement_timeout, "Configuration is wrong");
+	zassert_equal(false, data.no_data.gnss, "Configuration is wrong");
+
+	/* Check for missing configuration and invalid input. */
+
+	ret = json_common_config_decode(nested, sizeof(nested), NULL, &data);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_config_decode("[]", 2, NULL, &data);
+	zassert_equal(-ENOENT, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_config_decode(nested, sizeof(nested) - 3, "state", &data);
+	zassert_equal(-ENOENT, ret, "Return value %d is wrong", ret);
+	zassert_equal(30, data.gnss_timeout, "Configuration changed by invalid input");
+}
+
+/* Allocations made by cJSON are tracked to find the peak heap usage. */
+#define HEAP_HEADER_SIZE 8
+
+static size_t heap_used;
+static size_t heap_peak;
+
+static void *tracking_malloc(size_t size)
+{
+	uint8_t *block = k_malloc(HEAP_HEADER_SIZE + size);
+
+	if (block == NULL) {
+		return NULL;
+	}
+
+	*(size_t *)block = size;
+	heap_used += size;
+	heap_peak = MAX(heap_peak, heap_used);
+
+	return block + HEAP_HEADER_SIZE;
+}
+
+static void tracking_free(void *ptr)
+{
+	uint8_t *block = (uint8_t *)ptr - HEAP_HEADER_SIZE;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	heap_used -= *(size_t *)block;
+	k_free(block);
+}
+
+#define BENCHMARK_ROUNDS 100
+
+static void test_benchmark_configuration(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = tracking_malloc,
+		.free_fn = tracking_free,
+	};
+	struct cloud_data_cfg data = {
+		.active_wait_timeout = 120,
+		.movement_resolution = 120,
+		.movement_timeout = 3600,
+		.gnss_timeout = 60,
+		.accelerometer_threshold = 2.22,
+		.no_data.gnss = true,
+	};
+	struct cloud_data_cfg decoded = {0};
+	char buf[256];
+	size_t len = 0;
+	uint32_t cycles[4];
+	size_t peak[2];
+	uint32_t start;
+
+	cJSON_InitHooks(&hooks);
+
+	heap_peak = 0;
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		cJSON *root_obj = cJSON_CreateObject();
+		char *str;
+
+		json_common_config_add(root_obj, &data, DATA_CONFIG);
+		str = cJSON_PrintUnformatted(root_obj);
+		cJSON_Delete(root_obj);
+		zassert_not_null(str, "Printed JSON string is NULL");
+		strcpy(buf, str);
+		cJSON_FreeString(str);
+	}
+	cycles[0] = k_cycle_get_32() - start;
+	peak[0] = heap_peak;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		struct json_writer writer;
+
+		json_writer_init(&writer, buf, sizeof(buf));
+		json_writer_obj_start(&writer, NULL);
+		json_common_config_write(&writer, &data, DATA_CONFIG);
+		json_writer_obj_end(&writer);
+		zassert_equal(0, json_writer_finish(&writer, &len), "Encoding failed");
+	}
+	cycles[1] = k_cycle_get_32() - start;
+
+	heap_peak = 0;
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		cJSON *root_obj = cJSON_ParseWithLength(buf, len);
+
+		json_common_config_get(json_object_decode(root_obj, OBJECT_CONFIG), &decoded);
+		cJSON_Delete(root_obj);
+	}
+	cycles[2] = k_cycle_get_32() - start;
+	peak[1] = heap_peak;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		zassert_equal(0, json_common_config_decode(buf, len, NULL, &decoded),
+			      "Decoding failed");
+	}
+	cycles[3] = k_cycle_get_32() - start;
+
+	cJSON_Init();
+
+	zassert_within(data.accelerometer_threshold, decoded.accelerometer_threshold, 0.001,
+		       "Decoded value is wrong");
+
+	TC_PRINT("Configuration of %zu bytes (cycles, peak heap):\n", len);
+	TC_PRINT("\tencode cJSON: %u, %zu bytes\n", cycles[0] / BENCHMARK_ROUNDS, peak[0]);
+	TC_PRINT("\tencode writer: %u, 0 bytes\n", cycles[1] / BENCHMARK_ROUNDS);
+	TC_PRINT("\tdecode cJSON: %u, %zu bytes\n", cycles[2] / BENCHMARK_ROUNDS, peak[1]);
+	TC_PRINT("\tdecode reader: %u, 0 bytes\n", cycles[3] / BENCHMARK_ROUNDS);
+}
+
+/* Columnar batch data */
+
+#define TEST_VALIDATE_COLUMNAR_GNSS_JSON_SCHEMA						\
+	"{"										\
+		"\"gnss\":{"								\
+			"\"ts\":[1646914800000,60000],"					\
+			"\"lng\":[10500000,12],"					\
+			"\"lat\":[62100000,20],"					\
+			"\"acc\":[241,-1],"						\
+			"\"alt\":[1700,15],"						\
+			"\"spd\":[10,-10],"						\
+			"\"hdg\":[1760,40]"						\
+		"}"									\
+	"}"
+
+static void test_encode_batch_columnar_gnss(void)
+{
+	int ret;
+	struct cloud_data_gnss gnss[3] = {
+		[0].pvt.longi = 10.5,
+		[0].pvt.lat = 62.1,
+		[0].pvt.acc = 24.1,
+		[0].pvt.alt = 170,
+		[0].pvt.spd = 1,
+		[0].pvt.hdg = 176,
+		[0].gnss_ts = 1646914800000,
+		[0].queued = true,
+		[0].format = CLOUD_CODEC_GNSS_FORMAT_PVT,
+		/* Second entry */
+		[1].pvt.longi = 10.500012,
+		[1].pvt.lat = 62.10002,
+		[1].pvt.acc = 24,
+		[1].pvt.alt = 171.5,
+		[1].pvt.spd = 0,
+		[1].pvt.hdg = 180,
+		[1].gnss_ts = 1646914860000,
+		[1].queued = true,
+		[1].format = CLOUD_CODEC_GNSS_FORMAT_PVT,
+		/* Third entry, not queued */
+		[2].pvt.longi = 11,
+		[2].gnss_ts = 1646914920000,
+		[2].format = CLOUD_CODEC_GNSS_FORMAT_PVT
+	};
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_GNSS, gnss,
+					     ARRAY_SIZE(gnss), DATA_GNSS);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = encoded_output_check(dummy.root_obj, TEST_VALIDATE_COLUMNAR_GNSS_JSON_SCHEMA, -1);
+	zassert_equal(0, ret, "Encoded output is wrong: %s", dummy.buffer);
+
+	zassert_false(gnss[0].queued, "Entry is still queued");
+	zassert_false(gnss[1].queued, "Entry is still queued");
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_GNSS, gnss,
+					     ARRAY_SIZE(gnss), DATA_GNSS);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_MODEM_DYNAMIC, gnss,
+					     ARRAY_SIZE(gnss), DATA_MODEM_DYNAMIC);
+	zassert_equal(-ENOTSUP, ret, "Return value %d is wrong", ret);
+}
+
+/* Decode a delta encoded column. */
+static void columnar_column_decode(const cJSON *columns_obj, const char *label, double scale,
+				   double *values, size_t count)
+{
+	const cJSON *array_obj = cJSON_GetObjectItem(columns_obj, label);
+	const cJSON *item;
+	double sum = 0;
+	size_t i = 0;
+
+	zassert_true(cJSON_IsArray(array_obj), "Column %s not found", label);
+	zassert_equal(count, cJSON_GetArraySize(array_obj), "Column %s has wrong length", label);
+
+	cJSON_ArrayForEach(item, array_obj) {
+		sum += item->valuedouble;
+		values[i++] = sum / scale;
+	}
+}
+
+#define COLUMNAR_ENTRY_COUNT 20
+
+static struct {
+	struct cloud_data_gnss gnss[COLUMNAR_ENTRY_COUNT];
+	struct cloud_data_sensors sensors[COLUMNAR_ENTRY_COUNT];
+	struct cloud_data_accelerometer accel[COLUMNAR_ENTRY_COUNT];
+	struct cloud_data_battery bat[COLUMNAR_ENTRY_COUNT];
+} columnar_data;
+
+/* Generate data similar to what a moving device samples once a minute. */
+static void columnar_data_generate(void)
+{
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		int64_t ts = 1646914800000 + i * 60000 + (i % 3);
+
+		columnar_data.gnss[i] = (struct cloud_data_gnss){
+			.pvt.longi = 10.437814 + i * 0.000731,
+			.pvt.lat = 63.421373 - i * 0.000417,
+			.pvt.acc = 4.2 + (i % 4),
+			.pvt.alt = 52.3 + i * 0.7,
+			.pvt.spd = 1.4 + (i % 2),
+			.pvt.hdg = 123.4 + i,
+			.gnss_ts = ts,
+			.queued = true,
+			.format = CLOUD_CODEC_GNSS_FORMAT_PVT
+		};
+
+		columnar_data.sensors[i] = (struct cloud_data_sensors){
+			.temperature = 21.37 + i * 0.01,
+			.humidity = 47.12 - i * 0.05,
+			.pressure = 100.63,
+			.bsec_air_quality = (i % 5) ? 50 + i : -1,
+			.env_ts = ts,
+			.queued = true
+		};
+
+		columnar_data.accel[i] = (struct cloud_data_accelerometer){
+			.values = { 0.21 * i, -9.81, 0.35 },
+			.ts = ts,
+			.queued = true
+		};
+
+		columnar_data.bat[i] = (struct cloud_data_battery){
+			.bat = 3600 - i,
+			.bat_ts = ts,
+			.queued = true
+		};
+	}
+}
+
+static void batch_size_get(bool columnar, size_t *len)
+{
+	cJSON *root_obj = cJSON_CreateObject();
+	char *buffer;
+	int (*add)(cJSON *parent, enum json_common_buffer_type type, void *buf,
+		   size_t buf_count, const char *object_label) =
+		columnar ? json_common_batch_columnar_add : json_common_batch_data_add;
+
+	columnar_data_generate();
+
+	zassert_equal(0, add(root_obj, JSON_COMMON_GNSS, columnar_data.gnss,
+			     COLUMNAR_ENTRY_COUNT, DATA_GNSS), "Encoding failed");
+	zassert_equal(0, add(root_obj, JSON_COMMON_SENSOR, columnar_data.sensors,
+			     COLUMNAR_ENTRY_COUNT, DATA_ENVIRONMENTALS), "Encoding failed");
+	zassert_equal(0, add(root_obj, JSON_COMMON_ACCELEROMETER, columnar_data.accel,
+			     COLUMNAR_ENTRY_COUNT, DATA_MOVEMENT), "Encoding failed");
+	zassert_equal(0, add(root_obj, JSON_COMMON_BATTERY, columnar_data.bat,
+			     COLUMNAR_ENTRY_COUNT, DATA_BATTERY), "Encoding failed");
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	zassert_not_null(buffer, "Printed JSON string is NULL");
+	*len = strlen(buffer);
+
+	cJSON_FreeString(buffer);
+	cJSON_Delete(root_obj);
+}
+
+static void test_encode_batch_columnar_round_trip(void)
+{
+	int ret;
+	double values[COLUMNAR_ENTRY_COUNT];
+	const cJSON *columns_obj;
+
+	columnar_data_generate();
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_GNSS,
+					     columnar_data.gnss, COLUMNAR_ENTRY_COUNT, DATA_GNSS);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_SENSOR,
+					     columnar_data.sensors, COLUMNAR_ENTRY_COUNT,
+					     DATA_ENVIRONMENTALS);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_ACCELEROMETER,
+					     columnar_data.accel, COLUMNAR_ENTRY_COUNT,
+					     DATA_MOVEMENT);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	ret = json_common_batch_columnar_add(dummy.root_obj, JSON_COMMON_BATTERY,
+					     columnar_data.bat, COLUMNAR_ENTRY_COUNT, DATA_BATTERY);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+
+	/* Decode from the printed string, as the cloud side would */
+	dummy.buffer = cJSON_PrintUnformatted(dummy.root_obj);
+	zassert_not_null(dummy.buffer, "Printed JSON string is NULL");
+	cJSON_Delete(dummy.root_obj);
+	dummy.root_obj = cJSON_Parse(dummy.buffer);
+	zassert_not_null(dummy.root_obj, "Encoded output is not valid JSON");
+
+	columns_obj = cJSON_GetObjectItem(dummy.root_obj, DATA_GNSS);
+
+	columnar_column_decode(columns_obj, DATA_TIMESTAMP, 1, values, COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_equal((int64_t)values[i], columnar_data.gnss[i].gnss_ts,
+			      "Timestamp %d is wrong", i);
+	}
+
+	columnar_column_decode(columns_obj, DATA_GNSS_LONGITUDE, 1000000, values,
+			       COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_within(values[i], columnar_data.gnss[i].pvt.longi, 0.0000005,
+			       "Longitude %d is wrong", i);
+	}
+
+	columnar_column_decode(columns_obj, DATA_GNSS_LATITUDE, 1000000, values,
+			       COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_within(values[i], columnar_data.gnss[i].pvt.lat, 0.0000005,
+			       "Latitude %d is wrong", i);
+	}
+
+	columnar_column_decode(columns_obj, DATA_GNSS_ALTITUDE, 10, values,
+			       COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_within(values[i], columnar_data.gnss[i].pvt.alt, 0.05,
+			       "Altitude %d is wrong", i);
+	}
+
+	columns_obj = cJSON_GetObjectItem(dummy.root_obj, DATA_ENVIRONMENTALS);
+
+	columnar_column_decode(columns_obj, DATA_TEMPERATURE, 100, values,
+			       COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_within(values[i], columnar_data.sensors[i].temperature, 0.005,
+			       "Temperature %d is wrong", i);
+	}
+
+	columnar_column_decode(columns_obj, DATA_BSEC_IAQ, 1, values, COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_equal((int)values[i], columnar_data.sensors[i].bsec_air_quality,
+			      "Air quality %d is wrong", i);
+	}
+
+	columns_obj = cJSON_GetObjectItem(dummy.root_obj, DATA_MOVEMENT);
+
+	columnar_column_decode(columns_obj, DATA_MOVEMENT_X, 100, values, COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_within(values[i], columnar_data.accel[i].values[0], 0.005,
+			       "Acceleration %d is wrong", i);
+	}
+
+	columns_obj = cJSON_GetObjectItem(dummy.root_obj, DATA_BATTERY);
+
+	columnar_column_decode(columns_obj, DATA_VALUE, 1, values, COLUMNAR_ENTRY_COUNT);
+	for (int i = 0; i < COLUMNAR_ENTRY_COUNT; i++) {
+		zassert_equal((int)values[i], columnar_data.bat[i].bat,
+			      "Battery voltage %d is wrong", i);
+	}
+}
+
+static void test_encode_batch_columnar_size(void)
+{
+	size_t row_len = 0;
+	size_t columnar_len = 0;
+
+	batch_size_get(false, &row_len);
+	batch_size_get(true, &columnar_len);
+
+	TC_PRINT("Batch of %d GNSS, environmental, movement and battery entries:\n",
+		 COLUMNAR_ENTRY_COUNT);
+	TC_PRINT("\tobject per entry: %zu bytes\n", row_len);
+	TC_PRINT("\tcolumnar: %zu bytes (%zu%%)\n", columnar_len, columnar_len * 100 / row_len);
+
+	zassert_true(columnar_len * 2 < row_len, "Columnar batch is not smaller");
+}
+
+static void test_timestamp_convert(void)
+{
+	int err;
+	int64_t uptime = 1000;
+	int64_t unix_time = 1600000000000;
+
+	/* Uptime is converted to UNIX time. */
+	err = json_common_timestamp_convert(&uptime);
+	zassert_equal(0, err, "Return value %d is not as expected", err);
+	zassert_equal(1563968747123, uptime, "Uptime is not converted");
+
+	/* Timestamps that already are UNIX time, such as entries read back from the data log,
+	 * are left as they are.
+	 */
+	err = json_common_timestamp_convert(&unix_time);
+	zassert_equal(0, err, "Return value %d is not as expected", err);
+	zassert_equal(1600000000000, unix_time, "UNIX time is converted again");
+}
+
 /* Setup and teardown functions. Used to allocate root and array objects used in test and to
  * cleanup allocated memory afterwards.
  */
@@ -1336,6 +1983,14 @@ void test_main(void)
 		/* Configuration decode */
 		ztest_unit_test(test_decode_configuration_data),
 
+		/* Streaming writer and reader */
+		ztest_unit_test(test_encode_configuration_data_writer),
+		ztest_unit_test(test_encode_configuration_message),
+		ztest_unit_test(test_json_writer_matches_cjson),
+		ztest_unit_test(test_json_reader_tokens),
+		ztest_unit_test(test_decode_configuration_data_reader),
+		ztest_unit_test(test_benchmark_configuration),
+
 		/* Batch */
 		ztest_unit_test_setup_teardown(test_encode_batch_data_object,
 					       test_setup_object,
@@ -1359,7 +2014,17 @@ void test_main(void)
 		/* Configuration floating point values comparison */
 		ztest_unit_test_setup_teardown(test_floating_point_encoding_configuration,
 					       test_setup_object,
-					       test_teardown_object)
+					       test_teardown_object),
+
+		/* Columnar batch encoding */
+		ztest_unit_test_setup_teardown(test_encode_batch_columnar_gnss,
+					       test_setup_object,
+					       test_teardown_object),
+		ztest_unit_test_setup_teardown(test_encode_batch_columnar_round_trip,
+					       test_setup_object,
+					       test_teardown_object),
+		ztest_unit_test(test_encode_batch_columnar_size),
+		ztest_unit_test(test_timestamp_convert)
 	);
 
 	ztest_run_test_suite(json_common);
@@ -40,6 +40,10 @@ extern "C" {
 typedef bool (*cb_fn)(const struct app_event_header *aeh);
 /**
  * @brief List of bits in event type flags.
+ *
+ * The event type flag field has 8 bits. Bits from
+ * @ref APP_EVENT_TYPE_FLAGS_USER_DEFINED_START up to bit 7 (three bits) are
+ * left for application-specific flags.
  */
 enum app_event_type_flags {
 	/* Flags set internally by Application Event Manager. */
@@ -50,14 +54,21 @@ enum app_event_type_flags {
 	APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
 	APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE =
 		APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
+	APP_EVENT_TYPE_FLAGS_PRIO_HIGH,
+	APP_EVENT_TYPE_FLAGS_PRIO_LOW,
+	APP_EVENT_TYPE_FLAGS_COALESCE,
 
 	/* Number of predefined flags. */
 	APP_EVENT_TYPE_FLAGS_COUNT,
 
-	/* Value greater or equal are user-specific. */
+	/* Value greater or equal are user-specific. Bits up to 7 can be used. */
 	APP_EVENT_TYPE_FLAGS_USER_DEFINED_START = APP_EVENT_TYPE_FLAGS_COUNT,
 };
 
+BUILD_ASSERT(APP_EVENT_TYPE_FLAGS_USER_DEFINED_START <
+	     (8 * sizeof(((struct event_type *)0)->flags)),
+	     "No event type flags left for user");
+
 /** @brief Get event type flag's value.
  *
  * @param flag Selected event type flag.
@@ -70,6 +81,24 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	return (et->flags & BIT(flag)) != 0;
 }
 
+/** @brief Get event type dispatch priority.
+ *
+ * Priority is used only if @kconfig{CONFIG_APP_EVENT_MANAGER_PRIO_QUEUES} is enabled.
+ *
+ * @param et   Pointer to the event type.
+ * @retval Dispatch priority of the event type.
+ */
+static inline enum app_event_prio app_event_get_type_prio(const struct event_type *et)
+{
+	if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_PRIO_HIGH)) {
+		return APP_EVENT_PRIO_HIGH;
+	} else if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_PRIO_LOW)) {
+		return APP_EVENT_PRIO_LOW;
+	}
+
+	return APP_EVENT_PRIO_NORMAL;
+}
+
 /** @brief Create an event listener object.
  *
  * @param lname   Module name.
@@ -109,6 +138,26 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	_APP_EVENT_SUBSCRIBE(lname, ename, _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL))
 
 
+/** @brief Subscribe a listener to the events of given type that match the key.
+ *
+ * The listener is notified only about events for which the function
+ * registered with @ref APP_EVENT_TYPE_KEY_DEFINE returns the given key.
+ * Listeners that are not interested in an event are not called at all.
+ * The listener is notified in the same order as listeners subscribed with
+ * @ref APP_EVENT_SUBSCRIBE.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY} option needs to be enabled.
+ *
+ * @param lname  Name of the listener.
+ * @param ename  Name of the event.
+ * @param key    Key of the event, converted to uintptr_t. It must be a constant expression.
+ */
+#define APP_EVENT_SUBSCRIBE_KEY(lname, ename, key) \
+	_APP_EVENT_SUBSCRIBE_KEY(lname, ename, _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL), key)
+
+
 /** @brief Subscribe a listener to an event type as final module that is
  *  being notified.
  *
@@ -165,6 +214,17 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	_APP_EVENT_TYPE_DEFINE(ename, log_fn, ev_info_struct, app_event_type_flags)
 
 
+/** @brief Define function returning key of the event.
+ *
+ * The key is used to select listeners subscribed with @ref APP_EVENT_SUBSCRIBE_KEY.
+ * The function should have a form `uintptr_t key_fn(const struct app_event_header *aeh)`.
+ *
+ * @param ename   Name of the event.
+ * @param key_fn  Function returning key of the event.
+ */
+#define APP_EVENT_TYPE_KEY_DEFINE(ename, key_fn) _APP_EVENT_TYPE_KEY_DEFINE(ename, key_fn)
+
+
 /** @brief Verify if an event ID is valid.
  *
  * The pointer to an event type structure is used as its ID. This macro
@@ -390,6 +450,77 @@ void *app_event_manager_alloc(size_t size);
 void app_event_manager_free(void *addr);
 
 
+/** @brief Take a reference to the event.
+ *
+ * The event is not freed after processing until the reference is released
+ * with @ref app_event_manager_event_unref. Use this function to keep
+ * the event data (for example a large dynamic data payload) after
+ * the processing without copying it. The event must not be modified.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT} option needs to be enabled.
+ *
+ * @param aeh  Pointer to the application event header.
+ */
+void app_event_manager_event_ref(const struct app_event_header *aeh);
+
+
+/** @brief Release a reference to the event.
+ *
+ * The event is freed when the last reference is released.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT} option needs to be enabled.
+ *
+ * @param aeh  Pointer to the application event header.
+ */
+void app_event_manager_event_unref(const struct app_event_header *aeh);
+
+
+/** @brief Allocate event of the given type from its memory slab.
+ *
+ * Used by the event allocator functions when
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_SLAB} is enabled.
+ * If the slab of the event type is exhausted or the event type has dynamic data,
+ * the event is allocated using @ref app_event_manager_alloc or the out of memory error
+ * is reported, depending on the selected fallback policy.
+ *
+ * @param et    Pointer to the event type.
+ * @param size  Amount of memory requested (in bytes).
+ * @retval Address of the allocated memory if successful, otherwise NULL.
+ */
+void *app_event_manager_slab_alloc(const struct event_type *et, size_t size);
+
+
+/** @brief Free event memory if it belongs to the memory slab of its event type.
+ *
+ * Custom implementation of @ref app_event_manager_free must call this function
+ * before releasing the memory if @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_SLAB} is enabled.
+ *
+ * @param addr  Pointer to previously allocated event.
+ * @retval true If the event was allocated from the slab and it was released.
+ * @retval false Otherwise.
+ */
+bool app_event_manager_slab_free(void *addr);
+
+
+/** @brief Get statistics of the memory slab of the given event type.
+ *
+ * @param et     Pointer to the event type.
+ * @param stats  Pointer to the structure to be filled with the statistics.
+ * @param used   Pointer to the variable to be filled with the number of currently used blocks.
+ * @param total  Pointer to the variable to be filled with the number of slab blocks.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If the event type is not allocated from a slab.
+ */
+int app_event_manager_slab_stats_get(const struct event_type *et,
+				     struct app_event_manager_slab_stats *stats,
+				     uint32_t *used, uint32_t *total);
+
+
 /** @brief Log event.
  *
  * This helper macro simplifies event logging.
@@ -72,10 +72,17 @@ struct bt_mesh_scheduler_srv {
 		sched_tai[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
 		/* Index of the ongoing action. */
 		uint8_t idx;
-		/* Bit field indicating active entries
-		 * in the Schedule Register.
+		/* Min-heap of the active entries in the Schedule Register,
+		 * ordered by their calculated TAI-time.
 		 */
-		uint16_t active_bitmap;
+		uint8_t heap[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+		/* Position of each entry in the heap, or
+		 * BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT if the entry
+		 * isn't active.
+		 */
+		uint8_t heap_pos[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+		/* Number of active entries. */
+		uint8_t heap_len;
 		/* The Schedule Register state is a 16-entry,
 		 * zero-based, indexed array
 		 */
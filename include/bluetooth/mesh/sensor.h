@@ -302,6 +302,8 @@ struct bt_mesh_sensor_series {
 	 *  range, and values that don't fit in any of the columns should be
 	 *  ignored. If columns overlap, samples must be present in all columns
 	 *  they fall into. The columns may come in any order.
+	 *
+	 *  May be NULL if @c column_get is used instead.
 	 */
 	const struct bt_mesh_sensor_column *columns;
 
@@ -318,7 +320,8 @@ struct bt_mesh_sensor_series {
 	 *  @param[in]  ctx    Message context pointer, or NULL if this call
 	 *                     didn't originate from a mesh message.
 	 *  @param[in]  column The requested sensor column. Points to a column
-	 *                     in the @c columns array.
+	 *                     in the @c columns array, or to a column returned
+	 *                     by @c column_get.
 	 *  @param[out] value  Sensor value response buffer. Holds the number of
 	 *                     channels indicated by the sensor type. All
 	 *                     channels must be filled.
@@ -330,6 +333,30 @@ struct bt_mesh_sensor_series {
 		struct bt_mesh_msg_ctx *ctx,
 		const struct bt_mesh_sensor_column *column,
 		struct sensor_value *value);
+
+	/** @brief Getter for the series columns.
+	 *
+	 *  Optional alternative to the @c columns list, for series with many
+	 *  columns or columns that are generated at runtime. The same rules
+	 *  apply to the columns as for the @c columns list.
+	 *
+	 *  The columns are reported in the order of their index. Large series
+	 *  are reported in several Sensor Series Status messages, and the
+	 *  getter is called for each column of each message as it is being
+	 *  sent.
+	 *
+	 *  @param[in]  srv    Sensor server associated with sensor instance.
+	 *  @param[in]  sensor Sensor pointer.
+	 *  @param[in]  index  Index of the requested column, less than
+	 *                     @c column_count.
+	 *  @param[out] column Column at the given index.
+	 *
+	 *  @return 0 on success, or (negative) error code otherwise.
+	 */
+	int (*column_get)(struct bt_mesh_sensor_srv *srv,
+			  struct bt_mesh_sensor *sensor,
+			  uint32_t index,
+			  struct bt_mesh_sensor_column *column);
 };
 
 /** Sensor instance. */
@@ -354,7 +381,8 @@ struct bt_mesh_sensor {
 	 *
 	 *  Only sensors whose type have the @ref
 	 *  BT_MESH_SENSOR_TYPE_FLAG_SERIES flag set, a non-empty list of
-	 *  columns and a defined series getter will accept series messages.
+	 *  columns or a column getter, and a defined series getter will accept
+	 *  series messages.
 	 */
 	const struct bt_mesh_sensor_series series;
 
@@ -382,9 +410,6 @@ struct bt_mesh_sensor {
 		/** Sensor threshold specification. */
 		struct bt_mesh_sensor_threshold threshold;
 
-		/** Linked list node. */
-		sys_snode_t node;
-
 		/** The previously published sensor value. */
 		struct sensor_value prev;
 
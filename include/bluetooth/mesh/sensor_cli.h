@@ -223,6 +223,11 @@ struct bt_mesh_sensor_cli_handlers {
 	 *  callback is called once per entry, with the @c index and @c count
 	 *  parameters indicating the progress.
 	 *
+	 *  Large series are sent in several messages (pages). The @c index and
+	 *  @c count parameters are relative to the message the entry was
+	 *  received in, so @c index starts at 0 for each page, and @c count is
+	 *  the number of entries in the page.
+	 *
 	 *  @note The @c index and @c count parameters does not necessarily
 	 *        match the total number of series entries of the sensor, as the
 	 *        callback may be the result of a filtered query.
@@ -230,9 +235,8 @@ struct bt_mesh_sensor_cli_handlers {
 	 *  @param[in] cli    Sensor client receiving the message.
 	 *  @param[in] ctx    Message context.
 	 *  @param[in] sensor Sensor instance.
-	 *  @param[in] index  Index of this entry in the list of entries
-	 *                    received.
-	 *  @param[in] count  Total number of entries received.
+	 *  @param[in] index  Index of this entry in the message.
+	 *  @param[in] count  Number of entries in the message.
 	 *  @param[in] entry  Single sensor series entry.
 	 */
 	void (*series_entry)(struct bt_mesh_sensor_cli *cli,
@@ -622,6 +626,12 @@ int bt_mesh_sensor_cli_series_entry_get(
  *  the buffer isn't big enough. If the call fails in a way that results in no
  *  response, @c count is set to 0.
  *
+ *  Large series are sent by the server in several messages. The client
+ *  collects the columns of all messages until the last message is received,
+ *  or until the @c rsp array is full. If the response times out, the
+ *  @c rsp array holds the columns received so far, and @c count is set to
+ *  their number.
+ *
  *  This call is blocking if the @c rsp buffer is non-NULL. Otherwise, this
  *  function will return, and the response will be passed to the
  *  bt_mesh_sensor_cli_handlers::series_entry callback as a list of
@@ -650,7 +660,9 @@ int bt_mesh_sensor_cli_series_entry_get(
  *  @retval -EADDRNOTAVAIL A message context was not provided and publishing is
  *                         not configured.
  *  @retval -EAGAIN        The device has not been provisioned.
- *  @retval -ETIMEDOUT     The request timed out without a response.
+ *  @retval -ETIMEDOUT     The request timed out before the full response was
+ *                         received. @c count has been changed to the number
+ *                         of columns received, which may be 0.
  */
 int bt_mesh_sensor_cli_series_entries_get(
 	struct bt_mesh_sensor_cli *cli, struct bt_mesh_msg_ctx *ctx,
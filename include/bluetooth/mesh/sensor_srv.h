@@ -61,8 +61,14 @@ struct bt_mesh_sensor_srv;
 struct bt_mesh_sensor_srv {
 	/** Sensors owned by this server. */
 	struct bt_mesh_sensor *const *sensor_array;
-	/** Ordered linked list of sensors. */
-	sys_slist_t sensors;
+	/** Sensors sorted by ID. */
+	struct bt_mesh_sensor *sensors[CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX];
+	/** Sensors that notify value changes, indexed like sensors. */
+	ATOMIC_DEFINE(notify, CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX);
+	/** Sensors whose value changed since they were last sampled for
+	 *  publication, indexed like sensors.
+	 */
+	ATOMIC_DEFINE(dirty, CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX);
 	/** Publish sequence counter */
 	uint16_t seq;
 	/** Number of sensors. */
@@ -72,6 +78,23 @@ struct bt_mesh_sensor_srv {
 	/** Storage timer */
 	struct k_work_delayable store_timer;
 #endif
+	/** Sensor Series Status response in progress. */
+	struct {
+		/** Work item sending the next page. */
+		struct k_work work;
+		/** Context of the Sensor Series Get message. */
+		struct bt_mesh_msg_ctx ctx;
+		/** Requested range of column start values. */
+		struct bt_mesh_sensor_column range;
+		/** Sensor being reported, or NULL if there's no response in
+		 *  progress.
+		 */
+		struct bt_mesh_sensor *sensor;
+		/** Index of the next column to report. */
+		uint32_t next;
+		/** Whether only columns in @c range are reported. */
+		bool ranged;
+	} series;
 	/** Publish parameters. */
 	struct bt_mesh_model_pub pub;
 	/* Publication buffer */
@@ -143,6 +166,25 @@ int bt_mesh_sensor_srv_pub(struct bt_mesh_sensor_srv *srv,
 int bt_mesh_sensor_srv_sample(struct bt_mesh_sensor_srv *srv,
 			      struct bt_mesh_sensor *sensor);
 
+/** @brief Notify the server that the value of a sensor has changed.
+ *
+ *  By default, the server samples every sensor each time it publishes. Once
+ *  this function has been called for a sensor, the server only samples the
+ *  sensor for periodic publication if its value has changed since it was
+ *  last sampled, or if its publication interval has expired. The sensor
+ *  driver must then call this function every time the sensor value changes.
+ *
+ *  Can be called from any context.
+ *
+ *  @param[in] srv    Sensor server instance.
+ *  @param[in] sensor Sensor instance owned by the server.
+ *
+ *  @retval 0       The sensor has been marked as changed.
+ *  @retval -ENOENT The sensor is not owned by the server.
+ */
+int bt_mesh_sensor_srv_mark_dirty(struct bt_mesh_sensor_srv *srv,
+				  const struct bt_mesh_sensor *sensor);
+
 /** @cond INTERNAL_HIDDEN */
 extern const struct bt_mesh_model_cb _bt_mesh_sensor_srv_cb;
 extern const struct bt_mesh_model_op _bt_mesh_sensor_srv_op[];
@@ -543,6 +543,40 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+/**@brief Advertising report deduplication statistics. */
+struct bt_scan_dedup_stats {
+	/** Number of reports dropped because the same advertisement was
+	 *  received less than CONFIG_BT_SCAN_DEDUP_TTL_MS ago.
+	 */
+	uint32_t hits;
+
+	/** Number of reports passed on because the advertisement was new,
+	 *  changed or expired.
+	 */
+	uint32_t misses;
+
+	/** Number of advertisements replaced in the full cache. */
+	uint32_t evictions;
+};
+
+/**@brief Get the advertising report deduplication statistics.
+ *
+ * @details Only available if CONFIG_BT_SCAN_DEDUP is enabled.
+ *
+ * @param[out] stats Statistics since the module was initialized or
+ *                   the cache was cleared.
+ */
+void bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats);
+
+/**@brief Clear the advertising report deduplication cache.
+ *
+ * @details Use this function to report all advertisements again, for
+ *          example after the filters have been changed. The statistics
+ *          are reset as well. Only available if CONFIG_BT_SCAN_DEDUP is
+ *          enabled.
+ */
+void bt_scan_dedup_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
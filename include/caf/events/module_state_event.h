@@ -275,6 +275,22 @@ static inline bool check_state(const struct module_state_event *event,
 			&MODULE_ID_PTR_VAR(mname);           \
 		})
 
+/** @brief Subscribe a listener to module state events of the given module.
+ *
+ * The listener is notified only about @ref module_state_event submitted by
+ * the module named @p mname.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY} option needs to be enabled.
+ *
+ * @param lname Name of the listener.
+ * @param mname Name of the module.
+ */
+#define MODULE_STATE_EVENT_SUBSCRIBE_MODULE(lname, mname)		\
+	MODULE_ID_PTR_VAR_EXTERN_DEC(mname);				\
+	APP_EVENT_SUBSCRIBE_KEY(lname, module_state_event, &MODULE_ID_PTR_VAR(mname))
+
 
 #ifdef __cplusplus
 }
@@ -30,6 +30,10 @@ struct sensor_data_aggregator_event {
 	uint8_t *buf;
 	enum sensor_state sensor_state;
 	uint8_t sample_cnt;
+	/** Uptime at which the first sample in the buffer was taken, in microseconds.
+	 *  Valid only if sample_cnt is not zero.
+	 */
+	int64_t timestamp;
 };
 
 /** @brief Sensor data aggregator release buffer event.
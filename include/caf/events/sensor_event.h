@@ -81,6 +81,7 @@ struct sensor_event {
 	struct app_event_header header; /**< Event header. */
 
 	const char *descr; /**< Description of the sensor. */
+	int64_t timestamp; /**< Uptime at which the sensor was sampled, in microseconds. */
 	struct event_dyndata dyndata; /**< Sensor data. Provided as floating-point values. */
 };
 
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SENSOR_DATA_AGGREGATOR_H_
+#define _SENSOR_DATA_AGGREGATOR_H_
+
+/**
+ * @file
+ * @defgroup caf_sensor_data_aggregator CAF Sensor Data Aggregator
+ * @{
+ * @brief CAF Sensor Data Aggregator.
+ *
+ * Functions used by the sensor manager to write samples directly into the
+ * aggregator buffers, if :kconfig:option:`CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT`
+ * is enabled.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Reserve space for a sample in the active buffer of an aggregator.
+ *
+ * The sample is written to the returned location and added to the buffer with
+ * @ref sensor_data_aggregator_sample_commit. If the sample is not committed,
+ * the next reservation returns the same location.
+ *
+ * @param[in]  sensor_descr Description of the sensor.
+ * @param[in]  size         Size of the sample in bytes.
+ * @param[out] data         Location of the sample.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT If there is no aggregator for the sensor.
+ * @retval -EBADMSG If the size does not match the aggregator sample size.
+ * @retval -ENOMEM If all buffers of the aggregator are busy.
+ */
+int sensor_data_aggregator_sample_reserve(const char *sensor_descr, size_t size, void **data);
+
+/** @brief Add the reserved sample to the active buffer of an aggregator.
+ *
+ * A sensor_data_aggregator_event is submitted if the buffer is full. The
+ * sample is dropped if the buffer was sent after the reservation, because of
+ * a sensor state change.
+ *
+ * @param[in] sensor_descr Description of the sensor.
+ * @param[in] timestamp    Uptime at which the sample was taken, in microseconds.
+ */
+void sensor_data_aggregator_sample_commit(const char *sensor_descr, int64_t timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _SENSOR_DATA_AGGREGATOR_H_ */
@@ -42,6 +42,25 @@ struct sm_sampled_channel {
 	uint8_t data_cnt;
 };
 
+/**
+ * @brief Description of the sensor hardware FIFO
+ *
+ * The sensor must raise the trigger when the number of samples in the FIFO
+ * reaches the watermark. Every sample fetch must pop one sample from the FIFO,
+ * and return -ENODATA if the FIFO is empty.
+ */
+struct sm_fifo {
+	/** @brief Trigger raised by the sensor when the watermark is reached */
+	struct sensor_trigger trigger;
+	/**
+	 * @brief Number of samples in the FIFO when the trigger is raised
+	 *
+	 * The FIFO is read until it is empty, but at most twice the watermark
+	 * number of samples is read on a trigger.
+	 */
+	uint8_t watermark;
+};
+
 /**
  * @brief Sensor configuration
  *
@@ -95,6 +114,16 @@ struct sm_sensor_config {
 	 * @brief Flag to indicate whether sensor should be suspended or not.
 	 */
 	bool suspend;
+	/**
+	 * @brief Sensor hardware FIFO configuration
+	 *
+	 * If set, the sensor is not sampled periodically. The samples are read
+	 * from the FIFO in batches when the FIFO trigger is raised, and the
+	 * sampling period must match the output data rate of the sensor.
+	 * Used only if the :kconfig:option:`CONFIG_CAF_SENSOR_MANAGER_FIFO`
+	 * option is enabled.
+	 */
+	const struct sm_fifo *fifo;
 };
 
 #ifdef __cplusplus
@@ -20,6 +20,9 @@
 extern "C" {
 #endif
 
+/** Size of the image digest, a SHA-256 hash. */
+#define DFU_TARGET_DIGEST_SIZE 32
+
 enum dfu_target_image_type {
 	DFU_TARGET_IMAGE_TYPE_ANY = 0,
 	DFU_TARGET_IMAGE_TYPE_MCUBOOT = 1,
@@ -42,6 +45,7 @@ struct dfu_target {
 	int (*write)(const void *const buf, size_t len);
 	int (*done)(bool successful);
 	int (*schedule_update)(int img_num);
+	int (*reset)(void);
 };
 
 /**
@@ -111,7 +115,11 @@ int dfu_target_write(const void *const buf, size_t len);
  *			 was aborted.
  *
  * @return 0 for an successful deinitialization or a negative error
- *	   code identicating reason of failure.
+ *	   code identicating reason of failure. -EBADMSG if the digest of the
+ *	   image does not match the expected digest, and -ENODATA if an
+ *	   expected digest is set but the digest of the image was not
+ *	   computed, for example for a resumed download. The target is then
+ *	   deinitialized and the image is erased.
  **/
 int dfu_target_done(bool successful);
 
@@ -124,6 +132,19 @@ int dfu_target_done(bool successful);
  **/
 int dfu_target_reset(void);
 
+/**
+ * @brief Deinitialize the current DFU target and discard the image.
+ *
+ *	  The stored write progress is deleted and the part of the image that
+ *	  was written is erased, so that the next 'dfu_target_init' starts
+ *	  from offset 0. Use it when the image that was partially downloaded
+ *	  can't be resumed, for example because it has changed on the server.
+ *
+ * @return 0 for a successful discard or a negative error
+ *	   code indicating reason of failure.
+ **/
+int dfu_target_discard(void);
+
 /**
  * @brief Schedule update of one or more images.
  *
@@ -138,6 +159,40 @@ int dfu_target_reset(void);
  **/
 int dfu_target_schedule_update(int img_num);
 
+/**
+ * @brief Set the expected digest of the image.
+ *
+ *	  Requires CONFIG_DFU_TARGET_DIGEST. The SHA-256 hash of the image is
+ *	  computed as it is written. If an expected digest is set, it is
+ *	  compared with the computed digest in 'dfu_target_done(true)', and an
+ *	  image with another digest, or an image that could not be hashed, is
+ *	  never scheduled for update.
+ *	  The expected digest is cleared by 'dfu_target_done(true)' and
+ *	  'dfu_target_reset'.
+ *
+ * @param[in] expected Expected digest of DFU_TARGET_DIGEST_SIZE bytes, or
+ *		       NULL to clear it.
+ *
+ * @return 0 on success.
+ **/
+int dfu_target_digest_expect(const uint8_t *expected);
+
+/**
+ * @brief Get the digest of the last image.
+ *
+ *	  Requires CONFIG_DFU_TARGET_DIGEST. The digest is available after
+ *	  'dfu_target_done(true)' if the image was written from its first
+ *	  byte without interruption. It is not available for a download
+ *	  that was resumed after the target was re-initialized.
+ *
+ * @param[out] digest Buffer of DFU_TARGET_DIGEST_SIZE bytes.
+ *
+ * @retval 0 on success.
+ * @retval -ENODATA if no digest is available.
+ * @retval -EINVAL if @p digest is NULL.
+ **/
+int dfu_target_digest_get(uint8_t *digest);
+
 #ifdef __cplusplus
 }
 #endif
@@ -119,6 +119,13 @@ int dfu_target_full_modem_done(bool successful);
  **/
 int dfu_target_full_modem_schedule_update(int img_num);
 
+/**
+ * @brief Discard the image written to the flash device.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_full_modem_reset(void);
+
 #endif /* DFU_TARGET_FULL_MODEM_H__ */
 
 /**@} */
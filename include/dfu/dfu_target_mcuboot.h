@@ -109,6 +109,15 @@ int dfu_target_mcuboot_done(bool successful);
  **/
 int dfu_target_mcuboot_schedule_update(int img_num);
 
+/**
+ * @brief Discard the image written to the secondary slot.
+ *
+ * The stored progress is deleted and the written part of the slot is erased.
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+int dfu_target_mcuboot_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,8 @@ struct dfu_target_stream_init {
 
 	/* Callback invoked upon successful flash write operations. This
 	 * can be used to inspect the actual written data.
+	 * If `CONFIG_DFU_TARGET_STREAM_ASYNC` is set, the callback is invoked
+	 * from the thread that writes to flash.
 	 */
 	stream_flash_callback_t cb;
 };
@@ -82,6 +84,11 @@ int dfu_target_stream_offset_get(size_t *offset);
 /**
  * @brief Write a chunk of firmware data.
  *
+ * If `CONFIG_DFU_TARGET_STREAM_ASYNC` is set, the data is copied and written
+ * to flash by a separate thread. The function then only blocks when all
+ * buffers are waiting to be written, and errors from writing to flash are
+ * returned by the following calls.
+ *
  * @param[in] buf Pointer to data that should be written.
  * @param[in] len Length of data to write.
  *
@@ -99,6 +106,18 @@ int dfu_target_stream_write(const uint8_t *buf, size_t len);
  */
 int dfu_target_stream_done(bool successful);
 
+/**
+ * @brief Discard the data written to the stream.
+ *
+ * The stored progress is deleted, and the flash pages written since
+ * the start of the stream are erased if `CONFIG_STREAM_FLASH_ERASE` is set.
+ * The next call to @ref dfu_target_stream_init starts from offset 0.
+ * Call it after @ref dfu_target_stream_done.
+ *
+ * @return Non-negative value on success, negative errno otherwise.
+ */
+int dfu_target_stream_reset(void);
+
 #endif /* DFU_TARGET_STREAM_H__ */
 
 /**@} */
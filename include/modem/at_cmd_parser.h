@@ -18,6 +18,7 @@
 #include <zephyr/types.h>
 
 #include <modem/at_params.h>
+#include <modem/at_cursor.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -106,6 +107,38 @@ int at_parser_max_params_from_str(const char *at_params_str,
 int at_parser_params_from_str(const char *at_params_str, char **next_param_str,
 			      struct at_param_list *const list);
 
+/**
+ * @brief Index AT command or response parameters in a string.
+ *
+ * This function parses @p at_params_str the same way as
+ * @ref at_parser_params_from_str, but instead of copying the parameters,
+ * it stores their location in @p cursor. No memory is allocated.
+ * Parameter values are decoded when they are read using the cursor
+ * functions, for example @ref at_cursor_int_get.
+ *
+ * @p at_params_str must not be modified or released while @p cursor is used.
+ *
+ * @param at_params_str  AT parameters as a null-terminated string.
+ * @param next_param_str In the case a string contains multiple notifications,
+ *                       the parser will stop parsing when it is done parsing
+ *                       the first notification, and return the remainder of
+ *                       the string in this pointer. The return code will be
+ *                       EAGAIN. If multinotification is not used, this
+ *                       pointer can be set to NULL.
+ * @param cursor         Pointer to a cursor defined using
+ *                       @ref AT_CURSOR_DEFINE. Must not be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EAGAIN New notification detected in string re-run the parser
+ *                 with the string pointed to by @p next_param_str.
+ * @retval -E2BIG  The cursor cannot index all detected parameters in string.
+ *                 The cursor will contain the maximum number of parameters
+ *                 possible.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_cursor_from_str(const char *at_params_str, char **next_param_str,
+			      struct at_cursor *const cursor);
+
 enum at_cmd_type {
 	/** Unknown command, indicates that the actual command type could not
 	 *  be resolved.
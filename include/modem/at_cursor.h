@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file at_cursor.h
+ *
+ * @defgroup at_cursor AT parameter cursor
+ * @ingroup at_cmd_parser
+ * @{
+ * @brief Access to AT command or response parameters without copying them.
+ *
+ * A cursor indexes the parameters of an AT command or response in the
+ * original string. Parameters are not copied and no memory is allocated.
+ * Parameter values are decoded only when they are read.
+ */
+
+#ifndef AT_CURSOR_H__
+#define AT_CURSOR_H__
+
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#include <modem/at_params.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Location of a parameter in the parsed string. */
+struct at_cursor_param {
+	/** Offset of the parameter from the start of the string. */
+	uint16_t offset;
+	/** Length of the parameter. */
+	uint16_t len;
+	/** Parameter type. */
+	uint8_t type;
+};
+
+/**
+ * @brief Cursor over the parameters of an AT command or response.
+ *
+ * The cursor refers to the parsed string, which must not be modified or
+ * released while the cursor is used.
+ */
+struct at_cursor {
+	/** Parsed string. */
+	const char *str;
+	/** Parameter locations. */
+	struct at_cursor_param *params;
+	/** Maximum number of parameters. */
+	size_t param_count;
+	/** Number of parameters found in the string. */
+	size_t count;
+};
+
+/**
+ * @brief Define a cursor that can index up to @p _max_params_count
+ *        parameters.
+ *
+ * The macro can be prefixed with @c static.
+ *
+ * @param _name Name of the cursor.
+ * @param _max_params_count Maximum number of parameters.
+ */
+#define AT_CURSOR_DEFINE(_name, _max_params_count)				\
+	struct at_cursor _name = {						\
+		.params = (struct at_cursor_param[_max_params_count]){ { 0 } },	\
+		.param_count = _max_params_count,				\
+	}
+
+/**
+ * @brief Get the number of parameters found in the parsed string.
+ *
+ * @param[in] cursor Cursor.
+ *
+ * @return Number of parameters.
+ */
+size_t at_cursor_valid_count_get(const struct at_cursor *cursor);
+
+/**
+ * @brief Get the type of a parameter.
+ *
+ * @param[in] cursor Cursor.
+ * @param[in] index  Parameter index.
+ *
+ * @return Parameter type, @c AT_PARAM_TYPE_INVALID if the parameter
+ *         does not exist.
+ */
+enum at_param_type at_cursor_type_get(const struct at_cursor *cursor, size_t index);
+
+/**
+ * @brief Get a parameter value as a signed 16-bit integer.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist, is not an integer or is
+ *                 out of range.
+ */
+int at_cursor_short_get(const struct at_cursor *cursor, size_t index, int16_t *value);
+
+/**
+ * @brief Get a parameter value as an unsigned 16-bit integer.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist, is not an integer or is
+ *                 out of range.
+ */
+int at_cursor_unsigned_short_get(const struct at_cursor *cursor, size_t index,
+				 uint16_t *value);
+
+/**
+ * @brief Get a parameter value as a signed 32-bit integer.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist, is not an integer or is
+ *                 out of range.
+ */
+int at_cursor_int_get(const struct at_cursor *cursor, size_t index, int32_t *value);
+
+/**
+ * @brief Get a parameter value as an unsigned 32-bit integer.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist, is not an integer or is
+ *                 out of range.
+ */
+int at_cursor_unsigned_int_get(const struct at_cursor *cursor, size_t index,
+			       uint32_t *value);
+
+/**
+ * @brief Get a parameter value as a signed 64-bit integer.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist or is not an integer.
+ */
+int at_cursor_int64_get(const struct at_cursor *cursor, size_t index, int64_t *value);
+
+/**
+ * @brief Get a string parameter without copying it.
+ *
+ * The string is not null-terminated.
+ *
+ * @param[in]  cursor Cursor.
+ * @param[in]  index  Parameter index.
+ * @param[out] str    Pointer to the string in the parsed string.
+ * @param[out] len    Length of the string.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Parameter does not exist or is not a string.
+ */
+int at_cursor_string_ptr_get(const struct at_cursor *cursor, size_t index,
+			     const char **str, size_t *len);
+
+/**
+ * @brief Copy a string parameter.
+ *
+ * The string is not null-terminated.
+ *
+ * @param[in]     cursor Cursor.
+ * @param[in]     index  Parameter index.
+ * @param[out]    value  Buffer where the string is copied.
+ * @param[in,out] len    Size of the buffer as input, length of the string as
+ *                       output.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOMEM The buffer is too small.
+ * @retval -EINVAL Parameter does not exist or is not a string.
+ */
+int at_cursor_string_get(const struct at_cursor *cursor, size_t index,
+			 char *value, size_t *len);
+
+/**
+ * @brief Decode an array parameter.
+ *
+ * @param[in]     cursor Cursor.
+ * @param[in]     index  Parameter index.
+ * @param[out]    array  Buffer where the array elements are stored.
+ * @param[in,out] len    Size of the buffer in bytes as input, size of the
+ *                       array in bytes as output.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOMEM The buffer is too small.
+ * @retval -EINVAL Parameter does not exist or is not an array.
+ */
+int at_cursor_array_get(const struct at_cursor *cursor, size_t index,
+			uint32_t *array, size_t *len);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AT_CURSOR_H__ */
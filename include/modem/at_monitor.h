@@ -43,6 +43,12 @@ struct at_monitor_entry {
 	const at_monitor_handler_t handler;
 	/** Whether monitor is paused. */
 	bool paused;
+	/** Index of the monitor filter, assigned by the library. */
+	uint8_t filter_idx;
+#if defined(CONFIG_AT_MONITOR_STATS)
+	/** Maximum latency between reception and dispatch, in microseconds. */
+	uint32_t latency_max_us;
+#endif
 };
 
 /**
@@ -55,6 +61,8 @@ struct at_monitor_isr_entry {
 	const at_monitor_handler_t handler;
 	/** Whether monitor is paused. */
 	bool paused;
+	/** Index of the monitor filter, assigned by the library. */
+	uint8_t filter_idx;
 };
 
 /** Wildcard. Match any notifications. */
@@ -120,6 +128,65 @@ struct at_monitor_isr_entry {
 #define at_monitor_resume(mon) \
 	at_monitor_##mon.paused = 0
 
+/**
+ * @brief Get the maximum dispatch latency of a monitor.
+ *
+ * The latency is measured from the reception of a notification
+ * to its dispatch to monitor @p mon.
+ * Requires @kconfig{CONFIG_AT_MONITOR_STATS}.
+ *
+ * @param mon The monitor.
+ */
+#define at_monitor_latency_max_us(mon) \
+	at_monitor_##mon.latency_max_us
+
+/**
+ * @brief Take a reference to a notification.
+ *
+ * A monitor defined with @ref AT_MONITOR can take a reference to the
+ * notification it receives to keep it after the monitor callback returns,
+ * instead of copying it. The reference must be released with
+ * @ref at_monitor_notif_unref. The notification occupies the AT monitor
+ * buffer until all its references are released, and so do all the
+ * notifications received after it.
+ *
+ * @note Must not be used on notifications received by @ref AT_MONITOR_ISR
+ *	 monitors.
+ *
+ * @param notif The AT notification, as received by the monitor callback.
+ */
+void at_monitor_notif_ref(const char *notif);
+
+/**
+ * @brief Release a reference to a notification.
+ *
+ * @param notif The AT notification, as received by the monitor callback.
+ */
+void at_monitor_notif_unref(const char *notif);
+
+/**
+ * @brief AT monitor buffer statistics.
+ */
+struct at_monitor_stats {
+	/** Number of notifications dropped because the buffer was full. */
+	uint32_t drop_cnt;
+	/** Number of bytes currently used in the buffer. */
+	size_t used;
+	/** Peak number of bytes used in the buffer. */
+	size_t used_max;
+	/** Size of the buffer in bytes. */
+	size_t size;
+};
+
+/**
+ * @brief Get the AT monitor buffer statistics.
+ *
+ * Requires @kconfig{CONFIG_AT_MONITOR_STATS}.
+ *
+ * @param stats Pointer to the structure to fill.
+ */
+void at_monitor_stats_get(struct at_monitor_stats *stats);
+
 /** @} */
 
 #ifdef __cplusplus
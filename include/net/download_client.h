@@ -47,6 +47,9 @@ enum download_client_evt_id {
 	 * - EHOSTDOWN: host went down during download
 	 * - EBADMSG: HTTP response header not as expected
 	 * - E2BIG: HTTP response header could not fit in buffer
+	 * - ECANCELED: the file has changed on the server since the
+	 *   download was checkpointed, the download must be restarted
+	 *   from the beginning
 	 *
 	 * In case of errors on the socket during send() or recv() (ECONNRESET),
 	 * returning zero from the callback will let the library attempt
@@ -157,6 +160,29 @@ struct download_client {
 		bool has_header;
 		/** The server has closed the connection. */
 		bool connection_close;
+		/** Number of range requests waiting for a response. */
+		uint8_t pending;
+		/** Offset of the first byte of the next range request. */
+		size_t req_offset;
+		/** Offset of the end of the current response payload. */
+		size_t resp_end;
+		/** Number of bytes of the next response already received. */
+		size_t carry;
+		/** Offset in the buffer of the bytes of the next response. */
+		size_t carry_off;
+#if CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH > 1
+		/** Request buffer, the response buffer may hold
+		 * bytes of pipelined responses.
+		 */
+		char req_buf[CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE +
+			     CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE + 128];
+#endif
+#if defined(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)
+		/** Validator of the file, ETag or Last-Modified. */
+		char validator[CONFIG_DOWNLOAD_CLIENT_VALIDATOR_SIZE];
+		/** Progress at the last checkpoint. */
+		size_t checkpoint;
+#endif
 	} http;
 
 	struct {
@@ -216,6 +242,10 @@ int download_client_connect(struct download_client *client, const char *host,
  * which are delivered to the application
  * via @ref DOWNLOAD_CLIENT_EVT_FRAGMENT events.
  *
+ * When @kconfig{CONFIG_DOWNLOAD_CLIENT_CHECKPOINT} is enabled and the
+ * download is resumed from the checkpoint of the file, the download fails
+ * with ECANCELED if the file has changed on the server.
+ *
  * @param[in] client	Client instance.
  * @param[in] file	File to download, null-terminated.
  * @param[in] from	Offset from where to resume the download,
@@ -252,6 +282,25 @@ void download_client_resume(struct download_client *client);
  */
 int download_client_file_size_get(struct download_client *client, size_t *size);
 
+/**
+ * @brief Get the offset of the last checkpoint of a file.
+ *
+ * The checkpoint is stored when
+ * @kconfig{CONFIG_DOWNLOAD_CLIENT_CHECKPOINT} is enabled, and it is kept
+ * across resets. Pass the offset to @ref download_client_start to resume
+ * the download. The checkpoint is deleted when the download completes.
+ *
+ * @param[in]  client	Client instance, connected to the host of the file.
+ * @param[in]  file	File name, null-terminated.
+ * @param[out] offset	Offset of the last checkpoint.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL Invalid parameters.
+ * @retval -ENOENT There is no checkpoint for the file.
+ */
+int download_client_checkpoint_get(const struct download_client *client,
+				   const char *file, size_t *offset);
+
 /**
  * @brief Disconnect from the server.
  *
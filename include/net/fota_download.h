@@ -144,6 +144,41 @@ int fota_download_start_with_image_type(const char *host, const char *file,
 			int sec_tag, uint8_t pdn_id, size_t fragment_size,
 			const enum dfu_target_image_type expected_type);
 
+/**@brief Start downloading the given file from the given host. Validate that the
+ * file type and the image digest match the expected ones before starting the
+ * installation.
+ *
+ * The SHA-256 digest of the image is computed while it is written and compared
+ * with @p digest when the download completes. If it does not match, the image
+ * is not scheduled for update, and a @ref FOTA_DOWNLOAD_EVT_ERROR event with
+ * the @ref FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE cause is sent. A download
+ * that is resumed after a reboot cannot be verified, and is rejected the same
+ * way. The rejected image is erased, so the next download starts over.
+ *
+ * Requires @kconfig{CONFIG_DFU_TARGET_DIGEST}.
+ *
+ * @param host Name of host to start downloading from. Can include scheme
+ *             and port number, for example https://google.com:443
+ * @param file Filepath to the file you wish to download. See fota_download_start()
+ *             for details on expected format.
+ * @param sec_tag Security tag you want to use with HTTPS set to -1 to Disable.
+ * @param pdn_id Packet Data Network ID to use for the download, or 0 to use the default.
+ * @param fragment_size Fragment size to be used for the download.
+ *			If 0, @kconfig{CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE} is used.
+ * @param expected_type Type of firmware file to be downloaded and installed.
+ * @param digest Expected digest of DFU_TARGET_DIGEST_SIZE bytes, or NULL to
+ *		 skip the verification.
+ *
+ * @retval 0	     If download has started successfully.
+ * @retval -EALREADY If download is already ongoing.
+ * @retval -ENOTSUP  If a digest is given without CONFIG_DFU_TARGET_DIGEST.
+ *                   Otherwise, a negative value is returned.
+ */
+int fota_download_start_with_digest(const char *host, const char *file,
+			int sec_tag, uint8_t pdn_id, size_t fragment_size,
+			const enum dfu_target_image_type expected_type,
+			const uint8_t *digest);
+
 /**@brief Cancel FOTA image downloading.
  *
  * @retval 0       If FOTA download is cancelled successfully.
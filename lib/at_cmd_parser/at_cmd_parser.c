@@ -13,6 +13,7 @@
 #include <zephyr/types.h>
 
 #include <modem/at_cmd_parser.h>
+#include <modem/at_cursor.h>
 #include "at_utils.h"
 
 #define AT_CMD_MAX_ARRAY_SIZE 32
@@ -37,10 +38,75 @@ enum at_parser_state {
 	CLAC,
 };
 
+/* Destination of the parsed parameters. Exactly one of the members is set. */
+struct at_parse_output {
+	struct at_param_list *list;
+	struct at_cursor *cursor;
+};
+
 static enum at_parser_state state;
 
 static bool set_type_string;
 
+static void cursor_param_put(struct at_cursor *cursor, int index,
+			     enum at_param_type type, const char *str, size_t len)
+{
+	struct at_cursor_param *param = &cursor->params[index];
+	size_t offset = str - cursor->str;
+
+	if ((offset > UINT16_MAX) || (len > UINT16_MAX)) {
+		param->type = AT_PARAM_TYPE_INVALID;
+		return;
+	}
+
+	param->type = type;
+	param->offset = offset;
+	param->len = len;
+
+	cursor->count = MAX(cursor->count, index + 1);
+}
+
+static void param_empty_put(const struct at_parse_output *out, int index,
+			    const char *str)
+{
+	if (out->list) {
+		at_params_empty_put(out->list, index);
+	} else {
+		cursor_param_put(out->cursor, index, AT_PARAM_TYPE_EMPTY, str, 0);
+	}
+}
+
+static void param_int_put(const struct at_parse_output *out, int index,
+			  const char *str, size_t len, int64_t value)
+{
+	if (out->list) {
+		at_params_int_put(out->list, index, value);
+	} else {
+		cursor_param_put(out->cursor, index, AT_PARAM_TYPE_NUM_INT, str, len);
+	}
+}
+
+static void param_string_put(const struct at_parse_output *out, int index,
+			     const char *str, size_t len)
+{
+	if (out->list) {
+		at_params_string_put(out->list, index, str, len);
+	} else {
+		cursor_param_put(out->cursor, index, AT_PARAM_TYPE_STRING, str, len);
+	}
+}
+
+static void param_array_put(const struct at_parse_output *out, int index,
+			    const char *str, size_t len,
+			    const uint32_t *array, size_t array_len)
+{
+	if (out->list) {
+		at_params_array_put(out->list, index, array, array_len);
+	} else {
+		cursor_param_put(out->cursor, index, AT_PARAM_TYPE_ARRAY, str, len);
+	}
+}
+
 static inline void set_new_state(enum at_parser_state new_state)
 {
 	state = new_state;
@@ -178,7 +244,7 @@ static int at_parse_detect_type(const char **str, int index)
 }
 
 static int at_parse_process_element(const char **str, int index,
-				    struct at_param_list *const list)
+				    const struct at_parse_output *out)
 {
 	const char *tmpstr = *str;
 
@@ -193,8 +259,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 	} else if (state == COMMAND) {
 		const char *start_ptr = tmpstr;
 
@@ -204,8 +269,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 
 		/* Skip read/test special characters. */
 		if ((*tmpstr == AT_CMD_SEPARATOR) &&
@@ -216,7 +280,7 @@ static int at_parse_process_element(const char **str, int index,
 		}
 
 	} else if (state == OPTIONAL) {
-		at_params_empty_put(list, index);
+		param_empty_put(out, index, tmpstr);
 
 	} else if (state == STRING) {
 		const char *start_ptr = tmpstr;
@@ -225,8 +289,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 
 		tmpstr++;
 	} else if (state == QUOTED_STRING) {
@@ -236,11 +299,11 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 
 		tmpstr++;
 	} else if (state == ARRAY) {
+		const char *start_ptr = tmpstr;
 		char *next;
 		size_t i = 0;
 		uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
@@ -268,16 +331,18 @@ static int at_parse_process_element(const char **str, int index,
 			}
 		}
 
-		at_params_array_put(list, index, tmparray, i * sizeof(uint32_t));
+		param_array_put(out, index, start_ptr, tmpstr - start_ptr,
+				tmparray, i * sizeof(uint32_t));
 
 		tmpstr++;
 	} else if (state == NUMBER) {
+		const char *start_ptr = tmpstr;
 		char *next;
 		int64_t value = (int64_t)strtoll(tmpstr, &next, 10);
 
 		tmpstr = next;
 
-		at_params_int_put(list, index, value);
+		param_int_put(out, index, start_ptr, tmpstr - start_ptr, value);
 	} else if (state == SMS_PDU) {
 		const char *start_ptr = tmpstr;
 
@@ -285,8 +350,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 	} else if (state == CLAC) {
 		const char *start_ptr = tmpstr;
 
@@ -294,8 +358,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(out, index, start_ptr, tmpstr - start_ptr);
 	}
 
 	*str = tmpstr;
@@ -307,7 +370,7 @@ static int at_parse_process_element(const char **str, int index,
  * Parameters cannot be null. String must be null terminated.
  */
 static int at_parse_param(const char **at_params_str,
-			  struct at_param_list *const list,
+			  const struct at_parse_output *out,
 			  const size_t max_params)
 {
 	int index = 0;
@@ -332,7 +395,7 @@ static int at_parse_param(const char **at_params_str,
 			index = 0;
 		}
 
-		if (at_parse_process_element(&str, index, list) == -1) {
+		if (at_parse_process_element(&str, index, out) == -1) {
 			break;
 		}
 
@@ -352,7 +415,7 @@ static int at_parse_param(const char **at_params_str,
 				}
 
 				if (at_parse_process_element(&str, index,
-							     list) == -1) {
+							     out) == -1) {
 					break;
 				}
 			}
@@ -407,6 +470,9 @@ int at_parser_max_params_from_str(const char *at_params_str,
 				  size_t max_params_count)
 {
 	int err = 0;
+	const struct at_parse_output out = {
+		.list = list,
+	};
 
 	if (at_params_str == NULL || list == NULL || list->params == NULL) {
 		return -EINVAL;
@@ -416,7 +482,31 @@ int at_parser_max_params_from_str(const char *at_params_str,
 
 	max_params_count = MIN(max_params_count, list->param_count);
 
-	err = at_parse_param(&at_params_str, list, max_params_count);
+	err = at_parse_param(&at_params_str, &out, max_params_count);
+
+	if (next_param_str) {
+		*next_param_str = (char *)at_params_str;
+	}
+
+	return err;
+}
+
+int at_parser_cursor_from_str(const char *at_params_str, char **next_param_str,
+			      struct at_cursor *const cursor)
+{
+	int err = 0;
+	const struct at_parse_output out = {
+		.cursor = cursor,
+	};
+
+	if (at_params_str == NULL || cursor == NULL || cursor->params == NULL) {
+		return -EINVAL;
+	}
+
+	cursor->str = at_params_str;
+	cursor->count = 0;
+
+	err = at_parse_param(&at_params_str, &out, cursor->param_count);
 
 	if (next_param_str) {
 		*next_param_str = (char *)at_params_str;
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include <zephyr/types.h>
+
+#include <modem/at_cursor.h>
+#include "at_utils.h"
+
+/* Internal function. Parameter cannot be null. */
+static const struct at_cursor_param *at_cursor_param_get(const struct at_cursor *cursor,
+							 size_t index,
+							 enum at_param_type type)
+{
+	__ASSERT(cursor != NULL, "Cursor cannot be NULL.");
+
+	if ((cursor->params == NULL) || (index >= cursor->count)) {
+		return NULL;
+	}
+
+	if (cursor->params[index].type != type) {
+		return NULL;
+	}
+
+	return &cursor->params[index];
+}
+
+/* Internal function. Parameters cannot be null. */
+static int at_cursor_num_get(const struct at_cursor *cursor, size_t index,
+			     int64_t min, int64_t max, int64_t *value)
+{
+	const struct at_cursor_param *param =
+		at_cursor_param_get(cursor, index, AT_PARAM_TYPE_NUM_INT);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	/* Number is followed by a separator or a line end in the parsed string,
+	 * so decoding stops at the end of the parameter.
+	 */
+	int64_t num = (int64_t)strtoll(cursor->str + param->offset, NULL, 10);
+
+	if ((num > max) || (num < min)) {
+		return -EINVAL;
+	}
+
+	*value = num;
+	return 0;
+}
+
+size_t at_cursor_valid_count_get(const struct at_cursor *cursor)
+{
+	if (cursor == NULL) {
+		return 0;
+	}
+
+	return cursor->count;
+}
+
+enum at_param_type at_cursor_type_get(const struct at_cursor *cursor, size_t index)
+{
+	if ((cursor == NULL) || (cursor->params == NULL) || (index >= cursor->count)) {
+		return AT_PARAM_TYPE_INVALID;
+	}
+
+	return cursor->params[index].type;
+}
+
+int at_cursor_short_get(const struct at_cursor *cursor, size_t index, int16_t *value)
+{
+	int64_t num;
+	int err;
+
+	if (cursor == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_cursor_num_get(cursor, index, INT16_MIN, INT16_MAX, &num);
+	if (!err) {
+		*value = (int16_t)num;
+	}
+
+	return err;
+}
+
+int at_cursor_unsigned_short_get(const struct at_cursor *cursor, size_t index,
+				 uint16_t *value)
+{
+	int64_t num;
+	int err;
+
+	if (cursor == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_cursor_num_get(cursor, index, 0, UINT16_MAX, &num);
+	if (!err) {
+		*value = (uint16_t)num;
+	}
+
+	return err;
+}
+
+int at_cursor_int_get(const struct at_cursor *cursor, size_t index, int32_t *value)
+{
+	int64_t num;
+	int err;
+
+	if (cursor == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_cursor_num_get(cursor, index, INT32_MIN, INT32_MAX, &num);
+	if (!err) {
+		*value = (int32_t)num;
+	}
+
+	return err;
+}
+
+int at_cursor_unsigned_int_get(const struct at_cursor *cursor, size_t index,
+			       uint32_t *value)
+{
+	int64_t num;
+	int err;
+
+	if (cursor == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_cursor_num_get(cursor, index, 0, UINT32_MAX, &num);
+	if (!err) {
+		*value = (uint32_t)num;
+	}
+
+	return err;
+}
+
+int at_cursor_int64_get(const struct at_cursor *cursor, size_t index, int64_t *value)
+{
+	if (cursor == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	return at_cursor_num_get(cursor, index, INT64_MIN, INT64_MAX, value);
+}
+
+int at_cursor_string_ptr_get(const struct at_cursor *cursor, size_t index,
+			     const char **str, size_t *len)
+{
+	if (cursor == NULL || str == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	const struct at_cursor_param *param =
+		at_cursor_param_get(cursor, index, AT_PARAM_TYPE_STRING);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	*str = cursor->str + param->offset;
+	*len = param->len;
+
+	return 0;
+}
+
+int at_cursor_string_get(const struct at_cursor *cursor, size_t index,
+			 char *value, size_t *len)
+{
+	const char *str;
+	size_t str_len;
+	int err;
+
+	if (value == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_cursor_string_ptr_get(cursor, index, &str, &str_len);
+	if (err) {
+		return err;
+	}
+
+	if (*len < str_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, str, str_len);
+	*len = str_len;
+
+	return 0;
+}
+
+int at_cursor_array_get(const struct at_cursor *cursor, size_t index,
+			uint32_t *array, size_t *len)
+{
+	const char *str;
+	const char *end;
+	size_t i = 0;
+	char *next;
+
+	if (cursor == NULL || array == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	const struct at_cursor_param *param =
+		at_cursor_param_get(cursor, index, AT_PARAM_TYPE_ARRAY);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	str = cursor->str + param->offset;
+	end = str + param->len;
+
+	if (*len < sizeof(uint32_t)) {
+		return -ENOMEM;
+	}
+
+	/* Elements are decoded the same way as by at_parser_params_from_str(). */
+	array[i++] = (uint32_t)strtoul(str, &next, 10);
+	str = next;
+
+	while (str < end) {
+		if (is_separator(*str)) {
+			if ((i + 1) * sizeof(uint32_t) > *len) {
+				return -ENOMEM;
+			}
+
+			str++;
+			array[i++] = (uint32_t)strtoul(str, &next, 10);
+
+			if (next == str) {
+				break;
+			}
+
+			str = next;
+		} else {
+			str++;
+		}
+	}
+
+	*len = i * sizeof(uint32_t);
+
+	return 0;
+}
@@ -17,30 +17,395 @@ LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
 struct at_notif_fifo {
 	void *fifo_reserved;
+	/* Number of references to the notification. */
+	atomic_t ref_cnt;
+	/* Number of buffer blocks occupied by the entry. */
+	uint16_t blocks;
+	/* Filters matched by the notification. */
+	uint32_t matched;
+#if defined(CONFIG_AT_MONITOR_STATS)
+	/* Time of reception, in cycles. */
+	uint32_t timestamp;
+#endif
 	char data[];
 };
 
+#define NOTIF_BLOCK_SIZE CONFIG_AT_MONITOR_BUF_BLOCK_SIZE
+#define NOTIF_BLOCK_CNT (CONFIG_AT_MONITOR_HEAP_SIZE / NOTIF_BLOCK_SIZE)
+
+BUILD_ASSERT(NOTIF_BLOCK_SIZE >= sizeof(struct at_notif_fifo),
+	     "Block must fit the notification header");
+BUILD_ASSERT((NOTIF_BLOCK_SIZE % sizeof(void *)) == 0,
+	     "Block size must be a multiple of the pointer size");
+
 static void at_monitor_task(struct k_work *work);
 
 static K_FIFO_DEFINE(at_monitor_fifo);
-static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
+#if defined(CONFIG_AT_MONITOR_WORKQUEUE)
+static K_THREAD_STACK_DEFINE(at_monitor_stack_area, CONFIG_AT_MONITOR_WORKQUEUE_STACK_SIZE);
+static struct k_work_q at_monitor_work_q;
+#endif
+
+/* Notifications are copied to a ring of fixed-size blocks. Entries are
+ * allocated at the head of the ring in the order they are received and
+ * released from its tail once nothing references them. An entry that does
+ * not fit before the end of the ring is preceded by a padding entry taking
+ * up the remaining blocks.
+ */
+static uint8_t notif_buf[NOTIF_BLOCK_CNT][NOTIF_BLOCK_SIZE] __aligned(sizeof(void *));
+static size_t notif_head;
+static size_t notif_tail;
+static size_t notif_used;
+static struct k_spinlock notif_lock;
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+static uint32_t notif_drop_cnt;
+static size_t notif_used_max;
+#endif
+
+/* Filter index of monitors that match any notification. */
+#define FILTER_ANY UINT8_MAX
+
+#if defined(CONFIG_AT_MONITOR_FILTER_TRIE)
+
+/* The filters of all monitors are compiled at initialization into a trie
+ * with failure links (Aho-Corasick automaton). Walking the notification
+ * through the automaton once finds all the filters it contains, which
+ * gives the same result as searching for each filter with strstr().
+ */
+
+/* The root node is never a child of another node, so its index
+ * is used to mark a missing link.
+ */
+#define NODE_NONE 0
+#define FILTER_NONE UINT8_MAX
+
+BUILD_ASSERT(CONFIG_AT_MONITOR_FILTER_TRIE_FILTERS <= 32,
+	     "Matched filters are tracked in a 32-bit mask");
+
+struct filter_node {
+	/* First child node. */
+	uint8_t child;
+	/* Next node having the same parent. */
+	uint8_t sibling;
+	/* Node of the longest proper suffix present in the trie. */
+	uint8_t fail;
+	/* Nearest node terminating a filter, following failure links
+	 * from this node (included).
+	 */
+	uint8_t out;
+	/* Index of the filter terminated by this node. */
+	uint8_t filter;
+	/* Character leading to this node. */
+	char c;
+};
+
+static struct filter_node filter_trie[CONFIG_AT_MONITOR_FILTER_TRIE_NODES];
+static const char *filter_tab[CONFIG_AT_MONITOR_FILTER_TRIE_FILTERS];
+static size_t filter_cnt;
+static size_t node_cnt;
+static bool filter_trie_ready;
+
+static uint8_t filter_trie_child(uint8_t node, char c)
+{
+	for (uint8_t n = filter_trie[node].child; n != NODE_NONE; n = filter_trie[n].sibling) {
+		if (filter_trie[n].c == c) {
+			return n;
+		}
+	}
+
+	return NODE_NONE;
+}
+
+static int filter_trie_add(const char *filter)
+{
+	uint8_t node = 0;
+
+	/* An empty filter matches any notification. */
+	if (*filter == '\0') {
+		return FILTER_ANY;
+	}
+
+	for (size_t i = 0; i < filter_cnt; i++) {
+		if (!strcmp(filter_tab[i], filter)) {
+			return i;
+		}
+	}
+
+	if (filter_cnt == ARRAY_SIZE(filter_tab)) {
+		return -ENOMEM;
+	}
+
+	for (const char *c = filter; *c != '\0'; c++) {
+		uint8_t next = filter_trie_child(node, *c);
+
+		if (next == NODE_NONE) {
+			if (node_cnt == ARRAY_SIZE(filter_trie)) {
+				return -ENOMEM;
+			}
+
+			next = node_cnt++;
+			filter_trie[next].c = *c;
+			filter_trie[next].filter = FILTER_NONE;
+			filter_trie[next].sibling = filter_trie[node].child;
+			filter_trie[node].child = next;
+		}
+
+		node = next;
+	}
+
+	filter_trie[node].filter = filter_cnt;
+	filter_tab[filter_cnt] = filter;
+
+	return filter_cnt++;
+}
+
+static void filter_trie_link(void)
+{
+	uint8_t queue[CONFIG_AT_MONITOR_FILTER_TRIE_NODES];
+	size_t head = 0;
+	size_t tail = 0;
+
+	/* Nodes are visited breadth-first, so that the failure link of a node
+	 * always points to a node that has already been linked.
+	 */
+	for (uint8_t n = filter_trie[0].child; n != NODE_NONE; n = filter_trie[n].sibling) {
+		filter_trie[n].fail = 0;
+		queue[tail++] = n;
+	}
+
+	while (head < tail) {
+		uint8_t node = queue[head++];
+		struct filter_node *fn = &filter_trie[node];
+
+		fn->out = (fn->filter != FILTER_NONE) ? node : filter_trie[fn->fail].out;
+
+		for (uint8_t n = fn->child; n != NODE_NONE; n = filter_trie[n].sibling) {
+			uint8_t fail = fn->fail;
+			uint8_t next;
+
+			while (((next = filter_trie_child(fail, filter_trie[n].c)) == NODE_NONE) &&
+			       (fail != 0)) {
+				fail = filter_trie[fail].fail;
+			}
+
+			filter_trie[n].fail = next;
+			queue[tail++] = n;
+		}
+	}
+}
+
+static int filter_trie_build(void)
+{
+	int idx;
+
+	node_cnt = 1;
+	filter_trie[0].filter = FILTER_NONE;
+
+	STRUCT_SECTION_FOREACH(at_monitor_isr_entry, e) {
+		idx = (e->filter == ANY) ? FILTER_ANY : filter_trie_add(e->filter);
+		if (idx < 0) {
+			return idx;
+		}
+		e->filter_idx = idx;
+	}
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		idx = (e->filter == ANY) ? FILTER_ANY : filter_trie_add(e->filter);
+		if (idx < 0) {
+			return idx;
+		}
+		e->filter_idx = idx;
+	}
+
+	filter_trie_link();
+
+	LOG_DBG("%zu filters compiled into %zu nodes", filter_cnt, node_cnt);
+
+	return 0;
+}
+
+static uint32_t filter_trie_match(const char *notif)
+{
+	uint32_t matched = 0;
+	uint8_t node = 0;
+
+	for (const char *c = notif; *c != '\0'; c++) {
+		uint8_t next;
+
+		while (((next = filter_trie_child(node, *c)) == NODE_NONE) && (node != 0)) {
+			node = filter_trie[node].fail;
+		}
+
+		node = next;
+
+		for (uint8_t n = filter_trie[node].out; n != NODE_NONE;
+		     n = filter_trie[filter_trie[n].fail].out) {
+			matched |= BIT(filter_trie[n].filter);
+		}
+	}
+
+	return matched;
+}
+
+#endif /* CONFIG_AT_MONITOR_FILTER_TRIE */
+
+static uint32_t filters_match(const char *notif)
+{
+#if defined(CONFIG_AT_MONITOR_FILTER_TRIE)
+	if (filter_trie_ready) {
+		return filter_trie_match(notif);
+	}
+#endif
+
+	return 0;
+}
+
+static bool is_monitored(const char *filter, uint8_t filter_idx,
+			 const char *notif, uint32_t matched)
+{
+	if (filter == ANY) {
+		return true;
+	}
+
+#if defined(CONFIG_AT_MONITOR_FILTER_TRIE)
+	if (filter_trie_ready) {
+		return (filter_idx == FILTER_ANY) || (matched & BIT(filter_idx));
+	}
+#endif
+
+	return strstr(notif, filter) != NULL;
+}
+
+static struct at_notif_fifo *notif_alloc(size_t len)
+{
+	struct at_notif_fifo *at_notif;
+	size_t blocks = ceiling_fraction(sizeof(struct at_notif_fifo) + len + sizeof(char),
+					 NOTIF_BLOCK_SIZE);
+	size_t pad = 0;
+	k_spinlock_key_t key = k_spin_lock(&notif_lock);
+
+	if (notif_used == 0) {
+		notif_head = 0;
+		notif_tail = 0;
+	}
+
+	if (notif_head + blocks > NOTIF_BLOCK_CNT) {
+		pad = NOTIF_BLOCK_CNT - notif_head;
+	}
+
+	if (notif_used + pad + blocks > NOTIF_BLOCK_CNT) {
+#if defined(CONFIG_AT_MONITOR_STATS)
+		notif_drop_cnt++;
+#endif
+		k_spin_unlock(&notif_lock, key);
+		return NULL;
+	}
+
+	if (pad > 0) {
+		struct at_notif_fifo *padding = (void *)notif_buf[notif_head];
+
+		atomic_set(&padding->ref_cnt, 0);
+		padding->blocks = pad;
+		notif_used += pad;
+		notif_head = 0;
+	}
+
+	at_notif = (void *)notif_buf[notif_head];
+	atomic_set(&at_notif->ref_cnt, 1);
+	at_notif->blocks = blocks;
+	notif_used += blocks;
+	notif_head = (notif_head + blocks) % NOTIF_BLOCK_CNT;
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+	notif_used_max = MAX(notif_used_max, notif_used);
+#endif
+
+	k_spin_unlock(&notif_lock, key);
+
+	return at_notif;
+}
+
+static void notif_release(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&notif_lock);
+
+	while (notif_used > 0) {
+		struct at_notif_fifo *at_notif = (void *)notif_buf[notif_tail];
+
+		if (atomic_get(&at_notif->ref_cnt) > 0) {
+			break;
+		}
+
+		notif_used -= at_notif->blocks;
+		notif_tail = (notif_tail + at_notif->blocks) % NOTIF_BLOCK_CNT;
+	}
+
+	k_spin_unlock(&notif_lock, key);
+}
+
+void at_monitor_notif_ref(const char *notif)
+{
+	struct at_notif_fifo *at_notif = CONTAINER_OF(notif, struct at_notif_fifo, data);
+
+	__ASSERT_NO_MSG(atomic_get(&at_notif->ref_cnt) > 0);
+
+	atomic_inc(&at_notif->ref_cnt);
+}
+
+void at_monitor_notif_unref(const char *notif)
+{
+	struct at_notif_fifo *at_notif = CONTAINER_OF(notif, struct at_notif_fifo, data);
+
+	__ASSERT_NO_MSG(atomic_get(&at_notif->ref_cnt) > 0);
+
+	if (atomic_dec(&at_notif->ref_cnt) == 1) {
+		notif_release();
+	}
+}
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+void at_monitor_stats_get(struct at_monitor_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&notif_lock);
+
+	stats->drop_cnt = notif_drop_cnt;
+	stats->used = notif_used * NOTIF_BLOCK_SIZE;
+	stats->used_max = notif_used_max * NOTIF_BLOCK_SIZE;
+	stats->size = sizeof(notif_buf);
+
+	k_spin_unlock(&notif_lock, key);
+}
+#endif
+
+static void at_monitor_work_submit(void)
+{
+#if defined(CONFIG_AT_MONITOR_WORKQUEUE)
+	k_work_submit_to_queue(&at_monitor_work_q, &at_monitor_work);
+#else
+	k_work_submit(&at_monitor_work);
+#endif
+}
+
 /* This is not static so that tests can call this function */
 void at_monitor_dispatch(const char *notif)
 {
 	bool monitored;
+	uint32_t matched;
 	struct at_notif_fifo *at_notif;
-	size_t sz_needed;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
+	matched = filters_match(notif);
+
 	/* Dispatch to monitors in ISR, if any.
 	 * There might be non-ISR monitors that are interested
-	 * in the same notification, so copy it to the heap afterwards regardless.
+	 * in the same notification, so copy it to the buffer afterwards regardless.
 	 */
 	STRUCT_SECTION_FOREACH(at_monitor_isr_entry, e) {
-		if (!e->paused && (e->filter == ANY || strstr(notif, e->filter))) {
+		if (!e->paused && is_monitored(e->filter, e->filter_idx, notif, matched)) {
 			LOG_DBG("Dispatching to %p (ISR)", e->handler);
 			e->handler(notif);
 		}
@@ -48,7 +413,7 @@ void at_monitor_dispatch(const char *notif)
 
 	monitored = false;
 	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!e->paused && (e->filter == ANY || strstr(notif, e->filter))) {
+		if (!e->paused && is_monitored(e->filter, e->filter_idx, notif, matched)) {
 			monitored = true;
 			break;
 		}
@@ -58,19 +423,21 @@ void at_monitor_dispatch(const char *notif)
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
-
-	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
+	at_notif = notif_alloc(strlen(notif));
 	if (!at_notif) {
-		LOG_WRN("No heap space for incoming notification: %s",
+		LOG_WRN("No buffer space for incoming notification: %s",
 			log_strdup(notif));
 		return;
 	}
 
+	at_notif->matched = matched;
+#if defined(CONFIG_AT_MONITOR_STATS)
+	at_notif->timestamp = k_cycle_get_32();
+#endif
 	strcpy(at_notif->data, notif);
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
-	k_work_submit(&at_monitor_work);
+	at_monitor_work_submit();
 }
 
 static void at_monitor_task(struct k_work *work)
@@ -81,13 +448,19 @@ static void at_monitor_task(struct k_work *work)
 		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %s", log_strdup(at_notif->data));
 		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!e->paused &&
-			   (e->filter == ANY || strstr(at_notif->data, e->filter))) {
+			if (!e->paused && is_monitored(e->filter, e->filter_idx,
+							at_notif->data, at_notif->matched)) {
 				LOG_DBG("Dispatching to %p", e->handler);
+#if defined(CONFIG_AT_MONITOR_STATS)
+				uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() -
+								       at_notif->timestamp);
+
+				e->latency_max_us = MAX(e->latency_max_us, latency);
+#endif
 				e->handler(at_notif->data);
 			}
 		}
-		k_heap_free(&at_monitor_heap, at_notif);
+		at_monitor_notif_unref(at_notif->data);
 	}
 }
 
@@ -95,6 +468,22 @@ static int at_monitor_sys_init(const struct device *unused)
 {
 	int err;
 
+#if defined(CONFIG_AT_MONITOR_FILTER_TRIE)
+	err = filter_trie_build();
+	if (err) {
+		LOG_WRN("Filters do not fit in the filter table, err %d", err);
+	} else {
+		filter_trie_ready = true;
+	}
+#endif
+
+#if defined(CONFIG_AT_MONITOR_WORKQUEUE)
+	k_work_queue_start(&at_monitor_work_q, at_monitor_stack_area,
+			   K_THREAD_STACK_SIZEOF(at_monitor_stack_area),
+			   CONFIG_AT_MONITOR_WORKQUEUE_PRIORITY, NULL);
+	k_thread_name_set(&at_monitor_work_q.thread, "at_monitor");
+#endif
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
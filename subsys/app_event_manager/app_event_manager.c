@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr.h>
 #include <spinlock.h>
 #include <sys/slist.h>
@@ -19,8 +20,47 @@ static void event_processor_fn(struct k_work *work);
 
 struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIO_QUEUES)
+#define EVENT_QUEUE_CNT APP_EVENT_PRIO_COUNT
+#else
+#define EVENT_QUEUE_CNT 1
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+struct app_event_manager_latency_stats _app_event_manager_latency_stats;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE)
+static K_THREAD_STACK_DEFINE(event_processor_stack_area,
+			     CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE_STACK_SIZE);
+static struct k_work_q event_processor_work_q;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+/* Subscribers of event type with key in subs_table. Subscribers that are not
+ * keyed go first, followed by keyed subscribers sorted by key. Both groups
+ * keep the order in which the subscribers are notified.
+ */
+struct subs_index {
+	app_event_key_fn key_fn;
+	uint16_t start;
+	uint16_t keyed_start;
+	uint16_t end;
+};
+
+static struct subs_index subs_index[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+static const struct event_subscriber *subs_table[CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY_TABLE_SIZE];
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+struct app_event_manager_coalesce_stats _app_event_manager_coalesce_stats;
+
+/* The last queued event of every coalescing event type. */
+static struct app_event_header *coalesce_pending[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+#endif
+
 static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+static sys_slist_t eventq[EVENT_QUEUE_CNT];
 static struct k_spinlock lock;
 
 static bool log_is_event_displayed(const struct event_type *et)
@@ -114,18 +154,23 @@ static void log_event_init(void)
 	}
 }
 
+static void oom_error_handle(void)
+{
+	LOG_ERR("Application Event Manager OOM error\n");
+	__ASSERT_NO_MSG(false);
+	if (IS_ENABLED(CONFIG_REBOOT)) {
+		sys_reboot(SYS_REBOOT_WARM);
+	} else {
+		k_panic();
+	}
+}
+
 void * __weak app_event_manager_alloc(size_t size)
 {
 	void *event = k_malloc(size);
 
 	if (unlikely(!event)) {
-		LOG_ERR("Application Event Manager OOM error\n");
-		__ASSERT_NO_MSG(false);
-		if (IS_ENABLED(CONFIG_REBOOT)) {
-			sys_reboot(SYS_REBOOT_WARM);
-		} else {
-			k_panic();
-		}
+		oom_error_handle();
 		return NULL;
 	}
 
@@ -134,92 +179,528 @@ void * __weak app_event_manager_alloc(size_t size)
 
 void __weak app_event_manager_free(void *addr)
 {
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB) &&
+	    app_event_manager_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
 
-static void event_processor_fn(struct k_work *work)
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+static bool is_slab_block(const struct k_mem_slab *slab, const void *addr)
 {
-	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+	const char *start = slab->buffer;
+	const char *end = start + (slab->num_blocks * slab->block_size);
+
+	return ((const char *)addr >= start) && ((const char *)addr < end);
+}
+
+static void slab_max_used_update(const struct event_type *et)
+{
+	atomic_val_t used = k_mem_slab_num_used_get(et->slab);
+	atomic_val_t max_used;
+
+	do {
+		max_used = atomic_get(&et->slab_stats->max_used);
+		if (used <= max_used) {
+			break;
+		}
+	} while (!atomic_cas(&et->slab_stats->max_used, max_used, used));
+}
 
-	/* Make current event list local. */
+void *app_event_manager_slab_alloc(const struct event_type *et, size_t size)
+{
+	APP_EVENT_ASSERT_ID(et);
+
+	void *event;
+
+	if (et->slab) {
+		__ASSERT_NO_MSG(size <= et->slab->block_size);
+
+		if (!k_mem_slab_alloc(et->slab, &event, K_NO_WAIT)) {
+			slab_max_used_update(et);
+			return event;
+		}
+
+		atomic_inc(&et->slab_stats->fallback_cnt);
+
+		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_FALLBACK_OOM)) {
+			oom_error_handle();
+			return NULL;
+		}
+	}
+
+	return app_event_manager_alloc(size);
+}
+
+bool app_event_manager_slab_free(void *addr)
+{
+	const struct app_event_header *aeh = addr;
+	const struct event_type *et = aeh->type_id;
+
+	APP_EVENT_ASSERT_ID(et);
+
+	if (!et->slab || !is_slab_block(et->slab, addr)) {
+		return false;
+	}
+
+	k_mem_slab_free(et->slab, &addr);
+
+	return true;
+}
+
+int app_event_manager_slab_stats_get(const struct event_type *et,
+				     struct app_event_manager_slab_stats *stats,
+				     uint32_t *used, uint32_t *total)
+{
+	APP_EVENT_ASSERT_ID(et);
+
+	if (!et->slab) {
+		return -ENOTSUP;
+	}
+
+	atomic_set(&stats->max_used, atomic_get(&et->slab_stats->max_used));
+	atomic_set(&stats->fallback_cnt, atomic_get(&et->slab_stats->fallback_cnt));
+	*used = k_mem_slab_num_used_get(et->slab);
+	*total = et->slab->num_blocks;
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_SLAB */
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+void app_event_manager_event_ref(const struct app_event_header *aeh)
+{
+	/* Reference counter is the only field that can be modified by listeners. */
+	atomic_t *ref_cnt = (atomic_t *)&aeh->ref_cnt;
+	atomic_val_t prev = atomic_inc(ref_cnt);
+
+	__ASSERT_NO_MSG(prev > 0);
+	ARG_UNUSED(prev);
+}
+
+void app_event_manager_event_unref(const struct app_event_header *aeh)
+{
+	atomic_t *ref_cnt = (atomic_t *)&aeh->ref_cnt;
+	atomic_val_t prev = atomic_dec(ref_cnt);
+
+	__ASSERT_NO_MSG(prev > 0);
+
+	if (prev == 1) {
+		app_event_manager_free((void *)aeh);
+	}
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT */
+
+static void event_free(struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+	app_event_manager_event_unref(aeh);
+#else
+	app_event_manager_free(aeh);
+#endif
+}
+
+static void event_processor_submit(void)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE)
+	k_work_submit_to_queue(&event_processor_work_q, &event_processor);
+#else
+	k_work_submit(&event_processor);
+#endif
+}
+
+static size_t event_queue_idx(const struct event_type *et)
+{
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIO_QUEUES)) {
+		return app_event_get_type_prio(et);
+	}
+
+	return 0;
+}
+
+static struct app_event_header *event_get(void)
+{
+	sys_snode_t *node = NULL;
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	/* Queues are ordered from the highest priority. */
+	for (size_t i = 0; (i < ARRAY_SIZE(eventq)) && !node; i++) {
+		node = sys_slist_get(&eventq[i]);
+	}
+
+	if (!node) {
 		k_spin_unlock(&lock, key);
-		return;
+		return NULL;
+	}
+
+	struct app_event_header *aeh = CONTAINER_OF(node, struct app_event_header, node);
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	size_t idx = aeh->type_id - _event_type_list_start;
+
+	if (coalesce_pending[idx] == aeh) {
+		coalesce_pending[idx] = NULL;
 	}
+#endif
 
-	sys_slist_merge_slist(&events, &eventq);
+	k_spin_unlock(&lock, key);
+
+	return aeh;
+}
+
+static bool event_pending(void)
+{
+	bool pending = false;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; (i < ARRAY_SIZE(eventq)) && !pending; i++) {
+		pending = !sys_slist_is_empty(&eventq[i]);
+	}
 
 	k_spin_unlock(&lock, key);
 
-	/* Traverse the list of events. */
-	sys_snode_t *node;
-	while (NULL != (node = sys_slist_get(&events))) {
-		struct app_event_header *aeh = CONTAINER_OF(node,
-						       struct app_event_header,
-						       node);
+	return pending;
+}
 
-		APP_EVENT_ASSERT_ID(aeh->type_id);
+static void latency_update(const struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+	struct app_event_manager_latency_stats *stats = &_app_event_manager_latency_stats;
+	uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - aeh->submit_cyc);
+	size_t prio = app_event_get_type_prio(aeh->type_id);
+	size_t bucket = 0;
+
+	while ((bucket < (_APP_EVENT_LATENCY_BUCKET_CNT - 1)) &&
+	       (latency_us >= BIT(bucket))) {
+		bucket++;
+	}
 
-		const struct event_type *et = aeh->type_id;
+	stats->hist[prio][bucket]++;
+	stats->max_us[prio] = MAX(stats->max_us[prio], latency_us);
+#endif
+}
+
+static bool subscriber_notify(const struct event_subscriber *es,
+			      const struct app_event_header *aeh)
+{
+	__ASSERT_NO_MSG(es != NULL);
+
+	const struct event_listener *el = es->listener;
+
+	__ASSERT_NO_MSG(el != NULL);
+	__ASSERT_NO_MSG(el->notification != NULL);
+
+	log_event_progress(aeh->type_id, el);
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
-				h->hook(aeh);
+	bool consumed = el->notification(aeh);
+
+	if (consumed) {
+		log_event_consumed(aeh->type_id);
+	}
+
+	return consumed;
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+static bool is_subscriber_keyed(const struct event_subscriber *es)
+{
+	return es->keyed;
+}
+
+/* Find the first keyed subscriber with key not less than the given one. */
+static size_t subs_key_lower_bound(size_t lo, size_t hi, uintptr_t key)
+{
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (subs_table[mid]->key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void keyed_subscribers_notify(const struct subs_index *si,
+				     const struct app_event_header *aeh)
+{
+	uintptr_t key = si->key_fn(aeh);
+	size_t w = si->start;
+	size_t k = subs_key_lower_bound(si->keyed_start, si->end, key);
+	bool consumed = false;
+
+	/* Merge both groups of subscribers according to the notification order.
+	 * Subscribers are placed in the array by linker, so the order is the
+	 * same as the order of the addresses.
+	 */
+	while (!consumed) {
+		bool w_valid = (w < si->keyed_start);
+		bool k_valid = ((k < si->end) && (subs_table[k]->key == key));
+		const struct event_subscriber *es;
+
+		if (w_valid && (!k_valid || (subs_table[w] < subs_table[k]))) {
+			es = subs_table[w++];
+		} else if (k_valid) {
+			es = subs_table[k++];
+		} else {
+			break;
+		}
+
+		consumed = subscriber_notify(es, aeh);
+	}
+}
+
+static int subs_table_add(const struct event_subscriber *es, size_t *cnt)
+{
+	if (*cnt >= ARRAY_SIZE(subs_table)) {
+		LOG_ERR("Subscriber lookup table too small");
+		return -ENOMEM;
+	}
+
+	subs_table[(*cnt)++] = es;
+
+	return 0;
+}
+
+static int subs_index_build(void)
+{
+	size_t cnt = 0;
+	int err;
+
+	STRUCT_SECTION_FOREACH(event_type_key, etk) {
+		APP_EVENT_ASSERT_ID(etk->type);
+
+		const struct event_type *et = etk->type;
+		struct subs_index *si = &subs_index[et - _event_type_list_start];
+
+		__ASSERT_NO_MSG(etk->key_fn != NULL);
+		si->key_fn = etk->key_fn;
+		si->start = cnt;
+
+		for (const struct event_subscriber *es = et->subs_start;
+		     es != et->subs_stop;
+		     es++) {
+			if (!is_subscriber_keyed(es)) {
+				err = subs_table_add(es, &cnt);
+				if (err) {
+					return err;
+				}
 			}
 		}
 
-		log_event(aeh);
+		si->keyed_start = cnt;
 
-		bool consumed = false;
+		/* Insertion sort keeps the notification order for equal keys. */
+		for (const struct event_subscriber *es = et->subs_start;
+		     es != et->subs_stop;
+		     es++) {
+			if (!is_subscriber_keyed(es)) {
+				continue;
+			}
+
+			size_t pos = cnt;
+
+			err = subs_table_add(es, &cnt);
+			if (err) {
+				return err;
+			}
+
+			while ((pos > si->keyed_start) && (subs_table[pos - 1]->key > es->key)) {
+				subs_table[pos] = subs_table[pos - 1];
+				pos--;
+			}
+			subs_table[pos] = es;
+		}
+
+		si->end = cnt;
+	}
+
+	/* Keyed subscribers can be used only by the event types providing key. */
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		if (subs_index[et - _event_type_list_start].key_fn) {
+			continue;
+		}
 
 		for (const struct event_subscriber *es = et->subs_start;
-		     (es != et->subs_stop) && !consumed;
+		     es != et->subs_stop;
 		     es++) {
+			if (is_subscriber_keyed(es)) {
+				LOG_ERR("Event %s has no key defined", et->name);
+				return -EINVAL;
+			}
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY */
+
+static void subscribers_notify(const struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+	const struct subs_index *si = &subs_index[et - _event_type_list_start];
+
+	if (si->key_fn) {
+		keyed_subscribers_notify(si, aeh);
+		return;
+	}
+#endif
+
+	bool consumed = false;
+
+	for (const struct event_subscriber *es = et->subs_start;
+	     (es != et->subs_stop) && !consumed;
+	     es++) {
+		consumed = subscriber_notify(es, aeh);
+	}
+}
 
-			__ASSERT_NO_MSG(es != NULL);
+static void event_process(struct app_event_header *aeh)
+{
+	APP_EVENT_ASSERT_ID(aeh->type_id);
 
-			const struct event_listener *el = es->listener;
+	latency_update(aeh);
 
-			__ASSERT_NO_MSG(el != NULL);
-			__ASSERT_NO_MSG(el->notification != NULL);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	if (app_event_get_type_flag(aeh->type_id, APP_EVENT_TYPE_FLAGS_COALESCE)) {
+		_app_event_manager_coalesce_stats.dispatched[aeh->type_id - _event_type_list_start]++;
+	}
+#endif
 
-			log_event_progress(et, el);
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
+			h->hook(aeh);
+		}
+	}
+
+	log_event(aeh);
 
-			consumed = el->notification(aeh);
+	subscribers_notify(aeh);
 
-			if (consumed) {
-				log_event_consumed(et);
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
+			h->hook(aeh);
+		}
+	}
+
+	event_free(aeh);
+}
+
+static void event_processor_fn(struct k_work *work)
+{
+	struct app_event_header *aeh;
+	size_t cnt = 0;
+
+	/* Events are taken one by one to let events of higher priority
+	 * that were submitted in the meantime overtake the queued ones.
+	 */
+	while (NULL != (aeh = event_get())) {
+		event_process(aeh);
+		cnt++;
+
+		if ((CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET > 0) &&
+		    (cnt >= CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET)) {
+			/* Let other work items run. */
+			if (event_pending()) {
+				event_processor_submit();
 			}
+			break;
 		}
+	}
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+/* Find queued event that can be replaced by the submitted one. Must be called under lock. */
+static struct app_event_header *coalesce_target_find(const struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+	size_t idx = et - _event_type_list_start;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+	app_event_key_fn key_fn = subs_index[idx].key_fn;
+
+	/* Only an event with the same key can be replaced. */
+	if (key_fn) {
+		uintptr_t key = key_fn(aeh);
+		struct app_event_header *queued;
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
-				h->hook(aeh);
+		SYS_SLIST_FOR_EACH_CONTAINER(&eventq[event_queue_idx(et)], queued, node) {
+			if ((queued->type_id == et) && (key_fn(queued) == key)) {
+				return queued;
 			}
 		}
 
-		app_event_manager_free(aeh);
+		return NULL;
+	}
+#endif
+
+	return coalesce_pending[idx];
+}
+
+/* Replace data of a queued event of the same type. Must be called under lock.
+ *
+ * The queued event keeps its place in the queue and its header.
+ */
+static bool event_coalesce(struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+
+	if (!app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_COALESCE)) {
+		return false;
 	}
+
+	size_t idx = et - _event_type_list_start;
+	struct app_event_header *target = coalesce_target_find(aeh);
+
+	if (!target) {
+		coalesce_pending[idx] = aeh;
+		return false;
+	}
+
+	memcpy((uint8_t *)target + sizeof(*target),
+	       (const uint8_t *)aeh + sizeof(*aeh),
+	       et->struct_size - sizeof(*aeh));
+	_app_event_manager_coalesce_stats.coalesced[idx]++;
+
+	return true;
 }
+#endif /* CONFIG_APP_EVENT_MANAGER_COALESCE */
 
 void _event_submit(struct app_event_header *aeh)
 {
 	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+	aeh->submit_cyc = k_cycle_get_32();
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	if (event_coalesce(aeh)) {
+		k_spin_unlock(&lock, key);
+		/* Queued event was updated, the submitted one is no longer needed. */
+		event_free(aeh);
+		return;
+	}
+#endif
+
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
 		STRUCT_SECTION_FOREACH(event_submit_hook, h) {
 			h->hook(aeh);
 		}
 	}
-	sys_slist_append(&eventq, &aeh->node);
+	sys_slist_append(&eventq[event_queue_idx(aeh->type_id)], &aeh->node);
 	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	event_processor_submit();
 }
 
 int app_event_manager_init(void)
@@ -231,6 +712,25 @@ int app_event_manager_init(void)
 
 	log_event_init();
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+	ret = subs_index_build();
+	if (ret) {
+		return ret;
+	}
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE)
+	k_work_queue_start(&event_processor_work_q, event_processor_stack_area,
+			   K_THREAD_STACK_SIZEOF(event_processor_stack_area),
+			   CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE_PRIORITY, NULL);
+	k_thread_name_set(&event_processor_work_q.thread, "app_event_manager");
+
+	/* Process events submitted before the work queue was started. */
+	if (event_pending()) {
+		event_processor_submit();
+	}
+#endif
+
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTINIT_HOOK)) {
 		STRUCT_SECTION_FOREACH(app_event_manager_postinit_hook, h) {
 			ret = h->hook();
@@ -117,10 +117,48 @@ extern "C" {
 	}
 
 
+/* Subscribe a listener to events with the given key. */
+#define _APP_EVENT_SUBSCRIBE_KEY(lname, ename, prio, k)					\
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY),		\
+		     "Enable APP_EVENT_MANAGER_SUBSCRIBE_KEY before usage");		\
+	const struct event_subscriber _CONCAT(_CONCAT(_CONCAT(__event_subscriber_, ename),\
+		lname), _CONCAT(_key, __COUNTER__))					\
+	__used __aligned(__alignof(struct event_subscriber))				\
+	__attribute__((__section__(_APP_EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)))) = {\
+		.listener = &_CONCAT(__event_listener_, lname),				\
+		.key = (uintptr_t)(k),							\
+		.keyed = true,								\
+	}
+
+
+/* Register function returning the key of event. */
+#define _APP_EVENT_TYPE_KEY_DEFINE(ename, kfn)						\
+	STRUCT_SECTION_ITERABLE(event_type_key, _CONCAT(__event_type_key_, ename)) = {	\
+		.type = _EVENT_ID(ename),						\
+		.key_fn = (kfn),							\
+	}
+
+
 /* Pointer to event type definition is used as event type identifier. */
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Allocate memory for an event of the given ename type. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+#define _APP_EVENT_ALLOC(ename, size) app_event_manager_slab_alloc(_EVENT_ID(ename), (size))
+#else
+#define _APP_EVENT_ALLOC(ename, size) app_event_manager_alloc(size)
+#endif
+
+
+/* Initialize reference counter of a newly allocated event. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+#define _APP_EVENT_REF_CNT_INIT(aeh) atomic_set(&(aeh)->ref_cnt, 1)
+#else
+#define _APP_EVENT_REF_CNT_INIT(aeh)
+#endif
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -129,11 +167,12 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(void)			\
 	{									\
 		struct ename *event =						\
-			(struct ename *)app_event_manager_alloc(sizeof(*event));\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,		\
 				 "");						\
 		if (event != NULL) {						\
 			event->header.type_id = _EVENT_ID(ename);		\
+			_APP_EVENT_REF_CNT_INIT(&event->header);		\
 		}								\
 		return event;							\
 	}
@@ -155,6 +194,7 @@ extern "C" {
 				 "");							\
 		if (event != NULL) {							\
 			event->header.type_id = _EVENT_ID(ename);			\
+			_APP_EVENT_REF_CNT_INIT(&event->header);			\
 			event->dyndata.size = size;					\
 		}									\
 		return event;								\
@@ -221,6 +261,50 @@ extern "C" {
 #define _APP_EVENT_TYPE_DEFINE_SIZES(ename)
 #endif
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+#define _APP_EVENT_SLAB_NAME(ename) _CONCAT(__event_slab_, ename)
+#define _APP_EVENT_SLAB_STATS_NAME(ename) _CONCAT(__event_slab_stats_, ename)
+
+/* Additional level of indirection is needed to expand the slab name before
+ * it is concatenated by K_MEM_SLAB_DEFINE.
+ */
+#define _APP_EVENT_MEM_SLAB_DEFINE(name, block_size, block_cnt, align) \
+	K_MEM_SLAB_DEFINE(name, block_size, block_cnt, align)
+
+/* Events with dynamic data cannot be allocated from a slab, for those slab has no blocks. */
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)						\
+	_APP_EVENT_MEM_SLAB_DEFINE(_APP_EVENT_SLAB_NAME(ename),				\
+		sizeof(struct ename),							\
+		((_CONCAT(ename, _HAS_DYNDATA)) ?					\
+			0 : CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT),		\
+		__alignof(struct ename));						\
+	static struct app_event_manager_slab_stats _APP_EVENT_SLAB_STATS_NAME(ename)
+
+#define _APP_EVENT_TYPE_DEFINE_SLAB_FIELDS(ename)					\
+	.slab = ((_CONCAT(ename, _HAS_DYNDATA)) ?					\
+			NULL : &_APP_EVENT_SLAB_NAME(ename)),				\
+	.slab_stats = &_APP_EVENT_SLAB_STATS_NAME(ename),
+#else
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)
+#define _APP_EVENT_TYPE_DEFINE_SLAB_FIELDS(ename)
+#endif
+
+/** @brief Event dispatch priority.
+ */
+enum app_event_prio {
+	/** Events dispatched before all other events. */
+	APP_EVENT_PRIO_HIGH,
+
+	/** Default priority of the event. */
+	APP_EVENT_PRIO_NORMAL,
+
+	/** Events dispatched when there are no other events pending. */
+	APP_EVENT_PRIO_LOW,
+
+	/** Number of event priorities. */
+	APP_EVENT_PRIO_COUNT
+};
+
 /** @brief Event header.
  *
  * When defining an event structure, the application event header
@@ -232,6 +316,16 @@ struct app_event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+	/** Cycle counter value on event submission. */
+	uint32_t submit_cyc;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+	/** Number of references to the event. */
+	atomic_t ref_cnt;
+#endif
 };
 
 /** Function to log data from this event. */
@@ -264,6 +358,16 @@ typedef	int (*log_event_data_dep)(const struct app_event_header *aeh,
 #define _APP_EVENT_TYPE_DEFINE_LOG_FUN(log_fun) .log_event_func = log_fun,
 #endif
 
+/** @brief Statistics of the memory slab of an event type.
+ */
+struct app_event_manager_slab_stats {
+	/** Maximum number of slab blocks used at the same time. */
+	atomic_t max_used;
+
+	/** Number of events allocated outside of the slab because it was exhausted. */
+	atomic_t fallback_cnt;
+};
+
 /** @brief Event type.
  */
 struct event_type {
@@ -294,6 +398,14 @@ struct event_type {
 	/** The size of the event structure */
 	uint16_t struct_size;
 #endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+	/** Memory slab used to allocate events, NULL for events with dynamic data. */
+	struct k_mem_slab *slab;
+
+	/** Statistics of the memory slab. */
+	struct app_event_manager_slab_stats *slab_stats;
+#endif
 };
 
 
@@ -305,7 +417,14 @@ extern struct event_type _event_type_list_end[];
 	BUILD_ASSERT(((et_flags) & ((BIT_MASK(APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START-	\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START))<<					\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START)) == 0);				\
+	BUILD_ASSERT(!((et_flags) & BIT(APP_EVENT_TYPE_FLAGS_COALESCE)) ||		\
+		     !_CONCAT(ename, _HAS_DYNDATA),					\
+		     "Events with dynamic data cannot be coalesced");			\
+	BUILD_ASSERT(!((et_flags) & BIT(APP_EVENT_TYPE_FLAGS_PRIO_HIGH)) ||		\
+		     !((et_flags) & BIT(APP_EVENT_TYPE_FLAGS_PRIO_LOW)),		\
+		     "Event type cannot have both high and low priority");	\
 	_APP_EVENT_SUBSCRIBERS_ARRAY_TAGS(ename);					\
+	_APP_EVENT_TYPE_DEFINE_SLAB(ename);						\
 	STRUCT_SECTION_ITERABLE(event_type, _CONCAT(__event_type_, ename)) = {		\
 		.name            = STRINGIFY(ename),					\
 		.subs_start      = _APP_EVENT_SUBSCRIBERS_START_TAG(ename),		\
@@ -317,6 +436,7 @@ extern struct event_type _event_type_list_end[];
 				((et_flags) | BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) :	\
 				((et_flags) & (~BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)))),\
 		_APP_EVENT_TYPE_DEFINE_SIZES(ename) /* No comma here intentionally */	\
+		_APP_EVENT_TYPE_DEFINE_SLAB_FIELDS(ename) /* No comma here intentionally */\
 	}
 
 /**
@@ -328,6 +448,29 @@ struct app_event_manager_event_display_bm {
 
 extern struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
+/* Latency histogram buckets are powers of two microseconds, the last one gathers the rest. */
+#define _APP_EVENT_LATENCY_BUCKET_CNT 12
+
+/**
+ * @brief Event dispatch latency histogram for every event priority.
+ */
+struct app_event_manager_latency_stats {
+	uint32_t hist[APP_EVENT_PRIO_COUNT][_APP_EVENT_LATENCY_BUCKET_CNT];
+	uint32_t max_us[APP_EVENT_PRIO_COUNT];
+};
+
+extern struct app_event_manager_latency_stats _app_event_manager_latency_stats;
+
+/**
+ * @brief Number of dispatched and coalesced events of every event type.
+ */
+struct app_event_manager_coalesce_stats {
+	uint32_t dispatched[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+	uint32_t coalesced[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+};
+
+extern struct app_event_manager_coalesce_stats _app_event_manager_coalesce_stats;
+
 
 /* Event hooks subscribers */
 #define _APP_EVENT_HOOK_REGISTER(section, hook_fn, prio)           \
@@ -397,6 +540,34 @@ struct event_listener {
 struct event_subscriber {
 	/** Pointer to the listener. */
 	const struct event_listener *listener;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+	/** Key of events the listener is interested in. */
+	uintptr_t key;
+
+	/** True if the listener is notified only about events with matching key. */
+	bool keyed;
+#endif
+};
+
+
+/** @brief Function returning key of the event.
+ *
+ * Key is used to select listeners subscribed with @ref APP_EVENT_SUBSCRIBE_KEY.
+ */
+typedef uintptr_t (*app_event_key_fn)(const struct app_event_header *aeh);
+
+
+/** @brief Event type key.
+ *
+ * All event type keys must be defined using @ref APP_EVENT_TYPE_KEY_DEFINE.
+ */
+struct event_type_key {
+	/** Pointer to the event type. */
+	const struct event_type *type;
+
+	/** Function returning key of the event. */
+	app_event_key_fn key_fn;
 };
 
 
@@ -62,6 +62,15 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 			const struct event_listener *el = es->listener;
 
 			__ASSERT_NO_MSG(el != NULL);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+			if (es->keyed) {
+				shell_fprintf(shell, SHELL_NORMAL,
+					      "|\t[E:%s] -> [L:%s] key:0x%lx\n",
+					      et->name, el->name, (unsigned long)es->key);
+				is_subscribed = true;
+				continue;
+			}
+#endif
 			shell_fprintf(shell, SHELL_NORMAL,
 					"|\t[E:%s] -> [L:%s]\n",
 				et->name, el->name);
@@ -81,6 +90,93 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+static int show_slab_stats(const struct shell *shell, size_t argc,
+			   char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Event slabs (used/total, max used, fallbacks):\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		struct app_event_manager_slab_stats stats;
+		uint32_t used;
+		uint32_t total;
+
+		if (app_event_manager_slab_stats_get(et, &stats, &used, &total)) {
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|	[E:%s] not allocated from slab\n", et->name);
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|	[E:%s] %u/%u, %ld, %ld\n",
+			      et->name, used, total,
+			      (long)atomic_get(&stats.max_used),
+			      (long)atomic_get(&stats.fallback_cnt));
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_SLAB */
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+static int show_latency(const struct shell *shell, size_t argc,
+			char **argv)
+{
+	static const char * const prio_names[] = {
+		[APP_EVENT_PRIO_HIGH] = "high",
+		[APP_EVENT_PRIO_NORMAL] = "normal",
+		[APP_EVENT_PRIO_LOW] = "low",
+	};
+	const struct app_event_manager_latency_stats *stats =
+		&_app_event_manager_latency_stats;
+
+	BUILD_ASSERT(ARRAY_SIZE(prio_names) == APP_EVENT_PRIO_COUNT);
+
+	shell_fprintf(shell, SHELL_NORMAL, "Dispatch latency:\n");
+
+	for (size_t prio = 0; prio < APP_EVENT_PRIO_COUNT; prio++) {
+		shell_fprintf(shell, SHELL_NORMAL, "|\t[P:%s] max %u us\n",
+			      prio_names[prio], stats->max_us[prio]);
+
+		for (size_t i = 0; i < _APP_EVENT_LATENCY_BUCKET_CNT; i++) {
+			if (i < (_APP_EVENT_LATENCY_BUCKET_CNT - 1)) {
+				shell_fprintf(shell, SHELL_NORMAL, "|\t\t< %lu us:\t%u\n",
+					      BIT(i), stats->hist[prio][i]);
+			} else {
+				shell_fprintf(shell, SHELL_NORMAL, "|\t\t>= %lu us:\t%u\n",
+					      BIT(i - 1), stats->hist[prio][i]);
+			}
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS */
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+static int show_coalesce_stats(const struct shell *shell, size_t argc,
+			       char **argv)
+{
+	const struct app_event_manager_coalesce_stats *stats =
+		&_app_event_manager_coalesce_stats;
+
+	shell_fprintf(shell, SHELL_NORMAL, "Coalesced events (dispatched, coalesced):\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		size_t ev_id = et - _event_type_list_start;
+
+		if (!app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_COALESCE)) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "|\t[E:%s] %u, %u\n",
+			      et->name, stats->dispatched[ev_id], stats->coalesced[ev_id]);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_COALESCE */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -155,6 +251,18 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	SHELL_CMD_ARG(show_coalesce_stats, NULL, "Show coalesced event statistics",
+		      show_coalesce_stats, 0, 0),
+#endif
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_LATENCY_STATS)
+	SHELL_CMD_ARG(show_latency, NULL, "Show event dispatch latency histograms",
+		      show_latency, 0, 0),
+#endif
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+	SHELL_CMD_ARG(show_slab_stats, NULL, "Show event slab statistics",
+		      show_slab_stats, 0, 0),
+#endif
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
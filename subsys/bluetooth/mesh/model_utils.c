@@ -123,6 +123,15 @@ int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		    struct net_buf_simple *buf,
 		    struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
 		    void *user_data)
+{
+	return model_ackd_send_paged(model, ctx, buf, ack, rsp_op, user_data, 1);
+}
+
+int model_ackd_send_paged(struct bt_mesh_model *model,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct net_buf_simple *buf,
+			  struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
+			  void *user_data, uint32_t pages)
 {
 	if (ack &&
 	    bt_mesh_msg_ack_ctx_prepare(ack, rsp_op, ctx ? ctx->addr : model->pub->addr,
@@ -136,7 +145,8 @@ int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		if (retval == 0) {
 			uint8_t ttl = (ctx ? ctx->send_ttl : model->pub->ttl);
 			int32_t time = (CONFIG_BT_MESH_MOD_ACKD_TIMEOUT_BASE +
-				ttl * CONFIG_BT_MESH_MOD_ACKD_TIMEOUT_PER_HOP);
+				ttl * CONFIG_BT_MESH_MOD_ACKD_TIMEOUT_PER_HOP) *
+				pages;
 			return bt_mesh_msg_ack_ctx_wait(ack, K_MSEC(time));
 		}
 
@@ -74,6 +74,29 @@ int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		    struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
 		    void *user_data);
 
+/** @brief Send a message with a response that may span several messages.
+ *
+ * Works like @ref model_ackd_send, but the timeout is multiplied by the number
+ * of response messages (pages) that are expected. The response context must
+ * only be released when the last page has been received.
+ *
+ * @param model Model to send the message on.
+ * @param ctx Message context, or NULL to send with the configured publish
+ * parameters.
+ * @param buf Message to send.
+ * @param ack Message response context, or NULL if no response is expected.
+ * @param rsp_op Expected response opcode.
+ * @param user_data User defined parameter.
+ * @param pages Maximum number of response messages expected.
+ *
+ * @return See @ref model_ackd_send.
+ */
+int model_ackd_send_paged(struct bt_mesh_model *model,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct net_buf_simple *buf,
+			  struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
+			  void *user_data, uint32_t pages);
+
 /** @brief Compare the TID of an incoming message with the previous
  * transaction, and update it if it's new.
  *
@@ -378,19 +378,112 @@ static bool convert_scheduler_time_to_tm(struct tm *sched_time,
 	return stage == FINAL_STAGE;
 }
 
-static uint8_t get_least_time_index(struct bt_mesh_scheduler_srv *srv)
+static bool sched_before(struct bt_mesh_scheduler_srv *srv, uint8_t a,
+			 uint8_t b)
+{
+	if (srv->sched_tai[a].sec != srv->sched_tai[b].sec) {
+		return srv->sched_tai[a].sec < srv->sched_tai[b].sec;
+	}
+
+	return a < b;
+}
+
+static void heap_set(struct bt_mesh_scheduler_srv *srv, uint8_t pos,
+		     uint8_t idx)
+{
+	srv->heap[pos] = idx;
+	srv->heap_pos[idx] = pos;
+}
+
+static void heap_sift_up(struct bt_mesh_scheduler_srv *srv, uint8_t pos)
+{
+	uint8_t idx = srv->heap[pos];
+
+	while (pos > 0) {
+		uint8_t parent = (pos - 1) / 2;
+
+		if (!sched_before(srv, idx, srv->heap[parent])) {
+			break;
+		}
+
+		heap_set(srv, pos, srv->heap[parent]);
+		pos = parent;
+	}
+
+	heap_set(srv, pos, idx);
+}
+
+static void heap_sift_down(struct bt_mesh_scheduler_srv *srv, uint8_t pos)
 {
-	uint8_t cnt = u32_count_trailing_zeros(srv->active_bitmap);
-	uint8_t idx = cnt;
+	uint8_t idx = srv->heap[pos];
 
-	while (++cnt < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
-		if (srv->active_bitmap & BIT(cnt)) {
-			idx = srv->sched_tai[idx].sec >
-				srv->sched_tai[cnt].sec ? cnt : idx;
+	while (2 * pos + 1 < srv->heap_len) {
+		uint8_t child = 2 * pos + 1;
+
+		if (child + 1 < srv->heap_len &&
+		    sched_before(srv, srv->heap[child + 1], srv->heap[child])) {
+			child++;
 		}
+
+		if (!sched_before(srv, srv->heap[child], idx)) {
+			break;
+		}
+
+		heap_set(srv, pos, srv->heap[child]);
+		pos = child;
+	}
+
+	heap_set(srv, pos, idx);
+}
+
+static void heap_clear(struct bt_mesh_scheduler_srv *srv)
+{
+	srv->heap_len = 0;
+	memset(srv->heap_pos, BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT,
+	       sizeof(srv->heap_pos));
+}
+
+/* Insert the entry into the heap, or move it to its new position if its
+ * calculated time has changed.
+ */
+static void heap_update(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+{
+	uint8_t pos = srv->heap_pos[idx];
+
+	if (pos == BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
+		pos = srv->heap_len++;
+		heap_set(srv, pos, idx);
+	}
+
+	heap_sift_up(srv, pos);
+	heap_sift_down(srv, srv->heap_pos[idx]);
+}
+
+static void heap_remove(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+{
+	uint8_t pos = srv->heap_pos[idx];
+
+	if (pos == BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
+		return;
 	}
 
-	return MIN(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT, idx);
+	srv->heap_pos[idx] = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+	srv->heap_len--;
+
+	if (pos == srv->heap_len) {
+		return;
+	}
+
+	uint8_t moved = srv->heap[srv->heap_len];
+
+	heap_set(srv, pos, moved);
+	heap_sift_up(srv, pos);
+	heap_sift_down(srv, srv->heap_pos[moved]);
+}
+
+static uint8_t get_least_time_index(struct bt_mesh_scheduler_srv *srv)
+{
+	return srv->heap_len ? srv->heap[0] : BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 }
 
 static void run_scheduler(struct bt_mesh_scheduler_srv *srv)
@@ -400,6 +493,8 @@ static void run_scheduler(struct bt_mesh_scheduler_srv *srv)
 	uint8_t planned_idx = get_least_time_index(srv);
 
 	if (planned_idx == BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
+		/* Disable the timer handler if there are no active entries. */
+		srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 		return;
 	}
 
@@ -419,21 +514,31 @@ static void run_scheduler(struct bt_mesh_scheduler_srv *srv)
 			scheduled_uptime, current_uptime);
 }
 
-static void schedule_action(struct bt_mesh_scheduler_srv *srv,
-			    uint8_t idx)
+static bool is_entry_schedulable(struct bt_mesh_scheduler_srv *srv,
+				 uint8_t idx)
 {
-	struct tm sched_time = {0};
-	struct bt_mesh_schedule_entry *entry = &srv->sch_reg[idx];
+	return srv->sch_reg[idx].action < BT_MESH_SCHEDULER_SCENE_RECALL ||
+	       (srv->sch_reg[idx].action == BT_MESH_SCHEDULER_SCENE_RECALL &&
+		srv->sch_reg[idx].scene_number != 0);
+}
 
+static bool local_time_get(struct bt_mesh_scheduler_srv *srv,
+			   struct tm *current_local)
+{
 	int64_t current_uptime = k_uptime_get();
-	struct tm *current_local = bt_mesh_time_srv_localtime(srv->time_srv,
+	struct tm *local = bt_mesh_time_srv_localtime(srv->time_srv,
 			current_uptime);
 
-	if (current_local == NULL) {
+	if (local == NULL) {
 		BT_WARN("Local time not available");
-		return;
+		return false;
 	}
 
+	/* The local time is copied, as it may be overwritten by the time
+	 * server before all entries have been scheduled.
+	 */
+	*current_local = *local;
+
 	BT_DBG("Current uptime %lld", current_uptime);
 
 	BT_DBG("Current time:");
@@ -444,13 +549,24 @@ static void schedule_action(struct bt_mesh_scheduler_srv *srv,
 	BT_DBG("      minute: %d", current_local->tm_min);
 	BT_DBG("      second: %d", current_local->tm_sec);
 
+	return true;
+}
+
+static void schedule_action(struct bt_mesh_scheduler_srv *srv,
+			    uint8_t idx, struct tm *current_local)
+{
+	struct tm sched_time = {0};
+	struct bt_mesh_schedule_entry *entry = &srv->sch_reg[idx];
+
 	if (!convert_scheduler_time_to_tm(&sched_time, current_local, entry)) {
 		BT_WARN("Cannot convert scheduled action time to struct tm");
+		heap_remove(srv, idx);
 		return;
 	}
 
 	if (ts_to_tai(&srv->sched_tai[idx], &sched_time)) {
 		BT_WARN("tm cannot be converted into TAI");
+		heap_remove(srv, idx);
 		return;
 	}
 
@@ -462,7 +578,7 @@ static void schedule_action(struct bt_mesh_scheduler_srv *srv,
 	BT_DBG("        minute: %d", sched_time.tm_min);
 	BT_DBG("        second: %d", sched_time.tm_sec);
 
-	WRITE_BIT(srv->active_bitmap, idx, 1);
+	heap_update(srv, idx);
 }
 
 static void scheduled_action_handle(struct k_work *work)
@@ -477,7 +593,7 @@ static void scheduled_action_handle(struct k_work *work)
 		return;
 	}
 
-	WRITE_BIT(srv->active_bitmap, srv->idx, 0);
+	heap_remove(srv, srv->idx);
 
 	struct bt_mesh_model *next_sched_mod = NULL;
 	uint16_t model_id = srv->sch_reg[srv->idx].action ==
@@ -538,9 +654,17 @@ static void scheduled_action_handle(struct k_work *work)
 	} while (elem != NULL && next_sched_mod == NULL);
 
 	uint8_t tmp_idx = srv->idx;
+	struct tm current_local;
 
 	srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
-	schedule_action(srv, tmp_idx);
+
+	/* Only the next occurrence of the fired entry has to be calculated,
+	 * the other entries keep their position in the heap.
+	 */
+	if (local_time_get(srv, &current_local)) {
+		schedule_action(srv, tmp_idx, &current_local);
+	}
+
 	run_scheduler(srv);
 }
 
@@ -642,10 +766,18 @@ static int action_set(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 	srv->sch_reg[idx] = tmp;
 	BT_DBG("Rx: scheduler server action index %d set, ack %d", idx, ack);
 
-	if (srv->sch_reg[idx].action < BT_MESH_SCHEDULER_SCENE_RECALL ||
-	   (srv->sch_reg[idx].action == BT_MESH_SCHEDULER_SCENE_RECALL &&
-	    srv->sch_reg[idx].scene_number != 0)) {
-		schedule_action(srv, idx);
+	if (is_entry_schedulable(srv, idx)) {
+		struct tm current_local;
+
+		if (local_time_get(srv, &current_local)) {
+			schedule_action(srv, idx, &current_local);
+		} else {
+			heap_remove(srv, idx);
+		}
+
+		run_scheduler(srv);
+	} else if (srv->heap_pos[idx] != BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT) {
+		heap_remove(srv, idx);
 		run_scheduler(srv);
 	}
 
@@ -757,7 +889,7 @@ static int scheduler_srv_init(struct bt_mesh_model *model)
 	srv->pub.update = update_handler;
 	net_buf_simple_init_with_data(&srv->pub_buf, srv->pub_data,
 			sizeof(srv->pub_data));
-	srv->active_bitmap = 0;
+	heap_clear(srv);
 
 	srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
 	k_work_init_delayable(&srv->delayed_work, scheduled_action_handle);
@@ -774,7 +906,7 @@ static void scheduler_srv_reset(struct bt_mesh_model *model)
 	struct bt_mesh_scheduler_srv *srv = model->user_data;
 
 	srv->idx = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
-	srv->active_bitmap = 0;
+	heap_clear(srv);
 	/* If this cancellation fails, we'll exit early from the timer handler,
 	 * as srv->idx is out of bounds.
 	 */
@@ -835,12 +967,20 @@ const struct bt_mesh_model_cb _bt_mesh_scheduler_setup_srv_cb = {
 
 int bt_mesh_scheduler_srv_time_update(struct bt_mesh_scheduler_srv *srv)
 {
+	struct tm current_local;
+
 	if (srv == NULL) {
 		return -EINVAL;
 	}
 
-	for (int idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT; ++idx) {
-		schedule_action(srv, idx);
+	/* All entries are scheduled relative to the same local time. */
+	if (local_time_get(srv, &current_local)) {
+		for (int idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+		     ++idx) {
+			if (is_entry_schedulable(srv, idx)) {
+				schedule_action(srv, idx, &current_local);
+			}
+		}
 	}
 
 	run_scheduler(srv);
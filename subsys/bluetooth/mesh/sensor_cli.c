@@ -43,6 +43,7 @@ struct series_data_rsp {
 	const struct bt_mesh_sensor_column *col;
 	uint16_t id;
 	uint32_t count;
+	uint32_t received;
 };
 
 struct cadence_rsp {
@@ -309,6 +310,11 @@ static int handle_series_status(struct bt_mesh_model *model, struct bt_mesh_msg_
 
 	size_t val_len = (col_format->size * 2) + sensor_value_len(type);
 	uint8_t count = buf->len / val_len;
+	/* Large series are reported in several pages. Every page but the last
+	 * ends with the raw value of the next column, which is shorter than a
+	 * column entry.
+	 */
+	bool last = (buf->len % val_len) != col_format->size;
 
 	for (uint8_t i = 0; i < count; i++) {
 		struct bt_mesh_sensor_series_entry entry;
@@ -324,13 +330,17 @@ static int handle_series_status(struct bt_mesh_model *model, struct bt_mesh_msg_
 			cli->cb->series_entry(cli, ctx, type, i, count, &entry);
 		}
 
-		if (rsp && i < rsp->count) {
-			rsp->entries[i] = entry;
+		if (rsp && rsp->received < rsp->count) {
+			rsp->entries[rsp->received] = entry;
+		}
+
+		if (rsp) {
+			rsp->received++;
 		}
 	}
 
-	if (rsp) {
-		rsp->count = count;
+	if (rsp && (last || rsp->received >= rsp->count)) {
+		rsp->count = rsp->received;
 		bt_mesh_msg_ack_ctx_rx(&cli->ack_ctx);
 	}
 
@@ -970,8 +980,11 @@ int bt_mesh_sensor_cli_series_entries_get(
 	const struct bt_mesh_sensor_column *range,
 	struct bt_mesh_sensor_series_entry *rsp, uint32_t *count)
 {
+	const struct bt_mesh_sensor_format *col_format;
 	int err;
 
+	col_format = bt_mesh_sensor_column_format_get(sensor);
+
 	BT_MESH_MODEL_BUF_DEFINE(msg, BT_MESH_SENSOR_OP_SERIES_GET,
 				 BT_MESH_SENSOR_MSG_MAXLEN_SERIES_GET);
 	bt_mesh_model_msg_init(&msg, BT_MESH_SENSOR_OP_SERIES_GET);
@@ -979,10 +992,6 @@ int bt_mesh_sensor_cli_series_entries_get(
 	net_buf_simple_add_le16(&msg, sensor->id);
 
 	if (range) {
-		const struct bt_mesh_sensor_format *col_format;
-
-		col_format = bt_mesh_sensor_column_format_get(sensor);
-
 		err = sensor_ch_encode(&msg, col_format, &range->start);
 		if (err) {
 			return err;
@@ -999,13 +1008,32 @@ int bt_mesh_sensor_cli_series_entries_get(
 		.id = sensor->id,
 		.count = count ? *count : 0,
 	};
+	uint32_t page_cols = (BT_MESH_RX_SDU_MAX -
+			     BT_MESH_MODEL_OP_LEN(BT_MESH_SENSOR_OP_SERIES_STATUS) -
+			     BT_MESH_SENSOR_MSG_MINLEN_SERIES_STATUS -
+			     col_format->size - BT_MESH_MIC_SHORT) /
+			    ((col_format->size * 2) + sensor_value_len(sensor));
+
+	err = model_ackd_send_paged(cli->model, ctx, &msg,
+				    rsp ? &cli->ack_ctx : NULL,
+				    BT_MESH_SENSOR_OP_SERIES_STATUS, &rsp_data,
+				    (rsp_data.count / MAX(page_cols, 1)) + 1);
+	if (err == -ETIMEDOUT && rsp && count) {
+		/* Report the columns of the pages received before the timeout. */
+		BT_DBG("No page after %u columns", rsp_data.received);
+		*count = MIN(rsp_data.received, *count);
+		return err;
+	}
 
-	err = model_ackd_send(cli->model, ctx, &msg, rsp ? &cli->ack_ctx : NULL,
-			       BT_MESH_SENSOR_OP_SERIES_STATUS, &rsp_data);
 	if (!count || err) {
 		return err;
 	}
 
+	if (rsp && rsp_data.count > *count) {
+		*count = rsp_data.count;
+		return -E2BIG;
+	}
+
 	*count = rsp_data.count;
 
 	return 0;
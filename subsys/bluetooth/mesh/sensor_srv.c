@@ -18,22 +18,51 @@
 #define LOG_MODULE_NAME bt_mesh_sensor_srv
 #include "common/log.h"
 
-#define SENSOR_FOR_EACH(_list, _node)                                          \
-	SYS_SLIST_FOR_EACH_CONTAINER(_list, _node, state.node)
+/** @brief Find the position of a sensor ID in the sorted sensor array.
+ *
+ *  @param srv Sensor server.
+ *  @param id  Sensor ID.
+ *  @param idx Position of the sensor, or the position at which it would be
+ *             inserted if the sensor is not found.
+ *
+ *  @return true if the sensor is found, false otherwise.
+ */
+static bool sensor_idx_find(const struct bt_mesh_sensor_srv *srv, uint16_t id,
+			    int *idx)
+{
+	int low = 0;
+	int high = srv->sensor_count;
+
+	while (low < high) {
+		int mid = (low + high) / 2;
+		uint16_t mid_id = srv->sensors[mid]->type->id;
+
+		if (mid_id == id) {
+			*idx = mid;
+			return true;
+		}
+
+		if (mid_id < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	*idx = low;
+	return false;
+}
 
 static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 					 uint16_t id)
 {
-	struct bt_mesh_sensor *sensor;
+	int idx;
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor)
-	{
-		if (sensor->type->id == id) {
-			return sensor;
-		}
+	if (!sensor_idx_find(srv, id, &idx)) {
+		return NULL;
 	}
 
-	return NULL;
+	return srv->sensors[idx];
 }
 
 #if CONFIG_BT_SETTINGS
@@ -48,7 +77,7 @@ static void store_timeout(struct k_work *work)
 				    BT_MESH_SENSOR_MSG_MAXLEN_CADENCE_STATUS));
 
 	for (int i = 0; i < srv->sensor_count; ++i) {
-		const struct bt_mesh_sensor *s = srv->sensor_array[i];
+		const struct bt_mesh_sensor *s = srv->sensors[i];
 		int err;
 
 		if (!s->state.configured) {
@@ -159,7 +188,9 @@ static int handle_descriptor_get(struct bt_mesh_model *model, struct bt_mesh_msg
 		goto respond;
 	}
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor) {
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		sensor = srv->sensors[i];
+
 		BT_DBG("Reporting ID 0x%04x", sensor->type->id);
 
 		if (net_buf_simple_tailroom(&rsp) < (8 + BT_MESH_MIC_SHORT)) {
@@ -209,8 +240,8 @@ static int handle_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		goto respond;
 	}
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor) {
-		buf_status_add(srv, sensor, ctx, &rsp);
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		buf_status_add(srv, srv->sensors[i], ctx, &rsp);
 	}
 
 respond:
@@ -219,18 +250,43 @@ respond:
 	return 0;
 }
 
-static const struct bt_mesh_sensor_column *
-column_get(const struct bt_mesh_sensor_series *series,
-	   const struct sensor_value *val)
+static bool series_supported(const struct bt_mesh_sensor *sensor)
+{
+	return sensor->series.get && sensor->series.column_count &&
+	       (sensor->series.columns || sensor->series.column_get);
+}
+
+static int series_column_get(struct bt_mesh_sensor_srv *srv,
+			     struct bt_mesh_sensor *sensor, uint32_t index,
+			     struct bt_mesh_sensor_column *col)
+{
+	if (sensor->series.column_get) {
+		return sensor->series.column_get(srv, sensor, index, col);
+	}
+
+	*col = sensor->series.columns[index];
+	return 0;
+}
+
+static int column_get(struct bt_mesh_sensor_srv *srv,
+		      struct bt_mesh_sensor *sensor,
+		      const struct sensor_value *val,
+		      struct bt_mesh_sensor_column *col)
 {
-	for (uint32_t i = 0; i < series->column_count; ++i) {
-		if (series->columns[i].start.val1 == val->val1 &&
-		    series->columns[i].start.val2 == val->val2) {
-			return &series->columns[i];
+	for (uint32_t i = 0; i < sensor->series.column_count; ++i) {
+		int err = series_column_get(srv, sensor, i, col);
+
+		if (err) {
+			return err;
+		}
+
+		if (col->start.val1 == val->val1 &&
+		    col->start.val2 == val->val2) {
+			return 0;
 		}
 	}
 
-	return NULL;
+	return -ENOENT;
 }
 
 static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
@@ -257,11 +313,11 @@ static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 	}
 
 	const struct bt_mesh_sensor_format *col_format;
-	const struct bt_mesh_sensor_column *col;
+	struct bt_mesh_sensor_column col;
 	struct sensor_value col_x;
 
 	col_format = bt_mesh_sensor_column_format_get(sensor->type);
-	if (!col_format || !sensor->series.columns || !sensor->series.get) {
+	if (!col_format || !series_supported(sensor)) {
 		BT_WARN("No series support in 0x%04x", sensor->type->id);
 		goto respond;
 	}
@@ -273,14 +329,14 @@ static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 
 	BT_DBG("Column %s", bt_mesh_sensor_ch_str(&col_x));
 
-	col = column_get(&sensor->series, &col_x);
-	if (!col) {
+	err = column_get(srv, sensor, &col_x, &col);
+	if (err) {
 		BT_WARN("Unknown column");
 		sensor_ch_encode(&rsp, col_format, &col_x);
 		goto respond;
 	}
 
-	err = sensor_column_encode(&rsp, srv, sensor, ctx, col);
+	err = sensor_column_encode(&rsp, srv, sensor, ctx, &col);
 	if (err) {
 		BT_WARN("Failed encoding sensor column: %d", err);
 		return err;
@@ -292,6 +348,142 @@ respond:
 	return 0;
 }
 
+static void series_page_end(int err, void *cb_data)
+{
+	struct bt_mesh_sensor_srv *srv = cb_data;
+
+	if (!srv->series.sensor) {
+		return;
+	}
+
+	if (err) {
+		BT_WARN("Series page send failed: %d", err);
+		srv->series.sensor = NULL;
+		return;
+	}
+
+	k_work_submit(&srv->series.work);
+}
+
+static const struct bt_mesh_send_cb series_page_cb = {
+	.end = series_page_end,
+};
+
+/** @brief Encode a page of a Sensor Series Status response.
+ *
+ *  The page is filled with as many columns as fit in a message, starting at
+ *  column @c next. If columns remain after the page, the page ends with the
+ *  raw value of the next column, which tells the client that more pages
+ *  follow.
+ *
+ *  @param srv    Sensor server instance.
+ *  @param sensor Sensor to report the series of.
+ *  @param ctx    Message context of the request.
+ *  @param range  Range of the requested columns, or NULL for all columns.
+ *  @param next   Index of the first column of the page. Is changed to the
+ *                index of the first column of the next page.
+ *  @param rsp    Message buffer to encode the page in.
+ *
+ *  @return true if more pages follow this page, false otherwise.
+ */
+static bool series_page_encode(struct bt_mesh_sensor_srv *srv,
+			       struct bt_mesh_sensor *sensor,
+			       struct bt_mesh_msg_ctx *ctx,
+			       const struct bt_mesh_sensor_column *range,
+			       uint32_t *next, struct net_buf_simple *rsp)
+{
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(sensor->type);
+	size_t col_len = col_format->size * 2 + sensor_value_len(sensor->type);
+	struct bt_mesh_sensor_column col;
+	int err = 0;
+	uint32_t i;
+
+	bt_mesh_model_msg_init(rsp, BT_MESH_SENSOR_OP_SERIES_STATUS);
+	net_buf_simple_add_le16(rsp, sensor->type->id);
+
+	for (i = *next; i < sensor->series.column_count; ++i) {
+		if (net_buf_simple_tailroom(rsp) <
+		    col_len + col_format->size + BT_MESH_MIC_SHORT) {
+			break;
+		}
+
+		err = series_column_get(srv, sensor, i, &col);
+		if (err) {
+			break;
+		}
+
+		if (range && !bt_mesh_sensor_value_in_column(&col.start, range)) {
+			continue;
+		}
+
+		BT_DBG("Column #%u", i);
+
+		err = sensor_column_encode(rsp, srv, sensor, ctx, &col);
+		if (err) {
+			break;
+		}
+	}
+
+	*next = i;
+
+	if (!err && i < sensor->series.column_count) {
+		err = series_column_get(srv, sensor, i, &col);
+		if (!err) {
+			err = sensor_ch_encode(rsp, col_format, &col.start);
+		}
+
+		if (!err) {
+			return true;
+		}
+	}
+
+	if (err) {
+		/* End the response with the columns encoded so far. */
+		BT_WARN("Failed encoding column #%u: %d", i, err);
+	}
+
+	return false;
+}
+
+/** @brief Send the next page of the ongoing Sensor Series Status response.
+ *
+ *  The next page is only built when the previous page has been sent.
+ *
+ *  @param srv Sensor server instance.
+ */
+static void series_page_send(struct bt_mesh_sensor_srv *srv)
+{
+	int err;
+
+	NET_BUF_SIMPLE_DEFINE(rsp, BT_MESH_TX_SDU_MAX);
+
+	if (!series_page_encode(srv, srv->series.sensor, &srv->series.ctx,
+				srv->series.ranged ? &srv->series.range : NULL,
+				&srv->series.next, &rsp)) {
+		srv->series.sensor = NULL;
+		bt_mesh_model_send(srv->model, &srv->series.ctx, &rsp, NULL,
+				   NULL);
+		return;
+	}
+
+	err = bt_mesh_model_send(srv->model, &srv->series.ctx, &rsp,
+				 &series_page_cb, srv);
+	if (err) {
+		srv->series.sensor = NULL;
+	}
+}
+
+static void series_work_handler(struct k_work *work)
+{
+	struct bt_mesh_sensor_srv *srv =
+		CONTAINER_OF(work, struct bt_mesh_sensor_srv, series.work);
+
+	if (srv->series.sensor) {
+		series_page_send(srv);
+	}
+}
+
 static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 			     struct net_buf_simple *buf)
 {
@@ -306,7 +498,8 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 
 	struct bt_mesh_sensor *sensor = sensor_get(srv, id);
 
-	NET_BUF_SIMPLE_DEFINE(rsp, BT_MESH_TX_SDU_MAX);
+	BT_MESH_MODEL_BUF_DEFINE(rsp, BT_MESH_SENSOR_OP_SERIES_STATUS,
+				 BT_MESH_SENSOR_MSG_MINLEN_SERIES_STATUS);
 	bt_mesh_model_msg_init(&rsp, BT_MESH_SENSOR_OP_SERIES_STATUS);
 	net_buf_simple_add_le16(&rsp, id);
 
@@ -315,13 +508,13 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 	}
 
 	col_format = bt_mesh_sensor_column_format_get(sensor->type);
-	if (!col_format || !sensor->series.columns || !sensor->series.get) {
+	if (!col_format || !series_supported(sensor)) {
 		BT_WARN("No series support in 0x%04x", sensor->type->id);
 		goto respond;
 	}
 
-	struct bt_mesh_sensor_column range;
-	bool ranged = (buf->len != 0);
+	struct bt_mesh_sensor_column range = {};
+	bool ranged;
 
 	if (buf->len == col_format->size * 2) {
 		int err;
@@ -337,31 +530,43 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 			BT_WARN("Range end decode failed: %d", err);
 			return err;
 		}
-	} else if (buf->len != 0) {
+
+		ranged = true;
+	} else if (buf->len == 0) {
+		ranged = false;
+	} else {
 		/* invalid length */
 		BT_WARN("Invalid length (%u)", buf->len);
 		return -EMSGSIZE;
 	}
 
-	for (uint32_t i = 0; i < sensor->series.column_count; ++i) {
-		const struct bt_mesh_sensor_column *col =
-			&sensor->series.columns[i];
-
-		if (ranged &&
-		    !bt_mesh_sensor_value_in_column(&col->start, &range)) {
-			continue;
-		}
+	if (srv->series.sensor) {
+		/* Only one response is sent in pages at a time. Other requests
+		 * get the first page, which tells the client if columns are
+		 * missing.
+		 */
+		uint32_t next = 0;
 
-		BT_DBG("Column #%u", i);
+		NET_BUF_SIMPLE_DEFINE(page, BT_MESH_TX_SDU_MAX);
 
-		int err = sensor_column_encode(&rsp, srv, sensor, ctx, col);
+		BT_DBG("Series response in progress");
+		series_page_encode(srv, sensor, ctx, ranged ? &range : NULL,
+				   &next, &page);
+		bt_mesh_model_send(model, ctx, &page, NULL, NULL);
 
-		if (err) {
-			BT_WARN("Failed encoding: %d", err);
-			return err;
-		}
+		return 0;
 	}
 
+	srv->series.ctx = *ctx;
+	srv->series.range = range;
+	srv->series.ranged = ranged;
+	srv->series.next = 0;
+	srv->series.sensor = sensor;
+
+	series_page_send(srv);
+
+	return 0;
+
 respond:
 	bt_mesh_model_send(model, ctx, &rsp, NULL, NULL);
 
@@ -792,15 +997,18 @@ static uint16_t min_int_get(const struct bt_mesh_sensor *sensor,
  *  has expired and the value is outside its delta threshold or the
  *  publication interval has expired.
  *
+ *  Sensors that notify value changes are only sampled if their value has
+ *  changed or their publication interval has expired.
+ *
  *  @param srv         Server sending the publication.
- *  @param s           Sensor to add data of.
+ *  @param idx         Index of the sensor to add data of.
  *  @param period_div  Server's original period divisor.
  *  @param base_period Server's original base period.
  */
-static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
-			struct bt_mesh_sensor *s, uint8_t period_div,
-			uint32_t base_period)
+static void pub_msg_add(struct bt_mesh_sensor_srv *srv, int idx,
+			uint8_t period_div, uint32_t base_period)
 {
+	struct bt_mesh_sensor *s = srv->sensors[idx];
 	uint16_t min_int = min_int_get(s, period_div, base_period);
 	uint16_t delta = srv->seq - s->state.seq;
 	int err;
@@ -817,6 +1025,17 @@ static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 		return;
 	}
 
+	/** An unchanged value can't break the delta threshold, so the sensor
+	 * only has to be sampled when the publication interval has expired.
+	 */
+	bool dirty = atomic_test_and_clear_bit(srv->dirty, idx);
+
+	if (s->state.configured && !dirty &&
+	    atomic_test_bit(srv->notify, idx) &&
+	    delta < pub_int_get(s, period_div)) {
+		return;
+	}
+
 	struct sensor_value value[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX] = {};
 
 	err = value_get(srv, s, NULL, value);
@@ -845,7 +1064,6 @@ static void pub_msg_add(struct bt_mesh_sensor_srv *srv,
 static int update_handler(struct bt_mesh_model *model)
 {
 	struct bt_mesh_sensor_srv *srv = model->user_data;
-	struct bt_mesh_sensor *s;
 
 	bt_mesh_model_msg_init(srv->pub.msg, BT_MESH_SENSOR_OP_STATUS);
 
@@ -866,15 +1084,14 @@ static int update_handler(struct bt_mesh_model *model)
 
 	srv->pub.fast_period = true;
 
-	SENSOR_FOR_EACH(&srv->sensors, s)
-	{
-		pub_msg_add(srv, s, period_div, base_period);
+	for (int i = 0; i < srv->sensor_count; ++i) {
+		pub_msg_add(srv, i, period_div, base_period);
 
 		/** Update the publication divisor to a new value. This is needed to take new
 		 * changes in a sensor cadence state, .e.g. when the cadence decreased.
 		 */
 		srv->pub.period_div =
-			MAX(srv->pub.period_div, s->state.pub_div);
+			MAX(srv->pub.period_div, srv->sensors[i]->state.pub_div);
 	}
 
 	if (period_div != srv->pub.period_div) {
@@ -890,40 +1107,39 @@ static int update_handler(struct bt_mesh_model *model)
 static int sensor_srv_init(struct bt_mesh_model *model)
 {
 	struct bt_mesh_sensor_srv *srv = model->user_data;
-
-	sys_slist_init(&srv->sensors);
+	uint8_t count = srv->sensor_count;
 
 #if CONFIG_BT_SETTINGS
 	k_work_init_delayable(&srv->store_timer, store_timeout);
 #endif
+	k_work_init(&srv->series.work, series_work_handler);
+	srv->series.sensor = NULL;
 
-	/* Establish a sorted list of sensors, as this is a requirement when
-	 * sending multiple sensor values in one message.
+	/* Establish a sorted array of sensors, as this is a requirement when
+	 * sending multiple sensor values in one message. The array is also
+	 * used to look up sensors by ID.
 	 */
-	uint16_t min_id = 0;
+	srv->sensor_count = 0;
 
-	for (int count = 0; count < srv->sensor_count; ++count) {
-		struct bt_mesh_sensor *best = NULL;
-
-		for (int j = 0; j < srv->sensor_count; ++j) {
-			if (srv->sensor_array[j]->type->id >= min_id &&
-			    (!best ||
-			     srv->sensor_array[j]->type->id < best->type->id)) {
-				best = srv->sensor_array[j];
-			}
-		}
+	for (int i = 0; i < count; ++i) {
+		struct bt_mesh_sensor *sensor = srv->sensor_array[i];
+		int idx;
 
-		if (!best) {
-			BT_ERR("Duplicate sensor ID");
-			srv->sensor_count = count;
-			break;
+		if (sensor_idx_find(srv, sensor->type->id, &idx)) {
+			BT_ERR("Duplicate sensor ID 0x%04x", sensor->type->id);
+			continue;
 		}
 
-		sys_slist_append(&srv->sensors, &best->state.node);
-		BT_DBG("Sensor 0x%04x", best->type->id);
-		min_id = best->type->id + 1;
+		memmove(&srv->sensors[idx + 1], &srv->sensors[idx],
+			(srv->sensor_count - idx) * sizeof(srv->sensors[0]));
+		srv->sensors[idx] = sensor;
+		srv->sensor_count++;
+		BT_DBG("Sensor 0x%04x", sensor->type->id);
 	}
 
+	memset(srv->notify, 0, sizeof(srv->notify));
+	memset(srv->dirty, 0, sizeof(srv->dirty));
+
 	srv->seq = 1;
 
 	srv->model = model;
@@ -950,8 +1166,11 @@ static void sensor_srv_reset(struct bt_mesh_model *model)
 	net_buf_simple_reset(srv->pub.msg);
 	net_buf_simple_reset(srv->setup_pub.msg);
 
+	srv->series.sensor = NULL;
+	k_work_cancel(&srv->series.work);
+
 	for (int i = 0; i < srv->sensor_count; ++i) {
-		struct bt_mesh_sensor *s = srv->sensor_array[i];
+		struct bt_mesh_sensor *s = srv->sensors[i];
 
 		s->state.pub_div = 0;
 		s->state.min_int = 0;
@@ -1081,3 +1300,19 @@ int bt_mesh_sensor_srv_sample(struct bt_mesh_sensor_srv *srv,
 
 	return bt_mesh_sensor_srv_pub(srv, NULL, sensor, value);
 }
+
+int bt_mesh_sensor_srv_mark_dirty(struct bt_mesh_sensor_srv *srv,
+				  const struct bt_mesh_sensor *sensor)
+{
+	int idx;
+
+	if (!sensor_idx_find(srv, sensor->type->id, &idx) ||
+	    srv->sensors[idx] != sensor) {
+		return -ENOENT;
+	}
+
+	atomic_set_bit(srv->notify, idx);
+	atomic_set_bit(srv->dirty, idx);
+
+	return 0;
+}
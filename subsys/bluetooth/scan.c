@@ -18,9 +18,35 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Number of slots in the hash table of a filter with cnt entries. There is always an empty slot,
+ * where the lookup of a missing entry ends.
+ */
+#define HASH_SLOTS(cnt) (2 * (cnt) + 1)
+
+/* Slots hold the filter index plus one in a uint8_t, see hash_insert(). */
+BUILD_ASSERT(CONFIG_BT_SCAN_ADDRESS_CNT < UINT8_MAX,
+	     "CONFIG_BT_SCAN_ADDRESS_CNT does not fit in the hash table slots");
+BUILD_ASSERT(CONFIG_BT_SCAN_UUID_CNT < UINT8_MAX,
+	     "CONFIG_BT_SCAN_UUID_CNT does not fit in the hash table slots");
+#if CONFIG_BT_SCAN_BLOCKLIST
+BUILD_ASSERT(CONFIG_BT_SCAN_BLOCKLIST_LEN < UINT8_MAX,
+	     "CONFIG_BT_SCAN_BLOCKLIST_LEN does not fit in the hash table slots");
+#endif
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
+/* Incremented before and after the filters, the blocklist or the connection attempts filter are
+ * changed, so it is odd while they are changed. Advertising reports are matched without taking
+ * the mutex, and matched again with the mutex taken if the filters were changed meanwhile.
+ */
+static atomic_t filter_seq;
+
+/* Bluetooth Base UUID in little-endian order, without the 32-bit value in the last bytes. */
+static const uint8_t uuid_base[12] = {
+	0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00
+};
+
 /* Scanning control structure used to
  * compare matching filters, their mode and event generation.
  */
@@ -34,6 +60,9 @@ struct bt_scan_control {
 	/* Indicates whether at least one filter has been fitted. */
 	bool filter_match;
 
+	/* Device is on the blocklist or its connection attempts are exceeded. */
+	bool device_filtered;
+
 	/* Indicates in which mode filters operate. */
 	bool all_mode;
 
@@ -45,6 +74,9 @@ struct bt_scan_control {
 
 	/* Scan filter status. */
 	struct bt_scan_filter_match filter_status;
+
+	/* UUID filters found in the advertising data. */
+	bool uuid_found[CONFIG_BT_SCAN_UUID_CNT];
 };
 
 /* Name filter structure.
@@ -89,6 +121,9 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Hash table of the addresses. */
+	uint8_t hash[HASH_SLOTS(CONFIG_BT_SCAN_ADDRESS_CNT)];
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +155,9 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* Hash table of the UUIDs. */
+	uint8_t hash[HASH_SLOTS(CONFIG_BT_SCAN_UUID_CNT)];
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -225,11 +263,65 @@ struct conn_blocklist {
 	/* Array of the blocklist devices. */
 	bt_addr_le_t addr[CONFIG_BT_SCAN_BLOCKLIST_LEN];
 
+	/* Hash table of the blocklist devices. */
+	uint8_t hash[HASH_SLOTS(CONFIG_BT_SCAN_BLOCKLIST_LEN)];
+
 	/* Blocklist device count. */
 	uint32_t count;
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+/* Advertisement received recently. */
+struct dedup_entry {
+	/* Node in the hash bucket list. */
+	sys_snode_t bucket_node;
+
+	/* Node in the least recently used list. */
+	sys_dnode_t lru_node;
+
+	/* Advertiser address. */
+	bt_addr_le_t addr;
+
+	/* Hash of the advertising data. */
+	uint32_t ad_hash;
+
+	/* Advertising PDU type, BT_GAP_ADV_TYPE_*. */
+	uint8_t adv_type;
+
+	/* Uptime when the advertisement was last reported, in milliseconds. */
+	uint32_t timestamp;
+
+	/* Hash bucket index. */
+	uint16_t bucket;
+
+	/* Set if the entry holds an advertisement. */
+	bool used;
+};
+
+/* Advertising report deduplication cache. Only accessed from the
+ * scan_recv() context, other contexts request it to be cleared.
+ */
+static struct dedup_cache {
+	struct dedup_entry entry[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Entries by hash of the address and advertising data. */
+	sys_slist_t bucket[HASH_SLOTS(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE)];
+
+	/* Entries, most recently received first. */
+	sys_dlist_t lru;
+
+	/* Set if the cache must be cleared before it is used. */
+	atomic_t clear;
+
+	atomic_t hits;
+	atomic_t misses;
+	atomic_t evictions;
+} dedup = {
+	.clear = ATOMIC_INIT(1),
+};
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -268,6 +360,99 @@ static struct bt_scan {
 
 static sys_slist_t callback_list;
 
+static void filters_write_begin(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	atomic_inc(&filter_seq);
+}
+
+/* Set changed if an advertisement that was not matched before can be matched
+ * now. Counting connection attempts and blocking devices only drop reports.
+ */
+static void filters_write_end(bool changed)
+{
+	atomic_inc(&filter_seq);
+	k_mutex_unlock(&scan_mutex);
+
+#if CONFIG_BT_SCAN_DEDUP
+	if (changed) {
+		/* Report all advertisements again with the new filters. */
+		atomic_set(&dedup.clear, 1);
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
+/* FNV-1a hash. */
+static uint32_t hash_bytes(const void *data, size_t len)
+{
+	const uint8_t *bytes = data;
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static uint32_t addr_hash(const bt_addr_le_t *addr)
+{
+	return hash_bytes(addr, sizeof(*addr));
+}
+
+/* Hash of the 128-bit form of a UUID, so that UUIDs that are equal according to bt_uuid_cmp()
+ * have the same hash, whatever their size.
+ */
+static uint32_t uuid_hash(const struct bt_uuid *uuid)
+{
+	const uint8_t *val;
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return BT_UUID_16(uuid)->val;
+
+	case BT_UUID_TYPE_32:
+		return BT_UUID_32(uuid)->val;
+
+	case BT_UUID_TYPE_128:
+		val = BT_UUID_128(uuid)->val;
+
+		if (memcmp(val, uuid_base, sizeof(uuid_base)) == 0) {
+			return sys_get_le32(&val[sizeof(uuid_base)]);
+		}
+
+		return hash_bytes(val, BT_SCAN_UUID_128_SIZE);
+
+	default:
+		return 0;
+	}
+}
+
+/* Slots of the hash tables hold the filter index plus one, zero marks an empty slot. */
+static void hash_insert(uint8_t *slots, size_t slot_cnt, uint32_t hash, size_t idx)
+{
+	size_t i = hash % slot_cnt;
+
+	while (slots[i] != 0) {
+		i = (i + 1) % slot_cnt;
+	}
+
+	slots[i] = idx + 1;
+}
+
+static int addr_find(const uint8_t *slots, size_t slot_cnt, const bt_addr_le_t *table,
+		     const bt_addr_le_t *addr)
+{
+	for (size_t i = addr_hash(addr) % slot_cnt; slots[i] != 0; i = (i + 1) % slot_cnt) {
+		if (bt_addr_le_cmp(&table[slots[i] - 1], addr) == 0) {
+			return slots[i] - 1;
+		}
+	}
+
+	return -ENOENT;
+}
+
 void bt_scan_cb_register(struct bt_scan_cb *cb)
 {
 	if (!cb) {
@@ -329,21 +514,12 @@ static void notify_connecting_error(struct bt_scan_device_info *device_info)
 #if CONFIG_BT_SCAN_BLOCKLIST
 static bool blocklist_device_check(const bt_addr_le_t *addr)
 {
-	bool blocklist_device = false;
-
-	k_mutex_lock(&scan_mutex, K_FOREVER);
-
-	for (size_t i = 0; i < bt_scan.blocklist.count; i++) {
-		if (bt_addr_le_cmp(&bt_scan.blocklist.addr[i], addr) == 0) {
-			blocklist_device = true;
-
-			break;
-		}
+	if (bt_scan.blocklist.count == 0) {
+		return false;
 	}
 
-	k_mutex_unlock(&scan_mutex);
-
-	return blocklist_device;
+	return addr_find(bt_scan.blocklist.hash, ARRAY_SIZE(bt_scan.blocklist.hash),
+			 bt_scan.blocklist.addr, addr) >= 0;
 }
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
@@ -369,9 +545,11 @@ static void scan_attempts_filter_device_add(const bt_addr_le_t *addr)
 	struct conn_attempts_filter *filter = &bt_scan.attempts_filter;
 	char addr_str[BT_ADDR_LE_STR_LEN];
 
-	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+	if (IS_ENABLED(CONFIG_BT_SCAN_LOG_LEVEL_DBG)) {
+		bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+	}
 
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 
 	/* Check if device is already in the filter array. */
 	for (size_t i = 0; i < filter->count; i++) {
@@ -394,7 +572,7 @@ static void scan_attempts_filter_device_add(const bt_addr_le_t *addr)
 	}
 
 out:
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(false);
 }
 
 static void device_conn_attempts_count(struct bt_conn *conn)
@@ -402,7 +580,7 @@ static void device_conn_attempts_count(struct bt_conn *conn)
 	const bt_addr_le_t *addr = bt_conn_get_dst(conn);
 	struct conn_attempts_filter *filter = &bt_scan.attempts_filter;
 
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 
 	for (size_t i = 0; i < filter->count; i++) {
 		struct conn_attempts_device *device = &filter->device[i];
@@ -416,37 +594,34 @@ static void device_conn_attempts_count(struct bt_conn *conn)
 		}
 	}
 
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(false);
 }
 
 static bool conn_attempts_exceeded(const bt_addr_le_t *addr)
 {
 	struct conn_attempts_filter *filter = &bt_scan.attempts_filter;
 	char addr_str[BT_ADDR_LE_STR_LEN];
-	bool attempts_exceeded = false;
-
-	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
-
-	k_mutex_lock(&scan_mutex, K_FOREVER);
 
 	/* Check if the device is in the filter array. */
 	for (size_t i = 0; i < filter->count; i++) {
 		struct conn_attempts_device *device = &filter->device[i];
 
 		if (bt_addr_le_cmp(addr, &device->addr) == 0) {
-			if (device->attempts >= CONFIG_BT_SCAN_CONN_ATTEMPTS_COUNT) {
+			if (device->attempts < CONFIG_BT_SCAN_CONN_ATTEMPTS_COUNT) {
+				return false;
+			}
+
+			if (IS_ENABLED(CONFIG_BT_SCAN_LOG_LEVEL_DBG)) {
+				bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
 				LOG_DBG("Connection attempts count for %s exceeded",
 					log_strdup(addr_str));
-				attempts_exceeded = true;
 			}
 
-			break;
+			return true;
 		}
 	}
 
-	k_mutex_unlock(&scan_mutex);
-
-	return attempts_exceeded;
+	return false;
 }
 
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
@@ -504,19 +679,18 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			     struct bt_scan_control *control)
 {
-	const bt_addr_le_t *addr =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	const struct bt_scan_addr_filter *addr_filter = &bt_scan.scan_filters.addr;
+	int idx;
 
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
-
-			return true;
-		}
+	idx = addr_find(addr_filter->hash, ARRAY_SIZE(addr_filter->hash),
+			addr_filter->target_addr, target_addr);
+	if (idx < 0) {
+		return false;
 	}
 
-	return false;
+	control->filter_status.addr.addr = &addr_filter->target_addr[idx];
+
+	return true;
 }
 
 static bool is_addr_filter_enabled(void)
@@ -529,11 +703,8 @@ static void check_addr(struct bt_scan_control *control,
 {
 	if (is_addr_filter_enabled()) {
 		if (adv_addr_compare(addr, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.addr.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -541,9 +712,9 @@ static void check_addr(struct bt_scan_control *control,
 static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 {
 	char addr[BT_ADDR_LE_STR_LEN];
-	bt_addr_le_t *addr_filter =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	struct bt_scan_addr_filter *filter = &bt_scan.scan_filters.addr;
+	bt_addr_le_t *addr_filter = filter->target_addr;
+	uint8_t counter = filter->cnt;
 
 	/* If no memory for filter. */
 	if (counter >= CONFIG_BT_SCAN_ADDRESS_CNT) {
@@ -551,21 +722,22 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr_filter[i]) == 0) {
-			return 0;
-		}
+	if (addr_find(filter->hash, ARRAY_SIZE(filter->hash), addr_filter,
+		      target_addr) >= 0) {
+		return 0;
 	}
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	hash_insert(filter->hash, ARRAY_SIZE(filter->hash), addr_hash(target_addr), counter);
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
 
-	bt_addr_le_to_str(target_addr, addr, sizeof(addr));
-
-	LOG_DBG("Address: %s", addr);
+	if (IS_ENABLED(CONFIG_BT_SCAN_LOG_LEVEL_DBG)) {
+		bt_addr_le_to_str(target_addr, addr, sizeof(addr));
+		LOG_DBG("Address: %s", log_strdup(addr));
+	}
 
 	/* Increase the address filter counter. */
 	bt_scan.scan_filters.addr.cnt++;
@@ -615,11 +787,8 @@ static void name_check(struct bt_scan_control *control,
 {
 	if (is_name_filter_enabled()) {
 		if (adv_name_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.name.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -708,11 +877,8 @@ static void short_name_check(struct bt_scan_control *control,
 {
 	if (is_short_name_filter_enabled()) {
 		if (adv_short_name_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.short_name.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -759,14 +925,37 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+static int uuid_find(const struct bt_uuid *uuid)
+{
+	const struct bt_scan_uuid_filter *uuid_filter = &bt_scan.scan_filters.uuid;
+	const size_t slot_cnt = ARRAY_SIZE(uuid_filter->hash);
+	const uint8_t *slots = uuid_filter->hash;
+
+	for (size_t i = uuid_hash(uuid) % slot_cnt; slots[i] != 0; i = (i + 1) % slot_cnt) {
+		if (bt_uuid_cmp(uuid_filter->uuid[slots[i] - 1].uuid, uuid) == 0) {
+			return slots[i] - 1;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static bool is_uuid_filter_enabled(void)
+{
+	return CONFIG_BT_SCAN_UUID_CNT && bt_scan.scan_filters.uuid.enabled;
+}
+
+static void uuid_check(struct bt_scan_control *control,
+		       const struct bt_data *data,
+		       uint8_t type)
 {
 	uint8_t uuid_len;
 
-	switch (uuid_type) {
+	if (!is_uuid_filter_enabled()) {
+		return;
+	}
+
+	switch (type) {
 	case BT_UUID_TYPE_16:
 		uuid_len = sizeof(uint16_t);
 		break;
@@ -780,85 +969,44 @@ static bool find_uuid(const uint8_t *data,
 		break;
 
 	default:
-		return false;
+		return;
 	}
 
-	for (size_t i = 0; i < data_len; i += uuid_len) {
+	/* Mark the filters found, they are evaluated when all advertising data is parsed. */
+	for (size_t i = 0; i + uuid_len <= data->data_len; i += uuid_len) {
 		struct bt_uuid_128 uuid;
+		int idx;
 
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
+		if (!bt_uuid_create(&uuid.uuid, &data->data[i], uuid_len)) {
+			return;
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
+		idx = uuid_find(&uuid.uuid);
+		if (idx >= 0) {
+			control->uuid_found[idx] = true;
 		}
 	}
-
-	return false;
 }
 
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
+static void uuid_match_check(struct bt_scan_control *control)
 {
-	const struct bt_scan_uuid_filter *uuid_filter =
-			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
-	for (size_t i = 0; i < counter; i++) {
-
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
-			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
+	const struct bt_scan_uuid_filter *uuid_filter = &bt_scan.scan_filters.uuid;
+	struct bt_scan_uuid_filter_status *status = &control->filter_status.uuid;
 
-			uuid_match_cnt++;
-
-			/* In the normal filter mode,
-			 * only one UUID is needed to match.
-			 */
-			if (!all_filters_mode) {
-				break;
-			}
-
-		} else if (all_filters_mode) {
-			break;
+	for (size_t i = 0; i < uuid_filter->cnt; i++) {
+		if (control->uuid_found[i]) {
+			status->uuid[status->count] = uuid_filter->uuid[i].uuid;
+			status->count++;
 		}
 	}
 
-	control->filter_status.uuid.count = uuid_match_cnt;
-
 	/* In the multifilter mode, all UUIDs must be found in
 	 * the advertisement packets.
 	 */
-	if ((all_filters_mode && (uuid_match_cnt == counter)) ||
-	    ((!all_filters_mode) && (uuid_match_cnt > 0))) {
-		return true;
-	}
-
-	return false;
-}
-
-static bool is_uuid_filter_enabled(void)
-{
-	return CONFIG_BT_SCAN_UUID_CNT && bt_scan.scan_filters.uuid.enabled;
-}
-
-static void uuid_check(struct bt_scan_control *control,
-		       const struct bt_data *data,
-		       uint8_t type)
-{
-	if (is_uuid_filter_enabled()) {
-		if (adv_uuid_compare(data, type, control)) {
-			control->filter_match_cnt++;
-
-			/* Information about the filters matched. */
-			control->filter_status.uuid.match = true;
-			control->filter_match = true;
-		}
+	if (control->all_mode) {
+		status->match = (status->count > 0) && (status->count == uuid_filter->cnt);
+	} else {
+		status->match = (status->count > 0);
 	}
 }
 
@@ -876,10 +1024,8 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_uuid_cmp(uuid_filter[i].uuid, uuid) == 0) {
-			return 0;
-		}
+	if (uuid_find(uuid) >= 0) {
+		return 0;
 	}
 
 	/* Add UUID to the filter. */
@@ -912,6 +1058,8 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+	hash_insert(bt_scan.scan_filters.uuid.hash, ARRAY_SIZE(bt_scan.scan_filters.uuid.hash),
+		    uuid_hash(uuid), counter);
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -973,11 +1121,8 @@ static void appearance_check(struct bt_scan_control *control,
 {
 	if (is_appearance_filter_enabled()) {
 		if (adv_appearance_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.appearance.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -1060,11 +1205,8 @@ static void manufacturer_data_check(struct bt_scan_control *control,
 {
 	if (is_manufacturer_data_filter_enabled()) {
 		if (adv_manufacturer_data_compare(data, control)) {
-			control->filter_match_cnt++;
-
 			/* Information about the filters matched. */
 			control->filter_status.manufacturer_data.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -1166,7 +1308,7 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 		return -EINVAL;
 	}
 
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 
 	switch (type) {
 	case BT_SCAN_FILTER_TYPE_NAME:
@@ -1204,14 +1346,41 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 		break;
 	}
 
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(err == 0);
 
 	return err;
 }
 
+static size_t filters_cnt_get(void)
+{
+	const struct bt_scan_filters *filters = &bt_scan.scan_filters;
+
+	return filters->name.cnt + filters->short_name.cnt + filters->addr.cnt +
+	       filters->uuid.cnt + filters->appearance.cnt +
+	       filters->manufacturer_data.cnt;
+}
+
+static uint8_t filters_mode_get(void)
+{
+	const struct bt_scan_filters *filters = &bt_scan.scan_filters;
+	uint8_t mode = 0;
+
+	mode |= filters->addr.enabled ? BT_SCAN_ADDR_FILTER : 0;
+	mode |= filters->name.enabled ? BT_SCAN_NAME_FILTER : 0;
+	mode |= filters->short_name.enabled ? BT_SCAN_SHORT_NAME_FILTER : 0;
+	mode |= filters->uuid.enabled ? BT_SCAN_UUID_FILTER : 0;
+	mode |= filters->appearance.enabled ? BT_SCAN_APPEARANCE_FILTER : 0;
+	mode |= filters->manufacturer_data.enabled ?
+		BT_SCAN_MANUFACTURER_DATA_FILTER : 0;
+
+	return mode;
+}
+
 void bt_scan_filter_remove_all(void)
 {
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
+
+	bool changed = (filters_cnt_get() > 0);
 
 	struct bt_scan_name_filter *name_filter =
 			&bt_scan.scan_filters.name;
@@ -1224,10 +1393,12 @@ void bt_scan_filter_remove_all(void)
 	struct bt_scan_addr_filter *addr_filter =
 			&bt_scan.scan_filters.addr;
 	addr_filter->cnt = 0;
+	memset(addr_filter->hash, 0, sizeof(addr_filter->hash));
 
 	struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
 	uuid_filter->cnt = 0;
+	memset(uuid_filter->hash, 0, sizeof(uuid_filter->hash));
 
 	struct bt_scan_appearance_filter *appearance_filter =
 			&bt_scan.scan_filters.appearance;
@@ -1237,10 +1408,10 @@ void bt_scan_filter_remove_all(void)
 		&bt_scan.scan_filters.manufacturer_data;
 	manufacturer_data_filter->cnt = 0;
 
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(changed);
 }
 
-void bt_scan_filter_disable(void)
+static void filters_disable(void)
 {
 	/* Disable all filters. */
 	bt_scan.scan_filters.name.enabled = false;
@@ -1251,6 +1422,16 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
 }
 
+void bt_scan_filter_disable(void)
+{
+	bool changed;
+
+	filters_write_begin();
+	changed = (filters_mode_get() != 0);
+	filters_disable();
+	filters_write_end(changed);
+}
+
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
 {
 	/* Check if the mode is correct. */
@@ -1258,10 +1439,14 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 		return -EINVAL;
 	}
 
-	/* Disable filters. */
-	bt_scan_filter_disable();
+	filters_write_begin();
 
 	struct bt_scan_filters *filters = &bt_scan.scan_filters;
+	uint8_t old_mode = filters_mode_get();
+	bool old_all_mode = filters->all_mode;
+
+	/* Disable filters. */
+	filters_disable();
 
 	/* Turn on the filters of your choice. */
 	if (mode & BT_SCAN_ADDR_FILTER) {
@@ -1291,6 +1476,9 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	filters_write_end((filters_mode_get() != old_mode) ||
+			  (filters->all_mode != old_all_mode));
+
 	return 0;
 }
 
@@ -1330,7 +1518,9 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 	bt_le_scan_cb_register(&scan_cb);
 
 	/* Disable all scanning filters. */
+	filters_write_begin();
 	memset(&bt_scan.scan_filters, 0, sizeof(bt_scan.scan_filters));
+	filters_write_end(true);
 
 	/* If the pointer to the initialization structure exist,
 	 * use it to scan the configuration.
@@ -1362,6 +1552,10 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 	bt_conn_cb_register(&conn_callbacks);
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
 }
 
 void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
@@ -1398,11 +1592,16 @@ static void check_enabled_filters(struct bt_scan_control *control)
 	}
 }
 
-static bool adv_data_found(struct bt_data *data, void *user_data)
+static bool is_adv_data_filter_enabled(void)
 {
-	struct bt_scan_control *scan_control =
-			(struct bt_scan_control *)user_data;
+	return is_name_filter_enabled() || is_short_name_filter_enabled() ||
+	       is_uuid_filter_enabled() || is_appearance_filter_enabled() ||
+	       is_manufacturer_data_filter_enabled();
+}
 
+static void adv_data_found(const struct bt_data *data,
+			   struct bt_scan_control *scan_control)
+{
 	switch (data->type) {
 	case BT_DATA_NAME_COMPLETE:
 		/* Check the name filter. */
@@ -1444,14 +1643,167 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 	default:
 		break;
 	}
+}
 
-	return true;
+/* Check all advertising data structures against the enabled filters in one pass. Equivalent to
+ * bt_data_parse(), but the buffer is read in place instead of being pulled from.
+ */
+static void adv_data_parse(const struct net_buf_simple *ad,
+			   struct bt_scan_control *control)
+{
+	const uint8_t *p = ad->data;
+	size_t len = ad->len;
+
+	while (len > 1) {
+		struct bt_data data;
+		uint8_t field_len = p[0];
+
+		/* Check for early termination. */
+		if (field_len == 0) {
+			return;
+		}
+
+		if (field_len > len - 1) {
+			LOG_WRN("Malformed advertising data");
+			return;
+		}
+
+		data.type = p[1];
+		data.data_len = field_len - 1;
+		data.data = &p[2];
+
+		adv_data_found(&data, control);
+
+		p += field_len + 1;
+		len -= field_len + 1;
+	}
+}
+
+#if CONFIG_BT_SCAN_DEDUP
+static void dedup_reset(void)
+{
+	sys_dlist_init(&dedup.lru);
+
+	for (size_t i = 0; i < ARRAY_SIZE(dedup.bucket); i++) {
+		sys_slist_init(&dedup.bucket[i]);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(dedup.entry); i++) {
+		dedup.entry[i].used = false;
+		sys_dlist_append(&dedup.lru, &dedup.entry[i].lru_node);
+	}
+}
+
+/* Returns true if the same advertisement was reported less than
+ * CONFIG_BT_SCAN_DEDUP_TTL_MS ago. Otherwise, the advertisement is stored
+ * in place of the least recently received one. Advertisements are told
+ * apart by address, PDU type and advertising data, so that a scan response
+ * with the same data as the advertisement is reported too.
+ */
+static bool dedup_check(const struct bt_le_scan_recv_info *info,
+			const struct net_buf_simple *ad)
+{
+	const bt_addr_le_t *addr = info->addr;
+	uint32_t now = k_uptime_get_32();
+	uint32_t ad_hash = hash_bytes(ad->data, ad->len);
+	size_t bucket = (addr_hash(addr) ^ ad_hash ^ info->adv_type) %
+			ARRAY_SIZE(dedup.bucket);
+	struct dedup_entry *entry;
+
+	if (atomic_clear(&dedup.clear)) {
+		dedup_reset();
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&dedup.bucket[bucket], entry, bucket_node) {
+		if ((entry->ad_hash != ad_hash) ||
+		    (entry->adv_type != info->adv_type) ||
+		    bt_addr_le_cmp(&entry->addr, addr)) {
+			continue;
+		}
+
+		sys_dlist_remove(&entry->lru_node);
+		sys_dlist_prepend(&dedup.lru, &entry->lru_node);
+
+		if ((CONFIG_BT_SCAN_DEDUP_TTL_MS == 0) ||
+		    ((now - entry->timestamp) < CONFIG_BT_SCAN_DEDUP_TTL_MS)) {
+			atomic_inc(&dedup.hits);
+			return true;
+		}
+
+		/* Expired, report the advertisement again. */
+		entry->timestamp = now;
+		atomic_inc(&dedup.misses);
+		return false;
+	}
+
+	entry = SYS_DLIST_CONTAINER(sys_dlist_peek_tail(&dedup.lru), entry,
+				    lru_node);
+
+	if (entry->used) {
+		sys_slist_find_and_remove(&dedup.bucket[entry->bucket],
+					  &entry->bucket_node);
+		atomic_inc(&dedup.evictions);
+	}
+
+	bt_addr_le_copy(&entry->addr, addr);
+	entry->ad_hash = ad_hash;
+	entry->adv_type = info->adv_type;
+	entry->timestamp = now;
+	entry->bucket = bucket;
+	entry->used = true;
+
+	sys_slist_prepend(&dedup.bucket[bucket], &entry->bucket_node);
+	sys_dlist_remove(&entry->lru_node);
+	sys_dlist_prepend(&dedup.lru, &entry->lru_node);
+
+	atomic_inc(&dedup.misses);
+
+	return false;
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+static void filters_match(struct bt_scan_control *control,
+			  const struct bt_le_scan_recv_info *info,
+			  const struct net_buf_simple *ad)
+{
+	const struct bt_scan_filter_match *status = &control->filter_status;
+
+	memset(control, 0, sizeof(*control));
+
+	if (!scan_device_filter_check(info->addr)) {
+		control->device_filtered = true;
+		return;
+	}
+
+	control->all_mode = bt_scan.scan_filters.all_mode;
+
+	check_enabled_filters(control);
+
+	/* Check the address filter. */
+	check_addr(control, info->addr);
+
+	if (is_adv_data_filter_enabled()) {
+		adv_data_parse(ad, control);
+	}
+
+	if (is_uuid_filter_enabled()) {
+		uuid_match_check(control);
+	}
+
+	/* A filter type is counted once, even if it is matched by several
+	 * advertising data structures.
+	 */
+	control->filter_match_cnt = status->name.match + status->short_name.match +
+				    status->addr.match + status->uuid.match +
+				    status->appearance.match +
+				    status->manufacturer_data.match;
+	control->filter_match = (control->filter_match_cnt > 0);
 }
 
 static void filter_state_check(struct bt_scan_control *control,
 			       const bt_addr_le_t *addr)
 {
-	if (!scan_device_filter_check(addr)) {
+	if (control->device_filtered) {
 		return;
 	}
 
@@ -1481,28 +1833,34 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 		      struct net_buf_simple *ad)
 {
 	struct bt_scan_control scan_control;
-	struct net_buf_simple_state state;
+	atomic_val_t seq;
+
+#if CONFIG_BT_SCAN_DEDUP
+	if (dedup_check(info, ad)) {
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_DEDUP */
 
-	memset(&scan_control, 0, sizeof(scan_control));
+	seq = atomic_get(&filter_seq);
 
-	scan_control.all_mode = bt_scan.scan_filters.all_mode;
+	/* The filters are read without taking the mutex. If they were changed
+	 * meanwhile, the result might be inconsistent and the report is matched
+	 * again with the mutex taken.
+	 */
+	if ((seq & 1) == 0) {
+		filters_match(&scan_control, info, ad);
+	}
 
-	check_enabled_filters(&scan_control);
+	if (((seq & 1) != 0) || (atomic_get(&filter_seq) != seq)) {
+		k_mutex_lock(&scan_mutex, K_FOREVER);
+		filters_match(&scan_control, info, ad);
+		k_mutex_unlock(&scan_mutex);
+	}
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
 		(info->adv_props & BT_GAP_ADV_PROP_CONNECTABLE) != 0;
 
-	/* Check the address filter. */
-	check_addr(&scan_control, info->addr);
-
-	/* Save advertising buffer state to transfer it
-	 * data to application if futher processing is needed.
-	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
-
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
 	scan_control.device_info.adv_data = ad;
@@ -1572,16 +1930,14 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr)
 
 	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
 
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 
 	/* Check if the device is already on the blocklist. */
-	for (size_t i = 0; i < ARRAY_SIZE(bt_scan.blocklist.addr); i++) {
-		if (bt_addr_le_cmp(&bt_scan.blocklist.addr[i], addr) == 0) {
-			LOG_DBG("Device %s is already on the blocklist",
-				log_strdup(addr_str));
+	if (blocklist_device_check(addr)) {
+		LOG_DBG("Device %s is already on the blocklist",
+			log_strdup(addr_str));
 
-			goto out;
-		}
+		goto out;
 	}
 
 	if (bt_scan.blocklist.count >= ARRAY_SIZE(bt_scan.blocklist.addr)) {
@@ -1590,30 +1946,53 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr)
 	} else {
 		bt_addr_le_copy(&bt_scan.blocklist.addr[bt_scan.blocklist.count],
 				addr);
+		hash_insert(bt_scan.blocklist.hash, ARRAY_SIZE(bt_scan.blocklist.hash),
+			    addr_hash(addr), bt_scan.blocklist.count);
 		bt_scan.blocklist.count++;
 		LOG_INF("Device %s added to the scanning blocklist",
 			log_strdup(addr_str));
 	}
 
 out:
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(false);
 
 	return err;
 }
 
 void bt_scan_blocklist_clear(void)
 {
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 	memset(&bt_scan.blocklist, 0, sizeof(bt_scan.blocklist));
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(true);
 }
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+void bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats)
+{
+	__ASSERT_NO_MSG(stats);
+
+	stats->hits = atomic_get(&dedup.hits);
+	stats->misses = atomic_get(&dedup.misses);
+	stats->evictions = atomic_get(&dedup.evictions);
+}
+
+void bt_scan_dedup_clear(void)
+{
+	/* The cache is cleared in the context of scan_recv(). */
+	atomic_set(&dedup.clear, 1);
+
+	atomic_clear(&dedup.hits);
+	atomic_clear(&dedup.misses);
+	atomic_clear(&dedup.evictions);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 void bt_scan_conn_attempts_filter_clear(void)
 {
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+	filters_write_begin();
 	memset(&bt_scan.attempts_filter, 0, sizeof(bt_scan.attempts_filter));
-	k_mutex_unlock(&scan_mutex);
+	filters_write_end(true);
 }
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
@@ -38,3 +38,14 @@ APP_EVENT_TYPE_DEFINE(module_state_event,
 		  APP_EVENT_FLAGS_CREATE(
 			IF_ENABLED(CONFIG_CAF_INIT_LOG_MODULE_STATE_EVENTS,
 				(APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE))));
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+static uintptr_t module_state_event_key(const struct app_event_header *aeh)
+{
+	const struct module_state_event *event = cast_module_state_event(aeh);
+
+	return (uintptr_t)event->module_id;
+}
+
+APP_EVENT_TYPE_KEY_DEFINE(module_state_event, module_state_event_key);
+#endif
@@ -11,6 +11,7 @@
 #include <caf/events/sensor_event.h>
 #include <caf/events/sensor_data_aggregator_event.h>
 #include <caf/sensor_manager.h>
+#include <caf/sensor_data_aggregator.h>
 
 #define MODULE sensor_data_aggregator
 #include <caf/events/module_state_event.h>
@@ -74,12 +75,14 @@ struct aggregator_buffer {
 	uint8_t *data;		/* Dynamic data. */
 	bool busy;		/* Buffer status. */
 	uint8_t sample_cnt;	/* Number of samples already saved in the buffer. */
+	int64_t timestamp;	/* Uptime of the first sample in the buffer. */
 };
 
 struct aggregator {
 	const char *sensor_descr;		/* sensor_description of the sensor. */
 	struct aggregator_buffer *agg_buffers;	/* Buffers. */
 	struct aggregator_buffer *active_buf;	/* Active buffer to which data will be placed. */
+	struct aggregator_buffer *reserved_buf;	/* Buffer in which a sample is being written. */
 	enum sensor_state sensor_state;		/* Sensors state. */
 	const uint8_t sensor_data_size;		/* Size of sensor data in bytes. */
 	const uint8_t buf_count;		/* Number of buffers. */
@@ -92,6 +95,9 @@ static struct aggregator aggregators[] = {
 	DT_INST_FOREACH_STATUS_OKAY(__DEFINE_AGGREGATOR)
 };
 
+/* Protects the buffers, samples can be written from the sensor manager thread. */
+static struct k_spinlock lock;
+
 
 static struct aggregator_buffer *get_free_buffer(struct aggregator *agg)
 {
@@ -127,18 +133,21 @@ static void release_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
 static void send_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
 {
 	ab->busy = true;
+	agg->reserved_buf = NULL;
 	struct sensor_data_aggregator_event *event = new_sensor_data_aggregator_event();
 
 	event->buf = ab->data;
 	event->sample_cnt = ab->sample_cnt;
+	event->timestamp = ab->timestamp;
 	event->sensor_state = agg->sensor_state;
 	event->sensor_descr = agg->sensor_descr;
 	APP_EVENT_SUBMIT(event);
 }
 
-static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
+/* Must be called with the lock taken. */
+static int sample_reserve(struct aggregator *agg, size_t size, uint8_t **data)
 {
-	if (event->dyndata.size != agg->sensor_data_size) {
+	if (size != agg->sensor_data_size) {
 		return -EBADMSG;
 	}
 	if (!agg->active_buf) {
@@ -153,16 +162,83 @@ static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
 		__ASSERT_NO_MSG(false);
 		return -ENOMEM;
 	}
-	memcpy(&ab->data[pos], event->dyndata.data, event->dyndata.size);
+
+	*data = &ab->data[pos];
+
+	return 0;
+}
+
+/* Must be called with the lock taken. */
+static void sample_commit(struct aggregator *agg, int64_t timestamp)
+{
+	struct aggregator_buffer *ab = agg->active_buf;
+
+	if (ab->sample_cnt == 0) {
+		ab->timestamp = timestamp;
+	}
 	ab->sample_cnt++;
-	avail -= event->dyndata.size;
+
+	size_t avail = agg->buf_len - ab->sample_cnt * agg->sensor_data_size;
 
 	if (avail < agg->sensor_data_size) {
 		send_buffer(agg, ab);
 		agg->active_buf = get_free_buffer(agg);
 	}
+}
 
-	return 0;
+static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint8_t *data;
+	int err = sample_reserve(agg, event->dyndata.size, &data);
+
+	if (!err) {
+		memcpy(data, event->dyndata.data, event->dyndata.size);
+		sample_commit(agg, event->timestamp);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return err;
+}
+
+int sensor_data_aggregator_sample_reserve(const char *sensor_descr, size_t size, void **data)
+{
+	struct aggregator *agg = get_aggregator(sensor_descr);
+
+	if (!agg) {
+		return -ENOENT;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int err = sample_reserve(agg, size, (uint8_t **)data);
+
+	if (!err) {
+		agg->reserved_buf = agg->active_buf;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return err;
+}
+
+void sensor_data_aggregator_sample_commit(const char *sensor_descr, int64_t timestamp)
+{
+	struct aggregator *agg = get_aggregator(sensor_descr);
+
+	__ASSERT_NO_MSG(agg);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (agg->reserved_buf && (agg->reserved_buf == agg->active_buf)) {
+		sample_commit(agg, timestamp);
+	} else {
+		LOG_WRN("Dropped sample: %s. Buffer sent while the sample was written.",
+			sensor_descr);
+	}
+	agg->reserved_buf = NULL;
+
+	k_spin_unlock(&lock, key);
 }
 
 static bool event_handler(const struct app_event_header *aeh)
@@ -191,6 +267,8 @@ static bool event_handler(const struct app_event_header *aeh)
 
 		__ASSERT_NO_MSG(agg);
 
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
 		for (size_t i = 0; i < agg->buf_count; i++) {
 			if (agg->agg_buffers[i].data == event->buf) {
 				release_buffer(agg, &agg->agg_buffers[i]);
@@ -198,6 +276,8 @@ static bool event_handler(const struct app_event_header *aeh)
 			}
 		}
 
+		k_spin_unlock(&lock, key);
+
 		return false;
 	}
 
@@ -206,11 +286,16 @@ static bool event_handler(const struct app_event_header *aeh)
 		struct aggregator *agg = get_aggregator(event->descr);
 
 		if (agg) {
+			k_spinlock_key_t key = k_spin_lock(&lock);
 			struct aggregator_buffer *ab = agg->active_buf;
 
 			agg->sensor_state = event->state;
-			send_buffer(agg, ab);
-			agg->active_buf = get_free_buffer(agg);
+			if (ab) {
+				send_buffer(agg, ab);
+				agg->active_buf = get_free_buffer(agg);
+			}
+
+			k_spin_unlock(&lock, key);
 		}
 
 		return false;
@@ -11,6 +11,7 @@
 
 #include <caf/events/sensor_event.h>
 #include <caf/sensor_manager.h>
+#include <caf/sensor_data_aggregator.h>
 
 #include CONFIG_CAF_SENSOR_MANAGER_DEF_PATH
 
@@ -25,6 +26,10 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_SENSOR_MANAGER_LOG_LEVEL);
 #define SAMPLE_THREAD_STACK_SIZE	CONFIG_CAF_SENSOR_MANAGER_THREAD_STACK_SIZE
 #define SAMPLE_THREAD_PRIORITY		CONFIG_CAF_SENSOR_MANAGER_THREAD_PRIORITY
 
+/* Samples written directly into aggregator buffers are not converted to floats. */
+#define AGG_FORMAT_SENSOR_VALUE \
+	IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT_FORMAT_SENSOR_VALUE)
+
 struct sensor_data {
 	int sampling_period;
 	int64_t sample_timeout;
@@ -32,6 +37,10 @@ struct sensor_data {
 	atomic_t state;
 	unsigned int sleep_cntd;
 	atomic_t event_cnt;
+	atomic_t fifo_ready;
+	int64_t fifo_trigger_time;
+	int64_t fifo_last_time;
+	int fifo_last_cnt;
 };
 
 static struct sensor_data sensor_data[ARRAY_SIZE(sensor_configs)];
@@ -39,6 +48,7 @@ static struct sensor_data sensor_data[ARRAY_SIZE(sensor_configs)];
 static K_THREAD_STACK_DEFINE(sample_thread_stack, SAMPLE_THREAD_STACK_SIZE);
 static struct k_thread sample_thread;
 static struct k_sem can_sample;
+static struct k_spinlock fifo_lock;
 
 
 static void update_sensor_state(const struct sm_sensor_config *sc, struct sensor_data *sd,
@@ -53,19 +63,21 @@ static void update_sensor_state(const struct sm_sensor_config *sc, struct sensor
 	APP_EVENT_SUBMIT(event);
 }
 
-static void send_sensor_event(const char *descr, const float *data, const size_t data_cnt,
-			      atomic_t *event_cnt)
+static int64_t get_timestamp(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static struct sensor_event *alloc_sensor_event(const char *descr, const size_t data_cnt,
+					       int64_t timestamp)
 {
 	struct sensor_event *event = new_sensor_event(sizeof(float) * data_cnt);
-	float *data_ptr = sensor_event_get_data_ptr(event);
 
 	event->descr = descr;
-
+	event->timestamp = timestamp;
 	__ASSERT_NO_MSG(sensor_event_get_data_cnt(event) == data_cnt);
-	memcpy(data_ptr, data, sizeof(float) * data_cnt);
 
-	atomic_inc(event_cnt);
-	APP_EVENT_SUBMIT(event);
+	return event;
 }
 
 static struct sensor_data *get_sensor_data(const struct device *dev)
@@ -169,12 +181,56 @@ static bool is_sensor_active(const struct sensor_data *sd)
 	return sd->sleep_cntd != 0;
 }
 
+static void fifo_trigger_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+	struct sensor_data *sd = get_sensor_data(dev);
+	k_spinlock_key_t key = k_spin_lock(&fifo_lock);
+
+	sd->fifo_trigger_time = get_timestamp();
+	k_spin_unlock(&fifo_lock, key);
+
+	atomic_set(&sd->fifo_ready, true);
+	k_sem_give(&can_sample);
+}
+
+static int fifo_trigger_set(const struct sm_sensor_config *sc, struct sensor_data *sd,
+			    bool enable)
+{
+	if (!IS_ENABLED(CONFIG_CAF_SENSOR_MANAGER_FIFO) || !sc->fifo) {
+		return 0;
+	}
+
+	int err = sensor_trigger_set(sc->dev, &sc->fifo->trigger,
+				     enable ? fifo_trigger_handler : NULL);
+
+	if (err) {
+		LOG_ERR("Error setting FIFO trigger (err:%d)", err);
+	}
+
+	if (enable) {
+		/* Time of the previous batch is unknown after a break in sampling. */
+		k_spinlock_key_t key = k_spin_lock(&fifo_lock);
+
+		sd->fifo_last_time = 0;
+		sd->fifo_last_cnt = 0;
+		k_spin_unlock(&fifo_lock, key);
+	} else {
+		atomic_clear(&sd->fifo_ready);
+	}
+
+	return err;
+}
+
 static void sensor_wake_up_post(const struct sm_sensor_config *sc, struct sensor_data *sd)
 {
 	sd->sample_timeout = k_uptime_get();
 	if (sc->trigger) {
 		reset_sensor_sleep_cnt(sc, sd);
 	}
+	if (fifo_trigger_set(sc, sd, true)) {
+		update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
+		return;
+	}
 	update_sensor_state(sc, sd, SENSOR_STATE_ACTIVE);
 }
 
@@ -206,7 +262,11 @@ static void enter_sleep(const struct sm_sensor_config *sc,
 			struct sensor_data *sd)
 {
 	k_sched_lock();
-	int err = sensor_trigger_set(sc->dev, &sc->trigger->cfg, trigger_handler);
+	int err = fifo_trigger_set(sc, sd, false);
+
+	if (!err) {
+		err = sensor_trigger_set(sc->dev, &sc->trigger->cfg, trigger_handler);
+	}
 
 	if (err) {
 		LOG_ERR("Error setting trigger (err:%d)", err);
@@ -217,14 +277,53 @@ static void enter_sleep(const struct sm_sensor_config *sc,
 	k_sched_unlock();
 }
 
-static void sample_sensor(struct sensor_data *sd, const struct sm_sensor_config *sc)
+static int reserve_aggregator_sample(const struct sm_sensor_config *sc, size_t data_cnt,
+				     struct sensor_value **data, float **curr)
+{
+	if (!IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		return -ENOENT;
+	}
+
+	size_t value_size = AGG_FORMAT_SENSOR_VALUE ? sizeof(struct sensor_value) : sizeof(float);
+	void *buf;
+	int err = sensor_data_aggregator_sample_reserve(sc->event_descr, data_cnt * value_size,
+							&buf);
+
+	if (err) {
+		return err;
+	}
+
+	/* Store samples directly in the aggregator buffer to avoid copying. */
+	if (AGG_FORMAT_SENSOR_VALUE) {
+		*data = buf;
+	} else {
+		*curr = buf;
+	}
+
+	return 0;
+}
+
+/* Read the channels of a fetched sample and pass them to the aggregator or a sensor event. */
+static int process_sample(struct sensor_data *sd, const struct sm_sensor_config *sc,
+			  int64_t timestamp)
 {
 	size_t data_idx = 0;
 	size_t data_cnt = get_sensor_data_cnt(sc);
-	struct sensor_value data[data_cnt];
-	float curr[data_cnt];
+	struct sensor_value data_buf[data_cnt];
+	struct sensor_value *data = data_buf;
+	float curr_buf[data_cnt];
+	float *curr = curr_buf;
+	struct sensor_event *event = NULL;
+
+	/* -ENOENT if the sensor has no aggregator, sensor events are used then. */
+	int agg_err = reserve_aggregator_sample(sc, data_cnt, &data, &curr);
+
+	if (agg_err && (agg_err != -ENOENT)) {
+		LOG_WRN("Did not aggregate sample (err %d) on sensor: %s", agg_err,
+			sc->dev->name);
+	}
 
-	int err = sensor_sample_fetch(sc->dev);
+	int err = 0;
 
 	for (size_t i = 0; !err && (i < sc->chan_cnt); i++) {
 		const struct sm_sampled_channel *sampled_chan = &sc->chans[i];
@@ -233,29 +332,123 @@ static void sample_sensor(struct sensor_data *sd, const struct sm_sensor_config
 		data_idx += sampled_chan->data_cnt;
 	}
 
-	for (size_t i = 0; i < ARRAY_SIZE(curr); i++) {
-		curr[i] = sensor_value_to_double(&data[i]);
+	if (err) {
+		LOG_ERR("Sensor sampling error (err %d)", err);
+		update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
+		return err;
+	}
+
+	if (agg_err != -ENOENT) {
+		/* Sensor with aggregator, no event is submitted. */
+	} else if (atomic_get(&sd->event_cnt) < sc->active_events_limit) {
+		/* Store samples directly in the event to avoid copying. */
+		event = alloc_sensor_event(sc->event_descr, data_cnt, timestamp);
+		curr = sensor_event_get_data_ptr(event);
+	} else {
+		LOG_WRN("Did not send event due to too many active events on sensor: %s",
+			sc->dev->name);
+	}
+
+	/* Values in sensor_value format are only converted for activity checks. */
+	if (!AGG_FORMAT_SENSOR_VALUE || (agg_err != 0) || sc->trigger) {
+		for (size_t i = 0; i < data_cnt; i++) {
+			curr[i] = sensor_value_to_double(&data[i]);
+		}
+	}
+
+	/* Event data must be processed before the event is submitted. */
+	if (sc->trigger) {
+		process_sensor_activity(sc, sd, curr);
+	}
+
+	if (event) {
+		atomic_inc(&sd->event_cnt);
+		APP_EVENT_SUBMIT(event);
 	}
 
+	if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT) && !agg_err) {
+		sensor_data_aggregator_sample_commit(sc->event_descr, timestamp);
+	}
+
+	return 0;
+}
+
+static int sample_sensor(struct sensor_data *sd, const struct sm_sensor_config *sc,
+			 int64_t timestamp)
+{
+	int err = sensor_sample_fetch(sc->dev);
+
 	if (err) {
 		LOG_ERR("Sensor sampling error (err %d)", err);
 		update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
-	} else {
-		if (atomic_get(&sd->event_cnt) < sc->active_events_limit) {
-			send_sensor_event(sc->event_descr, curr, ARRAY_SIZE(curr),
-					  &sd->event_cnt);
-		} else {
-			LOG_WRN("Did not send event due to too many active events on sensor: %s",
-				sc->dev->name);
+		return err;
+	}
+
+	return process_sample(sd, sc, timestamp);
+}
+
+static void sample_sensor_fifo(struct sensor_data *sd, const struct sm_sensor_config *sc)
+{
+	int watermark = sc->fifo->watermark;
+	/* Samples stored while the FIFO is read are read as well. The limit prevents
+	 * starving other sensors, the remaining samples are read on the next trigger.
+	 */
+	int max_cnt = 2 * watermark;
+	int cnt = 0;
+	int64_t nominal_period = (int64_t)sc->sampling_period_ms * USEC_PER_MSEC;
+	int64_t period = nominal_period;
+	k_spinlock_key_t key = k_spin_lock(&fifo_lock);
+	int64_t trigger_time = sd->fifo_trigger_time;
+	int64_t last_time = sd->fifo_last_time;
+	int last_cnt = sd->fifo_last_cnt;
+
+	sd->fifo_last_time = trigger_time;
+	k_spin_unlock(&fifo_lock, key);
+
+	/* The sample at the watermark is taken when the trigger is raised. All samples read
+	 * since the previous trigger were taken after it, so samples are spread evenly over
+	 * that time to compensate for drift of the sensor clock.
+	 */
+	if (last_time && last_cnt) {
+		int64_t measured_period = (trigger_time - last_time) / last_cnt;
+
+		if ((measured_period > nominal_period / 2) &&
+		    (measured_period < nominal_period * 2)) {
+			period = measured_period;
 		}
+	}
 
-		if (sc->trigger) {
-			process_sensor_activity(sc, sd, curr);
-			if (!is_sensor_active(sd)) {
-				enter_sleep(sc, sd);
-			}
+	/* Triggers raised before the thread handles the previous one are merged. Read until
+	 * the FIFO is empty, so that the samples of a merged trigger are not left behind.
+	 */
+	while (cnt < max_cnt) {
+		int err = sensor_sample_fetch(sc->dev);
 
+		if (err == -ENODATA) {
+			break;
+		} else if (err) {
+			LOG_ERR("Sensor sampling error (err %d)", err);
+			update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
+			return;
+		}
+
+		if (process_sample(sd, sc, trigger_time + (cnt - (watermark - 1)) * period)) {
+			return;
 		}
+
+		cnt++;
+	}
+
+	if (cnt == max_cnt) {
+		LOG_WRN("FIFO of sensor %s not emptied", sc->dev->name);
+	}
+
+	key = k_spin_lock(&fifo_lock);
+	sd->fifo_last_cnt = cnt;
+	k_spin_unlock(&fifo_lock, key);
+
+	if (sc->trigger && !is_sensor_active(sd)) {
+		enter_sleep(sc, sd);
 	}
 }
 
@@ -270,9 +463,19 @@ static size_t sample_sensors(int64_t *next_timeout)
 		struct sensor_data *sd = &sensor_data[i];
 		const struct sm_sensor_config *sc = &sensor_configs[i];
 
-		if (atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) {
+		if (IS_ENABLED(CONFIG_CAF_SENSOR_MANAGER_FIFO) && sc->fifo) {
+			/* Sensor is read only when its FIFO watermark is reached. */
+			if ((atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) &&
+			    atomic_cas(&sd->fifo_ready, true, false)) {
+				sample_sensor_fifo(sd, sc);
+			}
+		} else if (atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) {
 			if (sd->sample_timeout <= cur_uptime) {
-				sample_sensor(sd, sc);
+				int err = sample_sensor(sd, sc, get_timestamp());
+
+				if (!err && sc->trigger && !is_sensor_active(sd)) {
+					enter_sleep(sc, sd);
+				}
 			}
 
 			int drops = -1;
@@ -288,7 +491,8 @@ static size_t sample_sensors(int64_t *next_timeout)
 
 		if (atomic_get(&sd->state) != SENSOR_STATE_ERROR) {
 			alive_sensors++;
-			if (atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) {
+			if ((atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) &&
+			    !(IS_ENABLED(CONFIG_CAF_SENSOR_MANAGER_FIFO) && sc->fifo)) {
 				if (*next_timeout > sd->sample_timeout) {
 					*next_timeout = sd->sample_timeout;
 				}
@@ -406,6 +610,11 @@ static size_t sensor_init(void)
 			}
 		}
 
+		if (fifo_trigger_set(sc, sd, true)) {
+			update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
+			continue;
+		}
+
 		update_sensor_state(sc, sd, SENSOR_STATE_ACTIVE);
 		alive_sensors++;
 	}
@@ -426,7 +635,9 @@ static void sample_thread_fn(void)
 		module_set_state(MODULE_STATE_READY);
 
 		while (alive_sensors > 0) {
-			k_sem_take(&can_sample, K_TIMEOUT_ABS_MS(next_timeout));
+			/* No timeout if only sensors with FIFO are sampled. */
+			k_sem_take(&can_sample, (next_timeout == INT64_MAX) ?
+				   K_FOREVER : K_TIMEOUT_ABS_MS(next_timeout));
 
 			alive_sensors = sample_sensors(&next_timeout);
 			configure_max_power_state();
@@ -456,9 +667,9 @@ static bool handle_power_down_event(const struct app_event_header *aeh)
 			if (sc->trigger) {
 				enter_sleep(sc, sd);
 			} else if (atomic_get(&sd->state) == SENSOR_STATE_ACTIVE) {
-				int ret = 0;
+				int ret = fifo_trigger_set(sc, sd, false);
 
-				if (sc->suspend) {
+				if (!ret && sc->suspend) {
 					ret = pm_device_action_run(sc->dev,
 								   PM_DEVICE_ACTION_SUSPEND);
 				}
@@ -7,6 +7,10 @@
 #include <logging/log.h>
 #include <dfu/mcuboot.h>
 #include <dfu/dfu_target.h>
+#ifdef CONFIG_DFU_TARGET_DIGEST
+#include <string.h>
+#include <mbedtls/sha256.h>
+#endif
 
 #define DEF_DFU_TARGET(name) \
 static const struct dfu_target dfu_target_ ## name  = { \
@@ -15,6 +19,7 @@ static const struct dfu_target dfu_target_ ## name  = { \
 	.write = dfu_target_ ## name ## _write, \
 	.done = dfu_target_ ## name ## _done, \
 	.schedule_update = dfu_target_ ## name ## _schedule_update, \
+	.reset = dfu_target_ ## name ## _reset, \
 }
 
 #ifdef CONFIG_DFU_TARGET_MODEM_DELTA
@@ -36,6 +41,146 @@ LOG_MODULE_REGISTER(dfu_target, CONFIG_DFU_TARGET_LOG_LEVEL);
 
 static const struct dfu_target *current_target;
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+static mbedtls_sha256_context digest_ctx;
+/* The image has been hashed from its first byte. */
+static bool digest_started;
+/* Number of bytes hashed, to detect a download that skips data. */
+static size_t digest_offset;
+static bool digest_available;
+static uint8_t digest[DFU_TARGET_DIGEST_SIZE];
+static bool expected_digest_set;
+static uint8_t expected_digest[DFU_TARGET_DIGEST_SIZE];
+
+static void digest_start(void)
+{
+	size_t offset;
+	int err;
+
+	digest_started = false;
+	digest_available = false;
+	digest_offset = 0;
+
+	err = current_target->offset_get(&offset);
+	if (err != 0 || offset != 0) {
+		/* The data that was written before is not hashed again */
+		LOG_WRN("Image resumed, digest is not computed");
+		return;
+	}
+
+	mbedtls_sha256_init(&digest_ctx);
+	err = mbedtls_sha256_starts(&digest_ctx, false);
+	if (err != 0) {
+		LOG_ERR("mbedtls_sha256_starts error %d", err);
+		return;
+	}
+
+	digest_started = true;
+}
+
+static void digest_resume(void)
+{
+	size_t offset;
+	int err;
+
+	if (!digest_started) {
+		return;
+	}
+
+	err = current_target->offset_get(&offset);
+	if (err != 0 || offset != digest_offset) {
+		LOG_WRN("Image resumed at other offset, digest is not computed");
+		digest_started = false;
+	}
+}
+
+static void digest_update(const void *const buf, size_t len)
+{
+	int err;
+
+	if (!digest_started) {
+		return;
+	}
+
+	err = mbedtls_sha256_update(&digest_ctx, buf, len);
+	if (err != 0) {
+		LOG_ERR("mbedtls_sha256_update error %d", err);
+		digest_started = false;
+		return;
+	}
+
+	digest_offset += len;
+}
+
+/* An expected digest that cannot be compared is an error, the image is
+ * not trusted then.
+ */
+static int digest_unavailable(void)
+{
+	if (expected_digest_set) {
+		LOG_WRN("Image digest not computed, image not verified");
+		return -ENODATA;
+	}
+
+	return 0;
+}
+
+static int digest_finish(void)
+{
+	int err;
+
+	if (!digest_started) {
+		return digest_unavailable();
+	}
+
+	digest_started = false;
+
+	err = mbedtls_sha256_finish(&digest_ctx, digest);
+	if (err != 0) {
+		LOG_ERR("mbedtls_sha256_finish error %d", err);
+		return digest_unavailable();
+	}
+
+	digest_available = true;
+
+	if (expected_digest_set &&
+	    memcmp(digest, expected_digest, sizeof(digest)) != 0) {
+		LOG_ERR("Image digest mismatch");
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int dfu_target_digest_expect(const uint8_t *expected)
+{
+	if (expected == NULL) {
+		expected_digest_set = false;
+		return 0;
+	}
+
+	memcpy(expected_digest, expected, sizeof(expected_digest));
+	expected_digest_set = true;
+
+	return 0;
+}
+
+int dfu_target_digest_get(uint8_t *out)
+{
+	if (out == NULL) {
+		return -EINVAL;
+	}
+
+	if (!digest_available) {
+		return -ENODATA;
+	}
+
+	memcpy(out, digest, sizeof(digest));
+
+	return 0;
+}
+#endif /* CONFIG_DFU_TARGET_DIGEST */
+
 int dfu_target_img_type(const void *const buf, size_t len)
 {
 	if (len < MIN_SIZE_IDENTIFY_BUF) {
@@ -92,12 +237,25 @@ int dfu_target_init(int img_type, int img_num, size_t file_size, dfu_target_call
 	 */
 	if (new_target == current_target
 	   && img_type != DFU_TARGET_IMAGE_TYPE_MODEM_DELTA) {
+#ifdef CONFIG_DFU_TARGET_DIGEST
+		digest_resume();
+#endif
 		return 0;
 	}
 
 	current_target = new_target;
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	int err = current_target->init(file_size, img_num, cb);
+
+	if (err == 0) {
+		digest_start();
+	}
+
+	return err;
+#else
 	return current_target->init(file_size, img_num, cb);
+#endif
 }
 
 int dfu_target_offset_get(size_t *offset)
@@ -115,7 +273,17 @@ int dfu_target_write(const void *const buf, size_t len)
 		return -EACCES;
 	}
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	int err = current_target->write(buf, len);
+
+	if (err == 0) {
+		digest_update(buf, len);
+	}
+
+	return err;
+#else
 	return current_target->write(buf, len);
+#endif
 }
 
 int dfu_target_done(bool successful)
@@ -126,6 +294,28 @@ int dfu_target_done(bool successful)
 		return -EACCES;
 	}
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	if (successful) {
+		int verify_err = digest_finish();
+
+		expected_digest_set = false;
+
+		if (verify_err != 0) {
+			/* Never schedule the image, and erase it */
+			if (current_target->done(false) != 0) {
+				LOG_ERR("Unable to clean up dfu_target");
+			}
+
+			if (current_target->reset() != 0) {
+				LOG_ERR("Unable to discard image");
+			}
+
+			current_target = NULL;
+			return verify_err;
+		}
+	}
+#endif
+
 	err = current_target->done(successful);
 	if (err != 0) {
 		LOG_ERR("Unable to clean up dfu_target");
@@ -146,9 +336,37 @@ int dfu_target_reset(void)
 		}
 	}
 	current_target = NULL;
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	digest_started = false;
+	expected_digest_set = false;
+#endif
 	return 0;
 }
 
+int dfu_target_discard(void)
+{
+	int err = 0;
+
+	if (current_target != NULL) {
+		err = current_target->done(false);
+		if (err != 0) {
+			LOG_ERR("Unable to clean up dfu_target");
+		}
+
+		/* Discard the image even if the clean up failed */
+		err = current_target->reset();
+		if (err != 0) {
+			LOG_ERR("Unable to discard image");
+		}
+	}
+	current_target = NULL;
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	digest_started = false;
+	expected_digest_set = false;
+#endif
+	return err;
+}
+
 int dfu_target_schedule_update(int img_num)
 {
 	int err = 0;
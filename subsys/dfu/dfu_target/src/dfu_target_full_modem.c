@@ -85,3 +85,8 @@ int dfu_target_full_modem_schedule_update(int img_num)
 
 	return 0;
 }
+
+int dfu_target_full_modem_reset(void)
+{
+	return dfu_target_stream_reset();
+}
@@ -226,6 +226,13 @@ int dfu_target_mcuboot_done(bool successful)
 	return err;
 }
 
+int dfu_target_mcuboot_reset(void)
+{
+	stream_buf_bytes = 0;
+
+	return dfu_target_stream_reset();
+}
+
 static int dfu_target_mcuboot_schedule_one_img(int img_num)
 {
 	int err = 0;
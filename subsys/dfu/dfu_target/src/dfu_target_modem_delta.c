@@ -180,6 +180,11 @@ int dfu_target_modem_delta_done(bool successful)
 	return 0;
 }
 
+int dfu_target_modem_delta_reset(void)
+{
+	return delete_banked_modem_delta_fw();
+}
+
 int dfu_target_modem_delta_schedule_update(int img_num)
 {
 	int err;
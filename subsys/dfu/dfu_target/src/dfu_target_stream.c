@@ -8,6 +8,7 @@
 #include <logging/log.h>
 #include <storage/stream_flash.h>
 #include <stdio.h>
+#include <string.h>
 #include <dfu/dfu_target_stream.h>
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
@@ -25,6 +26,13 @@ static const char *current_id;
 
 static char current_name_key[32];
 
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+/* State of the stream when the progress was last stored. */
+static size_t stored_bytes_written;
+static off_t stored_erased_page;
+static int64_t stored_time;
+#endif
+
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
@@ -42,9 +50,87 @@ static int store_progress(void)
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+	stored_bytes_written = bytes_written;
+	stored_erased_page = stream.last_erased_page_start_offset;
+	stored_time = k_uptime_get();
+#endif
+
 	return 0;
 }
 
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+/**
+ * @brief Check if the progress must be stored, that is if a new page has
+ *	  been erased or if one of the configured intervals has elapsed.
+ */
+static bool progress_store_due(void)
+{
+	size_t bytes_written = stream_flash_bytes_written(&stream);
+
+	if (bytes_written == stored_bytes_written) {
+		return false;
+	}
+
+	if (stream.last_erased_page_start_offset != stored_erased_page) {
+		return true;
+	}
+
+	if (CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_BYTES &&
+	    bytes_written - stored_bytes_written >=
+	    CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_BYTES) {
+		return true;
+	}
+
+	if (CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_MS &&
+	    k_uptime_get() - stored_time >=
+	    CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_MS) {
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Find the number of bytes written after the stored progress.
+ *
+ * The progress is stored at least once per erased page, so only the last
+ * erased page can contain data written after it. The data is written in
+ * chunks of the stream buffer size, and a chunk is considered written if
+ * its last byte is not erased. This may underestimate the progress,
+ * but never overestimates it.
+ *
+ * @param page_end Absolute offset of the end of the last erased page.
+ */
+static size_t progress_recover(off_t page_end)
+{
+	const struct flash_parameters *params = flash_get_parameters(stream.fdev);
+	const off_t start = stream.offset + stream.bytes_written;
+	off_t end = start;
+
+	for (off_t off = start; off < page_end; off += stream.buf_len) {
+		size_t len = MIN(stream.buf_len, page_end - off);
+		int err = flash_read(stream.fdev, off, stream.buf, len);
+
+		if (err) {
+			LOG_WRN("Unable to read flash at 0x%lx (err %d)",
+				(long)off, err);
+			break;
+		}
+
+		for (size_t i = len; i > 0; i--) {
+			if (stream.buf[i - 1] != params->erase_value) {
+				end = off + i;
+				break;
+			}
+		}
+	}
+
+	/* Only whole chunks, the last one may have been interrupted */
+	return ((end - start) / stream.buf_len) * stream.buf_len;
+}
+#endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE */
+
 /**
  * @brief Function used by settings_load() to restore the stream_flash ctx.
  *	  See the Zephyr documentation of the settings subsystem for more
@@ -85,14 +171,192 @@ static int settings_set(const char *key, size_t len_rd,
 		 * written data.
 		 */
 		stream.last_erased_page_start_offset = page.start_offset;
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+		size_t recovered = progress_recover(page.start_offset +
+						    page.size);
+
+		if (recovered) {
+			LOG_INF("Recovered %u bytes written after the stored "
+				"progress", recovered);
+			stream.bytes_written += recovered;
+		}
+#endif
 	}
 
 	return 0;
 }
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
+static int stream_write(const uint8_t *buf, size_t len)
+{
+	int err = stream_flash_buffered_write(&stream, buf, len, false);
+
+	if (err != 0) {
+		LOG_ERR("stream_flash_buffered_write error %d", err);
+		return err;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+	if (!progress_store_due()) {
+		return 0;
+	}
+#endif
+	err = store_progress();
+	if (err != 0) {
+		/* Failing to store progress is not a critical error you'll just
+		 * be left to download a bit more if you fail and resume.
+		 */
+		LOG_WRN("Unable to store write progress: %d", err);
+	}
+#endif
+
+	return err;
+}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+#define ASYNC_BUF_COUNT CONFIG_DFU_TARGET_STREAM_ASYNC_BUF_COUNT
+
+struct async_buf {
+	size_t len;
+	uint8_t data[CONFIG_DFU_TARGET_STREAM_ASYNC_BUF_SIZE];
+};
+
+static struct async_buf async_bufs[ASYNC_BUF_COUNT];
+/* Buffer being filled by the caller, NULL if none. */
+static struct async_buf *async_fill;
+/* Buffers are filled and written in order. */
+static size_t async_next;
+/* Counts the buffers that are not queued for writing. */
+static K_SEM_DEFINE(async_free, ASYNC_BUF_COUNT, ASYNC_BUF_COUNT);
+K_MSGQ_DEFINE(async_queue, sizeof(struct async_buf *), ASYNC_BUF_COUNT, 4);
+/* First error returned by the stream, reported to the caller. */
+static atomic_t async_err;
+
+static K_THREAD_STACK_DEFINE(async_stack_area,
+			     CONFIG_DFU_TARGET_STREAM_ASYNC_STACK_SIZE);
+static struct k_work_q async_work_q;
+static struct k_work async_work;
+
+static void async_work_fn(struct k_work *work)
+{
+	struct async_buf *buf;
+
+	while (k_msgq_get(&async_queue, &buf, K_NO_WAIT) == 0) {
+		/* Once a write has failed, the following data is dropped. */
+		if (atomic_get(&async_err) == 0) {
+			int err = stream_write(buf->data, buf->len);
+
+			if (err != 0) {
+				atomic_set(&async_err, err);
+			}
+		}
+
+		k_sem_give(&async_free);
+	}
+}
+
+static void async_submit(void)
+{
+	/* Cannot fail, the queue has room for all buffers. */
+	(void)k_msgq_put(&async_queue, &async_fill, K_NO_WAIT);
+	(void)k_work_submit_to_queue(&async_work_q, &async_work);
+
+	async_fill = NULL;
+}
+
+static int async_write(const uint8_t *buf, size_t len)
+{
+	int err = atomic_get(&async_err);
+
+	if (err != 0) {
+		return err;
+	}
+
+	while (len > 0) {
+		size_t chunk;
+
+		if (async_fill == NULL) {
+			/* Wait until a buffer has been written to flash.
+			 * This blocks the caller, and thereby the download,
+			 * when the flash cannot keep up.
+			 */
+			(void)k_sem_take(&async_free, K_FOREVER);
+
+			async_fill = &async_bufs[async_next];
+			async_fill->len = 0;
+			async_next = (async_next + 1) % ASYNC_BUF_COUNT;
+		}
+
+		chunk = MIN(len, sizeof(async_fill->data) - async_fill->len);
+		memcpy(async_fill->data + async_fill->len, buf, chunk);
+		async_fill->len += chunk;
+		buf += chunk;
+		len -= chunk;
+
+		if (async_fill->len == sizeof(async_fill->data)) {
+			async_submit();
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write all buffered data to the stream and wait for completion.
+ *
+ * @return The first error returned by the stream, if any.
+ */
+static int async_flush(void)
+{
+	if (async_fill != NULL) {
+		async_submit();
+	}
+
+	for (size_t i = 0; i < ASYNC_BUF_COUNT; i++) {
+		(void)k_sem_take(&async_free, K_FOREVER);
+	}
+
+	for (size_t i = 0; i < ASYNC_BUF_COUNT; i++) {
+		k_sem_give(&async_free);
+	}
+
+	return atomic_get(&async_err);
+}
+
+/**
+ * @brief Drop buffered data that was not queued for writing.
+ *
+ * Waits for the queued writes to complete and clears the write error, so that
+ * data of a stream that was not completed does not end up in the next one.
+ */
+static void async_drop(void)
+{
+	if (async_fill != NULL) {
+		LOG_WRN("Dropping %zu bytes not written to flash", async_fill->len);
+		async_fill = NULL;
+		k_sem_give(&async_free);
+	}
+
+	for (size_t i = 0; i < ASYNC_BUF_COUNT; i++) {
+		(void)k_sem_take(&async_free, K_FOREVER);
+	}
+
+	for (size_t i = 0; i < ASYNC_BUF_COUNT; i++) {
+		k_sem_give(&async_free);
+	}
+
+	atomic_set(&async_err, 0);
+}
+#endif /* CONFIG_DFU_TARGET_STREAM_ASYNC */
+
 struct stream_flash_ctx *dfu_target_stream_get_stream(void)
 {
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	(void)async_flush();
+#endif
+
 	return &stream;
 }
 
@@ -109,10 +373,24 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	static bool async_started;
+
+	if (!async_started) {
+		k_work_queue_start(&async_work_q, async_stack_area,
+				   K_THREAD_STACK_SIZEOF(async_stack_area),
+				   CONFIG_DFU_TARGET_STREAM_ASYNC_PRIORITY, NULL);
+		k_work_init(&async_work, async_work_fn);
+		async_started = true;
+	}
+
+	async_drop();
+#endif
+
 	current_id = init->id;
 
 	err = stream_flash_init(&stream, init->fdev, init->buf, init->len,
-				init->offset, init->size, NULL);
+				init->offset, init->size, init->cb);
 	if (err) {
 		LOG_ERR("stream_flash_init failed (err %d)", err);
 		return err;
@@ -149,6 +427,12 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		LOG_ERR("settings_load failed (err %d)", err);
 		return err;
 	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+	stored_bytes_written = stream_flash_bytes_written(&stream);
+	stored_erased_page = stream.last_erased_page_start_offset;
+	stored_time = k_uptime_get();
+#endif
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
 	return 0;
@@ -156,6 +440,14 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 
 int dfu_target_stream_offset_get(size_t *out)
 {
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	int err = async_flush();
+
+	if (err != 0) {
+		return err;
+	}
+#endif
+
 	*out = stream_flash_bytes_written(&stream);
 
 	return 0;
@@ -163,30 +455,27 @@ int dfu_target_stream_offset_get(size_t *out)
 
 int dfu_target_stream_write(const uint8_t *buf, size_t len)
 {
-	int err = stream_flash_buffered_write(&stream, buf, len, false);
-
-	if (err != 0) {
-		LOG_ERR("stream_flash_buffered_write error %d", err);
-		return err;
-	}
-
-#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
-	if (err != 0) {
-		/* Failing to store progress is not a critical error you'll just
-		 * be left to download a bit more if you fail and resume.
-		 */
-		LOG_WRN("Unable to store write progress: %d", err);
-	}
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	return async_write(buf, len);
+#else
+	return stream_write(buf, len);
 #endif
-
-	return err;
 }
 
 int dfu_target_stream_done(bool successful)
 {
 	int err = 0;
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	int write_err = async_flush();
+
+	if (write_err != 0) {
+		LOG_ERR("Asynchronous write failed (err %d)", write_err);
+		/* Keep the progress of the data that was written */
+		successful = false;
+	}
+#endif
+
 	if (successful) {
 		err = stream_flash_buffered_write(&stream, NULL, 0, true);
 		if (err != 0) {
@@ -214,5 +503,73 @@ int dfu_target_stream_done(bool successful)
 
 	current_id = NULL;
 
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	if (write_err != 0) {
+		atomic_set(&async_err, 0);
+		return write_err;
+	}
+#endif
+
+	return err;
+}
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+/**
+ * @brief Erase the flash pages that data was written to.
+ */
+static int erase_written(void)
+{
+	const off_t end = stream.offset + stream_flash_bytes_written(&stream);
+	struct flash_pages_info page;
+	int err;
+
+	for (off_t off = stream.offset; off < end;
+	     off = page.start_offset + page.size) {
+		err = flash_get_page_info_by_offs(stream.fdev, off, &page);
+		if (err != 0) {
+			LOG_ERR("Unable to get page info at 0x%lx (err %d)",
+				(long)off, err);
+			return err;
+		}
+
+		err = flash_erase(stream.fdev, page.start_offset, page.size);
+		if (err != 0) {
+			LOG_ERR("Unable to erase page at 0x%lx (err %d)",
+				(long)page.start_offset, err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_STREAM_FLASH_ERASE */
+
+int dfu_target_stream_reset(void)
+{
+	int err = 0;
+
+	if (current_id != NULL) {
+		return -EBUSY;
+	}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_ASYNC
+	async_drop();
+#endif
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	err = settings_delete(current_name_key);
+	if (err != 0) {
+		LOG_ERR("setting_delete error %d", err);
+		return err;
+	}
+#endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	/* Erased flash also prevents recovering the progress from
+	 * the data written after the progress was stored.
+	 */
+	err = erase_written();
+#endif
+
 	return err;
 }
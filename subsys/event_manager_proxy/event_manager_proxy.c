@@ -152,9 +152,13 @@ static void handle_ipc_endpoint_bound(void *priv)
 
 static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
 {
-	void *event = app_event_manager_alloc(len);
+	struct app_event_header *event = app_event_manager_alloc(len);
 
 	memcpy(event, data, len);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+	/* References taken on the remote core are not valid here. */
+	atomic_set(&event->ref_cnt, 1);
+#endif
 	_event_submit(event);
 }
 
@@ -273,7 +277,16 @@ static void handle_ipc_endpoint_error(const char *message, void *priv)
 	__ASSERT_NO_MSG(false);
 }
 
-static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+/**
+ * @brief Send the event to the remote.
+ *
+ * @param ipc       Element of the @ref emp_ipc_data array.
+ * @param eh        Pointer to the local event.
+ * @param remote_eh Buffer with the copy of the event. Only the event type is updated per remote.
+ * @param size      Size of the buffer.
+ */
+static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh,
+				struct app_event_header *remote_eh, size_t size)
 {
 	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
 
@@ -281,14 +294,9 @@ static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event
 		return 0;
 	}
 
-	size_t size = app_event_manager_event_size(eh);
-	uint32_t buffer[ceiling_fraction(size, sizeof(uint32_t))];
-	struct app_event_header *remote_eh = (struct app_event_header *)buffer;
-
-	memcpy(buffer, eh, sizeof(buffer));
 	remote_eh->type_id = remote_ev;
 
-	int ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
+	int ret = ipc_service_send(&ipc->ept, remote_eh, size);
 
 	if (ret < 0) {
 		LOG_ERR("Cannot send event to remote %p", ipc);
@@ -306,6 +314,10 @@ static void event_manager_proxy_on_event_process(const struct app_event_header *
 		return;
 	}
 
+	size_t size = app_event_manager_event_size(eh);
+	uint32_t buffer[ceiling_fraction(size, sizeof(uint32_t))];
+	bool copied = false;
+
 	for (size_t i = 0; (i < ARRAY_SIZE(emp_ipc_data)) && !ret; ++i) {
 		struct emp_ipc_data *ipc = &emp_ipc_data[i];
 
@@ -313,7 +325,16 @@ static void event_manager_proxy_on_event_process(const struct app_event_header *
 			continue;
 		}
 
-		ret = send_event_to_remote(ipc, eh);
+		/* The event is copied once and shared by all the remotes. The processed
+		 * event is left untouched, as other listeners may still access it.
+		 */
+		if (!copied) {
+			memcpy(buffer, eh, sizeof(buffer));
+			copied = true;
+		}
+
+		ret = send_event_to_remote(ipc, eh, (struct app_event_header *)buffer,
+					   sizeof(buffer));
 	}
 }
 APP_EVENT_HOOK_POSTPROCESS_REGISTER(event_manager_proxy_on_event_process);
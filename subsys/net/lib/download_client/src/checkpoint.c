@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/crc.h>
+#include <settings/settings.h>
+#include <logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define MODULE "dl_client"
+#define CHECKPOINT_KEY "checkpoint"
+
+/* Only the last download is checkpointed. */
+struct checkpoint {
+	/* CRC32 of the host and file name, zero if there is no checkpoint. */
+	uint32_t id;
+	uint32_t offset;
+	char validator[CONFIG_DOWNLOAD_CLIENT_VALIDATOR_SIZE];
+};
+
+static struct checkpoint checkpoint;
+
+static uint32_t checkpoint_id(const char *host, const char *file)
+{
+	uint32_t id = crc32_ieee((const uint8_t *)host, strlen(host));
+
+	id = crc32_ieee_update(id, (const uint8_t *)file, strlen(file));
+
+	/* Zero means no checkpoint */
+	return id ? id : 1;
+}
+
+static int settings_set(const char *key, size_t len_rd,
+			settings_read_cb read_cb, void *cb_arg)
+{
+	ssize_t len;
+
+	if (strcmp(key, CHECKPOINT_KEY)) {
+		return -ENOENT;
+	}
+
+	len = read_cb(cb_arg, &checkpoint, sizeof(checkpoint));
+	if (len != sizeof(checkpoint)) {
+		LOG_WRN("Discarding checkpoint of unexpected size %d", len);
+		memset(&checkpoint, 0, sizeof(checkpoint));
+	}
+
+	checkpoint.validator[sizeof(checkpoint.validator) - 1] = '\0';
+
+	return 0;
+}
+
+int checkpoint_init(void)
+{
+	int err;
+	static struct settings_handler sh = {
+		.name = MODULE,
+		.h_set = settings_set,
+	};
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_register(&sh);
+	if (err && err != -EEXIST) {
+		LOG_ERR("settings_register failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_load_subtree(MODULE);
+	if (err) {
+		LOG_ERR("settings_load_subtree failed (err %d)", err);
+		return err;
+	}
+
+	return 0;
+}
+
+void checkpoint_start(struct download_client *client, size_t from)
+{
+	const uint32_t id = checkpoint_id(client->host, client->file);
+
+	client->http.checkpoint = from;
+
+	if (from != 0 && checkpoint.id == id) {
+		/* Resume the download of the file that was checkpointed */
+		strcpy(client->http.validator, checkpoint.validator);
+	} else {
+		/* The validator is taken from the first response */
+		client->http.validator[0] = '\0';
+	}
+}
+
+void checkpoint_update(struct download_client *client)
+{
+	int err;
+	const uint32_t id = checkpoint_id(client->host, client->file);
+
+	/* Store the validator as soon as the first fragment of a file
+	 * is received, then store the progress periodically.
+	 */
+	if (checkpoint.id == id &&
+	    !strcmp(checkpoint.validator, client->http.validator) &&
+	    client->progress < client->http.checkpoint +
+			       CONFIG_DOWNLOAD_CLIENT_CHECKPOINT_INTERVAL) {
+		return;
+	}
+
+	checkpoint.id = id;
+	checkpoint.offset = client->progress;
+	strcpy(checkpoint.validator, client->http.validator);
+
+	err = settings_save_one(MODULE "/" CHECKPOINT_KEY, &checkpoint,
+				sizeof(checkpoint));
+	if (err) {
+		/* Not critical, the download is resumed from
+		 * the previous checkpoint instead.
+		 */
+		LOG_WRN("Unable to store checkpoint (err %d)", err);
+		return;
+	}
+
+	LOG_DBG("Checkpoint at %u bytes", client->progress);
+	client->http.checkpoint = client->progress;
+}
+
+void checkpoint_clear(struct download_client *client)
+{
+	int err;
+
+	if (checkpoint.id != checkpoint_id(client->host, client->file)) {
+		return;
+	}
+
+	memset(&checkpoint, 0, sizeof(checkpoint));
+
+	err = settings_delete(MODULE "/" CHECKPOINT_KEY);
+	if (err) {
+		LOG_WRN("Unable to delete checkpoint (err %d)", err);
+	}
+}
+
+int download_client_checkpoint_get(const struct download_client *client,
+				   const char *file, size_t *offset)
+{
+	if (client == NULL || client->host == NULL || file == NULL ||
+	    offset == NULL) {
+		return -EINVAL;
+	}
+
+	if (checkpoint.id != checkpoint_id(client->host, file)) {
+		return -ENOENT;
+	}
+
+	*offset = checkpoint.offset;
+
+	return 0;
+}
@@ -35,6 +35,11 @@ int url_parse_host(const char *url, char *host, size_t len);
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
 
+int checkpoint_init(void);
+void checkpoint_start(struct download_client *client, size_t from);
+void checkpoint_update(struct download_client *client);
+void checkpoint_clear(struct download_client *client);
+
 int coap_block_init(struct download_client *client, size_t from);
 int coap_get_recv_timeout(struct download_client *dl);
 int coap_initiate_retransmission(struct download_client *dl);
@@ -333,7 +338,8 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len, int timeout)
 {
 	int err;
 	int sent;
@@ -345,7 +351,7 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	}
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(client->fd, buf + off, len, 0);
 		if (sent < 0) {
 			return -errno;
 		}
@@ -402,11 +408,21 @@ static int error_evt_send(const struct download_client *dl, int error)
 	return dl->callback(&evt);
 }
 
+static void http_pipeline_reset(struct download_client *dl)
+{
+	/* Pending requests are lost with the connection,
+	 * they are sent again from the current progress.
+	 */
+	dl->http.pending = 0;
+	dl->http.carry = 0;
+}
+
 static int reconnect(struct download_client *dl)
 {
 	int err;
 
 	LOG_INF("Reconnecting..");
+	http_pipeline_reset(dl);
 	err = download_client_disconnect(dl);
 	if (err) {
 		return err;
@@ -444,6 +460,17 @@ static size_t socket_recv(struct download_client *dl)
 		return -1;
 	}
 
+	if (dl->http.carry) {
+		/* Bytes of a pipelined response were received
+		 * together with the previous response.
+		 */
+		size_t len = dl->http.carry;
+
+		memmove(dl->buf + dl->offset, dl->buf + dl->http.carry_off, len);
+		dl->http.carry = 0;
+		return len;
+	}
+
 	err = set_recv_socket_timeout(dl->fd, timeout);
 	if (err) {
 		return -1;
@@ -569,6 +596,17 @@ restart_and_suspend:
 			}
 		}
 
+		if (rc == -ECANCELED) {
+			/* The file has changed on the server,
+			 * the checkpoint can't be resumed.
+			 */
+			if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+				checkpoint_clear(dl);
+			}
+			error_evt_send(dl, ECANCELED);
+			break;
+		}
+
 		if (rc < 0) {
 			/* Something was wrong with the packet
 			 * Restart and suspend
@@ -595,8 +633,15 @@ restart_and_suspend:
 			break;
 		}
 
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+			checkpoint_update(dl);
+		}
+
 		if (dl->progress == dl->file_size) {
 			LOG_INF("Download complete");
+			if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+				checkpoint_clear(dl);
+			}
 			const struct download_client_evt evt = {
 				.id = DOWNLOAD_CLIENT_EVT_DONE,
 			};
@@ -651,6 +696,14 @@ int download_client_init(struct download_client *const client,
 	client->fd = -1;
 	client->callback = callback;
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+		int err = checkpoint_init();
+
+		if (err) {
+			return err;
+		}
+	}
+
 	/* The thread is spawned now, but it will suspend itself;
 	 * it is resumed when the download is started via the API.
 	 */
@@ -746,6 +799,11 @@ int download_client_start(struct download_client *client, const char *file,
 
 	client->offset = 0;
 	client->http.has_header = false;
+	http_pipeline_reset(client);
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+		checkpoint_start(client, from);
+	}
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
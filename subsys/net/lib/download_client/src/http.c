@@ -29,6 +29,7 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 	"GET /%s HTTP/1.1\r\n"                                                 \
 	"Host: %s\r\n"                                                         \
 	"Range: bytes=%u-\r\n"                                                 \
+	"%s"                                                                   \
 	"Connection: keep-alive\r\n"                                           \
 	"\r\n"
 
@@ -37,20 +38,137 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 	"GET /%s HTTP/1.1\r\n"                                                 \
 	"Host: %s\r\n"                                                         \
 	"Range: bytes=%u-%u\r\n"                                               \
+	"%s"                                                                   \
 	"Connection: keep-alive\r\n"                                           \
 	"\r\n"
 
+/* Make the range request conditional; use when resuming a download */
+#define HTTP_IF_RANGE "If-Range: %s\r\n"
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)
+#define IF_RANGE_SIZE (sizeof(HTTP_IF_RANGE) + CONFIG_DOWNLOAD_CLIENT_VALIDATOR_SIZE)
+#else
+#define IF_RANGE_SIZE 1
+#endif
+
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len, int timeout);
 
-int http_get_request_send(struct download_client *client)
+static bool http_range_requests(const struct download_client *client)
+{
+	return client->proto == IPPROTO_TLS_1_2 ||
+	       IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS);
+}
+
+static size_t http_frag_size(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static int http_request_send(struct download_client *client, const char *buf,
+			     size_t size, int len)
+{
+	int err;
+
+	if (len < 0 || len > size) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(buf, len, "HTTP request");
+	}
+
+	err = socket_send(client, buf, len, 0);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Returns the If-Range header line, empty if the validator is unknown. */
+static const char *http_if_range(const struct download_client *client,
+				 char *buf, size_t len)
+{
+#if defined(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)
+	if (client->http.validator[0] != '\0') {
+		(void)snprintf(buf, len, HTTP_IF_RANGE, client->http.validator);
+		return buf;
+	}
+#endif
+	return "";
+}
+
+static int http_range_request_send(struct download_client *client,
+				   const char *host, const char *file,
+				   const char *if_range)
 {
 	int err;
 	int len;
 	size_t off;
+	char *buf = client->buf;
+	size_t size = sizeof(client->buf);
+
+#if CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH > 1
+	/* The response buffer may hold bytes of pipelined responses */
+	buf = client->http.req_buf;
+	size = sizeof(client->http.req_buf);
+#endif
+
+	/* Offset of last byte in range (Content-Range) */
+	off = client->http.req_offset + http_frag_size(client) - 1;
+
+	if (client->file_size != 0) {
+		/* Don't request bytes past the end of file */
+		off = MIN(off, client->file_size - 1);
+	}
+
+	len = snprintf(buf, size, HTTP_GET_RANGE, file, host,
+		       client->http.req_offset, off, if_range);
+
+	err = http_request_send(client, buf, size, len);
+	if (err) {
+		return err;
+	}
+
+	client->http.req_offset = off + 1;
+	client->http.pending++;
+
+	return 0;
+}
+
+static bool http_pipeline_full(const struct download_client *client)
+{
+	if (client->http.pending >= CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH) {
+		return true;
+	}
+
+	/* Always send the first request. Send more only once the file size
+	 * is known, to not request bytes past the end of file.
+	 */
+	if (client->http.pending == 0) {
+		return false;
+	}
+
+	return client->file_size == 0 ||
+	       client->http.req_offset >= client->file_size;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+	int len;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
+	char if_range[IF_RANGE_SIZE];
 
 	__ASSERT_NO_MSG(client->host);
 	__ASSERT_NO_MSG(client->file);
@@ -65,62 +183,113 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
-	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
+	if (http_range_requests(client)) {
+		if (client->http.pending == 0) {
+			client->http.req_offset = client->progress;
+		}
 
-	if (client->file_size != 0) {
-		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size - 1);
+		while (!http_pipeline_full(client)) {
+			err = http_range_request_send(client, host, file,
+						      http_if_range(client, if_range,
+								    sizeof(if_range)));
+			if (err) {
+				return err;
+			}
+		}
+
+		return 0;
 	}
 
-	if (client->proto == IPPROTO_TLS_1_2
-	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_RANGE, file, host, client->progress, off);
-	} else if (client->progress) {
+	if (client->progress) {
 		len = snprintf(client->buf,
 			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_OFFSET, file, host, client->progress);
+			HTTP_GET_OFFSET, file, host, client->progress,
+			http_if_range(client, if_range, sizeof(if_range)));
 	} else {
 		len = snprintf(client->buf,
 			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 			HTTP_GET, file, host);
 	}
 
-	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
-		LOG_ERR("Cannot create GET request, buffer too small");
-		return -ENOMEM;
+	return http_request_send(client, client->buf, sizeof(client->buf), len);
+}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)
+/* Find a header field by its lowercase name and return its value. */
+static const char *http_header_field(const char *hdr, size_t hdr_len,
+				     const char *name, size_t *len)
+{
+	const char *end = hdr + hdr_len;
+	const size_t name_len = strlen(name);
+
+	for (const char *line = hdr; line < end; line += strlen("\r\n")) {
+		const char *eol = line;
+		size_t i = 0;
+
+		while (eol < end && *eol != '\r') {
+			eol++;
+		}
+
+		while (i < name_len && &line[i] < eol && tolower(line[i]) == name[i]) {
+			i++;
+		}
+
+		if (i == name_len && &line[i] < eol && line[i] == ':') {
+			const char *value = &line[i + 1];
+
+			while (value < eol && *value == ' ') {
+				value++;
+			}
+
+			*len = eol - value;
+			return value;
+		}
+
+		line = eol;
 	}
 
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+	return NULL;
+}
+
+/* The validator is case-sensitive, parse it before the header is lowercased. */
+static void http_validator_parse(struct download_client *client, size_t hdr_len)
+{
+	const char *p;
+	size_t len;
+
+	/* Weak entity tags can't be used in If-Range (RFC 7233) */
+	p = http_header_field(client->buf, hdr_len, "etag", &len);
+	if (!p || (len >= 2 && p[0] == 'W' && p[1] == '/')) {
+		p = http_header_field(client->buf, hdr_len, "last-modified", &len);
 	}
 
-	err = socket_send(client, len, 0);
-	if (err) {
-		LOG_ERR("Failed to send HTTP request, errno %d", errno);
-		return err;
+	if (!p) {
+		LOG_DBG("No validator in response");
+		return;
 	}
 
-	return 0;
+	if (len >= sizeof(client->http.validator)) {
+		LOG_WRN("Validator too long (%u), not used", len);
+		return;
+	}
+
+	memcpy(client->http.validator, p, len);
+	client->http.validator[len] = '\0';
 }
+#endif /* CONFIG_DOWNLOAD_CLIENT_CHECKPOINT */
 
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
- * -1 on error
+ * -ECANCELED if the file has changed on the server
+ * -1 on any other error
  */
 static int http_header_parse(struct download_client *client, size_t *hdr_len)
 {
 	char *p;
 	char *q;
 	unsigned int http_status;
+	bool conditional = false;
 	const bool using_range_requests =
 		(client->proto == IPPROTO_TLS_1_2 ||
 		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
@@ -129,7 +298,7 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	const unsigned int expected_status = using_range_requests ? 206 : 200;
 
 	p = strstr(client->buf, "\r\n\r\n");
-	if (!p || p > client->buf + client->offset) {
+	if (!p || p + strlen("\r\n\r\n") > client->buf + client->offset) {
 		/* Waiting full HTTP header */
 		LOG_DBG("Waiting full header in response");
 		return 1;
@@ -143,6 +312,13 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 		LOG_HEXDUMP_DBG(client->buf, *hdr_len, "HTTP response");
 	}
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)
+	conditional = (client->http.validator[0] != '\0');
+	if (!conditional) {
+		http_validator_parse(client, *hdr_len);
+	}
+#endif
+
 	for (size_t i = 0; i < *hdr_len; i++) {
 		client->buf[i] = tolower(client->buf[i]);
 	}
@@ -161,6 +337,14 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 		return -1;
 	}
 
+	if (conditional && using_range_requests && http_status == 200) {
+		/* The whole file is sent when the If-Range validator
+		 * doesn't match.
+		 */
+		LOG_ERR("File has changed on the server");
+		return -ECANCELED;
+	}
+
 	if (http_status != expected_status) {
 		/* Truncate the server response at the first CR or LF after the
 		 * status and message so we can log it. Normally we can't
@@ -223,13 +407,20 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 
 	client->http.has_header = true;
 
+	/* Responses to range requests are received in order,
+	 * each one carries the fragment starting at the current progress.
+	 */
+	client->http.resp_end = MIN(client->progress + http_frag_size(client),
+				    client->file_size);
+
 	return 0;
 }
 
 /* Returns:
  *  1 if more data is expected
  *  0 if a whole fragment has been received
- * -1 on error
+ * -ECANCELED if the file has changed on the server
+ * -1 on any other error
  */
 int http_parse(struct download_client *client, size_t len)
 {
@@ -247,7 +438,7 @@ int http_parse(struct download_client *client, size_t len)
 		}
 		if (rc < 0) {
 			/* Something is wrong with the header */
-			return -1;
+			return rc;
 		}
 
 		if (client->offset != hdr_len) {
@@ -257,7 +448,7 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			LOG_DBG("Copying %u payload bytes",
 				client->offset - hdr_len);
-			memcpy(client->buf, client->buf + hdr_len,
+			memmove(client->buf, client->buf + hdr_len,
 			       client->offset - hdr_len);
 
 			client->offset -= hdr_len;
@@ -278,13 +469,28 @@ int http_parse(struct download_client *client, size_t len)
 	 */
 	client->progress += MIN(client->offset, len);
 
+	if (http_range_requests(client) &&
+	    client->progress > client->http.resp_end) {
+		/* The buffer contains bytes of the next pipelined
+		 * response, keep them for when the next response is parsed.
+		 */
+		size_t excess = client->progress - client->http.resp_end;
+
+		client->progress -= excess;
+		client->offset -= excess;
+		client->http.carry = excess;
+		client->http.carry_off = client->offset;
+	}
+
 	/* Have we received a whole fragment or the whole file? */
 	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	    client->offset < http_frag_size(client)) {
 		return 1;
 	}
 
+	if (http_range_requests(client) && client->http.pending) {
+		client->http.pending--;
+	}
+
 	return 0;
 }
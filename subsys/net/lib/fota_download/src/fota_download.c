@@ -41,6 +41,10 @@ static enum dfu_target_image_type img_type;
 static enum dfu_target_image_type img_type_expected = DFU_TARGET_IMAGE_TYPE_ANY;
 static bool first_fragment;
 static bool downloading;
+#ifdef CONFIG_DFU_TARGET_DIGEST
+static bool expected_digest_set;
+static uint8_t expected_digest[DFU_TARGET_DIGEST_SIZE];
+#endif
 
 static void send_evt(enum fota_download_evt_id id)
 {
@@ -141,6 +145,14 @@ static int download_client_callback(const struct download_client_evt *event)
 				return err;
 			}
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+			/* Verified by dfu_target_done() before the update is
+			 * scheduled.
+			 */
+			(void)dfu_target_digest_expect(expected_digest_set ?
+						       expected_digest : NULL);
+#endif
+
 			err = dfu_target_offset_get(&offset);
 			if (err != 0) {
 				LOG_DBG("unable to get dfu target offset err: "
@@ -204,7 +216,16 @@ static int download_client_callback(const struct download_client_evt *event)
 			err = dfu_target_schedule_update(0);
 		}
 
-		if (err != 0) {
+		if (err == -EBADMSG || err == -ENODATA) {
+			/* The image digest does not match the expected one,
+			 * or could not be computed.
+			 */
+			LOG_ERR("Invalid image");
+			first_fragment = true;
+			(void)download_client_disconnect(&dlc);
+			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE);
+			return err;
+		} else if (err != 0) {
 			LOG_ERR("dfu_target_done error: %d", err);
 			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
 			return err;
@@ -232,6 +253,23 @@ static int download_client_callback(const struct download_client_evt *event)
 			/* Fall through and return 0 below to tell
 			 * download_client to retry
 			 */
+		} else if (event->error == -ECANCELED) {
+			/* The image has changed on the server since the
+			 * download was checkpointed, it can't be resumed.
+			 */
+			download_client_disconnect(&dlc);
+			LOG_ERR("Image has changed on the server");
+			/* Discard the progress of the previous image so that
+			 * the next download starts from offset 0.
+			 */
+			err = dfu_target_discard();
+			if (err != 0) {
+				LOG_ERR("Unable to discard DFU image, err: %d",
+					err);
+			}
+			first_fragment = true;
+			send_error_evt(FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED);
+			return event->error;
 		} else {
 			download_client_disconnect(&dlc);
 			LOG_ERR("Download client error");
@@ -343,6 +381,14 @@ int fota_download_s0_active_get(bool *const s0_active)
 int fota_download_start_with_image_type(const char *host, const char *file,
 	int sec_tag, uint8_t pdn_id, size_t fragment_size,
 	const enum dfu_target_image_type expected_type)
+{
+	return fota_download_start_with_digest(host, file, sec_tag, pdn_id,
+		fragment_size, expected_type, NULL);
+}
+
+int fota_download_start_with_digest(const char *host, const char *file,
+	int sec_tag, uint8_t pdn_id, size_t fragment_size,
+	const enum dfu_target_image_type expected_type, const uint8_t *digest)
 {
 	/* We need a static file buffer since the download client structure
 	 * only keeps a pointer to the file buffer. This is problematic when
@@ -367,6 +413,17 @@ int fota_download_start_with_image_type(const char *host, const char *file,
 		return -EALREADY;
 	}
 
+#ifdef CONFIG_DFU_TARGET_DIGEST
+	expected_digest_set = (digest != NULL);
+	if (expected_digest_set) {
+		memcpy(expected_digest, digest, sizeof(expected_digest));
+	}
+#else
+	if (digest != NULL) {
+		return -ENOTSUP;
+	}
+#endif
+
 	if (sec_tag != -1 && !is_ip_address(host)) {
 		config.set_tls_hostname = true;
 	}
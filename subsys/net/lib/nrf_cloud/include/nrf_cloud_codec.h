@@ -81,6 +81,7 @@ extern "C" {
 #define NRF_CLOUD_CELL_POS_JSON_KEY_NBORS	"nmr"
 #define NRF_CLOUD_CELL_POS_JSON_KEY_RSRP	"rsrp"
 #define NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ	"rsrq"
+#define NRF_CLOUD_CELL_POS_JSON_KEY_DOREPLY	"doReply"
 
 #define NRF_CLOUD_CELL_POS_TYPE_VAL_SCELL	"SCELL"
 #define NRF_CLOUD_CELL_POS_TYPE_VAL_MCELL	"MCELL"
@@ -221,6 +222,24 @@ cJSON *json_create_req_obj(const char *const app_id, const char *const msg_type)
 
 int nrf_cloud_parse_rest_error(const char *const buf, enum nrf_cloud_error *const err);
 
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+/** @brief Encode the sensor data message as CBOR into the provided buffer.
+ * The map has the same keys as the JSON message. No memory is allocated.
+ * On input, @p len is the size of @p buf, on output it is the encoded length.
+ * Returns -ENOMEM if the buffer is too small.
+ */
+int nrf_cloud_sensor_data_cbor_encode(const struct nrf_cloud_sensor_data *sensor,
+				      uint8_t *buf, size_t *len);
+
+/** @brief Encode a cellular positioning request message as CBOR into the
+ * provided buffer. The map has the same keys as the JSON message.
+ * If @p request_loc is false, nRF Cloud is asked not to reply with the location.
+ */
+int nrf_cloud_cell_pos_req_cbor_encode(struct lte_lc_cells_info const *const inf,
+				       size_t inf_cnt, const bool request_loc,
+				       uint8_t *buf, size_t *len);
+#endif /* CONFIG_NRF_CLOUD_CBOR */
+
 #ifdef CONFIG_NRF_CLOUD_GATEWAY
 typedef int (*gateway_state_handler_t)(void *root_obj);
 
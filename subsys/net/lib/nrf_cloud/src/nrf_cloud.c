@@ -287,6 +287,35 @@ int nrf_cloud_shadow_device_status_update(const struct nrf_cloud_device_status *
 	return err;
 }
 
+/* Encode the sensor data message. With CONFIG_NRF_CLOUD_CBOR, the message is
+ * encoded as CBOR, or as JSON if it does not fit in the CBOR buffer.
+ * The encoded data is freed with nrf_cloud_free().
+ */
+static int sensor_data_encode(const struct nrf_cloud_sensor_data *param,
+			      struct nrf_cloud_data *output)
+{
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+	size_t len = CONFIG_NRF_CLOUD_CBOR_MSG_SIZE;
+	uint8_t *buf = nrf_cloud_malloc(len);
+	int err;
+
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = nrf_cloud_sensor_data_cbor_encode(param, buf, &len);
+	if (!err) {
+		output->ptr = buf;
+		output->len = len;
+		return 0;
+	}
+
+	nrf_cloud_free(buf);
+	LOG_DBG("Sensor data not encoded as CBOR (err %d), sending JSON", err);
+#endif
+	return nrf_cloud_encode_sensor_data(param, output);
+}
+
 int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param)
 {
 	int err;
@@ -300,7 +329,7 @@ int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param)
 		return -EINVAL;
 	}
 
-	err = nrf_cloud_encode_sensor_data(param, &sensor_data.data);
+	err = sensor_data_encode(param, &sensor_data.data);
 	if (err) {
 		return err;
 	}
@@ -330,7 +359,7 @@ int nrf_cloud_sensor_data_stream(const struct nrf_cloud_sensor_data *param)
 		return -EINVAL;
 	}
 
-	err = nrf_cloud_encode_sensor_data(param, &sensor_data.data);
+	err = sensor_data_encode(param, &sensor_data.data);
 	if (err) {
 		return err;
 	}
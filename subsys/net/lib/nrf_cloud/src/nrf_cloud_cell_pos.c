@@ -24,8 +24,33 @@ int nrf_cloud_cell_pos_request_json_get(const struct lte_lc_cells_info *const ce
 
 #include "nrf_cloud_codec.h"
 #include "nrf_cloud_transport.h"
+#include "nrf_cloud_mem.h"
 
-#define CELL_POS_JSON_CELL_LOC_KEY_DOREPLY	"doReply"
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+/* Encode the request as CBOR. The encoded data is freed with nrf_cloud_free(). */
+static int cell_pos_request_cbor_encode(const struct lte_lc_cells_info *const cells_inf,
+					const bool request_loc, struct nrf_cloud_data *output)
+{
+	size_t len = CONFIG_NRF_CLOUD_CBOR_MSG_SIZE;
+	uint8_t *buf = nrf_cloud_malloc(len);
+	int err;
+
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = nrf_cloud_cell_pos_req_cbor_encode(cells_inf, 1, request_loc, buf, &len);
+	if (err) {
+		nrf_cloud_free(buf);
+		return err;
+	}
+
+	output->ptr = buf;
+	output->len = len;
+
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_CBOR */
 
 int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 			       const bool request_loc, nrf_cloud_cell_pos_response_t cb)
@@ -37,6 +62,26 @@ int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 	int err = 0;
 	cJSON *cell_pos_req_obj = NULL;
 
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+	/* The cell info of the modem is only available as JSON */
+	struct nct_dc_data msg = {0};
+
+	if (cells_inf) {
+		err = cell_pos_request_cbor_encode(cells_inf, request_loc, &msg.data);
+		if (!err) {
+			if (request_loc) {
+				nfsm_set_cell_pos_response_cb(cb);
+			}
+
+			err = nct_dc_send(&msg);
+			nrf_cloud_free((void *)msg.data.ptr);
+			return err;
+		}
+
+		LOG_DBG("Request not encoded as CBOR (err %d), sending JSON", err);
+	}
+#endif
+
 	err = nrf_cloud_cell_pos_request_json_get(cells_inf, request_loc, &cell_pos_req_obj);
 	if (!err) {
 		if (request_loc) {
@@ -77,7 +122,7 @@ int nrf_cloud_cell_pos_request_json_get(const struct lte_lc_cells_info *const ce
 
 	/* By default, nRF Cloud will send the location to the device */
 	if (!request_loc &&
-	    !cJSON_AddNumberToObjectCS(data_obj, CELL_POS_JSON_CELL_LOC_KEY_DOREPLY, 0)) {
+	    !cJSON_AddNumberToObjectCS(data_obj, NRF_CLOUD_CELL_POS_JSON_KEY_DOREPLY, 0)) {
 		err = -ENOMEM;
 		goto cleanup;
 	}
@@ -16,6 +16,9 @@
 #include <logging/log.h>
 #include <modem/modem_info.h>
 #include "cJSON_os.h"
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+#include <zcbor_encode.h>
+#endif
 
 LOG_MODULE_REGISTER(nrf_cloud_codec, CONFIG_NRF_CLOUD_LOG_LEVEL);
 
@@ -1706,3 +1709,163 @@ bool nrf_cloud_detect_disconnection_request(const char *const buf)
 	cJSON_Delete(discon_request_obj);
 	return ret;
 }
+
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+/* Maximum nesting depth of the encoded messages */
+#define CBOR_MAX_DEPTH 8
+/* Upper bound of map and array sizes, only used for canonical encoding */
+#define CBOR_MAX_ITEMS 16
+
+static bool cbor_tstr_put(zcbor_state_t *state, const char *str)
+{
+	return zcbor_tstr_encode_ptr(state, str, strlen(str));
+}
+
+static bool cbor_key_int_put(zcbor_state_t *state, const char *key, int32_t val)
+{
+	return cbor_tstr_put(state, key) && zcbor_int32_put(state, val);
+}
+
+static bool cbor_encode_cell(zcbor_state_t *state, struct lte_lc_cells_info const *const lte)
+{
+	struct lte_lc_cell const *const cur = &lte->current_cell;
+	bool ok = zcbor_map_start_encode(state, CBOR_MAX_ITEMS);
+
+	/* required items */
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_ECI) &&
+	     zcbor_uint32_put(state, cur->id);
+	ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_MCC, cur->mcc);
+	ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_MNC, cur->mnc);
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_TAC) &&
+	     zcbor_uint32_put(state, cur->tac);
+
+	/* optional */
+	if (cur->earfcn != NRF_CLOUD_CELL_POS_OMIT_EARFCN) {
+		ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN) &&
+		     zcbor_uint32_put(state, cur->earfcn);
+	}
+
+	if (cur->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+		ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+					    RSRP_ADJ(cur->rsrp));
+	}
+
+	if (cur->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+		ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ) &&
+		     zcbor_float32_put(state, RSRQ_ADJ(cur->rsrq));
+	}
+
+	if (cur->timing_advance != NRF_CLOUD_CELL_POS_OMIT_TIME_ADV) {
+		ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV,
+					    MIN(cur->timing_advance,
+						NRF_CLOUD_CELL_POS_TIME_ADV_MAX));
+	}
+
+	if (lte->ncells_count && lte->neighbor_cells) {
+		ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_NBORS) &&
+		     zcbor_list_start_encode(state, lte->ncells_count);
+
+		for (uint8_t j = 0; ok && (j < lte->ncells_count); ++j) {
+			struct lte_lc_ncell *ncell = lte->neighbor_cells + j;
+
+			ok = zcbor_map_start_encode(state, CBOR_MAX_ITEMS);
+			ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN) &&
+			     zcbor_uint32_put(state, ncell->earfcn);
+			ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_PCI,
+						    ncell->phys_cell_id);
+
+			if (ncell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+				ok = ok && cbor_key_int_put(state,
+							    NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+							    RSRP_ADJ(ncell->rsrp));
+			}
+
+			if (ncell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+				ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ) &&
+				     zcbor_float32_put(state, RSRQ_ADJ(ncell->rsrq));
+			}
+
+			ok = ok && zcbor_map_end_encode(state, CBOR_MAX_ITEMS);
+		}
+
+		ok = ok && zcbor_list_end_encode(state, lte->ncells_count);
+	}
+
+	return ok && zcbor_map_end_encode(state, CBOR_MAX_ITEMS);
+}
+
+static int cbor_encode_result(zcbor_state_t *state, bool ok, const uint8_t *buf,
+			      size_t *len)
+{
+	if (!ok) {
+		int err = zcbor_pop_error(state);
+
+		/* Any other error is caused by the input */
+		return (err == ZCBOR_ERR_NO_PAYLOAD) ? -ENOMEM : -EINVAL;
+	}
+
+	*len = state->payload - buf;
+
+	return 0;
+}
+
+int nrf_cloud_sensor_data_cbor_encode(const struct nrf_cloud_sensor_data *sensor,
+				      uint8_t *buf, size_t *len)
+{
+	if (!sensor || !sensor->data.ptr || !buf || !len ||
+	    sensor->type >= SENSOR_TYPE_ARRAY_SIZE) {
+		return -EINVAL;
+	}
+
+	ZCBOR_STATE_E(state, CBOR_MAX_DEPTH, buf, *len, 1);
+	bool ok = zcbor_map_start_encode(state, 3);
+
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_APPID_KEY) &&
+	     cbor_tstr_put(state, sensor_type_str[sensor->type]);
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_DATA_KEY) &&
+	     zcbor_tstr_encode_ptr(state, sensor->data.ptr, sensor->data.len);
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_MSG_TYPE_KEY) &&
+	     cbor_tstr_put(state, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	ok = ok && zcbor_map_end_encode(state, 3);
+
+	return cbor_encode_result(state, ok, buf, len);
+}
+
+int nrf_cloud_cell_pos_req_cbor_encode(struct lte_lc_cells_info const *const inf,
+				       size_t inf_cnt, const bool request_loc,
+				       uint8_t *buf, size_t *len)
+{
+	if (!inf || !inf_cnt || !buf || !len) {
+		return -EINVAL;
+	}
+
+	ZCBOR_STATE_E(state, CBOR_MAX_DEPTH, buf, *len, 1);
+	bool ok = zcbor_map_start_encode(state, 3);
+
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_APPID_KEY) &&
+	     cbor_tstr_put(state, NRF_CLOUD_JSON_APPID_VAL_CELL_POS);
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_MSG_TYPE_KEY) &&
+	     cbor_tstr_put(state, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_JSON_DATA_KEY) &&
+	     zcbor_map_start_encode(state, 2);
+
+	ok = ok && cbor_tstr_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_LTE) &&
+	     zcbor_list_start_encode(state, inf_cnt);
+
+	for (size_t i = 0; ok && (i < inf_cnt); ++i) {
+		ok = cbor_encode_cell(state, inf + i);
+	}
+
+	ok = ok && zcbor_list_end_encode(state, inf_cnt);
+
+	/* By default, nRF Cloud will send the location to the device */
+	if (!request_loc) {
+		ok = ok && cbor_key_int_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_DOREPLY, 0);
+	}
+
+	ok = ok && zcbor_map_end_encode(state, 2);
+	ok = ok && zcbor_map_end_encode(state, 3);
+
+	return cbor_encode_result(state, ok, buf, len);
+}
+#endif /* CONFIG_NRF_CLOUD_CBOR */
@@ -43,6 +43,41 @@ static inline void nrf_rpc_tr_free_rx_buf(const uint8_t *buf)
 
 int nrf_rpc_tr_send(uint8_t *buf, size_t len);
 
+/** @brief Transport statistics. */
+struct nrf_rpc_tr_stats {
+	/** Number of packets sent. */
+	uint32_t packets_sent;
+
+	/** Number of IPC messages sent. Lower than the number of packets
+	 *  sent if packets are batched.
+	 */
+	uint32_t frames_sent;
+
+	/** Number of bytes sent in IPC messages. */
+	uint32_t bytes_sent;
+
+	/** Number of packets received. */
+	uint32_t packets_received;
+
+	/** Number of IPC messages received. */
+	uint32_t frames_received;
+
+	/** Total time the packets sent waited in a batch, in microseconds. */
+	uint32_t latency_total_us;
+
+	/** Longest time a packet waited in a batch, in microseconds. */
+	uint32_t latency_max_us;
+};
+
+/** @brief Get the transport statistics.
+ *
+ * @param[out] stats Statistics since the start or the last reset.
+ */
+void nrf_rpc_tr_stats_get(struct nrf_rpc_tr_stats *stats);
+
+/** @brief Reset the transport statistics. */
+void nrf_rpc_tr_stats_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
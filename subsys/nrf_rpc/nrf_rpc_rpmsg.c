@@ -7,7 +7,10 @@
 #define NRF_RPC_LOG_MODULE NRF_RPC_TR
 #include <nrf_rpc_log.h>
 
+#include <string.h>
 #include <device.h>
+#include <sys/byteorder.h>
+#include <sys/slist.h>
 #include <ipc/ipc_service.h>
 #include <openamp/open_amp.h>
 
@@ -26,6 +29,11 @@
 } while (0)
 
 
+/* Each packet in a batch is preceded by its length and padded to a multiple
+ * of the length size, so that all packets are word aligned.
+ */
+#define BATCH_HDR_SIZE sizeof(uint32_t)
+
 /* Semaphore used to synchronize endpoint binding.*/
 K_SEM_DEFINE(ipc_bound_sem, 0, 1);
 
@@ -35,6 +43,53 @@ static nrf_rpc_tr_receive_handler_t receive_callback;
 /* IPC service endpoint instance */
 struct ipc_ept nrf_rpc_ept;
 
+/* Transport statistics, see struct nrf_rpc_tr_stats. */
+static struct {
+	atomic_t packets_sent;
+	atomic_t frames_sent;
+	atomic_t bytes_sent;
+	atomic_t packets_received;
+	atomic_t frames_received;
+	atomic_t latency_total_us;
+	atomic_t latency_max_us;
+} stats;
+
+#if CONFIG_NRF_RPC_TR_RPMSG_BATCH
+/* Packets waiting to be sent in one IPC message. */
+static struct {
+	uint8_t buf[CONFIG_NRF_RPC_TR_RPMSG_BATCH_SIZE] __aligned(4);
+	size_t len;
+	uint32_t packet_cnt;
+
+	/* Cycle count when the first packet was added. */
+	uint32_t first_cycles;
+
+	/* Sum of the cycle counts when the packets were added. */
+	uint32_t cycles_sum;
+
+	/* Senders of packets in the batch waiting for it to be sent. */
+	sys_slist_t waiters;
+} batch;
+
+/* Sender of a packet that is left in the batch for another thread to send. */
+struct batch_waiter {
+	sys_snode_t node;
+	int err;
+	bool done;
+};
+
+K_MUTEX_DEFINE(batch_mutex);
+
+/* Signaled when a batch has been sent and its waiters have their status. */
+K_CONDVAR_DEFINE(batch_sent);
+
+/* Number of threads waiting for the batch mutex. */
+static atomic_t batch_waiting;
+
+BUILD_ASSERT(CONFIG_NRF_RPC_TR_RPMSG_BATCH_SIZE > BATCH_HDR_SIZE,
+	     "CONFIG_NRF_RPC_TR_RPMSG_BATCH_SIZE too small");
+#endif /* CONFIG_NRF_RPC_TR_RPMSG_BATCH */
+
 static void nrf_rpc_ept_bound(void *priv)
 {
 	NRF_RPC_DBG("nRF RPC Connected");
@@ -42,13 +97,49 @@ static void nrf_rpc_ept_bound(void *priv)
 	k_sem_give(&ipc_bound_sem);
 }
 
+#if CONFIG_NRF_RPC_TR_RPMSG_BATCH
+static void batch_recv(const uint8_t *data, size_t len)
+{
+	while (len > 0) {
+		uint32_t packet_len;
+		size_t size;
+
+		if (len < BATCH_HDR_SIZE) {
+			NRF_RPC_ERR("Truncated batch, %u bytes dropped", len);
+			return;
+		}
+
+		packet_len = sys_get_le32(data);
+		if (packet_len > len - BATCH_HDR_SIZE) {
+			NRF_RPC_ERR("Invalid packet length %u in batch", packet_len);
+			return;
+		}
+
+		atomic_inc(&stats.packets_received);
+		receive_callback(data + BATCH_HDR_SIZE, packet_len);
+
+		/* The last packet may be sent without padding. */
+		size = MIN(BATCH_HDR_SIZE + ROUND_UP(packet_len, BATCH_HDR_SIZE), len);
+		data += size;
+		len -= size;
+	}
+}
+#endif /* CONFIG_NRF_RPC_TR_RPMSG_BATCH */
+
 static void nrf_rpc_ept_recv(const void *data, size_t len, void *priv)
 {
 	NRF_RPC_ASSERT(data != NULL);
 
 	DUMP_LIMITED_DBG(data, len, "Received data");
 
+	atomic_inc(&stats.frames_received);
+
+#if CONFIG_NRF_RPC_TR_RPMSG_BATCH
+	batch_recv(data, len);
+#else
+	atomic_inc(&stats.packets_received);
 	receive_callback(data, len);
+#endif /* CONFIG_NRF_RPC_TR_RPMSG_BATCH */
 }
 
 static struct ipc_ept_cfg nrf_rpc_ept_cfg = {
@@ -71,6 +162,8 @@ static int translate_error(int ll_err)
 		return -NRF_EALREADY;
 	case -EBADMSG:
 		return -NRF_EBADMSG;
+	case -ENOMEM:
+		return -NRF_ENOMEM;
 	case RPMSG_ERR_BUFF_SIZE:
 	case RPMSG_ERR_NO_MEM:
 	case RPMSG_ERR_NO_BUFF:
@@ -117,6 +210,131 @@ int nrf_rpc_tr_init(nrf_rpc_tr_receive_handler_t callback)
 	return 0;
 }
 
+static int frame_send(const uint8_t *buf, size_t len, uint32_t packet_cnt)
+{
+	int err;
+
+	err = ipc_service_send(&nrf_rpc_ept, buf, len);
+	if (err < 0) {
+		return err;
+	}
+
+	atomic_add(&stats.packets_sent, packet_cnt);
+	atomic_inc(&stats.frames_sent);
+	atomic_add(&stats.bytes_sent, len);
+
+	return 0;
+}
+
+#if CONFIG_NRF_RPC_TR_RPMSG_BATCH
+/* Must be called with the batch mutex taken. The status is also given to the
+ * senders waiting for the batch.
+ */
+static int batch_flush(void)
+{
+	struct batch_waiter *waiter;
+	uint32_t now;
+	uint32_t latency_us;
+	int err;
+
+	if (batch.packet_cnt == 0) {
+		return 0;
+	}
+
+	NRF_RPC_DBG("Send batch of %u packets, %u bytes.", batch.packet_cnt,
+		    batch.len);
+
+	err = frame_send(batch.buf, batch.len, batch.packet_cnt);
+	if (err == 0) {
+		/* Time from when the packets were added until they were sent. */
+		now = k_cycle_get_32();
+		latency_us = k_cyc_to_us_floor32(batch.packet_cnt * now -
+						 batch.cycles_sum);
+		atomic_add(&stats.latency_total_us, latency_us);
+
+		latency_us = k_cyc_to_us_floor32(now - batch.first_cycles);
+		if (latency_us > atomic_get(&stats.latency_max_us)) {
+			atomic_set(&stats.latency_max_us, latency_us);
+		}
+	} else {
+		NRF_RPC_ERR("Batch of %u packets dropped: %d", batch.packet_cnt, err);
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&batch.waiters, waiter, node) {
+		waiter->err = err;
+		waiter->done = true;
+	}
+
+	sys_slist_init(&batch.waiters);
+	k_condvar_broadcast(&batch_sent);
+
+	batch.len = 0;
+	batch.packet_cnt = 0;
+	batch.cycles_sum = 0;
+
+	return err;
+}
+
+static int batch_send(const uint8_t *buf, size_t len)
+{
+	size_t size = BATCH_HDR_SIZE + ROUND_UP(len, BATCH_HDR_SIZE);
+	struct batch_waiter waiter = { 0 };
+	uint8_t *dst;
+	int err;
+
+	if (size > sizeof(batch.buf)) {
+		NRF_RPC_ERR("Packet of %u bytes does not fit in a batch", len);
+		return -ENOMEM;
+	}
+
+	atomic_inc(&batch_waiting);
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+	atomic_dec(&batch_waiting);
+
+	/* The status of the packets already in the batch is given to their
+	 * senders, not to this one.
+	 */
+	if (batch.len + size > sizeof(batch.buf)) {
+		(void)batch_flush();
+	}
+
+	dst = &batch.buf[batch.len];
+
+	sys_put_le32(len, dst);
+	memcpy(dst + BATCH_HDR_SIZE, buf, len);
+	memset(dst + BATCH_HDR_SIZE + len, 0, size - BATCH_HDR_SIZE - len);
+
+	if (batch.packet_cnt == 0) {
+		batch.first_cycles = k_cycle_get_32();
+	}
+
+	batch.len += size;
+	batch.packet_cnt++;
+	batch.cycles_sum += k_cycle_get_32();
+
+	/* Flush on idle. If another thread is waiting to add a packet, the
+	 * batch is left to it, so the last thread sends the batch. This thread
+	 * waits until then to return the status of its own packet, so that a
+	 * response is not awaited for a packet that was dropped.
+	 */
+	if (atomic_get(&batch_waiting) == 0) {
+		err = batch_flush();
+	} else {
+		sys_slist_append(&batch.waiters, &waiter.node);
+
+		while (!waiter.done) {
+			k_condvar_wait(&batch_sent, &batch_mutex, K_FOREVER);
+		}
+
+		err = waiter.err;
+	}
+
+	k_mutex_unlock(&batch_mutex);
+
+	return err;
+}
+#endif /* CONFIG_NRF_RPC_TR_RPMSG_BATCH */
+
 int nrf_rpc_tr_send(uint8_t *buf, size_t len)
 {
 	int err;
@@ -125,10 +343,35 @@ int nrf_rpc_tr_send(uint8_t *buf, size_t len)
 	NRF_RPC_DBG("Send %u bytes.", len);
 	DUMP_LIMITED_DBG(buf, len, "Data:");
 
-	err = ipc_service_send(&nrf_rpc_ept, buf, len);
-	if (err > 0) {
-		err = 0;
-	}
+#if CONFIG_NRF_RPC_TR_RPMSG_BATCH
+	err = batch_send(buf, len);
+#else
+	err = frame_send(buf, len, 1);
+#endif /* CONFIG_NRF_RPC_TR_RPMSG_BATCH */
 
 	return translate_error(err);
 }
+
+void nrf_rpc_tr_stats_get(struct nrf_rpc_tr_stats *tr_stats)
+{
+	NRF_RPC_ASSERT(tr_stats != NULL);
+
+	tr_stats->packets_sent = atomic_get(&stats.packets_sent);
+	tr_stats->frames_sent = atomic_get(&stats.frames_sent);
+	tr_stats->bytes_sent = atomic_get(&stats.bytes_sent);
+	tr_stats->packets_received = atomic_get(&stats.packets_received);
+	tr_stats->frames_received = atomic_get(&stats.frames_received);
+	tr_stats->latency_total_us = atomic_get(&stats.latency_total_us);
+	tr_stats->latency_max_us = atomic_get(&stats.latency_max_us);
+}
+
+void nrf_rpc_tr_stats_reset(void)
+{
+	atomic_clear(&stats.packets_sent);
+	atomic_clear(&stats.frames_sent);
+	atomic_clear(&stats.bytes_sent);
+	atomic_clear(&stats.packets_received);
+	atomic_clear(&stats.frames_received);
+	atomic_clear(&stats.latency_total_us);
+	atomic_clear(&stats.latency_max_us);
+}
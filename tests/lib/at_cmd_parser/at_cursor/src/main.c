@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stddef.h>
+#include <ztest.h>
+#include <string.h>
+#include <kernel.h>
+#include <sys/util.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_cursor.h>
+#include <modem/at_params.h>
+
+#define TEST_PARAMS 64
+#define BENCHMARK_ROUNDS 100
+
+/* Modem output recorded on an nRF9160 DK. */
+static const char *const recorded[] = {
+	"+CEREG: 5,\"76C1\",\"0102DA04\",7,,,\"00001010\",\"00010110\"\r\n",
+	"%XMONITOR: 1,\"Operator\",\"OP\",\"24201\",\"76C1\",7,20,\"0102DA04\","
+	"334,6400,53,24,\"\",\"11100000\",\"00000111\",\"01001001\"\r\nOK\r\n",
+	"%NCELLMEAS: 0,\"0199F10A\",\"26295\",\"76C1\",64,7,6400,241,41,28,2650,"
+	"6400,194,29,18,-12,6400,195,23,11,-19,6400,78,21,8,-22,"
+	"1650,31,17,6,-26,1650,287,15,4,-31,300,428,13,2,-36,2600\r\n",
+	"+COPS: (2,\"Operator\",\"OP\",\"24201\",7),(1,\"Other\",\"OT\",\"24202\",7),"
+	"(1,\"Third\",\"TH\",\"24208\",9),,(0,1,3,4),(0,1,2)\r\nOK\r\n",
+	"+CMT: \"+44123456789\",22\r\n"
+	"0791534850020290040C9153486720111700002280212140814003C8329BFD06\r\n",
+	"+CNMI: 3,(1,2,3),,1\r\n",
+};
+
+static struct at_param_list test_list;
+static AT_CURSOR_DEFINE(test_cursor, TEST_PARAMS);
+
+static void test_cursor_setup(void)
+{
+	at_params_list_init(&test_list, TEST_PARAMS);
+}
+
+static void test_cursor_teardown(void)
+{
+	at_params_list_free(&test_list);
+}
+
+static void test_cursor_fail_on_invalid_input(void)
+{
+	static struct at_cursor uninitialized;
+	int32_t num;
+
+	zassert_equal(-EINVAL, at_parser_cursor_from_str(NULL, NULL, &test_cursor),
+		      "Parsing NULL string should fail");
+	zassert_equal(-EINVAL, at_parser_cursor_from_str(recorded[0], NULL, NULL),
+		      "Parsing to NULL cursor should fail");
+	zassert_equal(-EINVAL, at_parser_cursor_from_str(recorded[0], NULL, &uninitialized),
+		      "Parsing to uninitialized cursor should fail");
+
+	zassert_equal(0, at_parser_cursor_from_str(recorded[0], NULL, &test_cursor),
+		      "Parsing should not fail");
+	zassert_equal(-EINVAL, at_cursor_int_get(&test_cursor, 0, &num),
+		      "Getting string parameter as integer should fail");
+	zassert_equal(-EINVAL, at_cursor_int_get(&test_cursor, TEST_PARAMS, &num),
+		      "Getting parameter out of range should fail");
+	zassert_equal(AT_PARAM_TYPE_INVALID, at_cursor_type_get(&test_cursor, TEST_PARAMS),
+		      "Parameter out of range should be invalid");
+}
+
+static void test_cursor_lazy_access(void)
+{
+	const char *str;
+	size_t len;
+	int32_t num;
+	uint16_t tac;
+	uint32_t array[4];
+	size_t array_len = sizeof(array);
+	char buf[4];
+	size_t buf_len = sizeof(buf);
+
+	zassert_equal(0, at_parser_cursor_from_str(recorded[0], NULL, &test_cursor),
+		      "Parsing should not fail");
+	zassert_equal(9, at_cursor_valid_count_get(&test_cursor),
+		      "Unexpected parameter count");
+
+	zassert_equal(0, at_cursor_string_ptr_get(&test_cursor, 0, &str, &len), "");
+	zassert_equal(0, strncmp("+CEREG", str, len), "Unexpected notification ID");
+	zassert_true((str >= recorded[0]) && (str < recorded[0] + strlen(recorded[0])),
+		     "String is not referenced in place");
+
+	zassert_equal(0, at_cursor_int_get(&test_cursor, 1, &num), "");
+	zassert_equal(5, num, "Unexpected integer value");
+
+	zassert_equal(0, at_cursor_string_ptr_get(&test_cursor, 2, &str, &len), "");
+	zassert_equal(4, len, "Unexpected string length");
+	zassert_equal(0, strncmp("76C1", str, len), "Unexpected string value");
+	zassert_equal(-EINVAL, at_cursor_unsigned_short_get(&test_cursor, 2, &tac), "");
+
+	zassert_equal(-ENOMEM, at_cursor_string_get(&test_cursor, 3, buf, &buf_len),
+		      "Copying to too small buffer should fail");
+
+	zassert_equal(AT_PARAM_TYPE_EMPTY, at_cursor_type_get(&test_cursor, 5), "");
+
+	zassert_equal(0, at_parser_cursor_from_str(recorded[5], NULL, &test_cursor), "");
+	zassert_equal(AT_PARAM_TYPE_ARRAY, at_cursor_type_get(&test_cursor, 2), "");
+	zassert_equal(0, at_cursor_array_get(&test_cursor, 2, array, &array_len), "");
+	zassert_equal(3 * sizeof(uint32_t), array_len, "Unexpected array size");
+	zassert_equal(3, array[2], "Unexpected array element");
+}
+
+static void test_cursor_matches_param_list(void)
+{
+	char *next_list;
+	char *next_cursor;
+
+	for (size_t i = 0; i < ARRAY_SIZE(recorded); i++) {
+		int err_list = at_parser_params_from_str(recorded[i], &next_list, &test_list);
+		int err_cursor = at_parser_cursor_from_str(recorded[i], &next_cursor,
+							   &test_cursor);
+		size_t count = at_params_valid_count_get(&test_list);
+
+		zassert_equal(err_list, err_cursor, "Different result for %zu", i);
+		zassert_equal(next_list, next_cursor, "Different remainder for %zu", i);
+		zassert_equal(count, at_cursor_valid_count_get(&test_cursor),
+			      "Different parameter count for %zu", i);
+
+		for (size_t j = 0; j < count; j++) {
+			enum at_param_type type = at_params_type_get(&test_list, j);
+
+			zassert_equal(type, at_cursor_type_get(&test_cursor, j),
+				      "Different type for %zu:%zu", i, j);
+
+			if (type == AT_PARAM_TYPE_NUM_INT) {
+				int64_t a;
+				int64_t b;
+
+				at_params_int64_get(&test_list, j, &a);
+				at_cursor_int64_get(&test_cursor, j, &b);
+				zassert_equal(a, b, "Different integer for %zu:%zu", i, j);
+			} else if (type == AT_PARAM_TYPE_STRING) {
+				char a[128];
+				const char *b;
+				size_t a_len = sizeof(a);
+				size_t b_len;
+
+				at_params_string_get(&test_list, j, a, &a_len);
+				at_cursor_string_ptr_get(&test_cursor, j, &b, &b_len);
+				zassert_equal(a_len, b_len, "Different length for %zu:%zu", i, j);
+				zassert_equal(0, memcmp(a, b, a_len),
+					      "Different string for %zu:%zu", i, j);
+			} else if (type == AT_PARAM_TYPE_ARRAY) {
+				uint32_t a[16];
+				uint32_t b[16];
+				size_t a_len = sizeof(a);
+				size_t b_len = sizeof(b);
+
+				at_params_array_get(&test_list, j, a, &a_len);
+				at_cursor_array_get(&test_cursor, j, b, &b_len);
+				zassert_equal(a_len, b_len, "Different size for %zu:%zu", i, j);
+				zassert_equal(0, memcmp(a, b, a_len),
+					      "Different array for %zu:%zu", i, j);
+			}
+		}
+	}
+}
+
+/* Parse the recorded output and read all integer parameters,
+ * as a notification handler would.
+ */
+static uint32_t benchmark_param_list(void)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(recorded); i++) {
+			int32_t num;
+
+			at_parser_params_from_str(recorded[i], NULL, &test_list);
+
+			for (size_t j = 0; j < at_params_valid_count_get(&test_list); j++) {
+				(void)at_params_int_get(&test_list, j, &num);
+			}
+		}
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static uint32_t benchmark_cursor(void)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(recorded); i++) {
+			int32_t num;
+
+			at_parser_cursor_from_str(recorded[i], NULL, &test_cursor);
+
+			for (size_t j = 0; j < at_cursor_valid_count_get(&test_cursor); j++) {
+				(void)at_cursor_int_get(&test_cursor, j, &num);
+			}
+		}
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void test_cursor_benchmark(void)
+{
+	const size_t cnt = BENCHMARK_ROUNDS * ARRAY_SIZE(recorded);
+	uint32_t list_cyc = benchmark_param_list();
+	uint32_t cursor_cyc = benchmark_cursor();
+
+	TC_PRINT("Parsing of %zu responses (cycles per response):\n", cnt);
+	TC_PRINT("\tparameter list: %u\n", list_cyc / cnt);
+	TC_PRINT("\tcursor: %u\n", cursor_cyc / cnt);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cursor,
+			 ztest_unit_test_setup_teardown(
+				test_cursor_fail_on_invalid_input,
+				test_cursor_setup,
+				test_cursor_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_cursor_lazy_access,
+				test_cursor_setup,
+				test_cursor_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_cursor_matches_param_list,
+				test_cursor_setup,
+				test_cursor_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_cursor_benchmark,
+				test_cursor_setup,
+				test_cursor_teardown)
+			);
+
+	ztest_run_test_suite(at_cursor);
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <string.h>
+#include <kernel.h>
+#include <device.h>
+#include <modem/at_monitor.h>
+#include <mock_nrf_modem_at.h>
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+/* Number of times the corpus is dispatched when measuring performance. */
+#define BENCHMARK_ROUNDS 100
+/* Number of notifications received in a burst, exceeding the buffer size. */
+#define BURST_CNT 64
+
+/* Notifications recorded from an nRF9160 DK attaching to an LTE-M network,
+ * receiving an SMS and entering PSM.
+ */
+static const char *const corpus[] = {
+	"+CEREG: 2,\"76C1\",\"0102DA04\",7\r\n",
+	"+CSCON: 1\r\n",
+	"%MDMEV: SEARCH STATUS 1\r\n",
+	"+CEREG: 1,\"76C1\",\"0102DA04\",7,,,\"00001010\",\"00010110\"\r\n",
+	"+CGEV: ME PDN ACT 0\r\n",
+	"%XTIME: \"0A\",\"2260400152220A\",\"00\"\r\n",
+	"+CEDRXP: 4,\"1000\",\"0101\",\"0011\"\r\n",
+	"%CESQ: 54,2,15,2\r\n",
+	"%XT3412: 3240000\r\n",
+	"+CMT: \"+44123456789\",22\r\n0791534850020290040C915348...\r\n",
+	"%NCELLMEAS: 0,\"0199F10A\",\"26295\",\"76C1\",64,7,6400,241,41,28,2650,2,1\r\n",
+	"+CSCON: 0\r\n",
+	"%XMODEMSLEEP: 1,3239000\r\n",
+	"+CNEC_ESM: 50,0\r\n",
+	"%MDMEV: PRACH CE-LEVEL 1\r\n",
+	"+CGEV: IPV6 0\r\n",
+};
+
+/* Monitors using the filters of the libraries enabled in a typical
+ * nRF9160 application.
+ */
+static const char *const filters[] = {
+	"+CEREG", "+CSCON", "+CEDRXP", "%XT3412", "%NCELLMEAS", "%XMODEMSLEEP",
+	"%MDMEV", "%XTIME", "+CMT", "+CDS", "+CMS", "+CGEV", "+CNEC_ESM", "%CESQ",
+	"CEREG", "NCELLMEAS", ANY,
+};
+
+static uint32_t hits[ARRAY_SIZE(filters)];
+static uint32_t deferred_hits[ARRAY_SIZE(filters)];
+
+#define MONITOR_HANDLER_DEFINE(idx)					\
+	static void isr_handler_##idx(const char *notif)		\
+	{								\
+		hits[idx]++;						\
+	}								\
+	static void handler_##idx(const char *notif)			\
+	{								\
+		deferred_hits[idx]++;					\
+	}
+
+MONITOR_HANDLER_DEFINE(0)
+MONITOR_HANDLER_DEFINE(1)
+MONITOR_HANDLER_DEFINE(2)
+MONITOR_HANDLER_DEFINE(3)
+MONITOR_HANDLER_DEFINE(4)
+MONITOR_HANDLER_DEFINE(5)
+MONITOR_HANDLER_DEFINE(6)
+MONITOR_HANDLER_DEFINE(7)
+MONITOR_HANDLER_DEFINE(8)
+MONITOR_HANDLER_DEFINE(9)
+MONITOR_HANDLER_DEFINE(10)
+MONITOR_HANDLER_DEFINE(11)
+MONITOR_HANDLER_DEFINE(12)
+MONITOR_HANDLER_DEFINE(13)
+MONITOR_HANDLER_DEFINE(14)
+MONITOR_HANDLER_DEFINE(15)
+MONITOR_HANDLER_DEFINE(16)
+
+AT_MONITOR_ISR(isr_mon_0, "+CEREG", isr_handler_0);
+AT_MONITOR_ISR(isr_mon_1, "+CSCON", isr_handler_1);
+AT_MONITOR_ISR(isr_mon_2, "+CEDRXP", isr_handler_2);
+AT_MONITOR_ISR(isr_mon_3, "%XT3412", isr_handler_3);
+AT_MONITOR_ISR(isr_mon_4, "%NCELLMEAS", isr_handler_4);
+AT_MONITOR_ISR(isr_mon_5, "%XMODEMSLEEP", isr_handler_5);
+AT_MONITOR_ISR(isr_mon_6, "%MDMEV", isr_handler_6);
+AT_MONITOR_ISR(isr_mon_7, "%XTIME", isr_handler_7);
+AT_MONITOR_ISR(isr_mon_8, "+CMT", isr_handler_8);
+AT_MONITOR_ISR(isr_mon_9, "+CDS", isr_handler_9);
+AT_MONITOR_ISR(isr_mon_10, "+CMS", isr_handler_10);
+AT_MONITOR_ISR(isr_mon_11, "+CGEV", isr_handler_11);
+AT_MONITOR_ISR(isr_mon_12, "+CNEC_ESM", isr_handler_12);
+AT_MONITOR_ISR(isr_mon_13, "%CESQ", isr_handler_13);
+AT_MONITOR_ISR(isr_mon_14, "CEREG", isr_handler_14);
+AT_MONITOR_ISR(isr_mon_15, "NCELLMEAS", isr_handler_15);
+AT_MONITOR_ISR(isr_mon_16, ANY, isr_handler_16);
+
+AT_MONITOR(mon_0, "+CEREG", handler_0);
+AT_MONITOR(mon_1, "+CSCON", handler_1);
+AT_MONITOR(mon_2, "+CEDRXP", handler_2);
+AT_MONITOR(mon_3, "%XT3412", handler_3);
+AT_MONITOR(mon_4, "%NCELLMEAS", handler_4);
+AT_MONITOR(mon_5, "%XMODEMSLEEP", handler_5);
+AT_MONITOR(mon_6, "%MDMEV", handler_6);
+AT_MONITOR(mon_7, "%XTIME", handler_7);
+AT_MONITOR(mon_8, "+CMT", handler_8);
+AT_MONITOR(mon_9, "+CDS", handler_9);
+AT_MONITOR(mon_10, "+CMS", handler_10);
+AT_MONITOR(mon_11, "+CGEV", handler_11);
+AT_MONITOR(mon_12, "+CNEC_ESM", handler_12);
+AT_MONITOR(mon_13, "%CESQ", handler_13);
+AT_MONITOR(mon_14, "CEREG", handler_14);
+AT_MONITOR(mon_15, "NCELLMEAS", handler_15);
+AT_MONITOR(mon_16, ANY, handler_16, PAUSED);
+
+static const char *ref_notif;
+
+static void ref_handler(const char *notif)
+{
+	at_monitor_notif_ref(notif);
+	ref_notif = notif;
+}
+
+AT_MONITOR(ref_mon, "%XREFTEST", ref_handler);
+
+void setUp(void)
+{
+	memset(hits, 0, sizeof(hits));
+	memset(deferred_hits, 0, sizeof(deferred_hits));
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+static uint32_t expected_hits(const char *filter)
+{
+	uint32_t cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(corpus); i++) {
+		if (filter == ANY || strstr(corpus[i], filter)) {
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+
+void test_at_monitor_dispatch_isr(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(corpus); i++) {
+		at_monitor_dispatch(corpus[i]);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(filters); i++) {
+		TEST_ASSERT_EQUAL_MESSAGE(expected_hits(filters[i]), hits[i], filters[i]);
+	}
+}
+
+void test_at_monitor_dispatch(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(corpus); i++) {
+		at_monitor_dispatch(corpus[i]);
+		/* Let the workqueue process the notification. */
+		k_sleep(K_MSEC(1));
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(filters) - 1; i++) {
+		TEST_ASSERT_EQUAL_MESSAGE(expected_hits(filters[i]), deferred_hits[i], filters[i]);
+	}
+
+	/* Monitor is paused. */
+	TEST_ASSERT_EQUAL(0, deferred_hits[ARRAY_SIZE(filters) - 1]);
+}
+
+void test_at_monitor_dispatch_paused(void)
+{
+	at_monitor_pause(isr_mon_0);
+	at_monitor_pause(isr_mon_14);
+
+	at_monitor_dispatch(corpus[0]);
+
+	at_monitor_resume(isr_mon_0);
+	at_monitor_resume(isr_mon_14);
+
+	TEST_ASSERT_EQUAL(0, hits[0]);
+	TEST_ASSERT_EQUAL(0, hits[14]);
+	TEST_ASSERT_EQUAL(1, hits[16]);
+}
+
+void test_at_monitor_notif_ref(void)
+{
+	static const char notif[] = "%XREFTEST: 1\r\n";
+	struct at_monitor_stats stats;
+
+	ref_notif = NULL;
+
+	at_monitor_dispatch(notif);
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_NOT_NULL(ref_notif);
+
+	/* Notification is kept in the buffer until the reference is released. */
+	at_monitor_stats_get(&stats);
+	TEST_ASSERT_GREATER_THAN(0, stats.used);
+	TEST_ASSERT_EQUAL_STRING(notif, ref_notif);
+
+	at_monitor_notif_unref(ref_notif);
+
+	at_monitor_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, stats.used);
+}
+
+void test_at_monitor_buffer_full(void)
+{
+	struct at_monitor_stats stats;
+	uint32_t drop_cnt;
+
+	at_monitor_stats_get(&stats);
+	drop_cnt = stats.drop_cnt;
+
+	/* Receive a burst of notifications before any of them is dispatched. */
+	k_sched_lock();
+	for (size_t i = 0; i < BURST_CNT; i++) {
+		at_monitor_dispatch(corpus[0]);
+	}
+	k_sched_unlock();
+
+	k_sleep(K_MSEC(10));
+
+	at_monitor_stats_get(&stats);
+	TEST_ASSERT_GREATER_THAN(drop_cnt, stats.drop_cnt);
+	TEST_ASSERT_EQUAL(BURST_CNT, deferred_hits[0] + (stats.drop_cnt - drop_cnt));
+	TEST_ASSERT_LESS_OR_EQUAL(stats.size, stats.used_max);
+	TEST_ASSERT_EQUAL(0, stats.used);
+
+	printk("Burst of %d notifications: %u dropped, peak buffer usage %zu/%zu bytes\n",
+	       BURST_CNT, stats.drop_cnt - drop_cnt, stats.used_max, stats.size);
+}
+
+void test_at_monitor_dispatch_benchmark(void)
+{
+	uint32_t start;
+	uint32_t cycles;
+
+	/* Pause deferred monitors, to measure the matching in ISR only. */
+	at_monitor_pause(mon_0);
+	at_monitor_pause(mon_1);
+	at_monitor_pause(mon_2);
+	at_monitor_pause(mon_3);
+	at_monitor_pause(mon_4);
+	at_monitor_pause(mon_5);
+	at_monitor_pause(mon_6);
+	at_monitor_pause(mon_7);
+	at_monitor_pause(mon_8);
+	at_monitor_pause(mon_9);
+	at_monitor_pause(mon_10);
+	at_monitor_pause(mon_11);
+	at_monitor_pause(mon_12);
+	at_monitor_pause(mon_13);
+	at_monitor_pause(mon_14);
+	at_monitor_pause(mon_15);
+
+	start = k_cycle_get_32();
+
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(corpus); i++) {
+			at_monitor_dispatch(corpus[i]);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	for (size_t i = 0; i < ARRAY_SIZE(filters); i++) {
+		TEST_ASSERT_EQUAL_MESSAGE(BENCHMARK_ROUNDS * expected_hits(filters[i]), hits[i],
+					  filters[i]);
+	}
+
+	printk("Dispatch of %zu notifications to %zu monitors: %u cycles per notification\n",
+	       BENCHMARK_ROUNDS * ARRAY_SIZE(corpus), ARRAY_SIZE(filters),
+	       cycles / (BENCHMARK_ROUNDS * ARRAY_SIZE(corpus)));
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int at_monitor_test_sys_init(const struct device *unused)
+{
+	__wrap_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
+
+SYS_INIT(at_monitor_test_sys_init, POST_KERNEL, 0);
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "coalesce_event.h"
+
+APP_EVENT_TYPE_DEFINE(coalesce_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE(APP_EVENT_TYPE_FLAGS_COALESCE));
+
+APP_EVENT_TYPE_DEFINE(coalesce_keyed_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE(APP_EVENT_TYPE_FLAGS_COALESCE));
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+static uintptr_t coalesce_keyed_event_key(const struct app_event_header *aeh)
+{
+	return cast_coalesce_keyed_event(aeh)->key;
+}
+
+APP_EVENT_TYPE_KEY_DEFINE(coalesce_keyed_event, coalesce_keyed_event_key);
+#endif
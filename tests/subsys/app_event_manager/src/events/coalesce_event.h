@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _COALESCE_EVENT_H_
+#define _COALESCE_EVENT_H_
+
+/**
+ * @brief Coalesce Event
+ * @defgroup coalesce_event Event used to test event coalescing
+ * @{
+ */
+
+#include <app_event_manager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct coalesce_event {
+	struct app_event_header header;
+
+	uint32_t val;
+};
+
+APP_EVENT_TYPE_DECLARE(coalesce_event);
+
+struct coalesce_keyed_event {
+	struct app_event_header header;
+
+	uint32_t key;
+	uint32_t val;
+};
+
+APP_EVENT_TYPE_DECLARE(coalesce_keyed_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _COALESCE_EVENT_H_ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "keyed_event.h"
+
+APP_EVENT_TYPE_DEFINE(keyed_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE());
+
+APP_EVENT_TYPE_DEFINE(unkeyed_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE());
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+static uintptr_t keyed_event_key(const struct app_event_header *aeh)
+{
+	return cast_keyed_event(aeh)->key;
+}
+
+APP_EVENT_TYPE_KEY_DEFINE(keyed_event, keyed_event_key);
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _KEYED_EVENT_H_
+#define _KEYED_EVENT_H_
+
+/**
+ * @brief Keyed Events
+ * @defgroup keyed_event Events used to test keyed subscriptions
+ * @{
+ */
+
+#include <app_event_manager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct keyed_event {
+	struct app_event_header header;
+
+	uint32_t key;
+};
+
+APP_EVENT_TYPE_DECLARE(keyed_event);
+
+
+struct unkeyed_event {
+	struct app_event_header header;
+
+	uint32_t key;
+};
+
+APP_EVENT_TYPE_DECLARE(unkeyed_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _KEYED_EVENT_H_ */
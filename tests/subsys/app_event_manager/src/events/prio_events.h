@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PRIO_EVENTS_H_
+#define _PRIO_EVENTS_H_
+
+/**
+ * @brief Events with different dispatch priorities
+ * @defgroup prio_events Events used to test priority-aware event dispatch
+ * @{
+ */
+
+#include <app_event_manager.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct prio_high_event {
+	struct app_event_header header;
+
+	uint32_t seq;
+};
+
+APP_EVENT_TYPE_DECLARE(prio_high_event);
+
+
+struct prio_normal_event {
+	struct app_event_header header;
+
+	uint32_t seq;
+};
+
+APP_EVENT_TYPE_DECLARE(prio_normal_event);
+
+
+struct prio_low_event {
+	struct app_event_header header;
+
+	uint32_t seq;
+};
+
+APP_EVENT_TYPE_DECLARE(prio_low_event);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _PRIO_EVENTS_H_ */
@@ -175,6 +175,15 @@ static void test_event_size_disabled(void)
 }
 
 void test_oom_reset(void);
+void test_slab_burst(void);
+void test_slab_fragmentation(void);
+void test_subs_key_dispatch(void);
+void test_coalesce(void);
+void test_coalesce_keyed(void);
+void test_prio_order(void);
+void test_prio_budget(void);
+void test_prio_workqueue(void);
+void test_refcount(void);
 
 void test_main(void)
 {
@@ -186,6 +195,15 @@ void test_main(void)
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom_reset),
 			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_slab_burst),
+			 ztest_unit_test(test_slab_fragmentation),
+			 ztest_unit_test(test_subs_key_dispatch),
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_coalesce_keyed),
+			 ztest_unit_test(test_prio_order),
+			 ztest_unit_test(test_prio_budget),
+			 ztest_unit_test(test_prio_workqueue),
+			 ztest_unit_test(test_refcount),
 			 ztest_unit_test(test_event_size_static),
 			 ztest_unit_test(test_event_size_dynamic),
 			 ztest_unit_test(test_event_size_dynamic_with_data),
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <coalesce_event.h>
+
+#define MODULE test_coalesce
+#define SUBMIT_CNT 10
+#define KEY_CNT 2
+
+static K_SEM_DEFINE(coalesce_sem, 0, SUBMIT_CNT);
+static uint32_t last_val;
+
+struct keyed_record {
+	uint32_t key;
+	uint32_t val;
+};
+
+static struct keyed_record keyed_records[SUBMIT_CNT];
+static size_t keyed_record_cnt;
+
+
+void test_coalesce(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)) {
+		ztest_test_skip();
+		return;
+	}
+
+	/* Prevent processing until all the events are submitted. */
+	k_sched_lock();
+	for (uint32_t i = 0; i < SUBMIT_CNT; i++) {
+		struct coalesce_event *event = new_coalesce_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->val = i;
+		APP_EVENT_SUBMIT(event);
+	}
+	k_sched_unlock();
+
+	zassert_ok(k_sem_take(&coalesce_sem, K_SECONDS(1)), "Event not dispatched");
+	zassert_equal(k_sem_take(&coalesce_sem, K_MSEC(100)), -EAGAIN,
+		      "Event was not coalesced");
+	zassert_equal(last_val, SUBMIT_CNT - 1, "Event data not updated");
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	size_t idx = _EVENT_ID(coalesce_event) - _event_type_list_start;
+
+	zassert_equal(_app_event_manager_coalesce_stats.dispatched[idx], 1,
+		      "Wrong number of dispatched events");
+	zassert_equal(_app_event_manager_coalesce_stats.coalesced[idx], SUBMIT_CNT - 1,
+		      "Wrong number of coalesced events");
+#endif
+}
+
+void test_coalesce_keyed(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE) ||
+	    !IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)) {
+		ztest_test_skip();
+		return;
+	}
+
+	k_sem_reset(&coalesce_sem);
+	keyed_record_cnt = 0;
+
+	/* Prevent processing until all the events are submitted. */
+	k_sched_lock();
+	for (uint32_t i = 0; i < SUBMIT_CNT; i++) {
+		struct coalesce_keyed_event *event = new_coalesce_keyed_event();
+
+		zassert_not_null(event, "Failed to allocate event");
+		event->key = i % KEY_CNT;
+		event->val = i;
+		APP_EVENT_SUBMIT(event);
+	}
+	k_sched_unlock();
+
+	for (size_t i = 0; i < KEY_CNT; i++) {
+		zassert_ok(k_sem_take(&coalesce_sem, K_SECONDS(1)), "Event not dispatched");
+	}
+	zassert_equal(k_sem_take(&coalesce_sem, K_MSEC(100)), -EAGAIN,
+		      "Events with the same key were not coalesced");
+	zassert_equal(keyed_record_cnt, KEY_CNT, "Wrong number of dispatched events");
+
+	/* Every key keeps the place of its first event and the data of its last event. */
+	for (uint32_t key = 0; key < KEY_CNT; key++) {
+		zassert_equal(keyed_records[key].key, key,
+			      "Events with different keys were coalesced");
+		zassert_equal(keyed_records[key].val, SUBMIT_CNT - KEY_CNT + key,
+			      "Event data not updated");
+	}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_COALESCE)
+	size_t idx = _EVENT_ID(coalesce_keyed_event) - _event_type_list_start;
+
+	zassert_equal(_app_event_manager_coalesce_stats.dispatched[idx], KEY_CNT,
+		      "Wrong number of dispatched events");
+	zassert_equal(_app_event_manager_coalesce_stats.coalesced[idx], SUBMIT_CNT - KEY_CNT,
+		      "Wrong number of coalesced events");
+#endif
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_coalesce_event(aeh)) {
+		last_val = cast_coalesce_event(aeh)->val;
+		k_sem_give(&coalesce_sem);
+
+		return false;
+	}
+
+	if (is_coalesce_keyed_event(aeh)) {
+		const struct coalesce_keyed_event *event = cast_coalesce_keyed_event(aeh);
+
+		zassert_true(keyed_record_cnt < ARRAY_SIZE(keyed_records), "Too many events");
+		keyed_records[keyed_record_cnt].key = event->key;
+		keyed_records[keyed_record_cnt].val = event->val;
+		keyed_record_cnt++;
+		k_sem_give(&coalesce_sem);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, coalesce_event);
+APP_EVENT_SUBSCRIBE(MODULE, coalesce_keyed_event);
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <prio_events.h>
+
+#define MODULE test_prio
+#define ROUND_CNT 3
+#define BUDGET_ROUND_CNT 3
+#define RECORD_CNT MAX(ROUND_CNT * APP_EVENT_PRIO_COUNT,			\
+		       BUDGET_ROUND_CNT * MAX(CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET, 1))
+
+struct dispatch_record {
+	enum app_event_prio prio;
+	uint32_t seq;
+};
+
+static K_SEM_DEFINE(dispatch_sem, 0, 1);
+static struct dispatch_record records[RECORD_CNT];
+static size_t record_cnt;
+static size_t expected_cnt;
+static size_t probe_cnt;
+static k_tid_t dispatch_thread;
+
+
+static void dispatch_reset(size_t cnt)
+{
+	zassert_true(cnt <= ARRAY_SIZE(records), "Too many events");
+
+	k_sem_reset(&dispatch_sem);
+	record_cnt = 0;
+	expected_cnt = cnt;
+	dispatch_thread = NULL;
+}
+
+static void submit_high(uint32_t seq)
+{
+	struct prio_high_event *event = new_prio_high_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->seq = seq;
+	APP_EVENT_SUBMIT(event);
+}
+
+static void submit_normal(uint32_t seq)
+{
+	struct prio_normal_event *event = new_prio_normal_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->seq = seq;
+	APP_EVENT_SUBMIT(event);
+}
+
+static void submit_low(uint32_t seq)
+{
+	struct prio_low_event *event = new_prio_low_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->seq = seq;
+	APP_EVENT_SUBMIT(event);
+}
+
+void test_prio_order(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIO_QUEUES)) {
+		ztest_test_skip();
+		return;
+	}
+
+	dispatch_reset(ROUND_CNT * APP_EVENT_PRIO_COUNT);
+
+	/* Prevent processing until all the events are submitted. */
+	k_sched_lock();
+	for (uint32_t i = 0; i < ROUND_CNT; i++) {
+		submit_low(i);
+		submit_normal(i);
+		submit_high(i);
+	}
+	k_sched_unlock();
+
+	zassert_ok(k_sem_take(&dispatch_sem, K_SECONDS(1)), "Events not dispatched");
+
+	/* Events are dispatched by priority, keeping submission order within a priority. */
+	for (size_t i = 0; i < record_cnt; i++) {
+		zassert_equal(records[i].prio, i / ROUND_CNT,
+			      "Event %zu dispatched with wrong priority", i);
+		zassert_equal(records[i].seq, i % ROUND_CNT,
+			      "Event %zu dispatched out of order", i);
+	}
+}
+
+static void probe_work_fn(struct k_work *work)
+{
+	probe_cnt = record_cnt;
+}
+
+static K_WORK_DEFINE(probe_work, probe_work_fn);
+
+void test_prio_budget(void)
+{
+	if ((CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET == 0) ||
+	    IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE)) {
+		ztest_test_skip();
+		return;
+	}
+
+	const size_t event_cnt = BUDGET_ROUND_CNT * CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET;
+
+	dispatch_reset(event_cnt);
+	probe_cnt = 0;
+
+	/* The probe work is queued right after the event processing work. */
+	k_sched_lock();
+	for (uint32_t i = 0; i < event_cnt; i++) {
+		submit_normal(i);
+	}
+	k_work_submit(&probe_work);
+	k_sched_unlock();
+
+	zassert_ok(k_sem_take(&dispatch_sem, K_SECONDS(1)), "Events not dispatched");
+	zassert_equal(probe_cnt, CONFIG_APP_EVENT_MANAGER_DISPATCH_BUDGET,
+		      "Event processing did not yield after dispatch budget");
+
+	for (size_t i = 0; i < record_cnt; i++) {
+		zassert_equal(records[i].seq, i, "Event %zu dispatched out of order", i);
+	}
+}
+
+void test_prio_workqueue(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE)) {
+		ztest_test_skip();
+		return;
+	}
+
+	dispatch_reset(1);
+	submit_normal(0);
+
+	zassert_ok(k_sem_take(&dispatch_sem, K_SECONDS(1)), "Event not dispatched");
+	zassert_not_null(dispatch_thread, "Dispatch thread not recorded");
+	zassert_not_equal(dispatch_thread, &k_sys_work_q.thread,
+			  "Event dispatched from the system work queue");
+	zassert_equal(k_thread_priority_get(dispatch_thread),
+		      CONFIG_APP_EVENT_MANAGER_DISPATCH_WORKQUEUE_PRIORITY,
+		      "Wrong dispatch thread priority");
+}
+
+static void dispatch_record(enum app_event_prio prio, uint32_t seq)
+{
+	zassert_true(record_cnt < expected_cnt, "Unexpected event");
+
+	records[record_cnt].prio = prio;
+	records[record_cnt].seq = seq;
+	record_cnt++;
+	dispatch_thread = k_current_get();
+
+	if (record_cnt == expected_cnt) {
+		k_sem_give(&dispatch_sem);
+	}
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_prio_high_event(aeh)) {
+		dispatch_record(APP_EVENT_PRIO_HIGH, cast_prio_high_event(aeh)->seq);
+		return false;
+	}
+
+	if (is_prio_normal_event(aeh)) {
+		dispatch_record(APP_EVENT_PRIO_NORMAL, cast_prio_normal_event(aeh)->seq);
+		return false;
+	}
+
+	if (is_prio_low_event(aeh)) {
+		dispatch_record(APP_EVENT_PRIO_LOW, cast_prio_low_event(aeh)->seq);
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, prio_high_event);
+APP_EVENT_SUBSCRIBE(MODULE, prio_normal_event);
+APP_EVENT_SUBSCRIBE(MODULE, prio_low_event);
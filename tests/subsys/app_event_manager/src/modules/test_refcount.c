@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <ref_event.h>
+#include <test_event_allocator.h>
+
+#define PAYLOAD_SIZE 64
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT)
+
+static K_SEM_DEFINE(processed_sem, 0, 1);
+static const struct ref_event *kept[2];
+
+
+static void submit_ref_event(bool keep)
+{
+	struct ref_event *event = new_ref_event(PAYLOAD_SIZE);
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->keep = keep;
+	for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+		event->dyndata.data[i] = i;
+	}
+	APP_EVENT_SUBMIT(event);
+}
+
+static void payload_check(const struct ref_event *event)
+{
+	zassert_equal(event->dyndata.size, PAYLOAD_SIZE, "Wrong payload size");
+	for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+		zassert_equal(event->dyndata.data[i], i, "Payload modified");
+	}
+}
+
+void test_refcount(void)
+{
+	kept[0] = NULL;
+	kept[1] = NULL;
+
+	/* Events are processed in order. When the second event is received,
+	 * processing of the first one is complete.
+	 */
+	submit_ref_event(true);
+	submit_ref_event(false);
+	zassert_ok(k_sem_take(&processed_sem, K_SECONDS(1)), "Events not processed");
+
+	zassert_not_null(kept[0], "Event not kept by the first listener");
+	zassert_equal(kept[0], kept[1], "Listeners kept different events");
+
+	const struct ref_event *event = kept[0];
+
+	zassert_not_equal(test_event_last_freed, event, "Referenced event freed");
+	zassert_equal(atomic_get(&event->header.ref_cnt), 2, "Wrong reference count");
+	payload_check(event);
+
+	app_event_manager_event_ref(&event->header);
+	zassert_equal(atomic_get(&event->header.ref_cnt), 3, "Reference not taken");
+
+	app_event_manager_event_unref(&event->header);
+	app_event_manager_event_unref(&kept[0]->header);
+	zassert_not_equal(test_event_last_freed, event, "Event freed before last unref");
+	payload_check(event);
+
+	app_event_manager_event_unref(&kept[1]->header);
+	zassert_equal(test_event_last_freed, event, "Event not freed on last unref");
+}
+
+static bool app_event_handler(const struct app_event_header *aeh, size_t listener)
+{
+	if (is_ref_event(aeh)) {
+		const struct ref_event *event = cast_ref_event(aeh);
+
+		/* Every listener keeping the event takes one reference. */
+		zassert_equal(atomic_get(&aeh->ref_cnt), event->keep ? (1 + listener) : 1,
+			      "Wrong reference count during processing");
+
+		if (event->keep) {
+			app_event_manager_event_ref(aeh);
+			kept[listener] = event;
+		} else if (listener == (ARRAY_SIZE(kept) - 1)) {
+			k_sem_give(&processed_sem);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+static bool app_event_handler_first(const struct app_event_header *aeh)
+{
+	return app_event_handler(aeh, 0);
+}
+
+static bool app_event_handler_second(const struct app_event_header *aeh)
+{
+	return app_event_handler(aeh, 1);
+}
+
+APP_EVENT_LISTENER(test_refcount_first, app_event_handler_first);
+APP_EVENT_SUBSCRIBE_EARLY(test_refcount_first, ref_event);
+APP_EVENT_LISTENER(test_refcount_second, app_event_handler_second);
+APP_EVENT_SUBSCRIBE(test_refcount_second, ref_event);
+
+#else
+
+void test_refcount(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_REFCOUNT */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <data_event.h>
+
+#define MODULE test_slab
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+#define BURST_CNT CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT
+#else
+#define BURST_CNT 1
+#endif
+
+/* Number of long-lived heap allocations interleaved with the burst. */
+#define PINNED_CNT (BURST_CNT / 2)
+#define PINNED_SIZE 8
+
+static void *burst_tab[BURST_CNT];
+static void *pinned_tab[PINNED_CNT];
+
+
+/* Find the largest block that can be allocated from the system heap. */
+static size_t largest_heap_block(void)
+{
+	size_t lo = 0;
+	size_t hi = CONFIG_HEAP_MEM_POOL_SIZE;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi + 1) / 2;
+		void *p = k_malloc(mid);
+
+		if (p) {
+			k_free(p);
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+}
+
+static uint32_t burst_alloc(void *(*alloc_fn)(void))
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < ARRAY_SIZE(burst_tab); i++) {
+		burst_tab[i] = alloc_fn();
+		zassert_not_null(burst_tab[i], "Failed to allocate event");
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static uint32_t burst_free(void (*free_fn)(void *))
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < ARRAY_SIZE(burst_tab); i++) {
+		free_fn(burst_tab[i]);
+		burst_tab[i] = NULL;
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void *slab_event_alloc(void)
+{
+	return new_data_event();
+}
+
+static void *heap_event_alloc(void)
+{
+	struct data_event *event = k_malloc(sizeof(*event));
+
+	if (event) {
+		event->header.type_id = _EVENT_ID(data_event);
+	}
+
+	return event;
+}
+
+void test_slab_burst(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)) {
+		ztest_test_skip();
+		return;
+	}
+
+	struct app_event_manager_slab_stats stats;
+	uint32_t used;
+	uint32_t total;
+	uint32_t slab_alloc_cyc = burst_alloc(slab_event_alloc);
+
+	zassert_ok(app_event_manager_slab_stats_get(_EVENT_ID(data_event), &stats,
+						    &used, &total),
+		   "Event is not allocated from slab");
+	zassert_equal(used, BURST_CNT, "Unexpected number of used blocks");
+	zassert_equal(total, BURST_CNT, "Unexpected number of slab blocks");
+	zassert_equal(atomic_get(&stats.max_used), BURST_CNT, "Unexpected max used");
+	zassert_equal(atomic_get(&stats.fallback_cnt), 0, "Unexpected fallback");
+
+	uint32_t slab_free_cyc = burst_free(app_event_manager_free);
+
+	zassert_ok(app_event_manager_slab_stats_get(_EVENT_ID(data_event), &stats,
+						    &used, &total), "");
+	zassert_equal(used, 0, "Events not released to slab");
+
+	uint32_t heap_alloc_cyc = burst_alloc(heap_event_alloc);
+	uint32_t heap_free_cyc = burst_free(k_free);
+
+	TC_PRINT("Burst of %d events (cycles) alloc/free:\n", BURST_CNT);
+	TC_PRINT("\tslab: %u/%u\n", slab_alloc_cyc, slab_free_cyc);
+	TC_PRINT("\theap: %u/%u\n", heap_alloc_cyc, heap_free_cyc);
+}
+
+static size_t burst_fragmentation(void *(*alloc_fn)(void), void (*free_fn)(void *))
+{
+	/* Interleave event allocations with long-lived allocations done
+	 * by other modules to simulate bursts on a running system.
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(burst_tab); i++) {
+		burst_tab[i] = alloc_fn();
+		zassert_not_null(burst_tab[i], "Failed to allocate event");
+
+		if ((i % 2) && (i / 2 < ARRAY_SIZE(pinned_tab))) {
+			pinned_tab[i / 2] = k_malloc(PINNED_SIZE);
+			zassert_not_null(pinned_tab[i / 2], "Failed to allocate pinned block");
+		}
+	}
+
+	burst_free(free_fn);
+
+	size_t largest = largest_heap_block();
+
+	for (size_t i = 0; i < ARRAY_SIZE(pinned_tab); i++) {
+		k_free(pinned_tab[i]);
+		pinned_tab[i] = NULL;
+	}
+
+	return largest;
+}
+
+void test_slab_fragmentation(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)) {
+		ztest_test_skip();
+		return;
+	}
+
+	size_t largest_before = largest_heap_block();
+	size_t largest_slab = burst_fragmentation(slab_event_alloc, app_event_manager_free);
+	size_t largest_heap = burst_fragmentation(heap_event_alloc, k_free);
+
+	TC_PRINT("Largest free heap block (bytes):\n");
+	TC_PRINT("\tidle: %zu\n", largest_before);
+	TC_PRINT("\tafter slab burst: %zu\n", largest_slab);
+	TC_PRINT("\tafter heap burst: %zu\n", largest_heap);
+
+	zassert_true(largest_slab >= largest_heap,
+		     "Slab burst fragmented heap more than heap burst");
+	zassert_equal(largest_heap_block(), largest_before, "Heap memory leaked");
+}
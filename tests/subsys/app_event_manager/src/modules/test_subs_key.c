@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <keyed_event.h>
+
+#define MODULE test_subs_key
+
+/* Number of module state listeners in a typical nRF Desktop configuration. */
+#define LISTENER_CNT 32
+#define ROUND_EVENT_CNT 8
+#define ROUND_CNT 32
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY)
+
+static K_SEM_DEFINE(round_sem, 0, 1);
+static atomic_t call_cnt;
+static atomic_t hit_cnt;
+static atomic_t final_cnt;
+
+
+#define KEYED_LISTENER_DEFINE(i, _)							\
+	static bool _CONCAT(keyed_handler_, i)(const struct app_event_header *aeh)	\
+	{										\
+		atomic_inc(&call_cnt);							\
+		zassert_equal(cast_keyed_event(aeh)->key, i, "Wrong key");		\
+		atomic_inc(&hit_cnt);							\
+		return false;								\
+	}										\
+	APP_EVENT_LISTENER(_CONCAT(keyed_listener_, i), _CONCAT(keyed_handler_, i));	\
+	APP_EVENT_SUBSCRIBE_KEY(_CONCAT(keyed_listener_, i), keyed_event, i);
+
+#define UNKEYED_LISTENER_DEFINE(i, _)							\
+	static bool _CONCAT(unkeyed_handler_, i)(const struct app_event_header *aeh)	\
+	{										\
+		atomic_inc(&call_cnt);							\
+		if (cast_unkeyed_event(aeh)->key == i) {				\
+			atomic_inc(&hit_cnt);						\
+		}									\
+		return false;								\
+	}										\
+	APP_EVENT_LISTENER(_CONCAT(unkeyed_listener_, i), _CONCAT(unkeyed_handler_, i));\
+	APP_EVENT_SUBSCRIBE(_CONCAT(unkeyed_listener_, i), unkeyed_event);
+
+UTIL_LISTIFY(LISTENER_CNT, KEYED_LISTENER_DEFINE)
+UTIL_LISTIFY(LISTENER_CNT, UNKEYED_LISTENER_DEFINE)
+
+
+/* Final listener is not keyed and receives all the events. */
+static bool final_handler(const struct app_event_header *aeh)
+{
+	if (atomic_inc(&final_cnt) == (ROUND_EVENT_CNT - 1)) {
+		atomic_clear(&final_cnt);
+		k_sem_give(&round_sem);
+	}
+
+	return false;
+}
+
+APP_EVENT_LISTENER(final, final_handler);
+APP_EVENT_SUBSCRIBE_FINAL(final, keyed_event);
+APP_EVENT_SUBSCRIBE_FINAL(final, unkeyed_event);
+
+
+static void submit_keyed(uint32_t key)
+{
+	struct keyed_event *event = new_keyed_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->key = key;
+	APP_EVENT_SUBMIT(event);
+}
+
+static void submit_unkeyed(uint32_t key)
+{
+	struct unkeyed_event *event = new_unkeyed_event();
+
+	zassert_not_null(event, "Failed to allocate event");
+	event->key = key;
+	APP_EVENT_SUBMIT(event);
+}
+
+static uint32_t dispatch_run(void (*submit_fn)(uint32_t key))
+{
+	uint32_t key = 0;
+
+	atomic_clear(&call_cnt);
+	atomic_clear(&hit_cnt);
+
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t round = 0; round < ROUND_CNT; round++) {
+		for (size_t i = 0; i < ROUND_EVENT_CNT; i++) {
+			submit_fn(key);
+			key = (key + 1) % LISTENER_CNT;
+		}
+
+		int err = k_sem_take(&round_sem, K_SECONDS(1));
+
+		zassert_equal(err, 0, "Events not dispatched");
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+void test_subs_key_dispatch(void)
+{
+	const size_t event_cnt = ROUND_CNT * ROUND_EVENT_CNT;
+
+	uint32_t keyed_cyc = dispatch_run(submit_keyed);
+
+	zassert_equal(atomic_get(&hit_cnt), event_cnt, "Keyed listener not notified");
+	zassert_equal(atomic_get(&call_cnt), event_cnt, "Not interested listener notified");
+
+	uint32_t unkeyed_cyc = dispatch_run(submit_unkeyed);
+
+	zassert_equal(atomic_get(&hit_cnt), event_cnt, "Listener not notified");
+	zassert_equal(atomic_get(&call_cnt), event_cnt * LISTENER_CNT,
+		      "Listener notified unexpectedly");
+
+	TC_PRINT("Dispatch of %zu events to %d listeners (cycles per event):\n",
+		 event_cnt, LISTENER_CNT);
+	TC_PRINT("\tkeyed: %u\n", keyed_cyc / event_cnt);
+	TC_PRINT("\tnot keyed: %u\n", unkeyed_cyc / event_cnt);
+}
+
+#else
+
+void test_subs_key_dispatch(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_APP_EVENT_MANAGER_SUBSCRIBE_KEY */
@@ -5,7 +5,11 @@
  */
 
 #include "test_oom.h"
+#include "test_event_allocator.h"
 #include <zephyr.h>
+#include <app_event_manager.h>
+
+const void *test_event_last_freed;
 
 void *app_event_manager_alloc(size_t size)
 {
@@ -20,5 +24,12 @@ void *app_event_manager_alloc(size_t size)
 
 void app_event_manager_free(void *addr)
 {
+	test_event_last_freed = addr;
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB) &&
+	    app_event_manager_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
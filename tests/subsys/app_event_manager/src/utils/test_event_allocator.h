@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _TEST_EVENT_ALLOCATOR_H_
+#define _TEST_EVENT_ALLOCATOR_H_
+
+/* Address of the last event released by app_event_manager_free. */
+extern const void *test_event_last_freed;
+
+#endif /* _TEST_EVENT_ALLOCATOR_H_ */
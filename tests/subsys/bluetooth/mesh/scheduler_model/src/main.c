@@ -61,6 +61,8 @@ static struct tm start_tm;
 static int gfire_cnt;
 static struct tm *fired_tm;
 static int galloc_cnt;
+static uint16_t fired_scenes[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+static int fired_scene_cnt;
 
 static inline uint64_t tai_to_ms(const struct bt_mesh_time_tai *tai)
 {
@@ -117,6 +119,10 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 
 	gfire_cnt--;
 
+	if (fired_scene_cnt < ARRAY_SIZE(fired_scenes)) {
+		fired_scenes[fired_scene_cnt++] = scene;
+	}
+
 	if (fired_tm) {
 		fired_tm[galloc_cnt] = *bt_mesh_time_srv_localtime(&time_srv, k_uptime_get());
 		galloc_cnt++;
@@ -195,6 +201,7 @@ static void setup(void)
 	gfire_cnt = 0;
 	galloc_cnt = 0;
 	fired_tm = NULL;
+	fired_scene_cnt = 0;
 
 	k_sem_reset(&action_fired);
 	zassert_not_null(_bt_mesh_scheduler_srv_cb.init,
@@ -923,6 +930,112 @@ static void test_exact_time_general_ovflw(void)
 	expected_tm_check(&expected, 1);
 }
 
+static void action_idx_put(uint8_t idx,
+			   const struct bt_mesh_schedule_entry *test_action)
+{
+	BT_MESH_MODEL_BUF_DEFINE(buf, BT_MESH_SCHEDULER_OP_ACTION_SET_UNACK,
+			BT_MESH_SCHEDULER_MSG_LEN_ACTION_SET);
+
+	net_buf_simple_init(&buf, 0);
+	scheduler_action_pack(&buf, idx, test_action);
+
+	zassert_false(_bt_mesh_scheduler_setup_srv_op[1].func(&mock_sched_model, NULL, &buf),
+		"Cannot schedule test action.");
+}
+
+static void heap_check(void)
+{
+	for (int pos = 0; pos < scheduler_srv.heap_len; pos++) {
+		uint8_t idx = scheduler_srv.heap[pos];
+		uint8_t parent = scheduler_srv.heap[(pos - 1) / 2];
+
+		zassert_equal(scheduler_srv.heap_pos[idx], pos,
+			"entry %d has wrong heap position", idx);
+
+		if (pos > 0) {
+			zassert_true(scheduler_srv.sched_tai[parent].sec <=
+				     scheduler_srv.sched_tai[idx].sec,
+				"entry %d is scheduled before its parent %d",
+				idx, parent);
+		}
+	}
+}
+
+static void test_action_order(void)
+{
+	const int count = BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+	struct bt_mesh_schedule_entry test_action = {
+			.year = 10,
+			.month  = ANY_MONTH,
+			.day = 1,
+			.hour = 0,
+			.minute = 0,
+			.day_of_week = ANY_DAY_OF_WEEK,
+			.action = BT_MESH_SCHEDULER_SCENE_RECALL,
+			.transition_time = 0,
+	};
+	start_time_adjust();
+
+	/* Entries with higher indexes are scheduled earlier. */
+	for (int i = 0; i < count; i++) {
+		test_action.second = 5 + 3 * (count - 1 - i);
+		test_action.scene_number = i + 1;
+		action_idx_put(i, &test_action);
+	}
+
+	zassert_equal(scheduler_srv.heap_len, count, "Wrong number of active entries");
+	zassert_equal(scheduler_srv.idx, count - 1, "Wrong first action");
+	heap_check();
+
+	zassert_ok(bt_mesh_scheduler_srv_time_update(&scheduler_srv),
+		"Cannot update time");
+	heap_check();
+
+	/* Reschedule the last entry at the same time. */
+	test_action.second = 5;
+	test_action.scene_number = count;
+	action_idx_put(count - 1, &test_action);
+	heap_check();
+
+	measurement_start(5 + 3 * (count - 1), count);
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(fired_scenes[i], count - i,
+			"scene %d fired as action %d", fired_scenes[i], i + 1);
+	}
+}
+
+static void test_action_unconvertible(void)
+{
+	struct bt_mesh_schedule_entry test_action = {
+			.year = 10,
+			.month  = ANY_MONTH,
+			.day = 1,
+			.hour = 0,
+			.minute = 0,
+			.second = 5,
+			.day_of_week = ANY_DAY_OF_WEEK,
+			.action = BT_MESH_SCHEDULER_SCENE_RECALL,
+			.transition_time = 0,
+			.scene_number = 1,
+	};
+
+	start_time_adjust();
+
+	action_idx_put(0, &test_action);
+	action_idx_put(1, &test_action);
+	zassert_equal(scheduler_srv.heap_len, 2, "Wrong number of active entries");
+
+	/* An entry whose time can't be converted is no longer scheduled. */
+	test_action.month = 0;
+	action_idx_put(0, &test_action);
+	zassert_equal(scheduler_srv.heap_len, 1, "Wrong number of active entries");
+	zassert_equal(scheduler_srv.heap_pos[0], BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT,
+		"Entry left in the heap");
+	zassert_equal(scheduler_srv.idx, 1, "Wrong next action");
+	heap_check();
+}
+
 void test_main(void)
 {
 	ztest_test_suite(scheduler_test,
@@ -948,7 +1061,9 @@ void test_main(void)
 				setup, teardown),
 		ztest_unit_test_setup_teardown(test_any_day_month_gap, setup, teardown),
 		ztest_unit_test_setup_teardown(test_month_ovflw, setup, teardown),
-		ztest_unit_test_setup_teardown(test_exact_time_general_ovflw, setup, teardown)
+		ztest_unit_test_setup_teardown(test_exact_time_general_ovflw, setup, teardown),
+		ztest_unit_test_setup_teardown(test_action_order, setup, teardown),
+		ztest_unit_test_setup_teardown(test_action_unconvertible, setup, teardown)
 		);
 
 	ztest_run_test_suite(scheduler_test);
@@ -11,6 +11,8 @@
 #include <ztest.h>
 #include <bluetooth/mesh/properties.h>
 #include <bluetooth/mesh/sensor_types.h>
+#include <bluetooth/mesh/sensor_srv.h>
+#include <bluetooth/mesh/sensor_cli.h>
 #include <model_utils.h>
 #include <sensor.h> // private header from the source folder
 
@@ -24,6 +26,140 @@ struct __packed uint24_t  { uint32_t v:24; };
 /****************** types section **********************************/
 
 /****************** mock section **********************************/
+#define SRV_ADDR 0x0001
+#define CLI_ADDR 0x0002
+
+/* Time the client waits for each page of a response. */
+#define CLI_PAGE_TIMEOUT_MS 100
+
+NET_BUF_SIMPLE_DEFINE_STATIC(srv_rsp, BT_MESH_TX_SDU_MAX);
+static uint16_t srv_rsp_lens[8];
+static uint32_t srv_rsp_cnt;
+
+/* If set, responses of the series server are passed to the client, until
+ * srv_pages_max pages have been sent. The server stalls after that.
+ */
+static bool srv_rsp_to_cli;
+static uint32_t srv_pages_max;
+
+static struct bt_mesh_sensor_srv series_srv;
+static struct bt_mesh_model series_srv_model = {
+	.user_data = &series_srv,
+	.pub = &series_srv.pub,
+};
+
+static struct bt_mesh_sensor_cli cli;
+static struct bt_mesh_model cli_model = {
+	.user_data = &cli,
+	.pub = &cli.pub,
+};
+
+/* Pass a message to the handler of its opcode in a model. */
+static int msg_deliver(const struct bt_mesh_model_op *ops,
+		       struct bt_mesh_model *model, uint16_t src,
+		       struct net_buf_simple *msg)
+{
+	struct bt_mesh_msg_ctx ctx = { .addr = src };
+	struct net_buf_simple buf;
+	uint32_t opcode;
+
+	net_buf_simple_clone(msg, &buf);
+
+	if (!(buf.data[0] & 0x80)) {
+		opcode = net_buf_simple_pull_u8(&buf);
+	} else {
+		opcode = net_buf_simple_pull_be16(&buf);
+	}
+
+	for (; ops->func; ops++) {
+		if (ops->opcode == opcode) {
+			return ops->func(model, &ctx, &buf);
+		}
+	}
+
+	return -ENOENT;
+}
+
+int bt_mesh_model_send(struct bt_mesh_model *model,
+		       struct bt_mesh_msg_ctx *ctx,
+		       struct net_buf_simple *msg,
+		       const struct bt_mesh_send_cb *cb,
+		       void *cb_data)
+{
+	net_buf_simple_reset(&srv_rsp);
+	net_buf_simple_add_mem(&srv_rsp, msg->data, msg->len);
+
+	if (srv_rsp_cnt < ARRAY_SIZE(srv_rsp_lens)) {
+		srv_rsp_lens[srv_rsp_cnt] = msg->len;
+	}
+
+	srv_rsp_cnt++;
+
+	if (srv_rsp_to_cli) {
+		if (srv_rsp_cnt > srv_pages_max) {
+			return 0;
+		}
+
+		msg_deliver(_bt_mesh_sensor_cli_op, &cli_model, SRV_ADDR, msg);
+
+		if (srv_rsp_cnt == srv_pages_max) {
+			return 0;
+		}
+	}
+
+	if (cb && cb->end) {
+		cb->end(0, cb_data);
+	}
+
+	return 0;
+}
+
+int model_ackd_send_paged(struct bt_mesh_model *model,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct net_buf_simple *buf,
+			  struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
+			  void *user_data, uint32_t pages)
+{
+	if (ack &&
+	    bt_mesh_msg_ack_ctx_prepare(ack, rsp_op, ctx->addr, user_data) != 0) {
+		return -EALREADY;
+	}
+
+	/* The request is handled by the series server. */
+	msg_deliver(_bt_mesh_sensor_srv_op, &series_srv_model, CLI_ADDR, buf);
+
+	if (ack) {
+		return bt_mesh_msg_ack_ctx_wait(ack, K_MSEC(CLI_PAGE_TIMEOUT_MS * pages));
+	}
+
+	return 0;
+}
+
+int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		    struct net_buf_simple *buf,
+		    struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
+		    void *user_data)
+{
+	return model_ackd_send_paged(model, ctx, buf, ack, rsp_op, user_data, 1);
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int32_t bt_mesh_model_pub_period_get(struct bt_mesh_model *mod)
+{
+	return 1000;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	return 0;
+}
 /****************** mock section **********************************/
 
 /****************** callback section ******************************/
@@ -2437,6 +2573,458 @@ static void test_present_rel_output_ripple_voltage(void)
 	percentage8_check(sensor_type);
 }
 
+/****************** sensor server section **************************/
+
+#define SRV_SENSOR_COUNT 40
+#define SRV_PUB_COUNT 64
+
+static int srv_sensor_get(struct bt_mesh_sensor_srv *srv,
+			  struct bt_mesh_sensor *sensor,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct sensor_value *rsp);
+
+static struct bt_mesh_sensor srv_sensors[SRV_SENSOR_COUNT] = {
+	[0 ... SRV_SENSOR_COUNT - 1] = { .get = srv_sensor_get },
+};
+static struct bt_mesh_sensor *srv_sensor_ptrs[SRV_SENSOR_COUNT];
+static int32_t srv_sensor_values[SRV_SENSOR_COUNT];
+static uint32_t srv_get_cnt;
+
+static struct bt_mesh_sensor_srv sensor_srv;
+static struct bt_mesh_model sensor_srv_model = {
+	.user_data = &sensor_srv,
+	.pub = &sensor_srv.pub,
+};
+
+static int srv_sensor_get(struct bt_mesh_sensor_srv *srv,
+			  struct bt_mesh_sensor *sensor,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct sensor_value *rsp)
+{
+	rsp[0].val1 = srv_sensor_values[sensor - srv_sensors];
+	rsp[0].val2 = 0;
+	srv_get_cnt++;
+
+	return 0;
+}
+
+static void sensor_srv_setup(void)
+{
+	int count = 0;
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (count == SRV_SENSOR_COUNT) {
+			break;
+		}
+
+		if (type->channel_count != 1) {
+			continue;
+		}
+
+		srv_sensors[count].type = type;
+		memset(&srv_sensors[count].state, 0,
+		       sizeof(srv_sensors[count].state));
+		srv_sensor_values[count] = 0;
+
+		/* Reverse the order to check that the server sorts the sensors. */
+		srv_sensor_ptrs[SRV_SENSOR_COUNT - 1 - count] = &srv_sensors[count];
+		count++;
+	}
+
+	zassert_equal(count, SRV_SENSOR_COUNT, "Not enough sensor types");
+
+	memset(&sensor_srv, 0, sizeof(sensor_srv));
+	sensor_srv.sensor_array = srv_sensor_ptrs;
+	sensor_srv.sensor_count = SRV_SENSOR_COUNT;
+
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&sensor_srv_model),
+		   "Server init failed");
+
+	srv_get_cnt = 0;
+}
+
+static void test_sensor_srv_lookup(void)
+{
+	const struct bt_mesh_model_op *descriptor_get_op = &_bt_mesh_sensor_srv_op[0];
+	const struct bt_mesh_model_op *get_op = &_bt_mesh_sensor_srv_op[1];
+	struct bt_mesh_msg_ctx ctx = {};
+	uint32_t cycles = 0;
+	uint16_t prev_id = 0;
+	int count = 0;
+
+	zassert_equal(get_op->opcode, BT_MESH_SENSOR_OP_GET, "Wrong opcode");
+	zassert_equal(descriptor_get_op->opcode, BT_MESH_SENSOR_OP_DESCRIPTOR_GET,
+		      "Wrong opcode");
+
+	for (int i = 0; i < SRV_SENSOR_COUNT; i++) {
+		uint16_t id = srv_sensors[i].type->id;
+		uint16_t rsp_id;
+		uint8_t rsp_len;
+
+		NET_BUF_SIMPLE_DEFINE(req, 2);
+		net_buf_simple_add_le16(&req, id);
+
+		uint32_t start = k_cycle_get_32();
+
+		zassert_ok(get_op->func(&sensor_srv_model, &ctx, &req),
+			   "Get failed");
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(srv_get_cnt, i + 1, "Sensor not sampled");
+		zassert_equal(net_buf_simple_pull_u8(&srv_rsp),
+			      BT_MESH_SENSOR_OP_STATUS, "Wrong response opcode");
+		sensor_status_id_decode(&srv_rsp, &rsp_len, &rsp_id);
+		zassert_equal(rsp_id, id, "Wrong sensor 0x%04x", rsp_id);
+	}
+
+	TC_PRINT("Sensor Get for %d sensors: %u cycles per message\n",
+		 SRV_SENSOR_COUNT, cycles / SRV_SENSOR_COUNT);
+
+	/* All descriptors are reported in ascending ID order. */
+	NET_BUF_SIMPLE_DEFINE(req, 0);
+
+	zassert_ok(descriptor_get_op->func(&sensor_srv_model, &ctx, &req),
+		   "Descriptor Get failed");
+	zassert_equal(net_buf_simple_pull_u8(&srv_rsp),
+		      BT_MESH_SENSOR_OP_DESCRIPTOR_STATUS, "Wrong response opcode");
+
+	while (srv_rsp.len >= 8) {
+		uint16_t id = net_buf_simple_pull_le16(&srv_rsp);
+
+		net_buf_simple_pull_mem(&srv_rsp, 6);
+		zassert_true(count == 0 || id > prev_id, "Sensors not sorted");
+		prev_id = id;
+		count++;
+	}
+
+	zassert_equal(count, SRV_SENSOR_COUNT, "Wrong descriptor count");
+}
+
+static uint32_t sensor_srv_pub(bool notify, uint32_t *cycles)
+{
+	*cycles = 0;
+	srv_get_cnt = 0;
+
+	for (int i = 0; i < SRV_PUB_COUNT; i++) {
+		if (notify) {
+			int idx = i % SRV_SENSOR_COUNT;
+
+			srv_sensor_values[idx]++;
+			zassert_ok(bt_mesh_sensor_srv_mark_dirty(&sensor_srv,
+								 &srv_sensors[idx]),
+				   "Mark dirty failed");
+		}
+
+		uint32_t start = k_cycle_get_32();
+
+		(void)sensor_srv.pub.update(&sensor_srv_model);
+		*cycles += k_cycle_get_32() - start;
+	}
+
+	return srv_get_cnt;
+}
+
+static void test_sensor_srv_dirty_pub(void)
+{
+	struct bt_mesh_sensor other = { .type = srv_sensors[0].type };
+	uint32_t polled_cycles, notify_cycles;
+	uint32_t polled_cnt, notify_cnt;
+
+	zassert_equal(bt_mesh_sensor_srv_mark_dirty(&sensor_srv, &other),
+		      -ENOENT, "Foreign sensor marked dirty");
+
+	/* Sensors are published 16 times less often than the server. */
+	for (int i = 0; i < SRV_SENSOR_COUNT; i++) {
+		srv_sensors[i].state.configured = true;
+		srv_sensors[i].state.pub_div = 4;
+	}
+	sensor_srv.pub.period_div = 4;
+
+	polled_cnt = sensor_srv_pub(false, &polled_cycles);
+	zassert_equal(polled_cnt, SRV_PUB_COUNT * SRV_SENSOR_COUNT,
+		      "Sensors not sampled on every publication");
+
+	/* Every sensor notifies changes, one value changes per publication. */
+	for (int i = 0; i < SRV_SENSOR_COUNT; i++) {
+		zassert_ok(bt_mesh_sensor_srv_mark_dirty(&sensor_srv,
+							 &srv_sensors[i]),
+			   "Mark dirty failed");
+	}
+
+	notify_cnt = sensor_srv_pub(true, &notify_cycles);
+
+	TC_PRINT("Publication of %d sensors: %u samples, %u cycles polled, "
+		 "%u samples, %u cycles with change notification\n",
+		 SRV_SENSOR_COUNT, polled_cnt, polled_cycles / SRV_PUB_COUNT,
+		 notify_cnt, notify_cycles / SRV_PUB_COUNT);
+
+	zassert_true(notify_cnt < polled_cnt / 4,
+		     "Unchanged sensors sampled (%u samples)", notify_cnt);
+}
+
+#define SERIES_COLUMN_COUNT 100
+
+static int series_column_get(struct bt_mesh_sensor_srv *srv,
+			     struct bt_mesh_sensor *sensor,
+			     uint32_t index,
+			     struct bt_mesh_sensor_column *column)
+{
+	column->start.val1 = index;
+	column->start.val2 = 0;
+	column->end.val1 = index + 1;
+	column->end.val2 = 0;
+
+	return 0;
+}
+
+static int series_get(struct bt_mesh_sensor_srv *srv,
+		      struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx,
+		      const struct bt_mesh_sensor_column *column,
+		      struct sensor_value *value)
+{
+	value[0].val1 = 1;
+	value[0].val2 = 0;
+	value[1] = column->start;
+	value[2] = column->end;
+
+	return 0;
+}
+
+static struct bt_mesh_sensor series_sensor = {
+	.type = &bt_mesh_sensor_rel_runtime_in_an_input_current_range,
+	.series = {
+		.column_count = SERIES_COLUMN_COUNT,
+		.column_get = series_column_get,
+		.get = series_get,
+	},
+};
+static struct bt_mesh_sensor *const series_sensor_ptrs[] = { &series_sensor };
+
+static void series_srv_setup(void)
+{
+	memset(&series_srv, 0, sizeof(series_srv));
+	series_srv.sensor_array = series_sensor_ptrs;
+	series_srv.sensor_count = ARRAY_SIZE(series_sensor_ptrs);
+
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&series_srv_model),
+		   "Server init failed");
+
+	srv_rsp_cnt = 0;
+}
+
+static uint32_t series_columns_get(struct net_buf_simple *req)
+{
+	const struct bt_mesh_model_op *series_get_op = &_bt_mesh_sensor_srv_op[3];
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(series_sensor.type);
+	size_t col_len = col_format->size * 2 + sensor_value_len(series_sensor.type);
+	struct bt_mesh_msg_ctx ctx = {};
+	uint32_t columns = 0;
+
+	zassert_equal(series_get_op->opcode, BT_MESH_SENSOR_OP_SERIES_GET,
+		      "Wrong opcode");
+
+	srv_rsp_cnt = 0;
+	zassert_ok(series_get_op->func(&series_srv_model, &ctx, req),
+		   "Series Get failed");
+
+	/* The pages after the first are sent from the system work queue. */
+	for (int i = 0; i < 100 && series_srv.series.sensor; i++) {
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_is_null(series_srv.series.sensor, "Response not finished");
+	zassert_true(srv_rsp_cnt <= ARRAY_SIZE(srv_rsp_lens), "Too many pages");
+
+	for (int i = 0; i < srv_rsp_cnt; i++) {
+		uint32_t len = srv_rsp_lens[i] - 3;
+		bool continued = (i < srv_rsp_cnt - 1);
+
+		/* All pages but the last are full, and end with the start of
+		 * the next column.
+		 */
+		zassert_equal(len % col_len, continued ? col_format->size : 0,
+			      "Invalid page #%u length %u", i, len);
+		zassert_true(!continued ||
+			     BT_MESH_TX_SDU_MAX - srv_rsp_lens[i] <
+			     col_len + BT_MESH_MIC_SHORT,
+			     "Page #%u not full", i);
+		columns += len / col_len;
+	}
+
+	return columns;
+}
+
+static void test_sensor_srv_series_pages(void)
+{
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(series_sensor.type);
+	struct sensor_value start = { 10 }, end = { 19 };
+
+	NET_BUF_SIMPLE_DEFINE(req, BT_MESH_SENSOR_MSG_MAXLEN_SERIES_GET);
+
+	net_buf_simple_add_le16(&req, series_sensor.type->id);
+	zassert_equal(series_columns_get(&req), SERIES_COLUMN_COUNT,
+		      "Wrong column count");
+	zassert_true(srv_rsp_cnt > 1, "Series not paged");
+
+	/* Ranged request */
+	net_buf_simple_reset(&req);
+	net_buf_simple_add_le16(&req, series_sensor.type->id);
+	zassert_ok(sensor_ch_encode(&req, col_format, &start), "Encode failed");
+	zassert_ok(sensor_ch_encode(&req, col_format, &end), "Encode failed");
+	zassert_equal(series_columns_get(&req), 10, "Wrong column count");
+	zassert_equal(srv_rsp_cnt, 1, "Wrong page count");
+}
+
+static void test_sensor_srv_series_busy(void)
+{
+	const struct bt_mesh_model_op *series_get_op = &_bt_mesh_sensor_srv_op[3];
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(series_sensor.type);
+	size_t col_len = col_format->size * 2 + sensor_value_len(series_sensor.type);
+	struct bt_mesh_msg_ctx ctx = {};
+
+	NET_BUF_SIMPLE_DEFINE(req, BT_MESH_SENSOR_MSG_MAXLEN_SERIES_GET);
+
+	/* Another paged response is in progress. */
+	series_srv.series.sensor = &series_sensor;
+	series_srv.series.next = SERIES_COLUMN_COUNT / 2;
+
+	net_buf_simple_add_le16(&req, series_sensor.type->id);
+	zassert_ok(series_get_op->func(&series_srv_model, &ctx, &req),
+		   "Series Get failed");
+
+	/* The request gets the first page, marked as continued. */
+	zassert_equal(srv_rsp_cnt, 1, "Wrong page count");
+	zassert_equal((srv_rsp.len - 3) % col_len, col_format->size,
+		      "Page not continued");
+	zassert_equal(series_srv.series.sensor, &series_sensor,
+		      "Response in progress ended");
+	zassert_equal(series_srv.series.next, SERIES_COLUMN_COUNT / 2,
+		      "Response in progress changed");
+
+	series_srv.series.sensor = NULL;
+}
+
+static uint32_t cli_series_entry_cnt;
+
+static void cli_series_entry(struct bt_mesh_sensor_cli *cli,
+			     struct bt_mesh_msg_ctx *ctx,
+			     const struct bt_mesh_sensor_type *sensor,
+			     uint8_t index, uint8_t count,
+			     const struct bt_mesh_sensor_series_entry *entry)
+{
+	/* Entries are counted per page. */
+	zassert_true(index < count, "Invalid index %u of %u", index, count);
+	cli_series_entry_cnt++;
+}
+
+static const struct bt_mesh_sensor_cli_handlers cli_handlers = {
+	.series_entry = cli_series_entry,
+};
+
+static void series_cli_setup(void)
+{
+	series_srv_setup();
+
+	memset(&cli, 0, sizeof(cli));
+	cli.cb = &cli_handlers;
+	zassert_ok(_bt_mesh_sensor_cli_cb.init(&cli_model),
+		   "Client init failed");
+
+	srv_rsp_to_cli = true;
+	srv_pages_max = UINT32_MAX;
+	cli_series_entry_cnt = 0;
+}
+
+static void series_cli_teardown(void)
+{
+	srv_rsp_to_cli = false;
+}
+
+static void series_entries_check(const struct bt_mesh_sensor_series_entry *entries,
+				 uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_equal(entries[i].column.start.val1, i,
+			      "Wrong column #%u", i);
+		zassert_equal(entries[i].value[0].val1, 1, "Wrong value #%u", i);
+	}
+}
+
+static void test_sensor_cli_series_pages(void)
+{
+	static struct bt_mesh_sensor_series_entry entries[SERIES_COLUMN_COUNT];
+	struct bt_mesh_msg_ctx ctx = { .addr = SRV_ADDR };
+	uint32_t count = ARRAY_SIZE(entries);
+	int err;
+
+	err = bt_mesh_sensor_cli_series_entries_get(&cli, &ctx, series_sensor.type,
+						    NULL, entries, &count);
+	zassert_ok(err, "Series get failed (err: %d)", err);
+	zassert_true(srv_rsp_cnt > 1, "Series not paged");
+	zassert_equal(count, SERIES_COLUMN_COUNT, "Wrong column count %u", count);
+	zassert_equal(cli_series_entry_cnt, SERIES_COLUMN_COUNT,
+		      "Wrong callback count %u", cli_series_entry_cnt);
+	series_entries_check(entries, count);
+}
+
+static void test_sensor_cli_series_small_array(void)
+{
+	struct bt_mesh_sensor_series_entry entries[10];
+	struct bt_mesh_msg_ctx ctx = { .addr = SRV_ADDR };
+	uint32_t count = ARRAY_SIZE(entries);
+	int err;
+
+	/* The first page holds more columns than the array. The server stalls
+	 * after it, so no pages are sent after the call returns.
+	 */
+	srv_pages_max = 1;
+
+	err = bt_mesh_sensor_cli_series_entries_get(&cli, &ctx, series_sensor.type,
+						    NULL, entries, &count);
+	zassert_equal(err, -E2BIG, "Wrong error %d", err);
+	zassert_true(count > ARRAY_SIZE(entries), "Wrong column count %u", count);
+	series_entries_check(entries, ARRAY_SIZE(entries));
+}
+
+static void test_sensor_cli_series_timeout(void)
+{
+	static struct bt_mesh_sensor_series_entry entries[SERIES_COLUMN_COUNT];
+	struct bt_mesh_msg_ctx ctx = { .addr = SRV_ADDR };
+	uint32_t count = ARRAY_SIZE(entries);
+	int err;
+
+	/* Only the first page is received. */
+	srv_pages_max = 1;
+
+	err = bt_mesh_sensor_cli_series_entries_get(&cli, &ctx, series_sensor.type,
+						    NULL, entries, &count);
+	zassert_equal(err, -ETIMEDOUT, "Wrong error %d", err);
+	zassert_true(count > 0 && count < SERIES_COLUMN_COUNT,
+		     "Wrong column count %u", count);
+	zassert_equal(cli_series_entry_cnt, count, "Wrong callback count %u",
+		      cli_series_entry_cnt);
+	series_entries_check(entries, count);
+}
+
+static void test_sensor_cli_series_no_rsp(void)
+{
+	static struct bt_mesh_sensor_series_entry entries[SERIES_COLUMN_COUNT];
+	struct bt_mesh_msg_ctx ctx = { .addr = SRV_ADDR };
+	uint32_t count = ARRAY_SIZE(entries);
+	int err;
+
+	srv_pages_max = 0;
+
+	err = bt_mesh_sensor_cli_series_entries_get(&cli, &ctx, series_sensor.type,
+						    NULL, entries, &count);
+	zassert_equal(err, -ETIMEDOUT, "Wrong error %d", err);
+	zassert_equal(count, 0, "Wrong column count %u", count);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(sensor_types_test,
@@ -2549,4 +3137,38 @@ void test_main(void)
 			 );
 
 	ztest_run_test_suite(sensor_types_test);
+
+	ztest_test_suite(sensor_srv_test,
+			 ztest_unit_test_setup_teardown(test_sensor_srv_lookup,
+							sensor_srv_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sensor_srv_dirty_pub,
+							sensor_srv_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sensor_srv_series_pages,
+							series_srv_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sensor_srv_series_busy,
+							series_srv_setup,
+							unit_test_noop)
+			 );
+
+	ztest_run_test_suite(sensor_srv_test);
+
+	ztest_test_suite(sensor_cli_test,
+			 ztest_unit_test_setup_teardown(test_sensor_cli_series_pages,
+							series_cli_setup,
+							series_cli_teardown),
+			 ztest_unit_test_setup_teardown(test_sensor_cli_series_small_array,
+							series_cli_setup,
+							series_cli_teardown),
+			 ztest_unit_test_setup_teardown(test_sensor_cli_series_timeout,
+							series_cli_setup,
+							series_cli_teardown),
+			 ztest_unit_test_setup_teardown(test_sensor_cli_series_no_rsp,
+							series_cli_setup,
+							series_cli_teardown)
+			 );
+
+	ztest_run_test_suite(sensor_cli_test);
 }
@@ -0,0 +1,608 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <bluetooth/scan.h>
+#include <bluetooth/gap.h>
+#include <random/rand32.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "native_rtc.h"
+#endif
+
+#define BENCHMARK_REPORT_CNT 1024
+#define BENCHMARK_ROUNDS 100
+
+static struct bt_le_scan_cb *scan_recv_cb;
+
+static struct {
+	size_t match_cnt;
+	size_t no_match_cnt;
+	struct bt_scan_filter_match status;
+} result;
+
+/* Custom 128-bit UUID, 4c3b0001-7d3e-4f1c-a2a7-7c1e8a3b9f10 */
+static const uint8_t custom_uuid_val[] = {
+	0x10, 0x9f, 0x3b, 0x8a, 0x1e, 0x7c, 0xa7, 0xa2,
+	0x1c, 0x4f, 0x3e, 0x7d, 0x01, 0x00, 0x3b, 0x4c
+};
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_recv_cb = cb;
+}
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	result.match_cnt++;
+	result.status = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	result.no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb, scan_filter_match, scan_filter_no_match, NULL, NULL);
+
+static bt_addr_le_t addr_get(uint32_t i)
+{
+	bt_addr_le_t addr = { .type = BT_ADDR_LE_PUBLIC };
+
+	sys_put_le32(i, addr.a.val);
+	addr.a.val[5] = 0xc0;
+
+	return addr;
+}
+
+static void report_feed_type(const bt_addr_le_t *addr, uint8_t adv_type,
+			     const uint8_t *ad, size_t len)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.rssi = -50,
+		.adv_type = adv_type,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	struct net_buf_simple buf;
+
+	net_buf_simple_init_with_data(&buf, (void *)ad, len);
+	scan_recv_cb->recv(&info, &buf);
+}
+
+static void report_feed(const bt_addr_le_t *addr, const uint8_t *ad, size_t len)
+{
+	report_feed_type(addr, BT_GAP_ADV_TYPE_ADV_IND, ad, len);
+}
+
+static void result_clear(void)
+{
+	memset(&result, 0, sizeof(result));
+}
+
+static void test_setup(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_blocklist_clear();
+	result_clear();
+}
+
+static void test_addr_filter(void)
+{
+	bt_addr_le_t addr;
+	int err;
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_ADDRESS_CNT; i++) {
+		addr = addr_get(i);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+		zassert_equal(err, 0, "Adding address filter failed: %d", err);
+	}
+
+	addr = addr_get(CONFIG_BT_SCAN_ADDRESS_CNT);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_equal(err, -ENOMEM, "Adding address filter did not fail: %d", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	addr = addr_get(17);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Address not matched");
+	zassert_true(result.status.addr.match, "Address filter not matched");
+	zassert_equal(bt_addr_le_cmp(result.status.addr.addr, &addr), 0,
+		      "Wrong address filter matched");
+
+	addr = addr_get(CONFIG_BT_SCAN_ADDRESS_CNT);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Unexpected match");
+	zassert_equal(result.no_match_cnt, 1, "Unknown address not reported");
+
+	/* Lookups after all filters are removed must not find stale entries */
+	bt_scan_filter_remove_all();
+	addr = addr_get(17);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Removed address matched");
+}
+
+static void test_uuid_filter(void)
+{
+	const bt_addr_le_t addr = addr_get(0);
+	const uint8_t ad_all[] = {
+		0x05, BT_DATA_UUID16_ALL, 0x0d, 0x18, 0x0f, 0x18,
+		0x11, BT_DATA_UUID128_ALL,
+		0x10, 0x9f, 0x3b, 0x8a, 0x1e, 0x7c, 0xa7, 0xa2,
+		0x1c, 0x4f, 0x3e, 0x7d, 0x01, 0x00, 0x3b, 0x4c
+	};
+	const uint8_t ad_uuid16[] = {
+		0x05, BT_DATA_UUID16_SOME, 0x0d, 0x18, 0x0f, 0x18
+	};
+	/* Heart Rate Service in 128-bit form, and a trailing byte */
+	const uint8_t ad_uuid128_form[] = {
+		0x12, BT_DATA_UUID128_SOME,
+		0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+		0x00, 0x10, 0x00, 0x00, 0x0d, 0x18, 0x00, 0x00,
+		0xff
+	};
+	struct bt_uuid_128 custom_uuid = { .uuid = { BT_UUID_TYPE_128 } };
+	int err;
+
+	memcpy(custom_uuid.val, custom_uuid_val, sizeof(custom_uuid.val));
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	zassert_equal(err, 0, "Adding UUID filter failed: %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_BAS);
+	zassert_equal(err, 0, "Adding UUID filter failed: %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &custom_uuid);
+	zassert_equal(err, 0, "Adding UUID filter failed: %d", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_UUID_FILTER, true);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	/* All UUIDs must be found, also when they are in different fields */
+	report_feed(&addr, ad_all, sizeof(ad_all));
+	zassert_equal(result.match_cnt, 1, "UUIDs not matched");
+	zassert_equal(result.status.uuid.count, 3, "Wrong number of UUIDs matched");
+
+	report_feed(&addr, ad_uuid16, sizeof(ad_uuid16));
+	zassert_equal(result.match_cnt, 1, "UUIDs matched without the custom UUID");
+	zassert_equal(result.no_match_cnt, 1, "Missing UUID not reported");
+
+	err = bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	report_feed(&addr, ad_uuid16, sizeof(ad_uuid16));
+	zassert_equal(result.match_cnt, 2, "UUIDs not matched");
+	zassert_equal(result.status.uuid.count, 2, "Wrong number of UUIDs matched");
+
+	/* A 16-bit UUID filter matches the UUID in 128-bit form */
+	report_feed(&addr, ad_uuid128_form, sizeof(ad_uuid128_form));
+	zassert_equal(result.match_cnt, 3, "UUID in 128-bit form not matched");
+	zassert_equal(result.status.uuid.count, 1, "Wrong number of UUIDs matched");
+	zassert_equal(bt_uuid_cmp(result.status.uuid.uuid[0], BT_UUID_HRS), 0,
+		      "Wrong UUID matched");
+}
+
+static void test_multi_filter(void)
+{
+	const bt_addr_le_t addr = addr_get(0);
+	uint8_t company_id[] = { 0x59, 0x00 };
+	const struct bt_scan_manufacturer_data manufacturer_data = {
+		.data = company_id,
+		.data_len = sizeof(company_id),
+	};
+	const uint8_t ad_name[] = {
+		0x07, BT_DATA_NAME_COMPLETE, 'S', 'e', 'n', 's', 'o', 'r'
+	};
+	/* The name is present twice, it must only be counted once */
+	const uint8_t ad_name_twice[] = {
+		0x07, BT_DATA_NAME_COMPLETE, 'S', 'e', 'n', 's', 'o', 'r',
+		0x07, BT_DATA_NAME_COMPLETE, 'S', 'e', 'n', 's', 'o', 'r'
+	};
+	const uint8_t ad_both[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR,
+		0x07, BT_DATA_NAME_COMPLETE, 'S', 'e', 'n', 's', 'o', 'r',
+		0x04, BT_DATA_MANUFACTURER_DATA, 0x59, 0x00, 0x01
+	};
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Sensor");
+	zassert_equal(err, 0, "Adding name filter failed: %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &manufacturer_data);
+	zassert_equal(err, 0, "Adding manufacturer data filter failed: %d", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER,
+				    true);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	report_feed(&addr, ad_name, sizeof(ad_name));
+	zassert_equal(result.match_cnt, 0, "Matched without manufacturer data");
+
+	report_feed(&addr, ad_name_twice, sizeof(ad_name_twice));
+	zassert_equal(result.match_cnt, 0, "Matched without manufacturer data");
+
+	report_feed(&addr, ad_both, sizeof(ad_both));
+	zassert_equal(result.match_cnt, 1, "Filters not matched");
+	zassert_true(result.status.name.match, "Name filter not matched");
+	zassert_true(result.status.manufacturer_data.match,
+		     "Manufacturer data filter not matched");
+	zassert_equal(result.no_match_cnt, 2, "Missing filter match not reported");
+}
+
+static void test_blocklist(void)
+{
+	const bt_addr_le_t addr = addr_get(1);
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_equal(err, 0, "Adding address filter failed: %d", err);
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	err = bt_scan_blocklist_device_add(&addr);
+	zassert_equal(err, 0, "Adding device to blocklist failed: %d", err);
+	err = bt_scan_blocklist_device_add(&addr);
+	zassert_equal(err, 0, "Adding duplicate device to blocklist failed: %d", err);
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt + result.no_match_cnt, 0,
+		      "Blocklisted device reported");
+
+	bt_scan_blocklist_clear();
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Device not reported after blocklist clear");
+}
+
+static void test_malformed_data(void)
+{
+	const bt_addr_le_t addr = addr_get(0);
+	/* Field length exceeds the data */
+	const uint8_t ad_truncated[] = {
+		0x09, BT_DATA_NAME_COMPLETE, 'S', 'e', 'n'
+	};
+	/* UUID list with a trailing byte */
+	const uint8_t ad_uuid_trailing[] = {
+		0x04, BT_DATA_UUID16_ALL, 0x0d, 0x18, 0x0f
+	};
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Sen");
+	zassert_equal(err, 0, "Adding name filter failed: %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS);
+	zassert_equal(err, 0, "Adding UUID filter failed: %d", err);
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER, false);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	report_feed(&addr, ad_truncated, sizeof(ad_truncated));
+	zassert_equal(result.match_cnt, 0, "Truncated data matched");
+	zassert_equal(result.no_match_cnt, 1, "Truncated data not reported");
+
+	report_feed(&addr, ad_uuid_trailing, sizeof(ad_uuid_trailing));
+	zassert_equal(result.match_cnt, 1, "UUID not matched");
+}
+
+static void test_dedup(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	const bt_addr_le_t addr = addr_get(0);
+	const bt_addr_le_t other_addr = addr_get(1);
+	const uint8_t ad[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR
+	};
+	const uint8_t ad_changed[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_LIMITED | BT_LE_AD_NO_BREDR
+	};
+	struct bt_scan_dedup_stats stats;
+
+	report_feed(&addr, ad, sizeof(ad));
+	report_feed(&addr, ad, sizeof(ad));
+	zassert_equal(result.no_match_cnt, 1, "Repeated advertisement reported");
+
+	report_feed(&addr, ad_changed, sizeof(ad_changed));
+	report_feed(&other_addr, ad, sizeof(ad));
+	zassert_equal(result.no_match_cnt, 3, "New advertisement not reported");
+
+	/* Both advertisements of a device, like advertising and scan response
+	 * data, are cached
+	 */
+	report_feed(&addr, ad, sizeof(ad));
+	report_feed(&addr, ad_changed, sizeof(ad_changed));
+	zassert_equal(result.no_match_cnt, 3, "Repeated advertisement reported");
+
+	k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_TTL_MS));
+
+	report_feed(&addr, ad, sizeof(ad));
+	zassert_equal(result.no_match_cnt, 4, "Expired advertisement not reported");
+
+	bt_scan_dedup_stats_get(&stats);
+	zassert_equal(stats.hits, 3, "Wrong hit count: %u", stats.hits);
+	zassert_equal(stats.misses, 4, "Wrong miss count: %u", stats.misses);
+	zassert_equal(stats.evictions, 0, "Wrong eviction count: %u", stats.evictions);
+
+	bt_scan_dedup_clear();
+
+	bt_scan_dedup_stats_get(&stats);
+	zassert_equal(stats.hits + stats.misses, 0, "Statistics not cleared");
+
+	report_feed(&addr, ad_changed, sizeof(ad_changed));
+	zassert_equal(result.no_match_cnt, 5, "Advertisement not reported after clear");
+#else
+	ztest_test_skip();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
+static void test_dedup_adv_type(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	const bt_addr_le_t addr = addr_get(0);
+	const uint8_t ad[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR
+	};
+
+	/* A scan response with the same data as the advertisement */
+	report_feed_type(&addr, BT_GAP_ADV_TYPE_ADV_IND, ad, sizeof(ad));
+	report_feed_type(&addr, BT_GAP_ADV_TYPE_SCAN_RSP, ad, sizeof(ad));
+	zassert_equal(result.no_match_cnt, 2, "Scan response not reported");
+
+	report_feed_type(&addr, BT_GAP_ADV_TYPE_ADV_IND, ad, sizeof(ad));
+	report_feed_type(&addr, BT_GAP_ADV_TYPE_SCAN_RSP, ad, sizeof(ad));
+	zassert_equal(result.no_match_cnt, 2, "Repeated advertisement reported");
+#else
+	ztest_test_skip();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
+static void test_dedup_filter_change(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	const bt_addr_le_t addr = addr_get(0);
+	const bt_addr_le_t blocked_addr = addr_get(1);
+	int err;
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.no_match_cnt, 1, "Advertisement not reported");
+
+	/* Blocking a device and setting the same filter mode again do not
+	 * change which advertisements are matched.
+	 */
+	err = bt_scan_blocklist_device_add(&blocked_addr);
+	zassert_equal(err, 0, "Blocklist add failed: %d", err);
+	bt_scan_filter_disable();
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.no_match_cnt, 1, "Cache cleared without filter change");
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_equal(err, 0, "Filter add failed: %d", err);
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_equal(err, 0, "Filter enable failed: %d", err);
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Advertisement not matched with new filter");
+
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_equal(err, 0, "Filter enable failed: %d", err);
+
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.match_cnt, 1, "Cache cleared without filter change");
+#else
+	ztest_test_skip();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
+static void test_dedup_eviction(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	bt_addr_le_t addr;
+	struct bt_scan_dedup_stats stats;
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_DEDUP_CACHE_SIZE; i++) {
+		addr = addr_get(i);
+		report_feed(&addr, NULL, 0);
+	}
+
+	/* The first device is now the most recently received one */
+	addr = addr_get(0);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE,
+		      "Repeated advertisement reported");
+
+	/* Replaces the second device */
+	addr = addr_get(CONFIG_BT_SCAN_DEDUP_CACHE_SIZE);
+	report_feed(&addr, NULL, 0);
+
+	addr = addr_get(0);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 1,
+		      "Recently received advertisement evicted");
+
+	addr = addr_get(1);
+	report_feed(&addr, NULL, 0);
+	zassert_equal(result.no_match_cnt, CONFIG_BT_SCAN_DEDUP_CACHE_SIZE + 2,
+		      "Evicted advertisement not reported");
+
+	bt_scan_dedup_stats_get(&stats);
+	zassert_equal(stats.evictions, 2, "Wrong eviction count: %u", stats.evictions);
+#else
+	ztest_test_skip();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+}
+
+static uint64_t time_us_get(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	/* Simulated time does not advance while the test runs */
+	return native_rtc_gettime_us(RTC_CLOCK_REALTIME);
+#else
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
+static struct {
+	bt_addr_le_t addr;
+	uint8_t ad[31];
+	uint8_t len;
+} reports[BENCHMARK_REPORT_CNT];
+
+/* Reports as seen by a gateway in a dense environment: flags, UUID list, name and manufacturer
+ * data. One in eight reports is from a device with an address filter.
+ */
+static void benchmark_reports_generate(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		uint8_t *p = reports[i].ad;
+		uint16_t uuid = 0x1800 + (sys_rand32_get() % 64);
+
+		reports[i].addr = ((i % 8) == 0) ?
+			addr_get(i % CONFIG_BT_SCAN_ADDRESS_CNT) : addr_get(0x10000 + i);
+
+		*p++ = 0x02;
+		*p++ = BT_DATA_FLAGS;
+		*p++ = BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR;
+
+		*p++ = 0x07;
+		*p++ = BT_DATA_UUID16_ALL;
+		for (size_t j = 0; j < 3; j++) {
+			sys_put_le16(uuid + j, p);
+			p += sizeof(uint16_t);
+		}
+
+		*p++ = 0x09;
+		*p++ = BT_DATA_NAME_COMPLETE;
+		memcpy(p, "Device00", 8);
+		p[6] = '0' + (i / 10) % 10;
+		p[7] = '0' + i % 10;
+		p += 8;
+
+		*p++ = 0x07;
+		*p++ = BT_DATA_MANUFACTURER_DATA;
+		sys_put_le16(0x0100 + i % 4, p);
+		sys_put_le32(sys_rand32_get(), p + 2);
+		p += 6;
+
+		reports[i].len = p - reports[i].ad;
+	}
+}
+
+static void test_benchmark(void)
+{
+	uint8_t company_id[] = { 0x59, 0x00 };
+	const struct bt_scan_manufacturer_data manufacturer_data = {
+		.data = company_id,
+		.data_len = sizeof(company_id),
+	};
+	uint64_t start;
+	uint64_t duration;
+	size_t report_cnt = 0;
+	size_t processed_cnt;
+	int err;
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_ADDRESS_CNT; i++) {
+		bt_addr_le_t addr = addr_get(i);
+
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+		zassert_equal(err, 0, "Adding address filter failed: %d", err);
+	}
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_UUID_CNT; i++) {
+		struct bt_uuid_16 uuid = BT_UUID_INIT_16(0x1840 + i);
+
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid);
+		zassert_equal(err, 0, "Adding UUID filter failed: %d", err);
+	}
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_BLOCKLIST_LEN; i++) {
+		bt_addr_le_t addr = addr_get(0x20000 + i);
+
+		err = bt_scan_blocklist_device_add(&addr);
+		zassert_equal(err, 0, "Adding device to blocklist failed: %d", err);
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Sensor");
+	zassert_equal(err, 0, "Adding name filter failed: %d", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &manufacturer_data);
+	zassert_equal(err, 0, "Adding manufacturer data filter failed: %d", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER | BT_SCAN_UUID_FILTER |
+				    BT_SCAN_NAME_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER,
+				    false);
+	zassert_equal(err, 0, "Enabling filters failed: %d", err);
+
+	benchmark_reports_generate();
+
+	start = time_us_get();
+
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+			report_feed(&reports[i].addr, reports[i].ad, reports[i].len);
+			report_cnt++;
+		}
+	}
+
+	duration = MAX(time_us_get() - start, 1);
+
+	processed_cnt = report_cnt;
+
+#if CONFIG_BT_SCAN_DEDUP
+	struct bt_scan_dedup_stats stats;
+
+	/* Only the first round is passed to the filters */
+	bt_scan_dedup_stats_get(&stats);
+	zassert_equal(stats.hits + stats.misses, report_cnt, "Not all reports were cached");
+	processed_cnt = stats.misses;
+
+	TC_PRINT("Deduplication: %u hits, %u misses, %u evictions\n",
+		 stats.hits, stats.misses, stats.evictions);
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
+	zassert_equal(result.match_cnt + result.no_match_cnt, processed_cnt,
+		      "Not all reports were processed");
+	zassert_true(result.match_cnt >= processed_cnt / 8, "Too few reports matched");
+
+	TC_PRINT("%u reports with %d address, %d UUID and %d blocklist entries:\n",
+		 (unsigned int)report_cnt, CONFIG_BT_SCAN_ADDRESS_CNT, CONFIG_BT_SCAN_UUID_CNT,
+		 CONFIG_BT_SCAN_BLOCKLIST_LEN);
+	TC_PRINT("\t%u matched, %u ns per report, %u reports per second\n",
+		 (unsigned int)result.match_cnt, (unsigned int)(duration * 1000 / report_cnt),
+		 (unsigned int)(report_cnt * 1000000ULL / duration));
+}
+
+void test_main(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb);
+
+	zassert_not_null(scan_recv_cb, "Scan callback not registered");
+
+	ztest_test_suite(bt_scan_test,
+			 ztest_unit_test_setup_teardown(test_addr_filter, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_uuid_filter, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_multi_filter, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_blocklist, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_malformed_data, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_adv_type, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_filter_change, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_dedup_eviction, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_benchmark, test_setup,
+							unit_test_noop));
+
+	ztest_run_test_suite(bt_scan_test);
+}
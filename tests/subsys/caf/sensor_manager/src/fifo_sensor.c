@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/sensor.h>
+
+#include "fifo_sensor.h"
+
+#define DT_DRV_COMPAT vnd_fifo_sensor
+
+/* Emulated sensor, which stores a sample in its FIFO every FIFO_SENSOR_PERIOD_MS. The trigger
+ * is raised from the system workqueue, like in drivers using a global thread.
+ */
+static struct {
+	uint32_t fifo[FIFO_SENSOR_DEPTH];
+	size_t head;
+	size_t count;
+	uint32_t seq;
+	uint32_t sample;
+	/* Number of samples read since the trigger was raised, or -1 if it is not raised. */
+	int drained;
+	uint32_t overrun_cnt;
+	uint32_t trigger_cnt;
+	sensor_trigger_handler_t handler;
+	struct sensor_trigger trigger;
+	struct k_spinlock lock;
+} fifo_sensor = {
+	.drained = -1,
+};
+
+static void trigger_work_fn(struct k_work *work)
+{
+	sensor_trigger_handler_t handler = fifo_sensor.handler;
+
+	if (handler) {
+		handler(DEVICE_DT_INST_GET(0), &fifo_sensor.trigger);
+	}
+}
+
+static K_WORK_DEFINE(trigger_work, trigger_work_fn);
+
+/* Must be called with the lock taken. */
+static void trigger_raise(void)
+{
+	if ((fifo_sensor.drained < 0) && (fifo_sensor.count >= FIFO_SENSOR_WATERMARK)) {
+		fifo_sensor.drained = 0;
+		fifo_sensor.trigger_cnt++;
+		k_work_submit(&trigger_work);
+	}
+}
+
+static void sample_timer_fn(struct k_timer *timer)
+{
+	k_spinlock_key_t key = k_spin_lock(&fifo_sensor.lock);
+
+	if (fifo_sensor.count == FIFO_SENSOR_DEPTH) {
+		fifo_sensor.overrun_cnt++;
+	} else {
+		size_t idx = (fifo_sensor.head + fifo_sensor.count) % FIFO_SENSOR_DEPTH;
+
+		fifo_sensor.fifo[idx] = fifo_sensor.seq;
+		fifo_sensor.count++;
+	}
+	fifo_sensor.seq++;
+
+	if (fifo_sensor.handler) {
+		trigger_raise();
+	}
+
+	k_spin_unlock(&fifo_sensor.lock, key);
+}
+
+static K_TIMER_DEFINE(sample_timer, sample_timer_fn, NULL);
+
+static int fifo_sensor_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+	k_spinlock_key_t key = k_spin_lock(&fifo_sensor.lock);
+	int err = 0;
+
+	if (fifo_sensor.count == 0) {
+		err = -ENODATA;
+	} else {
+		fifo_sensor.sample = fifo_sensor.fifo[fifo_sensor.head];
+		fifo_sensor.head = (fifo_sensor.head + 1) % FIFO_SENSOR_DEPTH;
+		fifo_sensor.count--;
+
+		/* Trigger is level sensitive, it is raised again if the FIFO is still above
+		 * the watermark after the batch is read.
+		 */
+		if ((fifo_sensor.drained >= 0) &&
+		    (++fifo_sensor.drained == FIFO_SENSOR_WATERMARK)) {
+			fifo_sensor.drained = -1;
+			trigger_raise();
+		}
+	}
+
+	k_spin_unlock(&fifo_sensor.lock, key);
+
+	return err;
+}
+
+static int fifo_sensor_channel_get(const struct device *dev, enum sensor_channel chan,
+				   struct sensor_value *val)
+{
+	if (chan != SENSOR_CHAN_ACCEL_X) {
+		return -ENOTSUP;
+	}
+
+	val->val1 = fifo_sensor.sample;
+	val->val2 = 0;
+
+	return 0;
+}
+
+static int fifo_sensor_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+				   sensor_trigger_handler_t handler)
+{
+	if (trig->type != FIFO_SENSOR_TRIG_WATERMARK) {
+		return -ENOTSUP;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&fifo_sensor.lock);
+
+	fifo_sensor.trigger = *trig;
+	fifo_sensor.handler = handler;
+	fifo_sensor.drained = -1;
+	if (handler) {
+		trigger_raise();
+	}
+
+	k_spin_unlock(&fifo_sensor.lock, key);
+
+	return 0;
+}
+
+static const struct sensor_driver_api fifo_sensor_api = {
+	.sample_fetch = fifo_sensor_sample_fetch,
+	.channel_get = fifo_sensor_channel_get,
+	.trigger_set = fifo_sensor_trigger_set,
+};
+
+static int fifo_sensor_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DT_INST_DEFINE(0, fifo_sensor_init, NULL, NULL, NULL, POST_KERNEL,
+		      CONFIG_SENSOR_INIT_PRIORITY, &fifo_sensor_api);
+
+void fifo_sensor_start(void)
+{
+	k_timer_start(&sample_timer, K_MSEC(FIFO_SENSOR_PERIOD_MS), K_MSEC(FIFO_SENSOR_PERIOD_MS));
+}
+
+void fifo_sensor_stop(void)
+{
+	k_timer_stop(&sample_timer);
+}
+
+uint32_t fifo_sensor_overrun_cnt(void)
+{
+	return fifo_sensor.overrun_cnt;
+}
+
+uint32_t fifo_sensor_trigger_cnt(void)
+{
+	return fifo_sensor.trigger_cnt;
+}
+
+uint32_t fifo_sensor_sample_cnt(void)
+{
+	return fifo_sensor.seq;
+}
+
+uint32_t fifo_sensor_level(void)
+{
+	return fifo_sensor.count;
+}
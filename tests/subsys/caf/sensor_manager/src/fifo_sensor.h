@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _FIFO_SENSOR_H_
+#define _FIFO_SENSOR_H_
+
+#include <drivers/sensor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output data rate of the emulated sensor */
+#define FIFO_SENSOR_PERIOD_MS 1
+#define FIFO_SENSOR_DEPTH 32
+#define FIFO_SENSOR_WATERMARK 25
+
+#define FIFO_SENSOR_TRIG_WATERMARK SENSOR_TRIG_PRIV_START
+
+/* Emulated sensor returns a sequence number of the sample on SENSOR_CHAN_ACCEL_X. */
+void fifo_sensor_start(void);
+void fifo_sensor_stop(void);
+uint32_t fifo_sensor_overrun_cnt(void);
+uint32_t fifo_sensor_trigger_cnt(void);
+uint32_t fifo_sensor_sample_cnt(void);
+uint32_t fifo_sensor_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FIFO_SENSOR_H_ */
@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <app_event_manager.h>
+#include <caf/events/sensor_event.h>
+#include <caf/events/sensor_data_aggregator_event.h>
+#include <caf/sensor_data_aggregator.h>
+
+#define MODULE main
+#include <caf/events/module_state_event.h>
+
+#include "fifo_sensor.h"
+
+#define TEST_DURATION_MS 2000
+#define SAMPLE_PERIOD_US (FIFO_SENSOR_PERIOD_MS * USEC_PER_MSEC)
+
+/* Number of float samples in a buffer of the fifo_sensor aggregator of the test overlay. */
+#define FIFO_AGG_BUF_SAMPLES (120 / sizeof(float))
+
+/* Aggregator of the test overlay that is not used by the sensor manager. */
+#define TEST_AGG_DESCR "test_agg"
+#define TEST_AGG_BUF_COUNT 2
+#define TEST_AGG_BUF_SAMPLES 4
+
+/* Samples written while the buffers of the test aggregator are sent. */
+#define RACE_SAMPLE_CNT 2000
+#define RACE_WRITE_TIME_US 100
+#define RACE_STATE_CHANGE_PERIOD_MS 3
+#define RACE_THREAD_STACK_SIZE 1024
+#define RACE_THREAD_PRIORITY 5
+
+#define AGG_FORMAT_SENSOR_VALUE \
+	IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT_FORMAT_SENSOR_VALUE)
+
+static struct {
+	uint32_t sample_cnt;
+	uint32_t next_seq;
+	int64_t last_timestamp;
+	uint8_t last_agg_sample_cnt;
+	uint32_t seq_error_cnt;
+	uint32_t timestamp_error_cnt;
+	uint32_t sensor_event_cnt;
+	uint32_t agg_event_cnt;
+} rx;
+
+/* Buffers of the test aggregator. */
+static struct {
+	/* Buffers are released when received, otherwise by test_agg_release(). */
+	bool auto_release;
+	uint32_t event_cnt;
+	const char *descr;
+	uint8_t *bufs[TEST_AGG_BUF_COUNT];
+	size_t buf_cnt;
+	uint32_t last[TEST_AGG_BUF_SAMPLES];
+	uint8_t last_cnt;
+	int64_t last_timestamp;
+	uint32_t sample_cnt;
+	uint32_t next;
+	uint32_t order_error_cnt;
+} agg;
+
+/* Events allocated by the application event manager. */
+static atomic_t alloc_cnt;
+static atomic_t alloc_size;
+
+static K_THREAD_STACK_DEFINE(race_stack, RACE_THREAD_STACK_SIZE);
+static struct k_thread race_thread;
+static atomic_t race_state_change_cnt;
+
+void *app_event_manager_alloc(size_t size)
+{
+	void *event = k_malloc(size);
+
+	__ASSERT_NO_MSG(event);
+
+	atomic_inc(&alloc_cnt);
+	atomic_add(&alloc_size, size);
+
+	return event;
+}
+
+static void fifo_sample_check(uint32_t seq)
+{
+	if (seq != rx.next_seq) {
+		rx.seq_error_cnt++;
+	}
+	rx.next_seq = seq + 1;
+	rx.sample_cnt++;
+}
+
+static void agg_buf_release(const char *descr, uint8_t *buf)
+{
+	struct sensor_data_aggregator_release_buffer_event *event =
+		new_sensor_data_aggregator_release_buffer_event();
+
+	event->sensor_descr = descr;
+	event->buf = buf;
+	APP_EVENT_SUBMIT(event);
+}
+
+static void test_agg_release(void)
+{
+	for (size_t i = 0; i < agg.buf_cnt; i++) {
+		agg_buf_release(agg.descr, agg.bufs[i]);
+	}
+	agg.buf_cnt = 0;
+
+	/* Wait until the events are processed. */
+	k_sleep(K_MSEC(10));
+}
+
+static void test_agg_state_change(void)
+{
+	struct sensor_state_event *event = new_sensor_state_event();
+
+	event->descr = TEST_AGG_DESCR;
+	event->state = SENSOR_STATE_ACTIVE;
+	APP_EVENT_SUBMIT(event);
+}
+
+static void test_agg_write(uint32_t value)
+{
+	uint32_t *data;
+	int err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(value),
+							(void **)&data);
+
+	zassert_ok(err, "Reserving sample failed: %d", err);
+
+	*data = value;
+	/* The value is used as timestamp of the sample. */
+	sensor_data_aggregator_sample_commit(TEST_AGG_DESCR, value);
+}
+
+static void test_fifo_no_drops(void)
+{
+	/* Sensor manager starts sampling when main module is ready. */
+	module_set_state(MODULE_STATE_READY);
+	k_sleep(K_MSEC(10));
+
+#if CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t start_stats;
+	k_thread_runtime_stats_t stats;
+
+	k_thread_runtime_stats_all_get(&start_stats);
+#endif
+	atomic_set(&alloc_cnt, 0);
+	atomic_set(&alloc_size, 0);
+
+	fifo_sensor_start();
+	k_sleep(K_MSEC(TEST_DURATION_MS));
+	fifo_sensor_stop();
+
+	/* Wait until the last batch is processed. */
+	k_sleep(K_MSEC(100));
+
+	uint32_t trigger_cnt = fifo_sensor_trigger_cnt();
+	/* Samples left in the FIFO are fewer than the watermark and are not read. */
+	uint32_t sample_cnt = fifo_sensor_sample_cnt() - fifo_sensor_overrun_cnt() -
+			      fifo_sensor_level();
+
+	TC_PRINT("%u samples read in %u batches\n", rx.sample_cnt, trigger_cnt);
+	TC_PRINT("\t%u events allocated, %u bytes\n", (uint32_t)atomic_get(&alloc_cnt),
+		 (uint32_t)atomic_get(&alloc_size));
+#if CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_all_get(&stats);
+	TC_PRINT("\t%u CPU cycles\n",
+		 (uint32_t)(stats.execution_cycles - start_stats.execution_cycles));
+#endif
+
+	zassert_equal(fifo_sensor_overrun_cnt(), 0, "Sensor FIFO overrun");
+	zassert_equal(rx.seq_error_cnt, 0, "Samples dropped");
+	zassert_equal(rx.timestamp_error_cnt, 0, "Invalid sample timestamps");
+
+	if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR)) {
+		/* The samples of the last buffer that is not full are not received. */
+		zassert_true(rx.sample_cnt <= sample_cnt, "Too many samples");
+		zassert_true(rx.sample_cnt + FIFO_AGG_BUF_SAMPLES >= sample_cnt,
+			     "Samples not aggregated");
+	} else {
+		zassert_equal(rx.sample_cnt, sample_cnt, "FIFO not emptied");
+	}
+	zassert_true(fifo_sensor_level() < FIFO_SENSOR_WATERMARK, "FIFO not read");
+	zassert_true(sample_cnt >= trigger_cnt * FIFO_SENSOR_WATERMARK,
+		     "Samples not read in batches");
+	zassert_true(rx.sample_cnt + (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR) ?
+				      FIFO_AGG_BUF_SAMPLES : 0) >=
+		     TEST_DURATION_MS / FIFO_SENSOR_PERIOD_MS - FIFO_SENSOR_DEPTH,
+		     "Too few samples read");
+
+	if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		/* Events are only allocated for the aggregator buffers. */
+		zassert_equal(rx.sensor_event_cnt, 0, "Sensor events submitted");
+		zassert_true(atomic_get(&alloc_cnt) < rx.sample_cnt / 4,
+			     "Events allocated for samples");
+	} else {
+		zassert_true(rx.sensor_event_cnt >= rx.sample_cnt, "No sensor events submitted");
+		zassert_true(atomic_get(&alloc_cnt) >= rx.sample_cnt,
+			     "Events not allocated for samples");
+	}
+}
+
+static void test_direct_reserve_commit(void)
+{
+	uint32_t *data;
+	uint32_t *data2;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	agg.event_cnt = 0;
+
+	err = sensor_data_aggregator_sample_reserve("no_agg", sizeof(*data), (void **)&data);
+	zassert_equal(err, -ENOENT, "Sample reserved without aggregator");
+
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, 2 * sizeof(*data),
+						    (void **)&data);
+	zassert_equal(err, -EBADMSG, "Sample of wrong size reserved");
+
+	/* A sample that is not committed is not added. */
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data),
+						    (void **)&data);
+	zassert_ok(err, "Reserving sample failed: %d", err);
+	*data = UINT32_MAX;
+
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data2),
+						    (void **)&data2);
+	zassert_ok(err, "Reserving sample failed: %d", err);
+	zassert_equal_ptr(data, data2, "Sample not reserved again");
+
+	/* A full buffer is sent. */
+	for (uint32_t i = 0; i < TEST_AGG_BUF_SAMPLES; i++) {
+		test_agg_write(i);
+	}
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(agg.event_cnt, 1, "Buffer not sent");
+	zassert_equal(agg.last_cnt, TEST_AGG_BUF_SAMPLES, "Wrong sample count");
+	for (uint32_t i = 0; i < TEST_AGG_BUF_SAMPLES; i++) {
+		zassert_equal(agg.last[i], i, "Wrong sample %u", i);
+	}
+	zassert_equal(agg.last_timestamp, 0, "Wrong timestamp");
+
+	for (uint32_t i = 0; i < TEST_AGG_BUF_SAMPLES; i++) {
+		test_agg_write(TEST_AGG_BUF_SAMPLES + i);
+	}
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(agg.event_cnt, 2, "Buffer not sent");
+	zassert_equal(agg.last[0], TEST_AGG_BUF_SAMPLES, "Wrong sample");
+	zassert_equal(agg.last_timestamp, TEST_AGG_BUF_SAMPLES, "Wrong timestamp");
+
+	/* All buffers are busy until they are released. */
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data),
+						    (void **)&data);
+	zassert_equal(err, -ENOMEM, "Sample reserved in busy buffer");
+
+	test_agg_release();
+
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data),
+						    (void **)&data);
+	zassert_ok(err, "Reserving sample failed: %d", err);
+}
+
+static void test_direct_state_change(void)
+{
+	uint32_t *data;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	agg.event_cnt = 0;
+
+	test_agg_write(100);
+
+	/* The buffer is sent while a sample is written. */
+	err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data),
+						    (void **)&data);
+	zassert_ok(err, "Reserving sample failed: %d", err);
+	*data = 101;
+
+	test_agg_state_change();
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(agg.event_cnt, 1, "Buffer not sent");
+	zassert_equal(agg.last_cnt, 1, "Wrong sample count");
+	zassert_equal(agg.last[0], 100, "Wrong sample");
+
+	/* The sample is dropped, it is neither in the sent buffer nor in the next one. */
+	sensor_data_aggregator_sample_commit(TEST_AGG_DESCR, 101);
+
+	for (uint32_t i = 0; i < TEST_AGG_BUF_SAMPLES; i++) {
+		test_agg_write(102 + i);
+	}
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(agg.event_cnt, 2, "Buffer not sent");
+	zassert_equal(agg.last_cnt, TEST_AGG_BUF_SAMPLES, "Wrong sample count");
+	for (uint32_t i = 0; i < TEST_AGG_BUF_SAMPLES; i++) {
+		zassert_equal(agg.last[i], 102 + i, "Wrong sample %u", i);
+	}
+
+	test_agg_release();
+}
+
+static void race_timer_fn(struct k_timer *timer)
+{
+	test_agg_state_change();
+	atomic_inc(&race_state_change_cnt);
+}
+
+static K_TIMER_DEFINE(race_timer, race_timer_fn, NULL);
+
+/* Samples are written while buffers are sent by state changes from the timer interrupt. */
+static void race_thread_fn(void *p1, void *p2, void *p3)
+{
+	for (uint32_t i = 0; i < RACE_SAMPLE_CNT; i++) {
+		uint32_t *data;
+		int err;
+
+		while ((err = sensor_data_aggregator_sample_reserve(TEST_AGG_DESCR, sizeof(*data),
+								    (void **)&data)) == -ENOMEM) {
+			k_sleep(K_USEC(RACE_WRITE_TIME_US));
+		}
+
+		if (err) {
+			agg.order_error_cnt++;
+			return;
+		}
+
+		*data = i;
+		k_busy_wait(RACE_WRITE_TIME_US);
+		sensor_data_aggregator_sample_commit(TEST_AGG_DESCR, i);
+	}
+}
+
+static void test_direct_race(void)
+{
+	if (!IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	agg.event_cnt = 0;
+	agg.auto_release = true;
+
+	k_timer_start(&race_timer, K_MSEC(RACE_STATE_CHANGE_PERIOD_MS),
+		      K_MSEC(RACE_STATE_CHANGE_PERIOD_MS));
+	k_thread_create(&race_thread, race_stack, RACE_THREAD_STACK_SIZE, race_thread_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(RACE_THREAD_PRIORITY), 0, K_NO_WAIT);
+	k_thread_join(&race_thread, K_FOREVER);
+	k_timer_stop(&race_timer);
+
+	/* Send the last samples. */
+	test_agg_state_change();
+	k_sleep(K_MSEC(10));
+
+	TC_PRINT("%u of %u samples received, %u buffers sent on %u state changes\n",
+		 agg.sample_cnt, RACE_SAMPLE_CNT, agg.event_cnt,
+		 (uint32_t)atomic_get(&race_state_change_cnt));
+
+	/* Samples are received at most once, in order and unchanged. A sample is only dropped
+	 * if its buffer was sent while it was written.
+	 */
+	zassert_equal(agg.order_error_cnt, 0, "Samples out of order or modified");
+	zassert_true(agg.sample_cnt > 0, "No samples received");
+	zassert_true(RACE_SAMPLE_CNT - agg.sample_cnt <= atomic_get(&race_state_change_cnt),
+		     "Samples dropped without state change");
+
+	agg.auto_release = false;
+}
+
+void test_main(void)
+{
+	int err = app_event_manager_init();
+
+	zassert_ok(err, "Event manager initialization failed");
+
+	ztest_test_suite(caf_sensor_manager_tests,
+			 ztest_unit_test(test_fifo_no_drops),
+			 ztest_unit_test(test_direct_reserve_commit),
+			 ztest_unit_test(test_direct_state_change),
+			 ztest_unit_test(test_direct_race)
+			 );
+
+	ztest_run_test_suite(caf_sensor_manager_tests);
+}
+
+#if CONFIG_CAF_SENSOR_DATA_AGGREGATOR
+static uint32_t fifo_agg_sample_get(const uint8_t *buf, size_t idx)
+{
+	/* Samples of sensor events are copied as floats. */
+	if (AGG_FORMAT_SENSOR_VALUE) {
+		return ((const struct sensor_value *)buf)[idx].val1;
+	}
+
+	return ((const float *)buf)[idx];
+}
+
+static void test_agg_event_handle(const struct sensor_data_aggregator_event *event)
+{
+	agg.event_cnt++;
+	agg.descr = event->sensor_descr;
+
+	if (agg.auto_release) {
+		const uint32_t *samples = (const uint32_t *)event->buf;
+
+		for (size_t i = 0; i < event->sample_cnt; i++) {
+			if ((samples[i] < agg.next) || (samples[i] >= RACE_SAMPLE_CNT)) {
+				agg.order_error_cnt++;
+			}
+			agg.next = samples[i] + 1;
+		}
+		agg.sample_cnt += event->sample_cnt;
+
+		agg_buf_release(event->sensor_descr, event->buf);
+		return;
+	}
+
+	__ASSERT_NO_MSG(agg.buf_cnt < ARRAY_SIZE(agg.bufs));
+	__ASSERT_NO_MSG(event->sample_cnt <= ARRAY_SIZE(agg.last));
+
+	agg.bufs[agg.buf_cnt++] = event->buf;
+	memcpy(agg.last, event->buf, event->sample_cnt * sizeof(agg.last[0]));
+	agg.last_cnt = event->sample_cnt;
+	agg.last_timestamp = event->timestamp;
+}
+
+#endif /* CONFIG_CAF_SENSOR_DATA_AGGREGATOR */
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_sensor_event(aeh)) {
+		const struct sensor_event *event = cast_sensor_event(aeh);
+
+		rx.sensor_event_cnt++;
+
+		/* Samples are checked in the aggregator buffers. */
+		if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR)) {
+			return false;
+		}
+
+		/* Timestamps are reconstructed from the times of the FIFO triggers. */
+		if (rx.sample_cnt > 0) {
+			int64_t diff = event->timestamp - rx.last_timestamp;
+
+			if ((diff <= 0) || (diff > 2 * SAMPLE_PERIOD_US)) {
+				rx.timestamp_error_cnt++;
+			}
+		}
+		rx.last_timestamp = event->timestamp;
+		fifo_sample_check(sensor_event_get_data_ptr(event)[0]);
+
+		return false;
+	}
+
+#if CONFIG_CAF_SENSOR_DATA_AGGREGATOR
+	if (is_sensor_data_aggregator_event(aeh)) {
+		const struct sensor_data_aggregator_event *event =
+			cast_sensor_data_aggregator_event(aeh);
+
+		if (!strcmp(event->sensor_descr, TEST_AGG_DESCR)) {
+			test_agg_event_handle(event);
+			return false;
+		}
+
+		/* Timestamp of the first sample is set also if samples are written directly. */
+		if (event->sample_cnt > 0) {
+			if (rx.last_agg_sample_cnt > 0) {
+				int64_t diff = event->timestamp - rx.last_timestamp;
+
+				if ((diff <= 0) ||
+				    (diff > 2 * rx.last_agg_sample_cnt * SAMPLE_PERIOD_US)) {
+					rx.timestamp_error_cnt++;
+				}
+			}
+			rx.last_timestamp = event->timestamp;
+			rx.last_agg_sample_cnt = event->sample_cnt;
+		}
+
+		rx.agg_event_cnt++;
+
+		for (size_t i = 0; i < event->sample_cnt; i++) {
+			fifo_sample_check(fifo_agg_sample_get(event->buf, i));
+		}
+
+		agg_buf_release(event->sensor_descr, event->buf);
+
+		return false;
+	}
+#endif /* CONFIG_CAF_SENSOR_DATA_AGGREGATOR */
+
+	/* If event is unhandled, unsubscribe. */
+	__ASSERT_NO_MSG(false);
+
+	return false;
+}
+
+APP_EVENT_LISTENER(test, app_event_handler);
+APP_EVENT_SUBSCRIBE(test, sensor_event);
+#if CONFIG_CAF_SENSOR_DATA_AGGREGATOR
+APP_EVENT_SUBSCRIBE(test, sensor_data_aggregator_event);
+#endif /* CONFIG_CAF_SENSOR_DATA_AGGREGATOR */
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <caf/sensor_manager.h>
+
+#include "fifo_sensor.h"
+
+/* This configuration file is included only once from sensor_manager module and holds
+ * information about the sampled sensors.
+ */
+
+/* This structure enforces the header file is included only once in the build.
+ * Violating this requirement triggers a multiple definition error at link time.
+ */
+const struct {} sensor_manager_def_include_once;
+
+static const struct sm_sampled_channel fifo_sensor_chan[] = {
+	{
+		.chan = SENSOR_CHAN_ACCEL_X,
+		.data_cnt = 1,
+	},
+};
+
+static const struct sm_fifo fifo_sensor_fifo = {
+	.trigger = {
+		.type = FIFO_SENSOR_TRIG_WATERMARK,
+		.chan = SENSOR_CHAN_ALL,
+	},
+	.watermark = FIFO_SENSOR_WATERMARK,
+};
+
+static const struct sm_sensor_config sensor_configs[] = {
+	{
+		.dev = DEVICE_DT_GET(DT_NODELABEL(fifo_sensor)),
+		.event_descr = "fifo_sensor",
+		.chans = fifo_sensor_chan,
+		.chan_cnt = ARRAY_SIZE(fifo_sensor_chan),
+		.sampling_period_ms = FIFO_SENSOR_PERIOD_MS,
+		.active_events_limit = 2 * FIFO_SENSOR_WATERMARK,
+		.fifo = &fifo_sensor_fifo,
+	},
+};
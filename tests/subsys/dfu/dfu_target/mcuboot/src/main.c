@@ -20,6 +20,9 @@ static int done_retval;
 static int init_retval;
 static bool identify_retval;
 static int schedule_retval;
+static bool done_param_successful;
+static int done_call_count;
+static int reset_call_count;
 
 bool dfu_target_mcuboot_identify(const void *const buf)
 {
@@ -46,6 +49,8 @@ int dfu_target_mcuboot_write(const void *const buf, size_t len)
 
 int dfu_target_mcuboot_done(bool successful)
 {
+	done_param_successful = successful;
+	done_call_count++;
 	return done_retval;
 }
 
@@ -54,6 +59,12 @@ int dfu_target_mcuboot_schedule_update(int img_num)
 	return schedule_retval;
 }
 
+int dfu_target_mcuboot_reset(void)
+{
+	reset_call_count++;
+	return 0;
+}
+
 void test_setup(void)
 {
 	init_retval = 0;
@@ -218,12 +229,142 @@ static void test_write(void)
 	zassert_true(err < 0, "Did not get error when writing uninitialized");
 }
 
+static void test_discard(void)
+{
+	int err;
+	size_t offset;
+
+	err = dfu_target_discard();
+	zassert_equal(err, 0, "Should not fail when not initialized");
+
+	init();
+	done_call_count = 0;
+	reset_call_count = 0;
+	err = dfu_target_discard();
+	zassert_equal(err, 0, NULL);
+	zassert_equal(done_call_count, 1, "Target not released");
+	zassert_false(done_param_successful, "Target not aborted");
+	zassert_equal(reset_call_count, 1, "Target progress not discarded");
+
+	/* Discard de-initializes */
+	err = dfu_target_offset_get(&offset);
+	zassert_true(err < 0, "Expected negative error code");
+
+	/* Stored image is discarded even if releasing the target fails */
+	init();
+	reset_call_count = 0;
+	done_retval = -42;
+	err = dfu_target_discard();
+	zassert_equal(err, 0, NULL);
+	zassert_equal(reset_call_count, 1, "Target progress not discarded");
+	done_retval = 0;
+}
+
+#ifdef CONFIG_DFU_TARGET_DIGEST
+/* SHA-256 of "abc" */
+static const uint8_t abc_digest[DFU_TARGET_DIGEST_SIZE] = {
+	0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+	0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+	0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+	0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+static void test_digest(void)
+{
+	int err;
+	uint8_t digest[DFU_TARGET_DIGEST_SIZE];
+	uint8_t wrong[DFU_TARGET_DIGEST_SIZE] = { 0 };
+
+	done_retval = 0;
+	schedule_retval = 0;
+	offset_get_retval = 0;
+	offset_get_out_param = 0;
+	write_retval = 0;
+	done();
+
+	/* Digest computed from fragments */
+	init();
+	err = dfu_target_write("a", 1);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_write("bc", 2);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_digest_get(digest);
+	zassert_equal(err, -ENODATA, "Digest available before done");
+
+	err = dfu_target_digest_expect(abc_digest);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_done(true);
+	zassert_equal(err, 0, "Valid image rejected");
+	err = dfu_target_digest_get(digest);
+	zassert_equal(err, 0, NULL);
+	zassert_mem_equal(digest, abc_digest, sizeof(digest), "Wrong digest");
+	err = dfu_target_schedule_update(0);
+	zassert_equal(err, 0, NULL);
+
+	/* Image with another digest is not scheduled, and is erased */
+	init();
+	err = dfu_target_write("abd", 3);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_digest_expect(wrong);
+	zassert_equal(err, 0, NULL);
+	done_call_count = 0;
+	reset_call_count = 0;
+	err = dfu_target_done(true);
+	zassert_equal(err, -EBADMSG, "Invalid image accepted");
+	zassert_equal(done_call_count, 1, "Target not released");
+	zassert_false(done_param_successful, "Invalid image completed");
+	zassert_equal(reset_call_count, 1, "Invalid image not erased");
+	err = dfu_target_schedule_update(0);
+	zassert_true(err < 0, "Invalid image scheduled");
+
+	/* Expected digest is cleared after use */
+	init();
+	err = dfu_target_write("abd", 3);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_done(true);
+	zassert_equal(err, 0, NULL);
+	done();
+
+	/* No digest for an image resumed after re-initialization */
+	offset_get_out_param = 42;
+	init();
+	err = dfu_target_write("c", 1);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_done(true);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_digest_get(digest);
+	zassert_equal(err, -ENODATA, "Digest of resumed image");
+	done();
+
+	/* A resumed image that cannot be verified is rejected, and is erased */
+	init();
+	err = dfu_target_write("c", 1);
+	zassert_equal(err, 0, NULL);
+	err = dfu_target_digest_expect(abc_digest);
+	zassert_equal(err, 0, NULL);
+	reset_call_count = 0;
+	err = dfu_target_done(true);
+	zassert_equal(err, -ENODATA, "Unverified image accepted");
+	zassert_equal(reset_call_count, 1, "Unverified image not erased");
+	err = dfu_target_schedule_update(0);
+	zassert_true(err < 0, "Unverified image scheduled");
+	offset_get_out_param = 0;
+}
+#else
+static void test_digest(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_DFU_TARGET_DIGEST */
+
 void test_main(void)
 {
 	ztest_test_suite(dfu_target_test,
 			 ztest_unit_test(test_write),
 			 ztest_unit_test(test_offset_get),
 			 ztest_unit_test(test_done),
+			 ztest_unit_test(test_discard),
+			 ztest_unit_test(test_digest),
 			 ztest_user_unit_test_setup_teardown(test_init,
 				test_setup, unit_test_noop),
 			 ztest_user_unit_test_setup_teardown(test_schedule,
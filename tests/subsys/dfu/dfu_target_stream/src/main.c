@@ -10,6 +10,9 @@
 #include <stdbool.h>
 #include <ztest.h>
 #include <dfu/dfu_target_stream.h>
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+#include <settings/settings.h>
+#endif
 
 #define FLASH_BASE (64*1024)
 #define FLASH_SIZE DT_REG_SIZE(SOC_NV_FLASH_NODE)
@@ -20,13 +23,39 @@
 
 #define BUF_LEN 14000 /* Note, not page aligned */
 
+/* Size of the fragments received by a typical FOTA download */
+#define FRAG_LEN 512
+#define IMAGE_PAGES 8
+
+/* Emulated download of an image to a slow flash. Fragments are received
+ * at the same rate as the flash is written, so that a write in parallel
+ * with the download doubles the throughput.
+ */
+#define BENCH_IMAGE_LEN (32 * 1024)
+#define BENCH_FLASH_BUF_LEN 512
+#define BENCH_FRAG_RECV_US 4000
+#define BENCH_FLASH_WRITE_US 4000
+
 static const struct device *fdev = DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller));
 static uint8_t sbuf[128];
+static uint8_t bench_buf[BENCH_FLASH_BUF_LEN] __aligned(4);
 static uint8_t read_buf[BUF_LEN];
 static uint8_t write_buf[BUF_LEN] = {[0 ... BUF_LEN - 1] = 0xaa};
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 static int page_size;
+static size_t settings_write_cnt;
+
+int __real_settings_save_one(const char *name, const void *value,
+			     size_t val_len);
+
+int __wrap_settings_save_one(const char *name, const void *value,
+			     size_t val_len)
+{
+	settings_write_cnt++;
+
+	return __real_settings_save_one(name, value, val_len);
+}
 #endif
 
 #define DFU_TARGET_STREAM_INIT(id_, fdev_, buf_, len_, offset_, size_, cb_)  \
@@ -99,6 +128,62 @@ static void test_dfu_target_stream(void)
 	zassert_mem_equal(read_buf, write_buf, BUF_LEN, "Incorrect value");
 }
 
+static int slow_flash_cb(uint8_t *buf, size_t len, size_t offset)
+{
+	k_sleep(K_USEC(BENCH_FLASH_WRITE_US * len / BENCH_FLASH_BUF_LEN));
+
+	return 0;
+}
+
+static void test_dfu_target_stream_throughput(void)
+{
+	int err;
+	int64_t start;
+	int64_t duration;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, bench_buf,
+				     sizeof(bench_buf), FLASH_BASE, 0,
+				     slow_flash_cb);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	start = k_uptime_get();
+
+	for (size_t off = 0; off < BENCH_IMAGE_LEN; off += FRAG_LEN) {
+		k_sleep(K_USEC(BENCH_FRAG_RECV_US));
+
+		err = dfu_target_stream_write(write_buf + (off % (BUF_LEN - FRAG_LEN)),
+					      FRAG_LEN);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	duration = MAX(k_uptime_get() - start, 1);
+
+	TC_PRINT("Image of %u bytes in %d byte fragments, %s write:\n",
+		 BENCH_IMAGE_LEN, FRAG_LEN,
+		 IS_ENABLED(CONFIG_DFU_TARGET_STREAM_ASYNC) ? "async" : "sync");
+	TC_PRINT("\t%u ms, %u B/s\n", (uint32_t)duration,
+		 (uint32_t)(BENCH_IMAGE_LEN * 1000 / duration));
+
+	for (size_t off = 0; off < BENCH_IMAGE_LEN; off += FRAG_LEN) {
+		err = flash_read(fdev, FLASH_BASE + off, read_buf, FRAG_LEN);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+		zassert_mem_equal(read_buf, write_buf + (off % (BUF_LEN - FRAG_LEN)),
+				  FRAG_LEN, "Incorrect value");
+	}
+
+	/* Leave an initialized stream, as the following tests expect */
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_2, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 static void test_dfu_target_stream_save_progress(void)
 {
@@ -251,6 +336,145 @@ static void test_dfu_target_stream_save_progress(void)
 		      "Expected last erased page offset to be unchanged.");
 }
 
+static void test_dfu_target_stream_save_progress_writes(void)
+{
+	int err;
+	size_t offset;
+	const size_t image_len = IMAGE_PAGES * page_size;
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	settings_write_cnt = 0;
+
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t off = 0; off < image_len; off += FRAG_LEN) {
+		err = dfu_target_stream_write(write_buf + (off % (BUF_LEN - FRAG_LEN)),
+					      FRAG_LEN);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	uint32_t cyc = k_cycle_get_32() - start;
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, image_len, "Unexpected offset");
+
+	TC_PRINT("Write of %zu bytes in %d byte fragments:\n", image_len, FRAG_LEN);
+	TC_PRINT("\tsettings writes: %zu\n", settings_write_cnt);
+	TC_PRINT("\tcycles per kB: %u\n", (uint32_t)(cyc / (image_len / 1024)));
+
+	if (IS_ENABLED(CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE) &&
+	    CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_BYTES == 0 &&
+	    CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_MS == 0) {
+		/* Once per erased page */
+		zassert_true(settings_write_cnt <= IMAGE_PAGES,
+			     "Too many settings writes: %zu", settings_write_cnt);
+	} else {
+		/* Once per fragment */
+		zassert_equal(settings_write_cnt, image_len / FRAG_LEN,
+			      "Unexpected settings writes: %zu", settings_write_cnt);
+	}
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE
+static void test_dfu_target_stream_save_progress_recover(void)
+{
+	int err;
+	size_t written;
+	size_t offset;
+	size_t stored;
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Write into the third page, not aligned to the stream buffer */
+	err = dfu_target_stream_write(write_buf,
+				      2 * page_size + 5 * sizeof(sbuf) + 7);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&written);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(written, 2 * page_size + 5 * sizeof(sbuf),
+		      "Unexpected offset");
+
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Simulate a reset before the last progress was stored */
+	stored = 2 * page_size + sizeof(sbuf);
+	err = settings_save_one("dfu/" TEST_ID_1, &stored, sizeof(stored));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, written, "Progress not recovered");
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+#else
+static void test_dfu_target_stream_save_progress_recover(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_COALESCE */
+
+static void test_dfu_target_stream_reset(void)
+{
+	int err;
+	size_t offset;
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, page_size + sizeof(sbuf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_reset();
+	zassert_equal(err, -EBUSY, "Reset while in use");
+
+	/* Complete transfer with failure, this stores the progress */
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_reset();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* The written pages are erased */
+	err = flash_read(fdev, FLASH_BASE, read_buf, page_size + sizeof(sbuf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	for (size_t i = 0; i < page_size + sizeof(sbuf); i++) {
+		zassert_equal(read_buf[i], 0xff, "Flash not erased at %zu", i);
+	}
+
+	/* Re-initialize dfu target, verify that it starts from offset 0 */
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, 0, "Progress not discarded");
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+}
+
 static size_t get_flash_page_size(const struct device *dev)
 {
 	struct flash_driver_api *api = (struct flash_driver_api *) dev->api;
@@ -279,6 +503,21 @@ static void test_dfu_target_stream_save_progress(void)
 	ztest_test_skip();
 }
 
+static void test_dfu_target_stream_save_progress_writes(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dfu_target_stream_save_progress_recover(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dfu_target_stream_reset(void)
+{
+	ztest_test_skip();
+}
+
 #endif
 
 
@@ -295,12 +534,18 @@ void test_main(void)
 	page_size = get_flash_page_size(fdev);
 	__ASSERT(page_size <= BUF_LEN,
 		 "BUF_LEN must be at least one page long");
+	__ASSERT(FLASH_BASE + IMAGE_PAGES * page_size <= FLASH_SIZE,
+		 "Not enough flash for the test image");
 #endif
 
 	ztest_test_suite(lib_dfu_target_stream,
 	     ztest_unit_test(test_dfu_target_stream_null_checks),
 	     ztest_unit_test(test_dfu_target_stream),
-	     ztest_unit_test(test_dfu_target_stream_save_progress)
+	     ztest_unit_test(test_dfu_target_stream_throughput),
+	     ztest_unit_test(test_dfu_target_stream_save_progress),
+	     ztest_unit_test(test_dfu_target_stream_save_progress_writes),
+	     ztest_unit_test(test_dfu_target_stream_save_progress_recover),
+	     ztest_unit_test(test_dfu_target_stream_reset)
 	 );
 
 	ztest_run_test_suite(lib_dfu_target_stream);
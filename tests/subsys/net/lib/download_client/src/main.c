@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/download_client.h>
+
+#define SERVER_PORT 8080
+#define SERVER_HOST "http://127.0.0.1:8080"
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY 5
+#define FILE_NAME "file.bin"
+#define FILE_SIZE (32 * 1024 + 100)
+#define REQ_QUEUE_SIZE 16
+
+/* One-way latencies of the simulated link, in milliseconds. */
+static const uint32_t latencies[] = { 0, 10, 25, 50, 100, 200 };
+
+static struct download_client client;
+static K_SEM_DEFINE(done_sem, 0, 1);
+static size_t received;
+static bool content_ok;
+static int download_err;
+static uint32_t latency_ms;
+static size_t stop_at;
+static char etag[8] = "\"v1\"";
+
+static uint8_t file_byte(size_t off)
+{
+	return (uint8_t)(off * 7 + (off >> 8));
+}
+
+/* Requests are queued when they are received and answered in order,
+ * each one twice the link latency after it was received.
+ * Pipelined requests thus only wait for one round trip.
+ */
+struct range_request {
+	int64_t due;
+	uint32_t start;
+	uint32_t end;
+	/* If-Range validator did not match, send the whole file */
+	bool full;
+};
+
+static int response_send(int fd, const struct range_request *req)
+{
+	static char buf[2048];
+	uint32_t end = MIN(req->end, FILE_SIZE - 1);
+	uint32_t off = req->start;
+	int len;
+
+	if (req->full) {
+		off = 0;
+		end = FILE_SIZE - 1;
+		len = snprintf(buf, sizeof(buf),
+			       "HTTP/1.1 200 OK\r\n"
+			       "ETag: %s\r\n"
+			       "Content-Length: %u\r\n"
+			       "\r\n",
+			       etag, FILE_SIZE);
+	} else {
+		len = snprintf(buf, sizeof(buf),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "ETag: %s\r\n"
+			       "Content-Range: bytes %u-%u/%u\r\n"
+			       "Content-Length: %u\r\n"
+			       "\r\n",
+			       etag, req->start, end, FILE_SIZE, end - req->start + 1);
+	}
+
+	while (off <= end) {
+		while (len < sizeof(buf) && off <= end) {
+			buf[len++] = file_byte(off++);
+		}
+
+		for (int sent = 0; sent < len;) {
+			int rc = send(fd, buf + sent, len - sent, 0);
+
+			if (rc < 0) {
+				return -errno;
+			}
+			sent += rc;
+		}
+		len = 0;
+	}
+
+	return 0;
+}
+
+static void connection_serve(int fd)
+{
+	static char req_buf[1024];
+	static struct range_request queue[REQ_QUEUE_SIZE];
+	size_t head = 0;
+	size_t tail = 0;
+	size_t len = 0;
+
+	while (true) {
+		struct pollfd fds = { .fd = fd, .events = POLLIN };
+		int timeout = -1;
+		char *end;
+
+		if (head != tail) {
+			timeout = MAX(queue[head].due - k_uptime_get(), 0);
+		}
+
+		if (poll(&fds, 1, timeout) > 0) {
+			int rc = recv(fd, req_buf + len, sizeof(req_buf) - len - 1, 0);
+
+			if (rc <= 0) {
+				return;
+			}
+			len += rc;
+			req_buf[len] = '\0';
+
+			while ((end = strstr(req_buf, "\r\n\r\n")) != NULL) {
+				struct range_request *req = &queue[tail];
+				char *range = strstr(req_buf, "Range: bytes=");
+				char *if_range = strstr(req_buf, "If-Range: ");
+				size_t req_len = end + strlen("\r\n\r\n") - req_buf;
+
+				zassert_not_null(range, "Not a range request");
+				range += strlen("Range: bytes=");
+				req->start = strtoul(range, &range, 10);
+				req->end = strtoul(range + 1, NULL, 10);
+				req->full = (if_range != NULL && if_range < end &&
+					     strncmp(if_range + strlen("If-Range: "), etag,
+						     strlen(etag)));
+				req->due = k_uptime_get() + 2 * latency_ms;
+				tail = (tail + 1) % REQ_QUEUE_SIZE;
+				zassert_not_equal(head, tail, "Too many requests");
+
+				len -= req_len;
+				memmove(req_buf, req_buf + req_len, len + 1);
+			}
+			continue;
+		}
+
+		if (head != tail && queue[head].due <= k_uptime_get()) {
+			if (response_send(fd, &queue[head])) {
+				return;
+			}
+			head = (head + 1) % REQ_QUEUE_SIZE;
+		}
+	}
+}
+
+static void server_thread(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+	int err;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "Failed to create server socket: %d", errno);
+
+	err = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(err, 0, "Failed to bind server socket: %d", errno);
+
+	err = listen(fd, 1);
+	zassert_equal(err, 0, "Failed to listen: %d", errno);
+
+	while (true) {
+		int conn = accept(fd, NULL, NULL);
+
+		if (conn < 0) {
+			continue;
+		}
+
+		connection_serve(conn);
+		close(conn);
+	}
+}
+
+K_THREAD_DEFINE(server_tid, SERVER_STACK_SIZE, server_thread, NULL, NULL, NULL,
+		SERVER_PRIORITY, 0, 0);
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (((const uint8_t *)event->fragment.buf)[i] !=
+			    file_byte(received + i)) {
+				content_ok = false;
+			}
+		}
+		received += event->fragment.len;
+		if (stop_at != 0 && received >= stop_at) {
+			/* Interrupt the download */
+			k_sem_give(&done_sem);
+			return -1;
+		}
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&done_sem);
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		download_err = event->error;
+		k_sem_give(&done_sem);
+		/* Stop the download */
+		return -1;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static void download_run(size_t from)
+{
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	int err;
+
+	received = from;
+	content_ok = true;
+	download_err = 0;
+
+	err = download_client_connect(&client, SERVER_HOST, &config);
+	zassert_equal(err, 0, "Failed to connect: %d", err);
+
+	err = download_client_start(&client, FILE_NAME, from);
+	zassert_equal(err, 0, "Failed to start download: %d", err);
+
+	err = k_sem_take(&done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+
+	(void)download_client_disconnect(&client);
+}
+
+/* Returns the download duration in milliseconds. */
+static int64_t download(uint32_t latency)
+{
+	int64_t start = k_uptime_get();
+
+	latency_ms = latency;
+	download_run(0);
+
+	int64_t duration = k_uptime_get() - start;
+
+	zassert_equal(download_err, 0, "Download failed: %d", download_err);
+	zassert_equal(received, FILE_SIZE, "Unexpected size: %zu", received);
+	zassert_true(content_ok, "Unexpected content");
+
+	return duration;
+}
+
+static void test_download_content(void)
+{
+	(void)download(0);
+}
+
+static void test_download_throughput(void)
+{
+	TC_PRINT("Download of %u bytes, %d requests outstanding:\n", FILE_SIZE,
+		 CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH);
+
+	for (size_t i = 0; i < ARRAY_SIZE(latencies); i++) {
+		int64_t duration = download(latencies[i]);
+
+		TC_PRINT("\tlatency %u ms: %u ms, %u B/s\n", latencies[i],
+			 (uint32_t)duration,
+			 (uint32_t)(FILE_SIZE * 1000 / MAX(duration, 1)));
+	}
+}
+
+static void test_download_resume(void)
+{
+	size_t offset;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	latency_ms = 0;
+	stop_at = FILE_SIZE / 2;
+	download_run(0);
+	stop_at = 0;
+
+	err = download_client_checkpoint_get(&client, FILE_NAME, &offset);
+	zassert_equal(err, 0, "No checkpoint: %d", err);
+	zassert_true(offset > 0 && offset <= received,
+		     "Unexpected checkpoint: %zu", offset);
+
+	download_run(offset);
+	zassert_equal(download_err, 0, "Download failed: %d", download_err);
+	zassert_equal(received, FILE_SIZE, "Unexpected size: %zu", received);
+	zassert_true(content_ok, "Unexpected content");
+
+	err = download_client_checkpoint_get(&client, FILE_NAME, &offset);
+	zassert_equal(err, -ENOENT, "Checkpoint not deleted: %d", err);
+}
+
+static void test_download_resume_changed_file(void)
+{
+	size_t offset;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_CHECKPOINT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	latency_ms = 0;
+	stop_at = FILE_SIZE / 2;
+	download_run(0);
+	stop_at = 0;
+
+	err = download_client_checkpoint_get(&client, FILE_NAME, &offset);
+	zassert_equal(err, 0, "No checkpoint: %d", err);
+
+	strcpy(etag, "\"v2\"");
+	download_run(offset);
+	strcpy(etag, "\"v1\"");
+
+	zassert_equal(download_err, -ECANCELED, "Changed file not rejected: %d",
+		      download_err);
+
+	err = download_client_checkpoint_get(&client, FILE_NAME, &offset);
+	zassert_equal(err, -ENOENT, "Checkpoint not deleted: %d", err);
+}
+
+void test_main(void)
+{
+	int err = download_client_init(&client, download_client_callback);
+
+	zassert_equal(err, 0, "Failed to initialize client: %d", err);
+
+	ztest_test_suite(download_client,
+			 ztest_unit_test(test_download_content),
+			 ztest_unit_test(test_download_throughput),
+			 ztest_unit_test(test_download_resume),
+			 ztest_unit_test(test_download_resume_changed_file)
+			 );
+
+	ztest_run_test_suite(download_client);
+}
@@ -30,6 +30,7 @@ char buf[1024];
 /* Stubs and mocks */
 bool dfu_ctx_mcuboot_set_b1_file__s0_active;
 const char *download_client_start_file;
+static size_t download_client_start_from;
 char *dfu_ctx_mcuboot_set_b1_file__update;
 static bool spm_s0_active_retval;
 
@@ -39,6 +40,13 @@ static bool fail_on_offset_get;
 static bool fail_on_connect;
 static bool fail_on_start;
 static bool download_with_offset_success;
+static bool dfu_target_discard_called;
+static bool image_changed_error;
+static int dfu_target_done_retval;
+static bool dfu_target_schedule_update_called;
+static bool dfu_target_digest_expect_set;
+static uint8_t dfu_target_digest_expect_param[DFU_TARGET_DIGEST_SIZE];
+static bool invalid_update_error;
 static download_client_callback_t download_client_event_handler;
 
 int dfu_target_init(int img_type, int img_num, size_t file_size, dfu_target_callback_t cb)
@@ -73,6 +81,17 @@ int dfu_target_write(const void *const buf, size_t len)
 
 int dfu_target_done(bool successful)
 {
+	return successful ? dfu_target_done_retval : 0;
+}
+
+int dfu_target_digest_expect(const uint8_t *expected)
+{
+	dfu_target_digest_expect_set = (expected != NULL);
+	if (expected != NULL) {
+		memcpy(dfu_target_digest_expect_param, expected,
+		       DFU_TARGET_DIGEST_SIZE);
+	}
+
 	return 0;
 }
 
@@ -86,8 +105,17 @@ int dfu_target_reset(void)
 	return 0;
 }
 
+int dfu_target_discard(void)
+{
+	/* Stored progress is erased, the image restarts from offset 0 */
+	dfu_target_discard_called = true;
+	start_with_offset = false;
+	return 0;
+}
+
 int dfu_target_schedule_update(int img_num)
 {
+	dfu_target_schedule_update_called = true;
 	return 0;
 }
 
@@ -95,6 +123,7 @@ int download_client_start(struct download_client *client, const char *file,
 			  size_t from)
 {
 	download_client_start_file = file;
+	download_client_start_from = from;
 
 	if (fail_on_start == true) {
 		return -1;
@@ -226,6 +255,14 @@ void client_callback(const struct fota_download_evt *evt)
 			fail_on_start = false;
 			k_sem_give(&download_with_offset_sem);
 		}
+		if (invalid_update_error == true) {
+			zassert_equal(evt->cause, FOTA_DOWNLOAD_ERROR_CAUSE_INVALID_UPDATE, NULL);
+			invalid_update_error = false;
+		}
+		if (image_changed_error == true) {
+			zassert_equal(evt->cause, FOTA_DOWNLOAD_ERROR_CAUSE_DOWNLOAD_FAILED, NULL);
+			image_changed_error = false;
+		}
 		break;
 
 	default:
@@ -385,11 +422,140 @@ static void test_download_with_offset(void)
 	start_with_offset = false;
 }
 
+static void test_download_image_changed(void)
+{
+	int err;
+
+	uint8_t fragment_buf[1] = {0};
+	size_t  fragment_len = 1;
+	const struct download_client_evt fragment_evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+		.fragment = {
+			.buf = fragment_buf,
+			.len = fragment_len,
+		}
+	};
+	const struct download_client_evt error_evt = {
+		.id = DOWNLOAD_CLIENT_EVT_ERROR,
+		.error = -ECANCELED,
+	};
+
+	init();
+	dfu_target_discard_called = false;
+
+	/* Resume a previously stored image */
+	start_with_offset = true;
+	err = fota_download_start("something.com", buf, NO_TLS, 0, 0);
+	zassert_ok(err, NULL);
+
+	err = download_client_event_handler(&fragment_evt);
+	zassert_equal(err, -1, "Fragment not refused");
+
+	download_with_offset_success = false;
+	k_sem_take(&download_with_offset_sem, K_SECONDS(2));
+	zassert_true(download_with_offset_success, NULL);
+	zassert_equal(download_client_start_from, ARBITRARY_IMAGE_OFFSET, NULL);
+
+	/* The image has changed on the server */
+	image_changed_error = true;
+	err = download_client_event_handler(&error_evt);
+	zassert_equal(err, -ECANCELED, NULL);
+	zassert_false(image_changed_error, "Application not notified");
+	zassert_true(dfu_target_discard_called, "Stored image not discarded");
+
+	/* The next attempt starts the new image from offset 0 */
+	err = fota_download_start("something.com", buf, NO_TLS, 0, 0);
+	zassert_ok(err, NULL);
+	zassert_equal(download_client_start_from, 0, NULL);
+
+	err = download_client_event_handler(&fragment_evt);
+	zassert_equal(err, 0, "Fragment refused after discard");
+
+	err = fota_download_cancel();
+	zassert_ok(err, NULL);
+}
+
+static void test_download_with_digest(void)
+{
+	int err;
+	uint8_t digest[DFU_TARGET_DIGEST_SIZE] = {
+		[0 ... DFU_TARGET_DIGEST_SIZE - 1] = 0xab
+	};
+
+	uint8_t fragment_buf[1] = {0};
+	size_t  fragment_len = 1;
+	const struct download_client_evt fragment_evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+		.fragment = {
+			.buf = fragment_buf,
+			.len = fragment_len,
+		}
+	};
+	const struct download_client_evt done_evt = {
+		.id = DOWNLOAD_CLIENT_EVT_DONE,
+	};
+
+	init();
+
+	/* The expected digest is passed to the DFU target */
+	err = fota_download_start_with_digest("something.com", buf, NO_TLS, 0,
+					      0, DFU_TARGET_IMAGE_TYPE_ANY,
+					      digest);
+	zassert_ok(err, NULL);
+
+	err = download_client_event_handler(&fragment_evt);
+	zassert_ok(err, NULL);
+	zassert_true(dfu_target_digest_expect_set, "Digest not expected");
+	zassert_mem_equal(dfu_target_digest_expect_param, digest,
+			  sizeof(digest), "Wrong digest");
+
+	/* An image with another digest is rejected, not scheduled */
+	dfu_target_done_retval = -EBADMSG;
+	dfu_target_schedule_update_called = false;
+	invalid_update_error = true;
+	err = download_client_event_handler(&done_evt);
+	zassert_equal(err, -EBADMSG, NULL);
+	zassert_false(invalid_update_error, "Application not notified");
+	zassert_false(dfu_target_schedule_update_called,
+		      "Invalid image scheduled");
+
+	/* An image that could not be verified is rejected as well */
+	err = fota_download_start_with_digest("something.com", buf, NO_TLS, 0,
+					      0, DFU_TARGET_IMAGE_TYPE_ANY,
+					      digest);
+	zassert_ok(err, NULL);
+
+	err = download_client_event_handler(&fragment_evt);
+	zassert_ok(err, NULL);
+
+	dfu_target_done_retval = -ENODATA;
+	invalid_update_error = true;
+	err = download_client_event_handler(&done_evt);
+	zassert_equal(err, -ENODATA, NULL);
+	zassert_false(invalid_update_error, "Application not notified");
+	zassert_false(dfu_target_schedule_update_called,
+		      "Unverified image scheduled");
+	dfu_target_done_retval = 0;
+
+	/* No digest is expected by a download started without one */
+	err = fota_download_start("something.com", buf, NO_TLS, 0, 0);
+	zassert_ok(err, NULL);
+
+	err = download_client_event_handler(&fragment_evt);
+	zassert_ok(err, NULL);
+	zassert_false(dfu_target_digest_expect_set, "Stale digest expected");
+
+	err = fota_download_cancel();
+	zassert_ok(err, NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_fota_download_test,
 			 ztest_unit_test(test_fota_download_start),
-			 ztest_unit_test(test_download_with_offset));
+			 ztest_unit_test(test_download_with_offset),
+			 ztest_unit_test(test_download_image_changed),
+			 ztest_unit_test(test_download_with_digest));
 
 	ztest_run_test_suite(lib_fota_download_test);
 }
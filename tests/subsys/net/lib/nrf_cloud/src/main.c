@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <zcbor_decode.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_cell_pos.h>
+
+#include "nrf_cloud_codec.h"
+
+#define BENCHMARK_ROUNDS 100
+
+/* Modem info is not available on the test platform */
+int modem_info_init(void)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_init(struct modem_param_info *modem)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_get(struct modem_param_info *modem)
+{
+	return -ENOTSUP;
+}
+
+static const char gps_data[] =
+	"$GPGGA,160910.00,6325.4198,N,01022.8567,E,1,08,1.1,55.6,M,40.1,M,,*7A";
+
+static const struct nrf_cloud_sensor_data gps_sensor = {
+	.type = NRF_CLOUD_SENSOR_GPS,
+	.data.ptr = gps_data,
+	.data.len = sizeof(gps_data) - 1,
+};
+
+static struct lte_lc_ncell ncells[] = {
+	{ .earfcn = 6400, .phys_cell_id = 194, .rsrp = 29, .rsrq = 18 },
+	{ .earfcn = 6400, .phys_cell_id = 195, .rsrp = 23, .rsrq = 11 },
+	{ .earfcn = 6400, .phys_cell_id = 78, .rsrp = 21, .rsrq = 8 },
+	{ .earfcn = 1650, .phys_cell_id = 31, .rsrp = 17, .rsrq = 6 },
+	{ .earfcn = 300, .phys_cell_id = 428, .rsrp = 13, .rsrq = 2 },
+};
+
+static const struct lte_lc_cells_info cell_info = {
+	.current_cell = {
+		.mcc = 242,
+		.mnc = 1,
+		.id = 0x0199F10A,
+		.tac = 0x76C1,
+		.earfcn = 6400,
+		.timing_advance = 80,
+		.rsrp = 41,
+		.rsrq = 28,
+		.phys_cell_id = 241,
+	},
+	.ncells_count = ARRAY_SIZE(ncells),
+	.neighbor_cells = ncells,
+};
+
+static uint8_t cbor_buf[512];
+
+/* The sensor data encoder is only built with MQTT, so the JSON message is
+ * created the same way here.
+ */
+static char *sensor_json_encode(const struct nrf_cloud_sensor_data *sensor)
+{
+	cJSON *obj = json_create_req_obj(NRF_CLOUD_JSON_APPID_VAL_GPS,
+					 NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	char *str = NULL;
+
+	if (obj && cJSON_AddStringToObject(obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr)) {
+		str = cJSON_PrintUnformatted(obj);
+	}
+
+	cJSON_Delete(obj);
+
+	return str;
+}
+
+static void test_sensor_data(void)
+{
+	struct zcbor_string key;
+	struct zcbor_string val;
+	size_t len = sizeof(cbor_buf);
+	char *json = sensor_json_encode(&gps_sensor);
+	int err;
+
+	zassert_not_null(json, "JSON encoding failed");
+
+	err = nrf_cloud_sensor_data_cbor_encode(&gps_sensor, cbor_buf, &len);
+	zassert_equal(err, 0, "CBOR encoding failed: %d", err);
+	zassert_true(len < strlen(json), "CBOR (%zu) not smaller than JSON (%zu)",
+		     len, strlen(json));
+
+	ZCBOR_STATE_D(state, 2, cbor_buf, len, 1);
+
+	zassert_true(zcbor_map_start_decode(state), "No map");
+	zassert_true(zcbor_tstr_decode(state, &key), "No key");
+	zassert_true(zcbor_tstr_decode(state, &val), "No value");
+	zassert_equal(0, strncmp(NRF_CLOUD_JSON_APPID_KEY, key.value, key.len),
+		      "Unexpected key");
+	zassert_equal(0, strncmp(NRF_CLOUD_JSON_APPID_VAL_GPS, val.value, val.len),
+		      "Unexpected app ID");
+	zassert_true(zcbor_tstr_decode(state, &key), "No key");
+	zassert_true(zcbor_tstr_decode(state, &val), "No value");
+	zassert_equal(val.len, gps_sensor.data.len, "Unexpected data length");
+	zassert_equal(0, memcmp(gps_data, val.value, val.len), "Unexpected data");
+
+	cJSON_free(json);
+}
+
+/* The request is created the same way as by nrf_cloud_cell_pos_request(),
+ * which is only built with MQTT.
+ */
+static char *cell_pos_req_json_encode(const struct lte_lc_cells_info *inf)
+{
+	cJSON *obj = json_create_req_obj(NRF_CLOUD_JSON_APPID_VAL_CELL_POS,
+					 NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	cJSON *data_obj = cJSON_AddObjectToObject(obj, NRF_CLOUD_JSON_DATA_KEY);
+	char *str = NULL;
+
+	if (data_obj && !nrf_cloud_format_cell_pos_req_json(inf, 1, data_obj) &&
+	    cJSON_AddNumberToObject(data_obj, NRF_CLOUD_CELL_POS_JSON_KEY_DOREPLY, 0)) {
+		str = cJSON_PrintUnformatted(obj);
+	}
+
+	cJSON_Delete(obj);
+
+	return str;
+}
+
+static void test_cell_pos_req(void)
+{
+	struct zcbor_string key;
+	struct zcbor_string val;
+	size_t len = sizeof(cbor_buf);
+	size_t reply_len = sizeof(cbor_buf);
+	char *json = cell_pos_req_json_encode(&cell_info);
+	int err;
+
+	zassert_not_null(json, "JSON encoding failed");
+
+	err = nrf_cloud_cell_pos_req_cbor_encode(&cell_info, 1, false, cbor_buf, &len);
+	zassert_equal(err, 0, "CBOR encoding failed: %d", err);
+	zassert_true(len < strlen(json), "CBOR (%zu) not smaller than JSON (%zu)",
+		     len, strlen(json));
+
+	ZCBOR_STATE_D(state, 2, cbor_buf, len, 1);
+
+	zassert_true(zcbor_map_start_decode(state), "No map");
+	zassert_true(zcbor_tstr_decode(state, &key), "No key");
+	zassert_true(zcbor_tstr_decode(state, &val), "No value");
+	zassert_equal(0, strncmp(NRF_CLOUD_JSON_APPID_KEY, key.value, key.len),
+		      "Unexpected key");
+	zassert_equal(0, strncmp(NRF_CLOUD_JSON_APPID_VAL_CELL_POS, val.value, val.len),
+		      "Unexpected app ID");
+
+	/* The location is requested by leaving out the doReply item */
+	err = nrf_cloud_cell_pos_req_cbor_encode(&cell_info, 1, true, cbor_buf, &reply_len);
+	zassert_equal(err, 0, "CBOR encoding failed: %d", err);
+	zassert_true(reply_len < len, "doReply item not left out");
+
+	cJSON_free(json);
+}
+
+static void test_buffer_too_small(void)
+{
+	size_t len = 16;
+
+	zassert_equal(-ENOMEM, nrf_cloud_sensor_data_cbor_encode(&gps_sensor, cbor_buf, &len),
+		      "Encoding to too small buffer should fail");
+	zassert_equal(-ENOMEM,
+		      nrf_cloud_cell_pos_req_cbor_encode(&cell_info, 1, true, cbor_buf, &len),
+		      "Encoding to too small buffer should fail");
+	zassert_equal(-EINVAL,
+		      nrf_cloud_cell_pos_req_cbor_encode(&cell_info, 0, true, cbor_buf, &len),
+		      "Encoding no cells should fail");
+}
+
+static void test_benchmark(void)
+{
+	size_t json_len = 0;
+	size_t cbor_len = 0;
+	uint32_t json_cyc;
+	uint32_t cbor_cyc;
+	uint32_t start;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		char *json;
+
+		json = cell_pos_req_json_encode(&cell_info);
+		json_len = strlen(json);
+		cJSON_free(json);
+	}
+	json_cyc = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		cbor_len = sizeof(cbor_buf);
+		(void)nrf_cloud_cell_pos_req_cbor_encode(&cell_info, 1, false, cbor_buf,
+							 &cbor_len);
+	}
+	cbor_cyc = k_cycle_get_32() - start;
+
+	TC_PRINT("Cellular positioning request with %u neighbor cells:\n",
+		 cell_info.ncells_count);
+	TC_PRINT("\tJSON: %zu bytes, %u cycles\n", json_len, json_cyc / BENCHMARK_ROUNDS);
+	TC_PRINT("\tCBOR: %zu bytes, %u cycles\n", cbor_len, cbor_cyc / BENCHMARK_ROUNDS);
+}
+
+void test_main(void)
+{
+	nrf_cloud_codec_init();
+
+	ztest_test_suite(nrf_cloud_codec,
+			 ztest_unit_test(test_sensor_data),
+			 ztest_unit_test(test_cell_pos_req),
+			 ztest_unit_test(test_buffer_too_small),
+			 ztest_unit_test(test_benchmark)
+			 );
+
+	ztest_run_test_suite(nrf_cloud_codec);
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <device.h>
+#include <sys/byteorder.h>
+#include <ipc/ipc_service.h>
+
+#include <nrf_rpc_rpmsg.h>
+
+#define SENDER_CNT 4
+#define SENDER_STACK_SIZE 1024
+#define SENDER_PRIORITY 5
+
+#define PACKET_LEN 32
+#define PACKETS_PER_SENDER 100
+#define BENCHMARK_PACKETS_PER_SENDER 1000
+
+/* Time the IPC service takes to send a message to the other core. The
+ * benchmark measures simulated time, which includes this delay.
+ */
+#define IPC_SEND_TIME_US 20
+
+static const struct ipc_ept_cfg *ept_cfg;
+static uint32_t ipc_send_cnt;
+
+/* If set, every other IPC message is dropped and its send fails. */
+static bool ipc_send_fail;
+
+/* Number of packets of each sender for which sending failed. */
+static uint32_t tx_failed[SENDER_CNT];
+
+static struct {
+	uint32_t packet_cnt;
+	uint32_t byte_cnt;
+	/* Next sequence number expected from each sender */
+	uint32_t next_seq[SENDER_CNT];
+	/* Number of packets received from each sender */
+	uint32_t sender_cnt[SENDER_CNT];
+	bool error;
+} rx;
+
+static K_THREAD_STACK_ARRAY_DEFINE(sender_stacks, SENDER_CNT, SENDER_STACK_SIZE);
+static struct k_thread sender_threads[SENDER_CNT];
+
+/* ipc0 node of the test overlay */
+static int ipc_loopback_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DT_DEFINE(DT_NODELABEL(ipc0), ipc_loopback_init, NULL, NULL, NULL,
+		 POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, NULL);
+
+int __wrap_ipc_service_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+int __wrap_ipc_service_register_endpoint(const struct device *instance, struct ipc_ept *ept,
+					 const struct ipc_ept_cfg *cfg)
+{
+	ept_cfg = cfg;
+	ept_cfg->cb.bound(ept_cfg->priv);
+
+	return 0;
+}
+
+int __wrap_ipc_service_send(struct ipc_ept *ept, const void *data, size_t len)
+{
+	ipc_send_cnt++;
+
+	/* Other threads run while the message is sent */
+	k_sleep(K_USEC(IPC_SEND_TIME_US));
+
+	if (ipc_send_fail && (ipc_send_cnt % 2)) {
+		return -ENOMEM;
+	}
+
+	ept_cfg->cb.received(data, len, ept_cfg->priv);
+
+	return len;
+}
+
+/* Packets hold the sender index, a sequence number and a pattern. */
+static void packet_fill(uint8_t *buf, size_t len, uint8_t sender, uint32_t seq)
+{
+	buf[0] = sender;
+	sys_put_le32(seq, &buf[1]);
+
+	for (size_t i = 5; i < len; i++) {
+		buf[i] = (uint8_t)(seq + i);
+	}
+}
+
+static void packet_received(const uint8_t *packet, size_t len)
+{
+	uint8_t sender;
+	uint32_t seq;
+
+	rx.packet_cnt++;
+	rx.byte_cnt += len;
+
+	if (len < 5) {
+		rx.error = true;
+		return;
+	}
+
+	sender = packet[0];
+	seq = sys_get_le32(&packet[1]);
+
+	/* Packets of a sender must arrive in order and unchanged. Packets are
+	 * missing if their IPC message was dropped.
+	 */
+	if ((sender >= SENDER_CNT) || (seq < rx.next_seq[sender]) ||
+	    (!ipc_send_fail && (seq != rx.next_seq[sender]))) {
+		rx.error = true;
+		return;
+	}
+
+	rx.next_seq[sender] = seq + 1;
+	rx.sender_cnt[sender]++;
+
+	for (size_t i = 5; i < len; i++) {
+		if (packet[i] != (uint8_t)(seq + i)) {
+			rx.error = true;
+			return;
+		}
+	}
+}
+
+static void test_setup(void)
+{
+	memset(&rx, 0, sizeof(rx));
+	memset(tx_failed, 0, sizeof(tx_failed));
+	ipc_send_cnt = 0;
+	ipc_send_fail = false;
+	nrf_rpc_tr_stats_reset();
+}
+
+static void test_send_receive(void)
+{
+	uint8_t buf[64];
+	struct nrf_rpc_tr_stats stats;
+	int err;
+
+	for (size_t len = 5; len <= sizeof(buf); len++) {
+		packet_fill(buf, len, 0, len - 5);
+
+		err = nrf_rpc_tr_send(buf, len);
+		zassert_equal(err, 0, "Sending packet failed: %d", err);
+	}
+
+	zassert_false(rx.error, "Packet received out of order or modified");
+	zassert_equal(rx.packet_cnt, sizeof(buf) - 4, "Packets lost");
+
+	/* A single thread does not wait for more packets */
+	zassert_equal(ipc_send_cnt, rx.packet_cnt, "Packets from one thread batched");
+
+	nrf_rpc_tr_stats_get(&stats);
+	zassert_equal(stats.packets_sent, rx.packet_cnt, "Wrong packets sent count");
+	zassert_equal(stats.packets_received, rx.packet_cnt, "Wrong packets received count");
+	zassert_equal(stats.frames_sent, ipc_send_cnt, "Wrong frames sent count");
+	zassert_equal(stats.frames_received, ipc_send_cnt, "Wrong frames received count");
+}
+
+static void sender_entry(void *p1, void *p2, void *p3)
+{
+	uint8_t sender = POINTER_TO_UINT(p1);
+	uint32_t packet_cnt = POINTER_TO_UINT(p2);
+	uint8_t buf[PACKET_LEN];
+
+	for (uint32_t seq = 0; seq < packet_cnt; seq++) {
+		packet_fill(buf, sizeof(buf), sender, seq);
+
+		if (nrf_rpc_tr_send(buf, sizeof(buf))) {
+			tx_failed[sender]++;
+		}
+	}
+}
+
+static void senders_run(uint32_t packet_cnt)
+{
+	for (size_t i = 0; i < SENDER_CNT; i++) {
+		k_thread_create(&sender_threads[i], sender_stacks[i], SENDER_STACK_SIZE,
+				sender_entry, UINT_TO_POINTER(i), UINT_TO_POINTER(packet_cnt), NULL,
+				SENDER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	for (size_t i = 0; i < SENDER_CNT; i++) {
+		k_thread_join(&sender_threads[i], K_FOREVER);
+	}
+}
+
+static void test_concurrent_send(void)
+{
+	senders_run(PACKETS_PER_SENDER);
+
+	zassert_false(rx.error, "Packet received out of order or modified");
+	zassert_equal(rx.packet_cnt, SENDER_CNT * PACKETS_PER_SENDER, "Packets lost");
+
+	for (size_t i = 0; i < SENDER_CNT; i++) {
+		zassert_equal(tx_failed[i], 0, "Sending packets of sender %u failed", i);
+	}
+
+	if (IS_ENABLED(CONFIG_NRF_RPC_TR_RPMSG_BATCH)) {
+		zassert_true(ipc_send_cnt < rx.packet_cnt, "Packets not batched");
+	} else {
+		zassert_equal(ipc_send_cnt, rx.packet_cnt, "Packets batched");
+	}
+}
+
+static void test_send_failure(void)
+{
+	uint32_t failed_cnt = 0;
+
+	ipc_send_fail = true;
+
+	senders_run(PACKETS_PER_SENDER);
+
+	zassert_false(rx.error, "Packet received out of order or modified");
+
+	/* Each sender gets the status of its own packets, so a packet is
+	 * either received or its sender is told that sending failed.
+	 */
+	for (size_t i = 0; i < SENDER_CNT; i++) {
+		zassert_equal(rx.sender_cnt[i] + tx_failed[i], PACKETS_PER_SENDER,
+			      "Sender %u got %u failures for %u lost packets", i, tx_failed[i],
+			      PACKETS_PER_SENDER - rx.sender_cnt[i]);
+		failed_cnt += tx_failed[i];
+	}
+
+	zassert_true(failed_cnt > 0, "No failures reported");
+	zassert_true(rx.packet_cnt > 0, "No packets received");
+}
+
+static void test_benchmark(void)
+{
+	struct nrf_rpc_tr_stats stats;
+	uint64_t start;
+	uint64_t duration_us;
+
+	start = k_uptime_ticks();
+	senders_run(BENCHMARK_PACKETS_PER_SENDER);
+	duration_us = MAX(k_ticks_to_us_floor64(k_uptime_ticks() - start), 1);
+
+	zassert_false(rx.error, "Packet received out of order or modified");
+
+	nrf_rpc_tr_stats_get(&stats);
+	zassert_equal(stats.packets_received, SENDER_CNT * BENCHMARK_PACKETS_PER_SENDER,
+		      "Packets lost");
+
+	TC_PRINT("%u packets of %u bytes from %u threads, batching %s:\n",
+		 stats.packets_sent, PACKET_LEN, SENDER_CNT,
+		 IS_ENABLED(CONFIG_NRF_RPC_TR_RPMSG_BATCH) ? "enabled" : "disabled");
+	TC_PRINT("\t%u IPC messages, %u packets per second\n",
+		 stats.frames_sent, (uint32_t)(stats.packets_sent * 1000000ULL / duration_us));
+	TC_PRINT("\tlatency in batch: %u us average, %u us maximum\n",
+		 stats.latency_total_us / stats.packets_sent, stats.latency_max_us);
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = nrf_rpc_tr_init(packet_received);
+	zassert_equal(err, 0, "Transport initialization failed: %d", err);
+
+	ztest_test_suite(nrf_rpc_rpmsg_transport_test,
+			 ztest_unit_test_setup_teardown(test_send_receive, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_concurrent_send, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_send_failure, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_benchmark, test_setup,
+							unit_test_noop));
+
+	ztest_run_test_suite(nrf_rpc_rpmsg_transport_test);
+}